@@ -0,0 +1,380 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the microbenchmark registry, runner and reports.
+ */
+#include "Benchmark.h"
+
+// Include std::sort, std::min, std::max, std::find
+#include <algorithm>
+
+// Include std::sqrt
+#include <cmath>
+
+// Include std::ostream, std::endl
+#include <ostream>
+
+// Include std::setw, std::setprecision
+#include <iomanip>
+
+// Include std::srand
+#include <cstdlib>
+
+// Include OpenSteer::Stopwatch
+#include "OpenSteer/Stopwatch.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    struct Entry {
+        std::string name;
+        BenchmarkFunction function;
+        std::vector< size_t > sizes;
+    };
+    
+    
+    /**
+     * Created on first use by the static registrations of any translation
+     * unit.
+     */
+    std::vector< Entry >& 
+    registry()
+    {
+        static std::vector< Entry > entries;
+        return entries;
+    }
+    
+    
+    bool 
+    matches( std::string const& name, std::string const& filter )
+    {
+        return filter.empty() || std::string::npos != name.find( filter );
+    }
+    
+    
+    /**
+     * Seconds of one run of @a function, inputs generated with the 
+     * standard random number generator are the same for every run.
+     */
+    double 
+    timeRun( BenchmarkFunction function, size_t size, size_t iterations )
+    {
+        std::srand( 1 );
+        BenchmarkState state( size, iterations );
+        function( state );
+        return state.elapsedSeconds();
+    }
+    
+    
+    /**
+     * Writes @a s as JSON string.
+     */
+    void 
+    writeJsonString( std::ostream& out, std::string const& s )
+    {
+        out << '"';
+        for ( std::string::size_type i = 0; i < s.size(); ++i ) {
+            if ( '"' == s[ i ] || '\\' == s[ i ] ) {
+                out << '\\';
+            }
+            out << s[ i ];
+        }
+        out << '"';
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::BenchmarkState::BenchmarkState( size_type size, size_type iterations )
+    : size_( size ), 
+      iterations_( iterations ), 
+      remaining_( iterations ), 
+      started_( false ), 
+      start_( 0.0 ), 
+      elapsedSeconds_( 0.0 )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::BenchmarkState::size_type 
+OpenSteer::BenchmarkState::size() const
+{
+    return size_;
+}
+
+
+
+OpenSteer::BenchmarkState::size_type 
+OpenSteer::BenchmarkState::iterations() const
+{
+    return iterations_;
+}
+
+
+
+bool 
+OpenSteer::BenchmarkState::keepRunning()
+{
+    if ( ! started_ ) {
+        started_ = true;
+        start_ = Stopwatch::now();
+    }
+    
+    if ( 0 == remaining_ ) {
+        elapsedSeconds_ = Stopwatch::now() - start_;
+        return false;
+    }
+    
+    --remaining_;
+    return true;
+}
+
+
+
+double 
+OpenSteer::BenchmarkState::elapsedSeconds() const
+{
+    return elapsedSeconds_;
+}
+
+
+
+OpenSteer::BenchmarkRegistration::BenchmarkRegistration( char const* name, 
+                                                         BenchmarkFunction function )
+{
+    add( name, function, std::vector< size_type >( 1, 0 ) );
+}
+
+
+
+void 
+OpenSteer::BenchmarkRegistration::add( char const* name, 
+                                       BenchmarkFunction function, 
+                                       std::vector< size_type > const& sizes )
+{
+    Entry entry;
+    entry.name = name;
+    entry.function = function;
+    entry.sizes = sizes;
+    registry().push_back( entry );
+}
+
+
+
+OpenSteer::BenchmarkRunner::BenchmarkRunner()
+    : warmup_( 2 ), repetitions_( 15 ), minimumSeconds_( 0.01 )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::BenchmarkRunner::setWarmup( size_type repetitions )
+{
+    warmup_ = repetitions;
+}
+
+
+
+void 
+OpenSteer::BenchmarkRunner::setRepetitions( size_type repetitions )
+{
+    repetitions_ = std::max( size_type( 1 ), repetitions );
+}
+
+
+
+void 
+OpenSteer::BenchmarkRunner::setMinimumSeconds( double seconds )
+{
+    minimumSeconds_ = seconds;
+}
+
+
+
+std::vector< std::string > 
+OpenSteer::BenchmarkRunner::names( std::string const& filter )
+{
+    std::vector< std::string > result;
+    std::vector< Entry > const& entries = registry();
+    for ( size_type i = 0; i < entries.size(); ++i ) {
+        if ( matches( entries[ i ].name, filter ) && 
+             result.end() == std::find( result.begin(), result.end(), entries[ i ].name ) ) {
+            result.push_back( entries[ i ].name );
+        }
+    }
+    return result;
+}
+
+
+
+std::vector< OpenSteer::BenchmarkResult > 
+OpenSteer::BenchmarkRunner::run( std::string const& filter, 
+                                 std::ostream& progress ) const
+{
+    std::vector< BenchmarkResult > results;
+    std::vector< Entry > const& entries = registry();
+    
+    for ( size_type e = 0; e < entries.size(); ++e ) {
+        Entry const& entry = entries[ e ];
+        if ( ! matches( entry.name, filter ) ) {
+            continue;
+        }
+        
+        for ( size_type s = 0; s < entry.sizes.size(); ++s ) {
+            size_type const size = entry.sizes[ s ];
+            progress << entry.name;
+            if ( 0 != size ) {
+                progress << " size " << size;
+            }
+            progress << std::endl;
+            
+            size_type const iterations = calibrate( entry.function, size );
+            
+            for ( size_type i = 0; i < warmup_; ++i ) {
+                timeRun( entry.function, size, iterations );
+            }
+            
+            std::vector< double > times( repetitions_ );
+            for ( size_type i = 0; i < repetitions_; ++i ) {
+                times[ i ] = 1e9 * timeRun( entry.function, size, iterations ) / iterations;
+            }
+            std::sort( times.begin(), times.end() );
+            
+            double sum = 0.0;
+            for ( size_type i = 0; i < times.size(); ++i ) {
+                sum += times[ i ];
+            }
+            double const mean = sum / times.size();
+            double squares = 0.0;
+            for ( size_type i = 0; i < times.size(); ++i ) {
+                squares += ( times[ i ] - mean ) * ( times[ i ] - mean );
+            }
+            
+            size_type const middle = times.size() / 2;
+            BenchmarkResult result;
+            result.name = entry.name;
+            result.size = size;
+            result.iterations = iterations;
+            result.repetitions = repetitions_;
+            result.minimum = times.front();
+            result.median = ( times.size() % 2 ) ? times[ middle ] : 0.5 * ( times[ middle - 1 ] + times[ middle ] );
+            result.mean = mean;
+            result.standardDeviation = ( times.size() > 1 ) ? std::sqrt( squares / ( times.size() - 1 ) ) : 0.0;
+            result.maximum = times.back();
+            results.push_back( result );
+        }
+    }
+    
+    return results;
+}
+
+
+
+void 
+OpenSteer::BenchmarkRunner::write( std::ostream& out, 
+                                   Format format, 
+                                   std::vector< BenchmarkResult > const& results ) const
+{
+    std::streamsize const precision = out.precision( 6 );
+    
+    if ( csv == format ) {
+        out << "name,size,iterations,repetitions,min_ns,median_ns,mean_ns,stddev_ns,max_ns" << '\n';
+        for ( size_type i = 0; i < results.size(); ++i ) {
+            BenchmarkResult const& r = results[ i ];
+            out << '"' << r.name << '"' << ',' << r.size << ',' << r.iterations << ',' 
+                << r.repetitions << ',' << r.minimum << ',' << r.median << ',' 
+                << r.mean << ',' << r.standardDeviation << ',' << r.maximum << '\n';
+        }
+    } else if ( json == format ) {
+        out << "{\n  \"warmup\": " << warmup_ 
+            << ",\n  \"repetitions\": " << repetitions_
+            << ",\n  \"minimum_seconds\": " << minimumSeconds_
+            << ",\n  \"benchmarks\": [";
+        for ( size_type i = 0; i < results.size(); ++i ) {
+            BenchmarkResult const& r = results[ i ];
+            out << ( i ? "," : "" ) << "\n    {\"name\": ";
+            writeJsonString( out, r.name );
+            out << ", \"size\": " << r.size 
+                << ", \"iterations\": " << r.iterations 
+                << ", \"min_ns\": " << r.minimum 
+                << ", \"median_ns\": " << r.median 
+                << ", \"mean_ns\": " << r.mean 
+                << ", \"stddev_ns\": " << r.standardDeviation 
+                << ", \"max_ns\": " << r.maximum << "}";
+        }
+        out << "\n  ]\n}\n";
+    } else {
+        out << std::left << std::setw( 52 ) << "benchmark" << std::right
+            << std::setw( 7 ) << "size" 
+            << std::setw( 12 ) << "iterations" 
+            << std::setw( 12 ) << "median ns" 
+            << std::setw( 12 ) << "mean ns" 
+            << std::setw( 12 ) << "stddev ns" 
+            << std::setw( 12 ) << "min ns" << '\n';
+        for ( size_type i = 0; i < results.size(); ++i ) {
+            BenchmarkResult const& r = results[ i ];
+            out << std::left << std::setw( 52 ) << r.name << std::right 
+                << std::setw( 7 ) << r.size 
+                << std::setw( 12 ) << r.iterations 
+                << std::setw( 12 ) << r.median 
+                << std::setw( 12 ) << r.mean 
+                << std::setw( 12 ) << r.standardDeviation 
+                << std::setw( 12 ) << r.minimum << '\n';
+        }
+    }
+    
+    out.precision( precision );
+    out.flush();
+}
+
+
+
+OpenSteer::BenchmarkRunner::size_type 
+OpenSteer::BenchmarkRunner::calibrate( BenchmarkFunction function, size_type size ) const
+{
+    // grow tenfold until a run is long enough to extrapolate from
+    size_type iterations = 1;
+    double seconds = timeRun( function, size, iterations );
+    while ( seconds < 0.1 * minimumSeconds_ && iterations < 1000000000 ) {
+        iterations *= 10;
+        seconds = timeRun( function, size, iterations );
+    }
+    
+    if ( seconds <= 0.0 ) {
+        return iterations;
+    }
+    double const scaled = iterations * minimumSeconds_ / seconds;
+    return std::max( iterations, static_cast< size_type >( std::min( scaled, 1e10 ) ) );
+}
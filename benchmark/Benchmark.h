@@ -0,0 +1,236 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Minimal microbenchmark framework: benchmark functions register 
+ * themselves with the input sizes they should be run for, the runner
+ * calibrates the number of iterations, warms up, repeats the measurement
+ * and reports statistics of the time per iteration as text, CSV or JSON.
+ *
+ * A benchmark function prepares its input outside of the timed loop:
+ *
+ * <pre>
+ * void seek( BenchmarkState& state )
+ * {
+ *     SimpleVehicle vehicle;
+ *     while ( state.keepRunning() ) {
+ *         keepResult( vehicle.steerForSeek( target ) );
+ *     }
+ * }
+ *
+ * BenchmarkRegistration const registerSeek( "SteerLibrary seek", seek );
+ * </pre>
+ */
+#ifndef OPENSTEER_BENCHMARK_H
+#define OPENSTEER_BENCHMARK_H
+
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Passed to a benchmark function for one timed run of @c iterations
+     * iterations with input size @c size.
+     */
+    class BenchmarkState {
+    public:
+        typedef size_t size_type;
+        
+        BenchmarkState( size_type size, size_type iterations );
+        
+        /**
+         * Input size (number of neighbors, segments, obstacles...) or @c 0
+         * for benchmarks without sizes.
+         */
+        size_type size() const;
+        
+        size_type iterations() const;
+        
+        /**
+         * Returns @c true @c iterations times, starts timing with the first 
+         * and stops it with the last call.
+         */
+        bool keepRunning();
+        
+        /**
+         * Seconds between the first and the last call of @c keepRunning.
+         */
+        double elapsedSeconds() const;
+        
+    private:
+        size_type size_;
+        size_type iterations_;
+        size_type remaining_;
+        bool started_;
+        double start_;
+        double elapsedSeconds_;
+    }; // class BenchmarkState
+    
+    
+    typedef void (*BenchmarkFunction)( BenchmarkState& state );
+    
+    
+    /**
+     * Registers a benchmark function when constructed, instances are
+     * meant to be static.
+     */
+    class BenchmarkRegistration {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Registers @a function to be run once without input size.
+         */
+        BenchmarkRegistration( char const* name, BenchmarkFunction function );
+        
+        /**
+         * Registers @a function to be run for each of the input @a sizes.
+         */
+        template< size_t SizeCount >
+        BenchmarkRegistration( char const* name, 
+                               BenchmarkFunction function, 
+                               size_type const (&sizes)[ SizeCount ] )
+        {
+            add( name, function, std::vector< size_type >( sizes, sizes + SizeCount ) );
+        }
+        
+    private:
+        static void add( char const* name, 
+                         BenchmarkFunction function, 
+                         std::vector< size_type > const& sizes );
+    }; // class BenchmarkRegistration
+    
+    
+    /**
+     * Statistics of the repetitions of one benchmark and size, times are 
+     * nanoseconds per iteration.
+     */
+    struct BenchmarkResult {
+        std::string name;
+        size_t size;
+        size_t iterations;
+        size_t repetitions;
+        double minimum;
+        double median;
+        double mean;
+        double standardDeviation;
+        double maximum;
+    };
+    
+    
+    /**
+     * Runs the registered benchmarks.
+     */
+    class BenchmarkRunner {
+    public:
+        typedef size_t size_type;
+        
+        enum Format { text, csv, json };
+        
+        BenchmarkRunner();
+        
+        /**
+         * Untimed repetitions before measuring, default @c 2.
+         */
+        void setWarmup( size_type repetitions );
+        
+        /**
+         * Measured repetitions, default @c 15.
+         */
+        void setRepetitions( size_type repetitions );
+        
+        /**
+         * Targeted duration of one repetition, the number of iterations is
+         * calibrated to it, default @c 0.01 seconds.
+         */
+        void setMinimumSeconds( double seconds );
+        
+        /**
+         * Names of the registered benchmarks containing @a filter, each
+         * once.
+         */
+        static std::vector< std::string > names( std::string const& filter );
+        
+        /**
+         * Runs all registered benchmarks whose name contains @a filter
+         * (all for an empty filter) for all their sizes, writes the name
+         * and size of each to @a progress before running it.
+         */
+        std::vector< BenchmarkResult > run( std::string const& filter, 
+                                            std::ostream& progress ) const;
+        
+        /**
+         * Writes @a results in @a format, text is a table for reading,
+         * CSV has a header line, JSON is one object with the settings and
+         * an array of results.
+         */
+        void write( std::ostream& out, 
+                    Format format, 
+                    std::vector< BenchmarkResult > const& results ) const;
+        
+    private:
+        size_type calibrate( BenchmarkFunction function, size_type size ) const;
+        
+    private:
+        size_type warmup_;
+        size_type repetitions_;
+        double minimumSeconds_;
+    }; // class BenchmarkRunner
+    
+    
+    /**
+     * Keeps the compiler from optimizing away the computation of @a value.
+     */
+    template< typename T >
+    inline void keepResult( T const& value )
+    {
+#if defined( __GNUC__ )
+        __asm__ __volatile__( "" : : "g"( &value ) : "memory" );
+#else
+        static char volatile sink;
+        sink = *reinterpret_cast< char const volatile* >( &value );
+#endif
+    }
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_BENCHMARK_H
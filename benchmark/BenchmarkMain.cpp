@@ -0,0 +1,122 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Runs the OpenSteer microbenchmarks:
+ *
+ * <pre>
+ * OpenSteerBenchmark [--filter text] [--format text|csv|json] 
+ *                    [--warmup n] [--repetitions n] [--min-time seconds]
+ *                    [--list]
+ * </pre>
+ *
+ * Only benchmarks whose name contains the filter text are run. Results go
+ * to the standard output, progress to the standard error.
+ */
+#include "Benchmark.h"
+
+// Include std::cout, std::cerr
+#include <iostream>
+
+// Include std::strcmp
+#include <cstring>
+
+// Include std::atoi, std::atof, EXIT_SUCCESS, EXIT_FAILURE
+#include <cstdlib>
+
+// Include OpenSteer::setAnnotationOff
+#include "OpenSteer/Annotation.h"
+
+
+
+namespace {
+    
+    int 
+    usage( char const* program )
+    {
+        std::cerr << "usage: " << program 
+                  << " [--filter text] [--format text|csv|json]"
+                  << " [--warmup n] [--repetitions n] [--min-time seconds]"
+                  << " [--list]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+} // anonymous namespace
+
+
+
+int main( int argc, char* argv[] ) 
+{
+    using namespace OpenSteer;
+    
+    BenchmarkRunner runner;
+    BenchmarkRunner::Format format = BenchmarkRunner::text;
+    std::string filter;
+    bool list = false;
+    
+    for ( int i = 1; i < argc; ++i ) {
+        bool const hasValue = ( i + 1 ) < argc;
+        if ( 0 == std::strcmp( argv[ i ], "--list" ) ) {
+            list = true;
+        } else if ( hasValue && 0 == std::strcmp( argv[ i ], "--filter" ) ) {
+            filter = argv[ ++i ];
+        } else if ( hasValue && 0 == std::strcmp( argv[ i ], "--format" ) ) {
+            char const* const name = argv[ ++i ];
+            if ( 0 == std::strcmp( name, "text" ) ) {
+                format = BenchmarkRunner::text;
+            } else if ( 0 == std::strcmp( name, "csv" ) ) {
+                format = BenchmarkRunner::csv;
+            } else if ( 0 == std::strcmp( name, "json" ) ) {
+                format = BenchmarkRunner::json;
+            } else {
+                return usage( argv[ 0 ] );
+            }
+        } else if ( hasValue && 0 == std::strcmp( argv[ i ], "--warmup" ) ) {
+            runner.setWarmup( std::atoi( argv[ ++i ] ) );
+        } else if ( hasValue && 0 == std::strcmp( argv[ i ], "--repetitions" ) ) {
+            runner.setRepetitions( std::atoi( argv[ ++i ] ) );
+        } else if ( hasValue && 0 == std::strcmp( argv[ i ], "--min-time" ) ) {
+            runner.setMinimumSeconds( std::atof( argv[ ++i ] ) );
+        } else {
+            return usage( argv[ 0 ] );
+        }
+    }
+    
+    if ( list ) {
+        std::vector< std::string > const names = BenchmarkRunner::names( filter );
+        for ( size_t i = 0; i < names.size(); ++i ) {
+            std::cout << names[ i ] << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+    
+    // Behaviors only annotate for drawing, which isn't measured.
+    setAnnotationOff();
+    
+    std::vector< BenchmarkResult > const results = runner.run( filter, std::cerr );
+    runner.write( std::cout, format, results );
+    return EXIT_SUCCESS;
+}
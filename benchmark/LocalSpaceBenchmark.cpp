@@ -0,0 +1,147 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Microbenchmarks of the transformations between local and global space
+ * of @c OpenSteer::LocalSpace.
+ */
+#include "Benchmark.h"
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::LocalSpace
+#include "OpenSteer/LocalSpace.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Number of input vectors, a power of two.
+     */
+    size_t const inputCount = 1024;
+    
+    
+    std::vector< Vec3 > 
+    randomVectors()
+    {
+        std::vector< Vec3 > vectors( inputCount );
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            vectors[ i ] = RandomVectorInUnitRadiusSphere() * 10.0f;
+        }
+        return vectors;
+    }
+    
+    
+    size_t 
+    next( size_t index )
+    {
+        return ( index + 1 ) & ( inputCount - 1 );
+    }
+    
+    
+    /**
+     * A local space at a random position with a random orientation.
+     */
+    LocalSpace 
+    randomLocalSpace()
+    {
+        LocalSpace space;
+        space.regenerateOrthonormalBasis( RandomUnitVector() );
+        space.setPosition( RandomVectorInUnitRadiusSphere() * 10.0f );
+        return space;
+    }
+    
+    
+    void 
+    localizePosition( BenchmarkState& state )
+    {
+        LocalSpace const space = randomLocalSpace();
+        std::vector< Vec3 > const points = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( space.localizePosition( points[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    globalizePosition( BenchmarkState& state )
+    {
+        LocalSpace const space = randomLocalSpace();
+        std::vector< Vec3 > const points = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( space.globalizePosition( points[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    localizeDirection( BenchmarkState& state )
+    {
+        LocalSpace const space = randomLocalSpace();
+        std::vector< Vec3 > const directions = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( space.localizeDirection( directions[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    globalizeDirection( BenchmarkState& state )
+    {
+        LocalSpace const space = randomLocalSpace();
+        std::vector< Vec3 > const directions = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( space.globalizeDirection( directions[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    regenerateOrthonormalBasisUF( BenchmarkState& state )
+    {
+        LocalSpace space = randomLocalSpace();
+        std::vector< Vec3 > forwards = randomVectors();
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            forwards[ i ] = forwards[ i ].normalize();
+        }
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            space.regenerateOrthonormalBasisUF( forwards[ i ] );
+            keepResult( space );
+        }
+    }
+    
+    
+    BenchmarkRegistration const registerLocalizePosition( "LocalSpace localizePosition", localizePosition );
+    BenchmarkRegistration const registerGlobalizePosition( "LocalSpace globalizePosition", globalizePosition );
+    BenchmarkRegistration const registerLocalizeDirection( "LocalSpace localizeDirection", localizeDirection );
+    BenchmarkRegistration const registerGlobalizeDirection( "LocalSpace globalizeDirection", globalizeDirection );
+    BenchmarkRegistration const registerRegenerateOrthonormalBasisUF( "LocalSpace regenerateOrthonormalBasisUF", regenerateOrthonormalBasisUF );
+    
+} // anonymous namespace
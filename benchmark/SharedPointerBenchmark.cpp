@@ -0,0 +1,154 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Microbenchmarks of copying and destroying reference counted pointers:
+ * @c OpenSteer::SharedPointer, and @c OpenSteer::IntrusivePointer with a
+ * plain and an atomic count. The contended benchmark's input size is the
+ * number of threads copying pointers to the same object at once.
+ */
+#include "Benchmark.h"
+
+#if ! defined( _WIN32 )
+    // Include pthread_create, pthread_join
+    #include <pthread.h>
+#endif
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::SharedPointer
+#include "OpenSteer/SharedPointer.h"
+
+// Include OpenSteer::IntrusivePointer, OpenSteer::ReferenceCounted
+#include "OpenSteer/IntrusivePointer.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    struct Shared {
+        int value;
+    };
+    
+    struct AtomicShared : public ReferenceCounted< AtomicReferenceCount > {
+        int value;
+    };
+    
+    struct PlainShared : public ReferenceCounted< PlainReferenceCount > {
+        int value;
+    };
+    
+    
+    template< typename Pointer >
+    void 
+    copy( BenchmarkState& state, Pointer const& pointer )
+    {
+        while ( state.keepRunning() ) {
+            Pointer copy( pointer );
+            keepResult( copy );
+        }
+    }
+    
+    
+    void 
+    sharedPointer( BenchmarkState& state )
+    {
+        copy( state, SharedPointer< Shared >( new Shared() ) );
+    }
+    
+    
+    void 
+    intrusivePlain( BenchmarkState& state )
+    {
+        copy( state, IntrusivePointer< PlainShared >( new PlainShared() ) );
+    }
+    
+    
+    void 
+    intrusiveAtomic( BenchmarkState& state )
+    {
+        copy( state, IntrusivePointer< AtomicShared >( new AtomicShared() ) );
+    }
+    
+    
+#if ! defined( _WIN32 )
+    
+    struct Contention {
+        IntrusivePointer< AtomicShared > pointer;
+        bool volatile stopping;
+    };
+    
+    
+    void* 
+    copyUntilStopped( void* state )
+    {
+        Contention& contention = *static_cast< Contention* >( state );
+        while ( ! contention.stopping ) {
+            IntrusivePointer< AtomicShared > copy( contention.pointer );
+            keepResult( copy );
+        }
+        return 0;
+    }
+    
+    
+    /**
+     * Times the copies of one thread while @c state.size() - 1 other threads
+     * copy pointers to the same object.
+     */
+    void 
+    intrusiveAtomicContended( BenchmarkState& state )
+    {
+        Contention contention;
+        contention.pointer.reset( new AtomicShared() );
+        contention.stopping = false;
+        
+        std::vector< pthread_t > threads( state.size() - 1 );
+        for ( size_t i = 0; i < threads.size(); ++i ) {
+            pthread_create( &threads[ i ], 0, copyUntilStopped, &contention );
+        }
+        
+        copy( state, contention.pointer );
+        
+        contention.stopping = true;
+        for ( size_t i = 0; i < threads.size(); ++i ) {
+            pthread_join( threads[ i ], 0 );
+        }
+    }
+    
+    size_t const threadCounts[] = { 1, 2, 4, 8 };
+    
+    BenchmarkRegistration const registerIntrusiveAtomicContended( "IntrusivePointer atomic copy contended", intrusiveAtomicContended, threadCounts );
+    
+#endif
+    
+    BenchmarkRegistration const registerSharedPointer( "SharedPointer copy", sharedPointer );
+    BenchmarkRegistration const registerIntrusivePlain( "IntrusivePointer plain copy", intrusivePlain );
+    BenchmarkRegistration const registerIntrusiveAtomic( "IntrusivePointer atomic copy", intrusiveAtomic );
+    
+} // anonymous namespace
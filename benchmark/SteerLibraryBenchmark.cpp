@@ -0,0 +1,423 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Microbenchmarks of the steering behaviors of @c SteerLibraryMixin and 
+ * of @c SimpleVehicle locomotion. Behaviors reading neighbors, obstacles
+ * or paths are measured for several input sizes. Unless noted otherwise
+ * one iteration is one call of the behavior by a vehicle at the origin
+ * heading along +z.
+ */
+#include "Benchmark.h"
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::SphereObstacle, OpenSteer::ObstacleGroup
+#include "OpenSteer/Obstacle.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::IndexedPathway
+#include "OpenSteer/IndexedPathway.h"
+
+// Include OpenSteer::frandom01
+#include "OpenSteer/Utilities.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Number of input vectors, a power of two.
+     */
+    size_t const inputCount = 1024;
+    
+    size_t const neighborCounts[] = { 1, 4, 16, 64, 256 };
+    size_t const obstacleCounts[] = { 1, 4, 16, 64, 256 };
+    size_t const segmentCounts[] = { 4, 16, 64, 256, 1024 };
+    
+    float const elapsedTime = 1.0f / 60.0f;
+    
+    
+    std::vector< Vec3 > 
+    randomVectors( float radius )
+    {
+        std::vector< Vec3 > vectors( inputCount );
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            vectors[ i ] = RandomVectorInUnitRadiusSphere() * radius;
+        }
+        return vectors;
+    }
+    
+    
+    size_t 
+    next( size_t index )
+    {
+        return ( index + 1 ) & ( inputCount - 1 );
+    }
+    
+    
+    /**
+     * A vehicle that is only steered by the benchmarks.
+     */
+    class Vehicle : public SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * Places @a vehicle at a random position within @a radius of the 
+     * origin heading in a random direction at a random speed.
+     */
+    void 
+    randomize( SimpleVehicle& vehicle, float radius )
+    {
+        vehicle.setPosition( RandomVectorInUnitRadiusSphere() * radius );
+        vehicle.regenerateOrthonormalBasisUF( RandomUnitVector() );
+        vehicle.setSpeed( frandom01() * vehicle.maxSpeed() );
+    }
+    
+    
+    /**
+     * The vehicle calling the behaviors.
+     */
+    class Subject : public Vehicle {
+    public:
+        Subject()
+        {
+            setSpeed( 0.5f * maxSpeed() );
+        }
+    };
+    
+    
+    /**
+     * @a count vehicles within @a radius of the origin.
+     */
+    class Neighborhood {
+    public:
+        Neighborhood( size_t count, float radius )
+        {
+            for ( size_t i = 0; i < count; ++i ) {
+                Vehicle* vehicle = new Vehicle();
+                randomize( *vehicle, radius );
+                vehicles_.push_back( vehicle );
+            }
+        }
+        
+        ~Neighborhood()
+        {
+            for ( size_t i = 0; i < vehicles_.size(); ++i ) {
+                delete vehicles_[ i ];
+            }
+        }
+        
+        AVGroup const& vehicles() const
+        {
+            return vehicles_;
+        }
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Neighborhood( Neighborhood const& );
+        Neighborhood& operator=( Neighborhood const& );
+        
+    private:
+        AVGroup vehicles_;
+    };
+    
+    
+    /**
+     * Points of a random walk on the XZ plane in steps of 5 starting at
+     * the origin.
+     */
+    std::vector< Vec3 > 
+    randomWalk( size_t segmentCount )
+    {
+        std::vector< Vec3 > points( segmentCount + 1, Vec3::zero );
+        for ( size_t i = 1; i < points.size(); ++i ) {
+            points[ i ] = points[ i - 1 ] + RandomUnitVectorOnXZPlane() * 5.0f;
+        }
+        return points;
+    }
+    
+    
+    /**
+     * Positions near random points of @a path.
+     */
+    std::vector< Vec3 > 
+    positionsNear( std::vector< Vec3 > const& path )
+    {
+        std::vector< Vec3 > positions( inputCount );
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            size_t const point = static_cast< size_t >( frandom01() * ( path.size() - 1 ) );
+            positions[ i ] = path[ point ] + RandomVectorInUnitRadiusSphere() * 3.0f;
+        }
+        return positions;
+    }
+    
+    
+    void 
+    seek( BenchmarkState& state )
+    {
+        Subject const subject;
+        std::vector< Vec3 > const targets = randomVectors( 10.0f );
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( subject.steerForSeek( targets[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    flee( BenchmarkState& state )
+    {
+        Subject const subject;
+        std::vector< Vec3 > const targets = randomVectors( 10.0f );
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( subject.steerForFlee( targets[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    wander( BenchmarkState& state )
+    {
+        Subject subject;
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerForWander( elapsedTime ) );
+        }
+    }
+    
+    
+    void 
+    pursuit( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const quarries( inputCount, 10.0f );
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( subject.steerForPursuit( *quarries.vehicles()[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    evasion( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const menaces( inputCount, 10.0f );
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( subject.steerForEvasion( *menaces.vehicles()[ i ], 5.0f ) );
+        }
+    }
+    
+    
+    void 
+    targetSpeed( BenchmarkState& state )
+    {
+        Subject const subject;
+        std::vector< float > speeds( inputCount );
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            speeds[ i ] = frandom01() * subject.maxSpeed();
+        }
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( subject.steerForTargetSpeed( speeds[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    separation( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const flock( state.size(), 5.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerForSeparation( 10.0f, -0.707f, flock.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    alignment( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const flock( state.size(), 5.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerForAlignment( 10.0f, 0.7f, flock.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    cohesion( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const flock( state.size(), 5.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerForCohesion( 10.0f, -0.15f, flock.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    avoidNeighbors( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const others( state.size(), 10.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerToAvoidNeighbors( 3.0f, others.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    avoidCloseNeighbors( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const others( state.size(), 10.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerToAvoidCloseNeighbors( 1.0f, others.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    avoidNeighborsReciprocally( BenchmarkState& state )
+    {
+        Subject const subject;
+        Neighborhood const others( state.size(), 10.0f );
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerToAvoidNeighborsReciprocally( 2.0f, 
+                                                                  elapsedTime, 
+                                                                  subject.velocity(), 
+                                                                  others.vehicles() ) );
+        }
+    }
+    
+    
+    void 
+    avoidObstacles( BenchmarkState& state )
+    {
+        Subject const subject;
+        std::vector< SphereObstacle > spheres( state.size() );
+        ObstacleGroup obstacles;
+        for ( size_t i = 0; i < spheres.size(); ++i ) {
+            spheres[ i ] = SphereObstacle( 1.0f + 2.0f * frandom01(), 
+                                           RandomVectorInUnitRadiusSphere() * 20.0f );
+            obstacles.push_back( &spheres[ i ] );
+        }
+        while ( state.keepRunning() ) {
+            keepResult( subject.steerToAvoidObstacles( 5.0f, obstacles ) );
+        }
+    }
+    
+    
+    /**
+     * One iteration moves the vehicle to the next position near the path
+     * and follows @a path from there.
+     */
+    void 
+    followPathFrom( BenchmarkState& state, Pathway const& path, std::vector< Vec3 > const& positions )
+    {
+        Subject subject;
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            subject.setPosition( positions[ i ] );
+            keepResult( subject.steerToFollowPath( 1, 3.0f, path ) );
+        }
+    }
+    
+    
+    void 
+    followPath( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const points = randomWalk( state.size() );
+        PolylineSegmentedPathwaySingleRadius const path( points.size(), &points[ 0 ], 2.0f, false );
+        followPathFrom( state, path, positionsNear( points ) );
+    }
+    
+    
+    void 
+    followIndexedPath( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const points = randomWalk( state.size() );
+        IndexedPathway const path( points.size(), &points[ 0 ], 2.0f, false );
+        followPathFrom( state, path, positionsNear( points ) );
+    }
+    
+    
+    void 
+    stayOnPath( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const points = randomWalk( state.size() );
+        PolylineSegmentedPathwaySingleRadius const path( points.size(), &points[ 0 ], 2.0f, false );
+        std::vector< Vec3 > const positions = positionsNear( points );
+        Subject subject;
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            subject.setPosition( positions[ i ] );
+            keepResult( subject.steerToStayOnPath( 3.0f, path ) );
+        }
+    }
+    
+    
+    void 
+    applySteeringForce( BenchmarkState& state )
+    {
+        Subject subject;
+        std::vector< Vec3 > const forces = randomVectors( 0.2f );
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            subject.applySteeringForce( forces[ i ], elapsedTime );
+            keepResult( subject );
+        }
+    }
+    
+    
+    BenchmarkRegistration const registerSeek( "SteerLibrary seek", seek );
+    BenchmarkRegistration const registerFlee( "SteerLibrary flee", flee );
+    BenchmarkRegistration const registerWander( "SteerLibrary wander", wander );
+    BenchmarkRegistration const registerPursuit( "SteerLibrary pursuit", pursuit );
+    BenchmarkRegistration const registerEvasion( "SteerLibrary evasion", evasion );
+    BenchmarkRegistration const registerTargetSpeed( "SteerLibrary targetSpeed", targetSpeed );
+    BenchmarkRegistration const registerSeparation( "SteerLibrary separation (neighbors)", separation, neighborCounts );
+    BenchmarkRegistration const registerAlignment( "SteerLibrary alignment (neighbors)", alignment, neighborCounts );
+    BenchmarkRegistration const registerCohesion( "SteerLibrary cohesion (neighbors)", cohesion, neighborCounts );
+    BenchmarkRegistration const registerAvoidNeighbors( "SteerLibrary avoidNeighbors (neighbors)", avoidNeighbors, neighborCounts );
+    BenchmarkRegistration const registerAvoidCloseNeighbors( "SteerLibrary avoidCloseNeighbors (neighbors)", avoidCloseNeighbors, neighborCounts );
+    BenchmarkRegistration const registerAvoidNeighborsReciprocally( "SteerLibrary avoidNeighborsReciprocally (neighbors)", avoidNeighborsReciprocally, neighborCounts );
+    BenchmarkRegistration const registerAvoidObstacles( "SteerLibrary avoidObstacles (obstacles)", avoidObstacles, obstacleCounts );
+    BenchmarkRegistration const registerFollowPath( "SteerLibrary followPath (segments)", followPath, segmentCounts );
+    BenchmarkRegistration const registerFollowIndexedPath( "SteerLibrary followPath indexed (segments)", followIndexedPath, segmentCounts );
+    BenchmarkRegistration const registerStayOnPath( "SteerLibrary stayOnPath (segments)", stayOnPath, segmentCounts );
+    BenchmarkRegistration const registerApplySteeringForce( "SimpleVehicle applySteeringForce", applySteeringForce );
+    
+} // anonymous namespace
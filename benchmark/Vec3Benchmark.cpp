@@ -0,0 +1,194 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Microbenchmarks of the @c OpenSteer::Vec3 operations, each iteration
+ * applies the operation to the next of a fixed set of random vectors.
+ */
+#include "Benchmark.h"
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3, OpenSteer::RandomVectorInUnitRadiusSphere
+#include "OpenSteer/Vec3.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Number of input vectors, a power of two.
+     */
+    size_t const inputCount = 1024;
+    
+    
+    std::vector< Vec3 > 
+    randomVectors()
+    {
+        std::vector< Vec3 > vectors( inputCount );
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            vectors[ i ] = RandomVectorInUnitRadiusSphere() * 10.0f;
+        }
+        return vectors;
+    }
+    
+    
+    size_t 
+    next( size_t index )
+    {
+        return ( index + 1 ) & ( inputCount - 1 );
+    }
+    
+    
+    void 
+    add( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > const b = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ] + b[ i ] );
+        }
+    }
+    
+    
+    void 
+    scale( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ] * 1.5f );
+        }
+    }
+    
+    
+    void 
+    dot( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > const b = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].dot( b[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    cross( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > const b = randomVectors();
+        Vec3 result;
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            result.cross( a[ i ], b[ i ] );
+            keepResult( result );
+        }
+    }
+    
+    
+    void 
+    length( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].length() );
+        }
+    }
+    
+    
+    void 
+    normalize( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].normalize() );
+        }
+    }
+    
+    
+    void 
+    truncateLength( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].truncateLength( 5.0f ) );
+        }
+    }
+    
+    
+    void 
+    parallelComponent( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > b = randomVectors();
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            b[ i ] = b[ i ].normalize();
+        }
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].parallelComponent( b[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    perpendicularComponent( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > b = randomVectors();
+        for ( size_t i = 0; i < inputCount; ++i ) {
+            b[ i ] = b[ i ].normalize();
+        }
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( a[ i ].perpendicularComponent( b[ i ] ) );
+        }
+    }
+    
+    
+    void 
+    distance( BenchmarkState& state )
+    {
+        std::vector< Vec3 > const a = randomVectors();
+        std::vector< Vec3 > const b = randomVectors();
+        for ( size_t i = 0; state.keepRunning(); i = next( i ) ) {
+            keepResult( Vec3::distance( a[ i ], b[ i ] ) );
+        }
+    }
+    
+    
+    BenchmarkRegistration const registerAdd( "Vec3 add", add );
+    BenchmarkRegistration const registerScale( "Vec3 scale", scale );
+    BenchmarkRegistration const registerDot( "Vec3 dot", dot );
+    BenchmarkRegistration const registerCross( "Vec3 cross", cross );
+    BenchmarkRegistration const registerLength( "Vec3 length", length );
+    BenchmarkRegistration const registerNormalize( "Vec3 normalize", normalize );
+    BenchmarkRegistration const registerTruncateLength( "Vec3 truncateLength", truncateLength );
+    BenchmarkRegistration const registerParallelComponent( "Vec3 parallelComponent", parallelComponent );
+    BenchmarkRegistration const registerPerpendicularComponent( "Vec3 perpendicularComponent", perpendicularComponent );
+    BenchmarkRegistration const registerDistance( "Vec3 distance", distance );
+    
+} // anonymous namespace
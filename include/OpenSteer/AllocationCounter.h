@@ -0,0 +1,162 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Counts the heap allocations of the whole program, for allocation counts
+ * in benchmarks and performance regression runs. The global operator new 
+ * and delete replaced in AllocationCounterOperators.cpp update the 
+ * counters. Only the programs measuring allocations link it (OpenSteerDemo,
+ * the benchmark and the unit tests), in others the counters stay @c 0.
+ *
+ * The counters are updated with atomic additions so that allocations on 
+ * any thread are counted, they are never reset: measure differences.
+ * Threads running next to the measured code, like the metrics exporter,
+ * keep their allocations out of the counts with an @c UncountedScope.
+ *
+ * Code that must not allocate, like the steady state of a simulation, can
+ * be checked by forbidding allocations: every operator new then calls a
+ * handler, which by default reports the allocation and aborts so that a 
+ * debugger shows where it came from.
+ */
+#ifndef OPENSTEER_ALLOCATIONCOUNTER_H
+#define OPENSTEER_ALLOCATIONCOUNTER_H
+
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class AllocationCounter {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Called with the size of each allocation while allocations are
+         * forbidden. Handlers are called from operator new and must not 
+         * allocate themselves.
+         */
+        typedef void (*ForbiddenAllocationHandler)( size_type bytes );
+        
+        /**
+         * Forbids allocations while it exists, restores the previous 
+         * state on destruction.
+         */
+        class ForbiddenScope {
+        public:
+            ForbiddenScope();
+            ~ForbiddenScope();
+            
+        private:
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            ForbiddenScope( ForbiddenScope const& );
+            
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            ForbiddenScope& operator=( ForbiddenScope const& );
+            
+        private:
+            bool wasForbidden_;
+        }; // class ForbiddenScope
+        
+        /**
+         * Allocations of the calling thread are neither counted nor 
+         * forbidden while it exists, restores the previous state on
+         * destruction.
+         */
+        class UncountedScope {
+        public:
+            UncountedScope();
+            ~UncountedScope();
+            
+        private:
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            UncountedScope( UncountedScope const& );
+            
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            UncountedScope& operator=( UncountedScope const& );
+            
+        private:
+            bool wasUncounted_;
+        }; // class UncountedScope
+        
+        /**
+         * Number of calls of operator new (all forms) since program start.
+         */
+        static size_type allocationCount();
+        
+        /**
+         * Bytes requested from operator new since program start.
+         */
+        static size_type allocatedBytes();
+        
+        /**
+         * Called by the replaced operator new: counts the allocation and 
+         * calls the handler if allocations are forbidden, unless the calling
+         * thread is in an @c UncountedScope.
+         */
+        static void countAllocation( size_type bytes );
+        
+        /**
+         * Returns @c false while the calling thread is in an 
+         * @c UncountedScope.
+         */
+        static bool threadCounted();
+        
+        /**
+         * Forbids or allows allocations on all counted threads.
+         */
+        static void forbidAllocations( bool forbid );
+        static bool allocationsForbidden();
+        
+        /**
+         * Replaces the handler of forbidden allocations, @c 0 restores the
+         * default one that aborts.
+         */
+        static void setForbiddenAllocationHandler( ForbiddenAllocationHandler handler );
+        
+    private:
+        /**
+         * Not implemented, only the static members are used.
+         */
+        AllocationCounter();
+    }; // class AllocationCounter
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ALLOCATIONCOUNTER_H
@@ -0,0 +1,268 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Grid based continuum crowd layer for very large crowds.
+ *
+ * Agents splat their density and velocity onto a 2D grid on the XZ plane.
+ * From the density a per cell cost of travel is derived and a potential
+ * field toward a set of goals is computed by fast marching. Agents steer by
+ * sampling the gradient of the potential which is O(1) per agent. Close
+ * range avoidance should still be done with a proximity database.
+ *
+ * See Adrien Treuille, Seth Cooper, Zoran Popovic, Continuum Crowds, 
+ * ACM Transactions on Graphics 25(3), 2006, pp. 1160--1168.
+ */
+#ifndef OPENSTEER_CONTINUUMCROWD_H
+#define OPENSTEER_CONTINUUMCROWD_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::pair
+#include <utility>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Density, average velocity and cost of travel of a crowd sampled on a 
+     * regular grid on the XZ plane. Shared by all @c ContinuumCrowdPotential
+     * instances (one per group of agents with a common goal).
+     *
+     * Per frame usage: @c clear, @c splat each agent, @c computeCosts.
+     *
+     * @c splat isn't thread safe, @c computeCosts runs parallel if OpenMP is
+     * enabled, all sampling functions are const and thread safe.
+     */
+    class ContinuumCrowdGrid {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Tuning parameters of the speed and cost fields.
+         */
+        struct Parameters {
+            Parameters();
+            
+            /// Speed agents walk at in sparse regions.
+            float maxSpeed;
+            /// Lower bound of the speed in dense regions.
+            float minSpeed;
+            /// Density up to which agents walk at @c maxSpeed.
+            float minDensity;
+            /// Density above which agents move with the crowd flow.
+            float maxDensity;
+            /// Weight of the path length in the cost function.
+            float lengthWeight;
+            /// Weight of the travel time in the cost function.
+            float timeWeight;
+            /// Weight of the density (discomfort) in the cost function.
+            float discomfortWeight;
+        };
+        
+        
+        /**
+         * Grid covering the rectangle of @a width (x) times @a depth (z) 
+         * centered at @a center with quadratic cells of size @a cellSize.
+         */
+        ContinuumCrowdGrid( Vec3 const& center, 
+                            float width, 
+                            float depth, 
+                            float cellSize,
+                            Parameters const& parameters = Parameters() );
+        
+        void setParameters( Parameters const& parameters );
+        Parameters const& parameters() const;
+        
+        size_type columnCount() const;
+        size_type rowCount() const;
+        size_type cellCount() const;
+        float cellSize() const;
+        
+        /**
+         * Returns the center of the cell at @a column and @a row.
+         */
+        Vec3 cellCenter( size_type column, size_type row ) const;
+        
+        /**
+         * Marks a cell as impassable (walls, everything outside a pathway).
+         * All cells are passable initially.
+         */
+        void setPassable( size_type column, size_type row, bool passable );
+        bool isPassable( size_type column, size_type row ) const;
+        
+        /**
+         * Resets density and velocity of all cells to zero.
+         */
+        void clear();
+        
+        /**
+         * Adds an agent at @a position with @a velocity. The density is 
+         * distributed bilinearly over the four nearest cells. Agents outside
+         * the grid are ignored.
+         */
+        void splat( Vec3 const& position, Vec3 const& velocity );
+        
+        /**
+         * Computes the average velocity, speed and cost of each cell from the
+         * splatted agents. Call after all agents are splatted. Calling it 
+         * again without splatting yields the same result.
+         */
+        void computeCosts();
+        
+        /**
+         * Density at @a position, bilinearly interpolated.
+         */
+        float sampleDensity( Vec3 const& position ) const;
+        
+        /**
+         * Average velocity of the crowd at the cell containing @a position
+         * as of the last @c computeCosts.
+         */
+        Vec3 sampleAverageVelocity( Vec3 const& position ) const;
+        
+        
+        // Cell access used by ContinuumCrowdPotential.
+        
+        size_type cellIndex( size_type column, size_type row ) const;
+        
+        /**
+         * Cost to travel a unit distance through cell @a index. 
+         * @c std::numeric_limits< float >::max() for impassable cells.
+         */
+        float cost( size_type index ) const;
+        
+        /**
+         * Maps @a position to the grid. Returns @c false if outside.
+         */
+        bool mapPositionToCell( Vec3 const& position, 
+                                size_type& column, 
+                                size_type& row ) const;
+        
+        /**
+         * Maps @a position to the continuous grid coordinates relative to 
+         * the cell centers (cell @c (0,0) has its center at @c (0,0)).
+         */
+        void mapPositionToGrid( Vec3 const& position, float& x, float& z ) const;
+        
+    private:
+        Vec3 origin_;
+        float cellSize_;
+        size_type columns_;
+        size_type rows_;
+        Parameters parameters_;
+        
+        std::vector< float > density_;
+        // velocities splatted since the last clear, and their average per
+        // cell as of the last computeCosts
+        std::vector< Vec3 > velocitySum_;
+        std::vector< Vec3 > averageVelocity_;
+        std::vector< float > cost_;
+        std::vector< char > passable_;
+    }; // class ContinuumCrowdGrid
+    
+    
+    
+    /**
+     * Potential field toward a set of goal cells on a @c ContinuumCrowdGrid.
+     * Use one instance per group of agents sharing a goal.
+     *
+     * Different instances may @c compute in parallel on the same grid. 
+     * Sampling is const and thread safe.
+     */
+    class ContinuumCrowdPotential {
+    public:
+        typedef ContinuumCrowdGrid::size_type size_type;
+        
+        ContinuumCrowdPotential();
+        
+        void clearGoals();
+        
+        /**
+         * Adds all passable cells within @a radius of @a position as goals.
+         */
+        void addGoal( ContinuumCrowdGrid const& grid, 
+                      Vec3 const& position, 
+                      float radius );
+        
+        /**
+         * Computes the potential of all cells (the cost of the cheapest way
+         * to a goal) by fast marching, followed by the direction of steepest
+         * descent per cell.
+         *
+         * The working storage is kept between calls so recomputing a 
+         * potential each frame doesn't allocate.
+         */
+        void compute( ContinuumCrowdGrid const& grid );
+        
+        /**
+         * Returns the unit direction (on the XZ plane) toward the goals at 
+         * @a position, bilinearly interpolated, or @c Vec3::zero if there's
+         * no way to a goal from there.
+         */
+        Vec3 sampleDirection( ContinuumCrowdGrid const& grid, 
+                              Vec3 const& position ) const;
+        
+        /**
+         * Potential of the cell containing @a position. 
+         * @c std::numeric_limits< float >::max() if unreachable or outside
+         * of the grid.
+         */
+        float samplePotential( ContinuumCrowdGrid const& grid, 
+                               Vec3 const& position ) const;
+        
+    private:
+        /**
+         * Potential of cell @a index if @a inGrid and the cell is accepted
+         * by the fast marching, unreachable otherwise.
+         */
+        float acceptedPotential( size_type index, bool inGrid ) const;
+        
+    private:
+        std::vector< size_type > goals_;
+        std::vector< float > potential_;
+        std::vector< Vec3 > direction_;
+        std::vector< char > accepted_;
+        
+        /// Heap of ( potential, cell index ) used by the fast marching.
+        std::vector< std::pair< float, size_type > > front_;
+    }; // class ContinuumCrowdPotential
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CONTINUUMCROWD_H
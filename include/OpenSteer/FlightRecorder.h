@@ -0,0 +1,251 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Flight recorder of the work done by each agent: always on, it keeps the
+ * most recent per agent records of every thread in a fixed size ring 
+ * buffer, to be dumped when a frame takes too long or on demand.
+ *
+ * A record holds the frame, the agent's serial number and the counters
+ * noted while the agent's @c AgentScope is open: neighbors returned by 
+ * proximity queries, obstacles tested by @c steerToAvoidObstacles and the
+ * branch @c steerToAvoidNeighbors took. Notes made outside of an agent
+ * scope are ignored.
+ *
+ * Each thread writes only into its own ring, without locks or atomic
+ * read-modify-write operations. Dumping may run concurrently with the
+ * recording threads, it drops the records overwritten while it copies.
+ */
+#ifndef OPENSTEER_FLIGHTRECORDER_H
+#define OPENSTEER_FLIGHTRECORDER_H
+
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include uint16_t, uint32_t
+#include <stdint.h>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+#if defined( _MSC_VER )
+    #define OPENSTEER_THREAD_LOCAL __declspec( thread )
+#else
+    #define OPENSTEER_THREAD_LOCAL __thread
+#endif
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Process wide flight recorder, all members are static.
+     */
+    class FlightRecorder {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Branch taken by @c steerToAvoidNeighbors.
+         */
+        enum Avoidance {
+            /// @c steerToAvoidNeighbors wasn't called.
+            notEvaluated,
+            /// No neighbor threatens a collision.
+            noThreat,
+            /// A neighbor is already too close.
+            closeNeighbor,
+            headOn,
+            parallel,
+            /// Steering behind the threat.
+            perpendicular,
+            /// Perpendicular, but the threat is slower and steers instead.
+            perpendicularFaster,
+            avoidanceCount
+        };
+        
+        /**
+         * Compact binary record of one agent update, 16 bytes. Counts
+         * saturate.
+         */
+        struct Record {
+            uint32_t frame;
+            uint32_t agent;
+            uint16_t neighbors;
+            uint16_t obstacles;
+            uint16_t thread;
+            uint16_t avoidance;
+        };
+        
+        /**
+         * Records the work of @a agent while it lives.
+         */
+        class AgentScope {
+        public:
+            explicit AgentScope( size_type agent );
+            ~AgentScope();
+        private:
+            bool recording_;
+        }; // class AgentScope
+        
+        
+        /**
+         * Recording is on by default, turning it off costs one branch per
+         * agent scope.
+         */
+        static void setEnabled( bool enabled );
+        static bool enabled();
+        
+        /**
+         * Size of the ring of each thread, rounded up to a power of two, 
+         * default @c 16384. A ring keeps its newest @c capacity() - 1 
+         * records, the slot left is the one being written. Applies to the
+         * rings of threads recording for the first time after the call.
+         */
+        static void setCapacity( size_type records );
+        static size_type capacity();
+        
+        /**
+         * Starts the next frame, called by the thread running the frames.
+         */
+        static void beginFrame();
+        static size_type frame();
+        
+        static void beginAgent( size_type agent );
+        static void endAgent();
+        
+        static void addNeighbors( size_type count );
+        static void addObstacles( size_type count );
+        static void setAvoidance( Avoidance avoidance );
+        
+        /**
+         * Dumps to a file named @a prefix, the frame and @c ".flight" each
+         * time @c endFrame is told of a frame longer than 
+         * @a thresholdSeconds, up to @a maxDumps times. A threshold of 
+         * @c 0 turns spike dumps off.
+         */
+        static void setSpikeDump( std::string const& prefix, 
+                                  double thresholdSeconds,
+                                  size_type maxDumps = 10 );
+        
+        /**
+         * Ends the frame begun last, which took @a seconds. Returns @c true
+         * if that caused a dump, written to @c lastDumpFile.
+         */
+        static bool endFrame( double seconds );
+        
+        static std::string const& lastDumpFile();
+        
+        /**
+         * Dumps right away to a file named like the spike dumps, 
+         * @c flight- followed by the frame and @c ".flight" by default.
+         */
+        static bool dumpNow( std::string& errorMessage );
+        
+        /**
+         * The records of all threads, oldest first per thread.
+         */
+        static std::vector< Record > records();
+        
+        /**
+         * Writes all records to @a fileName: the magic bytes @c OSFR, 
+         * version, record size and record count as 32 bit integers, then
+         * the records, all in the byte order of the recording machine.
+         */
+        static bool dump( std::string const& fileName, std::string& errorMessage );
+        
+        static bool readDump( std::string const& fileName, 
+                              std::vector< Record >& records,
+                              std::string& errorMessage );
+        
+        /**
+         * Prints @a records as a table, followed by the records doing the
+         * most work per frame.
+         */
+        static void print( std::ostream& out, std::vector< Record > const& records );
+        
+        static char const* name( Avoidance avoidance );
+        
+    private:
+        /**
+         * Not implemented, all members are static.
+         */
+        FlightRecorder();
+        
+        struct Ring;
+        
+        static Ring& threadRing();
+        static Ring* loadRings();
+        
+    private:
+        static bool enabled_;
+        static Ring* volatile rings_;
+        static OPENSTEER_THREAD_LOCAL Ring* currentRing_;
+    }; // class FlightRecorder
+    
+    
+    
+    inline 
+    bool 
+    FlightRecorder::enabled()
+    {
+        return enabled_;
+    }
+    
+    
+    inline 
+    FlightRecorder::AgentScope::AgentScope( size_type agent )
+        : recording_( FlightRecorder::enabled() )
+    {
+        if ( recording_ ) {
+            FlightRecorder::beginAgent( agent );
+        }
+    }
+    
+    
+    inline 
+    FlightRecorder::AgentScope::~AgentScope()
+    {
+        if ( recording_ ) {
+            FlightRecorder::endAgent();
+        }
+    }
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FLIGHTRECORDER_H
@@ -0,0 +1,215 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Frame time budget: measures the cost of the update and draw phases of
+ * each frame and, while frames keep taking longer than the budget, lowers
+ * the fidelity of the simulation step by step until they fit again.
+ *
+ * Fidelity is lowered through knobs: the number of neighbors an agent
+ * considers, how often annotation is drawn and how far from the observer
+ * agents are updated every frame (farther ones move to lower update rates
+ * of a @c LevelOfDetailScheduler). Plugins declare the knobs they honor.
+ * A knob of the phase which costs most is turned down after a few frames
+ * over budget, the last turned knob is turned back up after many frames
+ * with headroom. Every decision is written to a log.
+ */
+#ifndef OPENSTEER_FRAMEBUDGET_H
+#define OPENSTEER_FRAMEBUDGET_H
+
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Degrades and restores simulation fidelity to keep frames within a 
+     * time budget. Disabled (no budget) by default, then all knobs stay at
+     * full fidelity.
+     *
+     * Per frame call @c beginFrame before the update, then report the cost
+     * of each phase with @c addPhaseSeconds. @c beginFrame decides on the 
+     * frame reported before. Not thread safe.
+     */
+    class FrameBudget {
+    public:
+        typedef size_t size_type;
+        
+        enum Phase { updatePhase, drawPhase, phaseCount };
+        
+        /**
+         * Ways to lower fidelity, each has the steps @c 0 (full fidelity)
+         * to @c maxStep.
+         */
+        enum Knob { annotationKnob, distantUpdatesKnob, neighborCapKnob, knobCount };
+        
+        static int const maxStep = 3;
+        
+        /// Frames over budget in a row before fidelity is lowered.
+        static size_type const degradeAfterFrames = 3;
+        
+        /// Frames with headroom in a row before fidelity is restored.
+        static size_type const restoreAfterFrames = 60;
+        
+        /// Frames taking less than this part of the budget have headroom.
+        static float headroom() { return 0.7f; }
+        
+        FrameBudget();
+        
+        /**
+         * Sets the time per frame in seconds, @c 0 disables the budget and
+         * restores full fidelity.
+         */
+        void setBudget( float seconds );
+        float budget() const;
+        bool enabled() const;
+        
+        /**
+         * Decisions are written as one line each to @a log, @c 0 (the
+         * default) doesn't log. The stream isn't owned.
+         */
+        void setLog( std::ostream* log );
+        
+        /**
+         * Plugins declare the knobs they honor after @c reset, only those
+         * are turned. @c annotationKnob is supported by default.
+         */
+        void setSupported( Knob knob, bool supported );
+        bool supported( Knob knob ) const;
+        
+        /**
+         * Restores full fidelity, forgets measurements and decisions and 
+         * the supported knobs. Keeps budget and log. Call when a plugin is
+         * opened.
+         */
+        void reset();
+        
+        /**
+         * Adds @a seconds to the cost of @a phase of the current frame.
+         */
+        void addPhaseSeconds( Phase phase, float seconds );
+        
+        /**
+         * Ends the current frame, possibly turns one knob, and starts the 
+         * next frame.
+         */
+        void beginFrame();
+        
+        /**
+         * Number of frames begun since the last @c reset.
+         */
+        size_type frame() const;
+        
+        /**
+         * Cost of @a phase during the last ended frame.
+         */
+        float phaseSeconds( Phase phase ) const;
+        
+        int step( Knob knob ) const;
+        
+        /**
+         * Most neighbors an agent should consider, @c 0 for no limit.
+         */
+        size_type neighborCap() const;
+        
+        /**
+         * Annotation is drawn every @c annotationInterval frames, never if
+         * it's @c 0.
+         */
+        size_type annotationInterval() const;
+        
+        /**
+         * Whether annotation is drawn in the current frame.
+         */
+        bool annotateFrame() const;
+        
+        /**
+         * Whether agents far from the observer should be updated at lower
+         * rates (for example by a @c LevelOfDetailScheduler).
+         */
+        bool reduceDistantUpdates() const;
+        
+        /**
+         * Factor for the distance within which agents are updated every
+         * frame, @c 1 down to @c 0.25 as @c distantUpdatesKnob is turned.
+         */
+        float fullDetailScale() const;
+        
+        /**
+         * Number of decisions since the last @c reset and the last one as
+         * logged.
+         */
+        size_type decisionCount() const;
+        std::string const& lastDecision() const;
+        
+        static char const* name( Knob knob );
+        
+        /**
+         * Describes the setting of @a knob at @a step, for example 
+         * "every 4th frame".
+         */
+        static std::string describe( Knob knob, int step );
+        
+    private:
+        bool degrade();
+        bool restore();
+        void decide( Knob knob, int step, char const* reason );
+        
+    private:
+        float budget_;
+        std::ostream* log_;
+        bool supported_[ knobCount ];
+        int steps_[ knobCount ];
+        // knobs in the order they were turned down
+        std::vector< Knob > turned_;
+        float phaseSeconds_[ phaseCount ];
+        float lastPhaseSeconds_[ phaseCount ];
+        size_type frame_;
+        size_type framesOver_;
+        size_type framesWithHeadroom_;
+        bool exhausted_;
+        size_type decisionCount_;
+        std::string lastDecision_;
+    }; // class FrameBudget
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FRAMEBUDGET_H
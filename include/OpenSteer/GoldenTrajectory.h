@@ -0,0 +1,214 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Reference trajectories of vehicles for checking that optimizations of
+ * the locomotion code don't change results.
+ *
+ * A trajectory is a list of samples (step, vehicle index, position,
+ * forward, up and speed) recorded while a deterministic simulation runs.
+ * It is stored as text with floats written with enough digits to be read
+ * back exactly, one sample per line, @c # starts a comment line:
+ *
+ * <pre>
+ * <step> <vehicle> <position x y z> <forward x y z> <up x y z> <speed>
+ * </pre>
+ */
+#ifndef OPENSTEER_GOLDENTRAJECTORY_H
+#define OPENSTEER_GOLDENTRAJECTORY_H
+
+
+// Include std::istream, std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Samples of vehicle states in the order they were recorded.
+     *
+     * Loading functions return @c false and describe the problem in 
+     * @c errorMessage if the input is malformed, the trajectory is left
+     * empty then.
+     */
+    class GoldenTrajectory {
+    public:
+        typedef size_t size_type;
+        
+        struct Sample {
+            size_type step;
+            size_type vehicle;
+            Vec3 position;
+            Vec3 forward;
+            Vec3 up;
+            float speed;
+        };
+        
+        /**
+         * Outcome of comparing a trajectory to a golden one.
+         */
+        struct Comparison {
+            /// All samples agree within the tolerance.
+            bool match;
+            /// Index of the first sample that doesn't agree, or @c npos.
+            size_type firstMismatch;
+            /// Largest relative deviation of a position, forward, up or
+            /// speed component over all compared samples.
+            float maxDeviation;
+            /// Empty for a match, otherwise what differs first.
+            std::string message;
+        };
+        
+        static size_type const npos;
+        
+        GoldenTrajectory();
+        
+        void clear();
+        
+        /**
+         * Appends the current state of @a vehicle as sample of @a step.
+         */
+        void record( size_type step, 
+                     size_type vehicleIndex, 
+                     AbstractVehicle const& vehicle );
+        
+        void add( Sample const& sample );
+        
+        size_type size() const;
+        Sample const& sample( size_type index ) const;
+        
+        /**
+         * Compares this trajectory sample by sample with @a golden. 
+         * Components @c a of this and @c b of @a golden agree if 
+         * <code>|a - b| <= tolerance * max( 1, |b| )</code>, a @a tolerance
+         * of @c 0 asks for bitwise equal floats. Trajectories of different
+         * length or with different steps or vehicles never match.
+         */
+        Comparison compare( GoldenTrajectory const& golden, 
+                            float tolerance ) const;
+        
+        bool load( std::string const& fileName );
+        bool save( std::string const& fileName ) const;
+        
+        bool read( std::istream& in );
+        void write( std::ostream& out ) const;
+        
+        std::string const& errorMessage() const;
+        
+    private:
+        /**
+         * Clears the trajectory, stores @a message and returns @c false.
+         */
+        bool fail( std::string const& message );
+        
+    private:
+        std::vector< Sample > samples_;
+        std::string errorMessage_;
+    }; // class GoldenTrajectory
+    
+    
+    
+    /**
+     * The golden trajectory check of a deterministic plugin, set up by its
+     * headless options:
+     *
+     * - @c goldenInterval: steps between two samples (default @c 60)
+     * - @c saveGolden: file to write the recorded trajectory to
+     * - @c golden: file with the trajectory to compare with
+     * - @c goldenTolerance: relative tolerance of the comparison, @c 0 for
+     *   bitwise equal floats (default @c 1e-5)
+     *
+     * Samples are only recorded if one of the files is set.
+     */
+    class GoldenTrajectoryCheck {
+    public:
+        typedef GoldenTrajectory::size_type size_type;
+        
+        GoldenTrajectoryCheck();
+        
+        /**
+         * Returns @c true if @a name is one of the options above.
+         */
+        static bool isOption( char const* name );
+        
+        /**
+         * Sets option @a name, returns @c false if it isn't one of the 
+         * options above or @a value is invalid.
+         */
+        bool setOption( char const* name, char const* value );
+        
+        /**
+         * Forgets all recorded samples.
+         */
+        void clear();
+        
+        /**
+         * Records the states of all @a vehicles if @a step is a sampling 
+         * step.
+         */
+        void sample( size_type step, AVGroup const& vehicles );
+        
+        /**
+         * Saves the recorded trajectory and compares it with the golden one
+         * as the options ask and reports the outcome to @a report. Returns
+         * @c false if the trajectory couldn't be saved, the golden one 
+         * couldn't be loaded or they don't match.
+         */
+        bool check( std::ostream& report ) const;
+        
+    private:
+        bool recording() const;
+        
+    private:
+        size_type interval_;
+        float tolerance_;
+        std::string goldenFile_;
+        std::string saveGoldenFile_;
+        GoldenTrajectory trajectory_;
+    }; // class GoldenTrajectoryCheck
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_GOLDENTRAJECTORY_H
@@ -0,0 +1,165 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Immutable single radius polyline pathway with precomputed acceleration
+ * structures for its queries.
+ *
+ * @c PolylineSegmentedPathwaySingleRadius maps a point to the path by
+ * testing every segment and a distance along the path by walking the
+ * segments. An indexed pathway is built once and never changes, so it
+ * keeps a uniform grid listing the segments which may be nearest to any
+ * point of a cell, and the distance along the path at which each segment 
+ * starts. It can be shared by any number of vehicles, crowds and plugins
+ * (see @c PathRegistry) and queried from several threads at once.
+ */
+#ifndef OPENSTEER_INDEXEDPATHWAY_H
+#define OPENSTEER_INDEXEDPATHWAY_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Pathway
+#include "OpenSteer/Pathway.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Pathway with a single radius whose queries only look at the segments
+     * near the query point. Points outside of the grid, which covers the 
+     * path with a margin of a few cells, are mapped by testing all 
+     * segments. Results equal those of the wrapped 
+     * @c PolylineSegmentedPathwaySingleRadius.
+     *
+     * All member functions are const and thread safe.
+     */
+    class IndexedPathway : public Pathway {
+    public:
+        typedef PolylineSegmentedPathwaySingleRadius::size_type size_type;
+        
+        /**
+         * Creates the pathway and its acceleration structures.
+         *
+         * @pre @a numOfPoints >= 2
+         */
+        IndexedPathway( size_type numOfPoints,
+                        Vec3 const points[],
+                        float r,
+                        bool closeCycle );
+        
+        virtual ~IndexedPathway();
+        
+        virtual bool isValid() const;
+        virtual Vec3 mapPointToPath( Vec3 const& point, 
+                                     Vec3& tangent, 
+                                     float& outside ) const;
+        virtual Vec3 mapPathDistanceToPoint( float pathDistance ) const;
+        virtual float mapPointToPathDistance( Vec3 const& point ) const;
+        virtual bool isCyclic() const;
+        virtual float length() const;
+        
+        /**
+         * The wrapped pathway, for drawing and for queries not accelerated.
+         */
+        PolylineSegmentedPathwaySingleRadius const& polyline() const;
+        
+        float radius() const;
+        size_type pointCount() const;
+        Vec3 point( size_type pointIndex ) const;
+        
+        /**
+         * Number of cells of the segment grid.
+         */
+        size_type cellCount() const;
+        
+        /**
+         * Mean number of segments tested per cell (instead of 
+         * @c polyline().segmentCount()).
+         */
+        float meanSegmentsPerCell() const;
+        
+    private:
+        /**
+         * Builds the segment grid.
+         */
+        void buildSegmentGrid();
+        
+        /**
+         * Returns the index of the cell containing @a point, or 
+         * @c cellCount() if the point is outside of the grid.
+         */
+        size_type cellIndex( Vec3 const& point ) const;
+        
+        /**
+         * Like @c mapPointToPathAlike but only tests the segments listed
+         * for the cell of @a point.
+         */
+        template< class Mapping >
+        void mapPointToIndexedPath( Vec3 const& point, Mapping& mapping ) const;
+        
+        /**
+         * Not implemented to make it non-copyable, share it instead.
+         */
+        IndexedPathway( IndexedPathway const& );
+        
+        /**
+         * Not implemented to make it non-copyable, share it instead.
+         */
+        IndexedPathway& operator=( IndexedPathway const& );
+        
+    private:
+        PolylineSegmentedPathwaySingleRadius const polyline_;
+        
+        // distance along the path at which each segment starts
+        std::vector< float > segmentStartDistance_;
+        
+        // the grid covers gridMin_ to gridMin_ + cells_ * cellSize_
+        Vec3 gridMin_;
+        float cellSize_;
+        float inverseCellSize_;
+        size_type cells_[ 3 ];
+        
+        // segments of cell c are cellSegments_[ cellStart_[ c ] ] to
+        // cellSegments_[ cellStart_[ c + 1 ] - 1 ] in increasing order
+        std::vector< size_type > cellStart_;
+        std::vector< size_type > cellSegments_;
+    }; // class IndexedPathway
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_INDEXEDPATHWAY_H
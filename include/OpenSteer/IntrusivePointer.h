@@ -0,0 +1,395 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Reference counting smart pointer for objects carrying their own count.
+ */
+#ifndef OPENSTEER_INTRUSIVEPOINTER_H
+#define OPENSTEER_INTRUSIVEPOINTER_H
+
+
+// Include std::swap
+#include <algorithm>
+
+// Include assert
+#include <cassert>
+
+#if defined( _MSC_VER )
+    // Include _InterlockedIncrement, _InterlockedDecrement
+    #include <intrin.h>
+#endif
+
+
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    /**
+     * Reference count that can be retained and released from several 
+     * threads at once. Retaining needs no ordering (a new reference is
+     * always made from an existing one), releasing orders all uses of the
+     * object before its deletion by the thread releasing the last reference.
+     */
+    class AtomicReferenceCount {
+    public:
+        typedef size_t size_type;
+        
+        AtomicReferenceCount() : count_( 0 ) {
+            // Nothing to do.
+        }
+        
+        void retain() {
+#if defined( __ATOMIC_RELAXED )
+            __atomic_fetch_add( &count_, 1, __ATOMIC_RELAXED );
+#elif defined( _MSC_VER )
+            _InterlockedIncrement( &count_ );
+#else
+            __sync_fetch_and_add( &count_, 1 );
+#endif
+        }
+        
+        /**
+         * Returns @c true if the last reference has been released.
+         */
+        bool release() {
+#if defined( __ATOMIC_ACQ_REL )
+            return 0 == __atomic_sub_fetch( &count_, 1, __ATOMIC_ACQ_REL );
+#elif defined( _MSC_VER )
+            return 0 == _InterlockedDecrement( &count_ );
+#else
+            return 0 == __sync_sub_and_fetch( &count_, 1 );
+#endif
+        }
+        
+        /**
+         * Might already be outdated if other threads share the object.
+         */
+        size_type value() const {
+#if defined( __ATOMIC_RELAXED )
+            return static_cast< size_type >( __atomic_load_n( &count_, __ATOMIC_RELAXED ) );
+#else
+            return static_cast< size_type >( count_ );
+#endif
+        }
+        
+    private:
+        long volatile count_;
+    }; // class AtomicReferenceCount
+    
+    
+    /**
+     * Reference count for objects only shared inside one thread.
+     */
+    class PlainReferenceCount {
+    public:
+        typedef size_t size_type;
+        
+        PlainReferenceCount() : count_( 0 ) {
+            // Nothing to do.
+        }
+        
+        void retain() {
+            ++count_;
+        }
+        
+        /**
+         * Returns @c true if the last reference has been released.
+         */
+        bool release() {
+            return 0 == --count_;
+        }
+        
+        size_type value() const {
+            return count_;
+        }
+        
+    private:
+        size_type count_;
+    }; // class PlainReferenceCount
+    
+    
+    
+    /**
+     * Base class of objects managed by @c IntrusivePointer. The reference
+     * count is part of the object, so sharing needs a single allocation
+     * and a pointer can be made from the raw pointer again at any time.
+     *
+     * @a ReferenceCount is @c AtomicReferenceCount for objects shared 
+     * between threads, or @c PlainReferenceCount for objects that stay
+     * inside one thread and shouldn't pay for atomic operations.
+     *
+     * Copies start unshared, assignment leaves the count alone.
+     */
+    template< typename ReferenceCount = AtomicReferenceCount >
+    class ReferenceCounted {
+    public:
+        typedef size_t size_type;
+        
+        size_type useCount() const {
+            return referenceCount_.value();
+        }
+        
+    protected:
+        ReferenceCounted() : referenceCount_() {
+            // Nothing to do.
+        }
+        
+        ReferenceCounted( ReferenceCounted const& ) : referenceCount_() {
+            // Nothing to do.
+        }
+        
+        ReferenceCounted& operator=( ReferenceCounted const& ) {
+            return *this;
+        }
+        
+        /**
+         * Not virtual, @c IntrusivePointer deletes the type it points to.
+         */
+        ~ReferenceCounted() {
+            // Nothing to do.
+        }
+        
+    private:
+        template< typename T > friend class IntrusivePointer;
+        
+        mutable ReferenceCount referenceCount_;
+    }; // class ReferenceCounted
+    
+    
+    
+    /**
+     * Smart pointer to instances of classes derived from @c ReferenceCounted.
+     * Unlike @c SharedPointer no separate reference count is allocated, an
+     * empty pointer allocates nothing at all, and objects derived from
+     * @c ReferenceCounted with an @c AtomicReferenceCount can be shared 
+     * between threads: different threads may copy and destroy their own
+     * pointers to the same object concurrently. A single pointer instance
+     * isn't thread safe, just like @c SharedPointer.
+     *
+     * Follows the interface of @c SharedPointer, see http://Boost.org
+     * intrusive_ptr 
+     * ( http://www.boost.org/libs/smart_ptr/intrusive_ptr.html ).
+     *
+     * @attention Beware of cycles of smart pointers as these will lead to 
+     * memory leaks.
+     */
+    template< typename T >
+    class IntrusivePointer {
+    public:
+        typedef size_t size_type;
+        typedef T value_type;
+        typedef value_type& reference;
+        typedef value_type const& const_reference;
+        typedef value_type* pointer;
+        typedef value_type const* const_pointer;
+        
+        template< typename U > friend class IntrusivePointer;
+        
+        
+        /**
+         * Constructs an empty @c IntrusivePointer.
+         *
+         * @post <code>get() == 0</code>
+         *
+         * @throw Nothing.
+         */
+        IntrusivePointer() : data_( 0 ) {
+            // Nothing to do.
+        }
+        
+        /**
+         * Constructs an @c IntrusivePointer that shares the ownership of
+         * @a _data with all other pointers to it.
+         *
+         * @post <code>get() == _data</code>
+         *
+         * @throw Nothing.
+         */
+        explicit IntrusivePointer( T* _data ) : data_( _data ) {
+            retain();
+        }
+        
+        /**
+         * Constructs an @c IntrusivePointer that shares ownership with 
+         * @a other.
+         *
+         * @post <code>get() == other.get()</code> and 
+         *       <code>useCount() == other.useCount()</code>
+         *
+         * @throw Nothing.
+         */
+        IntrusivePointer( IntrusivePointer const& other ) : data_( other.data_ ) {
+            retain();
+        }
+        
+        /**
+         * Constructs an @c IntrusivePointer that shares ownership with 
+         * @a other. A pointer of type @c U must be assignable to a pointer 
+         * of type @c T.
+         *
+         * @throw Nothing. 
+         */
+        template< typename U >
+        IntrusivePointer( IntrusivePointer< U > const& other ) : data_( other.data_ ) {
+            retain();
+        }
+        
+        /**
+         * Decreases the use count by one. If the use count hits @c 0 the 
+         * managed pointer is deleted.
+         */
+        ~IntrusivePointer() {
+            release();
+        }
+        
+        /**
+         * Shares the ownership of the pointer managed by @a other with 
+         * @a other. The old managed pointer is deleted if ownership 
+         * decreases to @c 0.
+         *
+         * @throw Nothing.
+         */
+        IntrusivePointer& operator=( IntrusivePointer other ) {
+            swap( other );
+            
+            return *this;
+        }
+        
+        /**
+         * Swaps the managed data and the ownership of it with @a other.
+         *
+         * @throw Nothing.
+         */
+        void swap( IntrusivePointer& other ) {
+            std::swap( data_, other.data_ );
+        }
+        
+        
+        reference operator*() const {
+            assert( 0 != data_ && "Unable to dereference a 0-pointer." );
+            return *data_;
+        }
+        
+        pointer operator->() const {
+            assert( 0 != data_ && "Unable to dereference a 0-pointer." );
+            return data_;
+        }
+        
+        /**
+         * Number of pointers sharing the managed object, @c 0 if empty.
+         */
+        size_type useCount() const {
+            return 0 == data_ ? 0 : data_->referenceCount_.value();
+        }
+        
+        /**
+         * Get direct control of the raw managed pointer.
+         *
+         * @attention Don't delete the pointer behind the back of the smart
+         *            pointer because this leads to undefined behavior.
+         */
+        pointer get() const {
+            return data_;
+        }
+        
+        /**
+         * Sets a new pointer to be managed by the smart pointer.
+         */
+        void reset( T* _data = 0 ) {
+            IntrusivePointer( _data ).swap( *this );
+        }
+        
+        
+        /**
+         * See http://Boost.org shared_ptr 
+         * ( http://www.boost.org/libs/smart_ptr/shared_ptr.htm ).
+         */
+        typedef T* (IntrusivePointer::*unspecified_bool_type)() const;
+        
+        /**
+         * Automatic cast operator to enable use of a smart pointer inside a
+         * conditional, for example to test if the smart pointer manages a 
+         * @c 0 pointer.
+         */
+        operator unspecified_bool_type () const {
+            return 0 == data_ ? 0 : &IntrusivePointer::get;
+        }
+        
+        
+        template< typename U >
+            bool operator<( IntrusivePointer< U > const& rhs ) const {
+                return data_ < rhs.data_;
+            }
+        
+        
+    private:
+        
+        void release() {
+            if ( 0 != data_ && data_->referenceCount_.release() ) {
+                delete data_;
+            }
+        }
+        
+        void retain() {
+            if ( 0 != data_ ) {
+                data_->referenceCount_.retain();
+            }
+        }
+        
+        
+    private:
+        pointer data_;
+    }; // class IntrusivePointer
+    
+    
+    
+    
+    template< typename T, typename U >
+        bool operator==( IntrusivePointer< T > const& lhs, IntrusivePointer< U > const& rhs ) {
+            return lhs.get() == rhs.get();
+        }
+    
+    template< typename T, typename U >
+        bool operator!=( IntrusivePointer< T > const& lhs, IntrusivePointer< U > const& rhs ) {
+            return !( lhs == rhs );
+        }
+    
+    
+    template< typename T >
+        void swap( IntrusivePointer< T >& lhs, IntrusivePointer< T >& rhs ) {
+            lhs.swap( rhs );
+        }
+    
+    
+} // namespace OpenSteer
+
+
+
+#endif // OPENSTEER_INTRUSIVEPOINTER_H
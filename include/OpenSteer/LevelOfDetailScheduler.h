@@ -0,0 +1,186 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Level of detail scheduling of vehicle updates.
+ *
+ * Important vehicles are updated every frame, less important ones every 
+ * 2nd, 4th, ... frame with the accumulated elapsed time. Importance is 
+ * provided by a pluggable metric, for example the distance to an observer.
+ */
+#ifndef OPENSTEER_LEVELOFDETAILSCHEDULER_H
+#define OPENSTEER_LEVELOFDETAILSCHEDULER_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Rates how important it is to simulate a vehicle at full detail.
+     */
+    class AbstractImportanceMetric {
+    public:
+        virtual ~AbstractImportanceMetric() {}
+        
+        /**
+         * Returns the importance of @a vehicle in the range @c 0 (least 
+         * important) to @c 1 (update every frame).
+         *
+         * Called from @c LevelOfDetailScheduler::update, must be thread safe
+         * if the scheduler is used from several threads.
+         */
+        virtual float importance( AbstractVehicle const& vehicle ) const = 0;
+    }; // class AbstractImportanceMetric
+    
+    
+    /**
+     * Importance falls off with the distance to an observer (typically the 
+     * camera): @c 1 within @c fullDetailDistance, then 
+     * <code>fullDetailDistance / distance</code>.
+     */
+    class ObserverDistanceImportanceMetric : public AbstractImportanceMetric {
+    public:
+        explicit ObserverDistanceImportanceMetric( float fullDetailDistance = 10.0f );
+        virtual ~ObserverDistanceImportanceMetric();
+        
+        void setObserverPosition( Vec3 const& position );
+        Vec3 const& observerPosition() const;
+        
+        void setFullDetailDistance( float distance );
+        float fullDetailDistance() const;
+        
+        virtual float importance( AbstractVehicle const& vehicle ) const;
+        
+    private:
+        Vec3 observerPosition_;
+        float fullDetailDistance_;
+    }; // class ObserverDistanceImportanceMetric
+    
+    
+    /**
+     * Replaces the plain "update every vehicle" loop of a plugin.
+     *
+     * A vehicle on level @c l is updated every <code>2^l</code> frames and
+     * gets the summed elapsed time of the skipped frames as its 
+     * @c elapsedTime. Updates of vehicles on the same level are staggered
+     * over the frames so the work per frame stays even. The level of a 
+     * vehicle is reassigned from its importance after each of its updates:
+     * it's placed on the first level whose threshold its importance reaches.
+     *
+     * Skipped vehicles don't move, so their proximity database tokens stay
+     * valid. Vehicles update their tokens in their own @c update as usual.
+     *
+     * Vehicles are identified by their index in the group passed to 
+     * @c update. Adding or removing vehicles at the end of the group is
+     * fine. After reordering the group call @c reset.
+     */
+    class LevelOfDetailScheduler {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Creates a scheduler with @a levelCount levels. The default 
+         * threshold of level @c l is <code>0.5^(l+1)</code>, the last level
+         * takes all remaining vehicles.
+         */
+        explicit LevelOfDetailScheduler( size_type levelCount = 4 );
+        
+        /**
+         * Sets the metric rating vehicle importance. The metric isn't owned.
+         * Without a metric (@c 0) all vehicles are updated every frame.
+         */
+        void setImportanceMetric( AbstractImportanceMetric const* metric );
+        AbstractImportanceMetric const* importanceMetric() const;
+        
+        size_type levelCount() const;
+        
+        /**
+         * Vehicles with an importance of at least @a minImportance (and
+         * less than the threshold of all lower levels) are placed on
+         * @a level.
+         */
+        void setThreshold( size_type level, float minImportance );
+        float threshold( size_type level ) const;
+        
+        /**
+         * Updates all vehicles of @a vehicles which are due in this frame.
+         */
+        void update( AVGroup const& vehicles, float currentTime, float elapsedTime );
+        
+        /**
+         * Forgets all per vehicle state, all vehicles are updated during the
+         * next frame.
+         */
+        void reset();
+        
+        /**
+         * Number of vehicles updated during the last call of @c update.
+         */
+        size_type updatedVehicleCount() const;
+        
+        /**
+         * Number of vehicles currently on @a level.
+         */
+        size_type vehicleCountOnLevel( size_type level ) const;
+        
+    private:
+        struct VehicleState {
+            VehicleState() : accumulatedTime( 0.0f ), level( 0 ) {}
+            
+            float accumulatedTime;
+            size_type level;
+        };
+        
+        size_type levelForImportance( float importance ) const;
+        
+    private:
+        AbstractImportanceMetric const* metric_;
+        std::vector< float > thresholds_;
+        std::vector< VehicleState > states_;
+        std::vector< size_type > levelPopulation_;
+        size_type updatedVehicleCount_;
+        size_type frame_;
+    }; // class LevelOfDetailScheduler
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_LEVELOFDETAILSCHEDULER_H
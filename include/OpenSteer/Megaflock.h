@@ -0,0 +1,194 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Boids at very large scale ("megaflock").
+ *
+ * The state of all boids is kept as structure of arrays in one block of
+ * memory allocated for the whole flock instead of one heap allocated
+ * vehicle and proximity token per boid. Neighbors are found with a uniform
+ * grid rebuilt by a counting sort each update, which also copies positions
+ * and headings into cell order so that neighbor scans read contiguous
+ * memory. Steering and integration run in parallel if OpenMP is enabled.
+ *
+ * The flocking behaviors are those of @c SteerLibraryMixin
+ * (@c steerForSeparation, @c steerForAlignment, @c steerForCohesion),
+ * integration follows @c SimpleVehicle::applySteeringForce without the
+ * adjustment of backward steering at low speed and without banking.
+ */
+#ifndef OPENSTEER_MEGAFLOCK_H
+#define OPENSTEER_MEGAFLOCK_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * A flock of boids stored as structure of arrays. Boids are identified
+     * by their index, which stays the same while the flock isn't cleared.
+     *
+     * @c update isn't reentrant, all other const member functions are thread
+     * safe.
+     */
+    class Megaflock {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Flocking behaviors (radius, cosine of the maximum angle off the
+         * forward axis, weight) and vehicle properties shared by all boids.
+         */
+        struct Parameters {
+            Parameters();
+            
+            float separationRadius;
+            float separationAngle;
+            float separationWeight;
+            
+            float alignmentRadius;
+            float alignmentAngle;
+            float alignmentWeight;
+            
+            float cohesionRadius;
+            float cohesionAngle;
+            float cohesionWeight;
+            
+            float maxSpeed;
+            float maxForce;
+            /// Boids closer than three radii are neighbors at any angle.
+            float radius;
+            /// Boids leaving this sphere around the origin wrap around.
+            float worldRadius;
+        };
+        
+        
+        explicit Megaflock( Parameters const& parameters = Parameters() );
+        
+        void setParameters( Parameters const& parameters );
+        Parameters const& parameters() const;
+        
+        /**
+         * Allocates memory for @a count boids in one block.
+         */
+        void reserve( size_type count );
+        
+        /**
+         * Adds @a count boids at random positions inside the sphere of 
+         * radius @a spawnRadius around the origin heading in random 
+         * directions at 30% of @c maxSpeed. Grows the storage at most once.
+         */
+        void spawn( size_type count, float spawnRadius );
+        
+        /**
+         * Adds one boid, returns its index.
+         */
+        size_type add( Vec3 const& position, Vec3 const& forward, float speed );
+        
+        /**
+         * Removes all boids, keeps the storage.
+         */
+        void clear();
+        
+        size_type size() const;
+        
+        Vec3 position( size_type index ) const;
+        Vec3 forward( size_type index ) const;
+        float speed( size_type index ) const;
+        
+        /**
+         * Moves all boids ahead by @a elapsedTime seconds.
+         */
+        void update( float elapsedTime );
+        
+        /**
+         * Number of neighbors (other boids within the largest behavior 
+         * radius) of all boids summed up during the last @c update.
+         */
+        size_type neighborCount() const;
+        
+        /**
+         * Number of cells of the neighbor grid of the last @c update.
+         */
+        size_type cellCount() const;
+        
+    private:
+        
+        // The per boid arrays carved out of storage_.
+        enum Field {
+            positionX, positionY, positionZ,
+            forwardX, forwardY, forwardZ,
+            speedField,
+            accelerationX, accelerationY, accelerationZ,
+            steeringX, steeringY, steeringZ,
+            // positions and headings in cell order
+            cellPositionX, cellPositionY, cellPositionZ,
+            cellForwardX, cellForwardY, cellForwardZ,
+            fieldCount
+        };
+        
+        // Start of the array of @a field, @c 0 while no storage is reserved.
+        float* field( Field field );
+        float const* field( Field field ) const;
+        
+        void buildGrid();
+        size_type cellCoordinate( float x ) const;
+        size_type steer( size_type index );
+        void integrate( size_type index, float elapsedTime );
+        
+    private:
+        Parameters parameters_;
+        size_type size_;
+        size_type capacity_;
+        std::vector< float > storage_;
+        
+        // neighbor grid: cubic cells covering the world sphere's bounding
+        // box, boids sorted by cell
+        size_type cellsPerSide_;
+        float cellSize_;
+        std::vector< unsigned int > cellOfBoid_;
+        std::vector< unsigned int > cellStart_;
+        std::vector< unsigned int > cellFill_;
+        std::vector< unsigned int > boidInCellOrder_;
+        
+        size_type neighborCount_;
+    }; // class Megaflock
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_MEGAFLOCK_H
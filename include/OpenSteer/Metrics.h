@@ -0,0 +1,310 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Registry of performance metrics of a running simulation -- counters,
+ * gauges and histograms -- and their export in the Prometheus text 
+ * format (version 0.0.4).
+ *
+ * Simulation threads update metrics with atomic operations only, without
+ * locks or allocations. Registering metrics and writing them out take a
+ * spin lock, so metrics should be registered when a simulation is opened
+ * rather than while it runs. Histograms observed many times per frame
+ * are best filled through a @c Histogram::Batch, which collects the
+ * observations of one thread without atomic operations and adds them to
+ * the histogram at once.
+ *
+ * Metrics have no labels, the registry holds one value per name.
+ */
+#ifndef OPENSTEER_METRICS_H
+#define OPENSTEER_METRICS_H
+
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include uint64_t
+#include <stdint.h>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * A double which is read and updated atomically.
+     */
+    class AtomicDouble {
+    public:
+        explicit AtomicDouble( double value = 0.0 );
+        
+        double load() const;
+        void store( double value );
+        void add( double amount );
+        
+    private:
+        AtomicDouble( AtomicDouble const& );
+        AtomicDouble& operator=( AtomicDouble const& );
+        
+        mutable uint64_t volatile bits_;
+    }; // class AtomicDouble
+    
+    
+    
+    /**
+     * A named value exported by a @c MetricsRegistry.
+     */
+    class Metric {
+    public:
+        enum Type { counterType, gaugeType, histogramType };
+        
+        virtual ~Metric();
+        
+        std::string const& name() const;
+        std::string const& help() const;
+        Type type() const;
+        
+        /**
+         * Writes the metric in the Prometheus text format: its @c HELP and 
+         * @c TYPE lines followed by its samples.
+         */
+        virtual void write( std::ostream& out ) const = 0;
+        
+        /**
+         * Returns if @a name is a valid Prometheus metric name: a letter, 
+         * @c _ or @c : followed by letters, digits, @c _ or @c :.
+         */
+        static bool validName( std::string const& name );
+        
+    protected:
+        Metric( std::string const& name, std::string const& help, Type type );
+        
+        void writeHeader( std::ostream& out ) const;
+        
+    private:
+        Metric( Metric const& );
+        Metric& operator=( Metric const& );
+        
+        std::string name_;
+        std::string help_;
+        Type type_;
+    }; // class Metric
+    
+    
+    
+    /**
+     * A total which only grows, like the number of frames simulated.
+     */
+    class Counter : public Metric {
+    public:
+        Counter( std::string const& name, std::string const& help );
+        
+        /**
+         * Adds @a amount, which must not be negative.
+         */
+        void increment( double amount = 1.0 );
+        double value() const;
+        
+        virtual void write( std::ostream& out ) const;
+        
+    private:
+        AtomicDouble value_;
+    }; // class Counter
+    
+    
+    
+    /**
+     * A current value, like the number of agents.
+     */
+    class Gauge : public Metric {
+    public:
+        Gauge( std::string const& name, std::string const& help );
+        
+        void set( double value );
+        void add( double amount );
+        double value() const;
+        
+        virtual void write( std::ostream& out ) const;
+        
+    private:
+        AtomicDouble value_;
+    }; // class Gauge
+    
+    
+    
+    /**
+     * Distribution of observed values, like frame times, counted in
+     * buckets by upper bound. A value falls into the first bucket whose
+     * upper bound it doesn't exceed, values above all bounds into an 
+     * implicit last bucket with the upper bound +Inf.
+     */
+    class Histogram : public Metric {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * @a upperBounds must be ascending.
+         */
+        Histogram( std::string const& name, 
+                   std::string const& help, 
+                   std::vector< double > const& upperBounds );
+        
+        void observe( double value );
+        
+        /**
+         * Number and sum of all observations.
+         */
+        size_type count() const;
+        double sum() const;
+        
+        std::vector< double > const& upperBounds() const;
+        
+        /**
+         * Number of observations in bucket @a index alone (not cumulative
+         * like the exported samples), the bucket with index 
+         * <code>upperBounds().size()</code> is the +Inf bucket.
+         */
+        size_type bucketCount( size_type index ) const;
+        
+        virtual void write( std::ostream& out ) const;
+        
+        
+        /**
+         * Observations of one thread collected without atomic operations,
+         * added to the histogram by @c flush, which isn't thread safe 
+         * itself but may run concurrently with the flushes of other 
+         * batches. Allocates only when constructed.
+         */
+        class Batch {
+        public:
+            explicit Batch( Histogram& histogram );
+            
+            /**
+             * Flushes remaining observations.
+             */
+            ~Batch();
+            
+            void observe( double value );
+            void flush();
+            
+        private:
+            Batch( Batch const& );
+            Batch& operator=( Batch const& );
+            
+            Histogram& histogram_;
+            std::vector< size_type > counts_;
+            double sum_;
+            bool empty_;
+        }; // class Batch
+        
+    private:
+        size_type bucketOf( double value ) const;
+        
+        std::vector< double > upperBounds_;
+        std::vector< size_type > counts_;
+        AtomicDouble sum_;
+    }; // class Histogram
+    
+    
+    
+    /**
+     * Owns metrics and writes them out in the order they were registered.
+     */
+    class MetricsRegistry {
+    public:
+        typedef size_t size_type;
+        
+        MetricsRegistry();
+        ~MetricsRegistry();
+        
+        /**
+         * The registry of the program, which @c OpenSteerDemo and the
+         * PlugIns register their metrics with.
+         */
+        static MetricsRegistry& global();
+        
+        /**
+         * Return the metric registered under @a name, registering it 
+         * first if there is none. @a name must be valid (see 
+         * @c Metric::validName) and mustn't be registered as a metric of 
+         * another type; in that case a metric which isn't exported is 
+         * returned (and assertions fail). A histogram which exists keeps 
+         * its buckets.
+         */
+        Counter& counter( std::string const& name, std::string const& help );
+        Gauge& gauge( std::string const& name, std::string const& help );
+        Histogram& histogram( std::string const& name, 
+                              std::string const& help, 
+                              std::vector< double > const& upperBounds );
+        
+        /**
+         * Number of metrics exported.
+         */
+        size_type size() const;
+        
+        /**
+         * Writes all metrics in the Prometheus text format.
+         */
+        void write( std::ostream& out ) const;
+        
+        /**
+         * Returns all metrics in the Prometheus text format.
+         */
+        std::string text() const;
+        
+    private:
+        MetricsRegistry( MetricsRegistry const& );
+        MetricsRegistry& operator=( MetricsRegistry const& );
+        
+        class Lock;
+        
+        // the exported metric named name or 0, called while locked
+        Metric* find( std::string const& name ) const;
+        
+        // takes ownership of a new metric, exported unless its name is 
+        // invalid or taken, called while locked
+        void add( Metric* metric );
+        
+    private:
+        std::vector< Metric* > metrics_;
+        std::vector< Metric* > unexported_;
+        mutable int volatile lock_;
+    }; // class MetricsRegistry
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_METRICS_H
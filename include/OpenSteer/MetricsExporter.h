@@ -0,0 +1,142 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Export of the metrics of a @c MetricsRegistry from a background thread,
+ * over HTTP for Prometheus to scrape and/or into a file.
+ */
+#ifndef OPENSTEER_METRICSEXPORTER_H
+#define OPENSTEER_METRICSEXPORTER_H
+
+
+// Include std::string
+#include <string>
+
+// Include OpenSteer::MetricsRegistry
+#include "OpenSteer/Metrics.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Exports the metrics of a registry from a background thread. It 
+     * answers HTTP GET requests for @c /metrics (or @c /) with all metrics
+     * in the Prometheus text format and/or writes them to a file at fixed
+     * intervals -- for the textfile collector of the node exporter, or as
+     * a fallback where the port can't be opened.
+     *
+     * Setting up (@c listen, @c dumpTo) and @c start, @c stop are meant 
+     * for one controlling thread. The background thread needs POSIX threads
+     * and sockets; where they aren't available @c listen and @c start fail
+     * and the application can call @c dump itself.
+     */
+    class MetricsExporter {
+    public:
+        explicit MetricsExporter( MetricsRegistry& registry = MetricsRegistry::global() );
+        
+        /**
+         * Stops the background thread and closes the socket.
+         */
+        ~MetricsExporter();
+        
+        /**
+         * Opens a TCP socket accepting connections on @a port of the 
+         * interface with the IPv4 @a address, port 0 picks a free port.
+         * Only local connections are accepted by default, "0.0.0.0" 
+         * accepts them on all interfaces.
+         */
+        bool listen( int port, std::string const& address = "127.0.0.1" );
+        
+        /**
+         * Port listened on, -1 if none.
+         */
+        int port() const;
+        
+        /**
+         * Makes the background thread write the metrics to @a fileName 
+         * every @a intervalSeconds and once more when it stops.
+         */
+        void dumpTo( std::string const& fileName, double intervalSeconds );
+        
+        /**
+         * Writes the metrics to the file given to @c dumpTo now, while the
+         * background thread isn't running. They are
+         * written to a temporary file which is then renamed, so readers
+         * never see a partial file.
+         */
+        bool dump();
+        
+        /**
+         * Starts the background thread, which needs a socket to serve or a
+         * file to write.
+         */
+        bool start();
+        
+        /**
+         * Stops the background thread, if running, after its last dump.
+         */
+        void stop();
+        
+        bool running() const;
+        
+        /**
+         * Why the last call which returned @c false failed.
+         */
+        std::string const& errorMessage() const;
+        
+    private:
+        MetricsExporter( MetricsExporter const& );
+        MetricsExporter& operator=( MetricsExporter const& );
+        
+        struct Thread;
+        
+        bool fail( std::string const& message );
+        bool writeFile( std::string& errorMessage ) const;
+        void closeSocket();
+        
+        // background thread: serve requests, dump periodically
+        static void* run( void* exporter );
+        void serve();
+        void answer( int connection ) const;
+        
+    private:
+        MetricsRegistry& registry_;
+        int socket_;
+        int port_;
+        std::string fileName_;
+        double interval_;
+        bool volatile stopping_;
+        Thread* thread_;
+        std::string errorMessage_;
+    }; // class MetricsExporter
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_METRICSEXPORTER_H
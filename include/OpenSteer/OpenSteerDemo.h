@@ -48,9 +48,12 @@
 
 
 
+#include <string>
+#include <vector>
 #include "OpenSteer/Clock.h"
 #include "OpenSteer/PlugIn.h"
 #include "OpenSteer/Camera.h"
+#include "OpenSteer/FrameBudget.h"
 #include "OpenSteer/Utilities.h"
 
 
@@ -71,6 +74,9 @@ namespace OpenSteer {
         // camera automatically tracks selected vehicle
         static Camera camera;
 
+        // frame budget lowers simulation fidelity while frames take too long
+        static FrameBudget frameBudget;
+
         // ------------------------------------------ addresses of selected objects
 
         // currently selected plug-in (user can choose or cycle through them)
@@ -95,6 +101,56 @@ namespace OpenSteer {
         static void errorExit (const char* message);
         static void exit (int exitCode);
 
+        // run the named PlugIn without graphics for frameCount updates of
+        // elapsedTime seconds each and print timing statistics, options are
+        // "name=value" strings passed on to PlugIn::setOption, returns the
+        // exit code for main.  Updates from steadyStateFrame on must not
+        // allocate, the run fails if they do.
+        static int runHeadless (const char* plugInName,
+                                const int frameCount,
+                                const float elapsedTime,
+                                const std::vector<std::string>& options,
+                                const int steadyStateFrame);
+
+        // run the named PlugIn headless twice, the random generator seeded
+        // alike, with options plus referenceOptions and then plus
+        // optimizedOptions (which must set the same names), and compare the
+        // states of all vehicles after each frame.  Prints the first frame whose states aren't bitwise
+        // identical (see SimulationHash) and the first frame and vehicle
+        // deviating by more than the relative tolerance (see
+        // GoldenTrajectory), returns EXIT_FAILURE if there is one.
+        static int runComparison (const char* plugInName,
+                                  const int frameCount,
+                                  const float elapsedTime,
+                                  const std::vector<std::string>& options,
+                                  const std::vector<std::string>& referenceOptions,
+                                  const std::vector<std::string>& optimizedOptions,
+                                  const float tolerance,
+                                  const unsigned int seed);
+
+        // run many independent worlds of the named PlugIn (see
+        // PlugIn::makeWorld) concurrently and print timing and the PlugIn's
+        // statistics for each.  Every "name=v1,v2,..." sweep multiplies the
+        // worlds by its number of values, each combination is run
+        // replicaCount times, options are applied to all worlds.
+        static int runBatch (const char* plugInName,
+                             const int frameCount,
+                             const float elapsedTime,
+                             const std::vector<std::string>& options,
+                             const std::vector<std::string>& sweeps,
+                             const int replicaCount);
+
+        // run the scenarios of a performance baseline file (see
+        // PerformanceBaseline) headless, print their frame time percentiles
+        // and allocations per frame and compare them against the baseline,
+        // or, if recordFileName isn't NULL, write the scenarios with the
+        // measurements as a new baseline into that file.  repetitions
+        // overrides the file's if positive.  Returns EXIT_FAILURE on any
+        // regression or scenario without recorded metrics.
+        static int runRegression (const char* baselineFileName,
+                                  const int repetitions,
+                                  const char* recordFileName);
+
         // ------------------------------------------------------- PlugIn interface
 
         // select the default PlugIn
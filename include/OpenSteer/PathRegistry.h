@@ -0,0 +1,130 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Named, shared, immutable pathways.
+ *
+ * Plugins and crowds which walk the same path look it up by name instead 
+ * of building their own copy, so that the path and its acceleration
+ * structures are created and stored once however many users it has.
+ */
+#ifndef OPENSTEER_PATHREGISTRY_H
+#define OPENSTEER_PATHREGISTRY_H
+
+
+// Include std::map
+#include <map>
+
+// Include std::string
+#include <string>
+
+// Include OpenSteer::IndexedPathway
+#include "OpenSteer/IndexedPathway.h"
+
+// Include OpenSteer::SharedPointer
+#include "OpenSteer/SharedPointer.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Maps names to reference counted immutable pathways. A path stays
+     * registered while the registry holds it, @c removeUnused releases the
+     * paths nobody else refers to anymore.
+     *
+     * The registry isn't thread safe, acquire and release paths while
+     * opening and closing plugins or worlds. The paths themselves can be
+     * queried concurrently.
+     */
+    class PathRegistry {
+    public:
+        typedef size_t size_type;
+        typedef SharedPointer< IndexedPathway const > PathPointer;
+        
+        PathRegistry();
+        ~PathRegistry();
+        
+        /**
+         * Returns the path registered as @a name, or an empty pointer.
+         */
+        PathPointer find( std::string const& name ) const;
+        
+        /**
+         * Returns the path registered as @a name, creating and registering
+         * it from @a numOfPoints @a points, radius @a r and @a closeCycle
+         * if there is none. An existing path is only returned if it was
+         * made from the same data, otherwise the new path replaces it (its
+         * users keep the old one), for example after a scenario with the 
+         * same name was changed and reloaded.
+         */
+        PathPointer acquire( std::string const& name,
+                             IndexedPathway::size_type numOfPoints,
+                             Vec3 const points[],
+                             float r,
+                             bool closeCycle );
+        
+        /**
+         * Unregisters all paths only referred to by the registry and 
+         * returns how many were destroyed.
+         */
+        size_type removeUnused();
+        
+        /**
+         * Number of registered paths.
+         */
+        size_type size() const;
+        
+        /**
+         * The registry shared by all plugins.
+         */
+        static PathRegistry& shared();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathRegistry( PathRegistry const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathRegistry& operator=( PathRegistry const& );
+        
+    private:
+        typedef std::map< std::string, PathPointer > PathMap;
+        PathMap paths_;
+    }; // class PathRegistry
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PATHREGISTRY_H
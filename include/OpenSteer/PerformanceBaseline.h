@@ -0,0 +1,200 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Stored performance baseline of a fixed set of headless scenarios, the
+ * thresholds for calling a measurement a regression, and the text format
+ * the baseline is kept in. Metrics are only comparable on the machine that
+ * recorded them, so the committed scenarios have none and each machine
+ * records its own baseline.
+ *
+ * Each scenario names a PlugIn, the number of frames, the random seed and
+ * the options of the run, and the metrics recorded for it. All metrics
+ * are "lower is better" (frame time percentiles, allocations per frame),
+ * each has the median of the recorded repetitions and their spread (the
+ * scaled median absolute deviation). A measurement regresses if it exceeds
+ * <code>value * ( 1 + tolerance ) + spreadFactor * spread</code>.
+ * Options stay set on the PlugIn after its scenario, so scenarios of the
+ * same PlugIn should all set the options they vary. Writing the baseline
+ * drops comments.
+ *
+ * Text format, one keyword per line, values run to the end of the line
+ * and @c # starts a comment line:
+ *
+ * <pre>
+ * tolerance <relative slack>
+ * spreadFactor <number of spreads of slack>
+ * repetitions <runs per scenario>
+ * scenario <name>
+ * plugin <PlugIn name>
+ * frames <count>
+ * seed <random seed>
+ * option <name>=<value>
+ * metric <name> <value> <spread>
+ * end
+ * </pre>
+ */
+#ifndef OPENSTEER_PERFORMANCEBASELINE_H
+#define OPENSTEER_PERFORMANCEBASELINE_H
+
+
+// Include std::istream, std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Scenarios with their baseline metrics and the regression thresholds.
+     *
+     * Loading functions return @c false and describe the problem in 
+     * @c errorMessage if the input is malformed, the baseline is left 
+     * empty then.
+     */
+    class PerformanceBaseline {
+    public:
+        typedef size_t size_type;
+        
+        struct Metric {
+            std::string name;
+            double value;
+            double spread;
+        };
+        
+        struct Scenario {
+            std::string name;
+            std::string plugIn;
+            int frames;
+            unsigned int seed;
+            std::vector< std::string > options;
+            std::vector< Metric > metrics;
+        };
+        
+        /**
+         * Outcome of checking one measured metric against the baseline.
+         */
+        struct Check {
+            std::string name;
+            double baseline;
+            double measured;
+            /// Largest measurement that isn't a regression.
+            double limit;
+            bool regression;
+            /// Better than the baseline by as much as a regression would
+            /// be worse, a hint to record a new baseline.
+            bool improvement;
+        };
+        
+        PerformanceBaseline();
+        
+        /**
+         * Removes all scenarios and restores the default thresholds.
+         */
+        void clear();
+        
+        /**
+         * Relative slack of the limits, default @c 0.15.
+         */
+        double tolerance() const;
+        void setTolerance( double tolerance );
+        
+        /**
+         * Number of recorded spreads added to the limits, default @c 3.
+         */
+        double spreadFactor() const;
+        void setSpreadFactor( double factor );
+        
+        /**
+         * Runs of each scenario the metrics are the median of, default 
+         * @c 5.
+         */
+        int repetitions() const;
+        void setRepetitions( int repetitions );
+        
+        void addScenario( Scenario const& scenario );
+        std::vector< Scenario > const& scenarios() const;
+        
+        /**
+         * Replaces the metrics of scenario @a index, for recording a new
+         * baseline.
+         */
+        void setMetrics( size_type index, std::vector< Metric > const& metrics );
+        
+        /**
+         * Checks each @a measured metric against the metric of the same 
+         * name of scenario @a index. Metrics without baseline can't regress.
+         */
+        std::vector< Check > check( size_type index, 
+                                    std::vector< Metric > const& measured ) const;
+        
+        bool load( std::string const& fileName );
+        bool save( std::string const& fileName ) const;
+        
+        bool read( std::istream& in );
+        void write( std::ostream& out ) const;
+        
+        std::string const& errorMessage() const;
+        
+        /**
+         * Median and spread (median absolute deviation scaled to estimate
+         * the standard deviation of normally distributed values) of 
+         * @a values.
+         *
+         * @pre @a values isn't empty.
+         */
+        static Metric summarize( std::string const& name, 
+                                 std::vector< double > values );
+        
+    private:
+        /**
+         * Clears the baseline, stores @a message and returns @c false.
+         */
+        bool fail( std::string const& message );
+        
+    private:
+        double tolerance_;
+        double spreadFactor_;
+        int repetitions_;
+        std::vector< Scenario > scenarios_;
+        std::string errorMessage_;
+    }; // class PerformanceBaseline
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PERFORMANCEBASELINE_H
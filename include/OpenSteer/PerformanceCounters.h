@@ -0,0 +1,122 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Hardware performance counters (cycles, instructions, cache and branch
+ * misses) of the calling thread, read with @c perf_event_open on Linux.
+ *
+ * Counters the processor, the kernel or its settings 
+ * (@c /proc/sys/kernel/perf_event_paranoid) don't provide, for example in
+ * virtual machines, are reported unavailable and read as @c 0, on other
+ * platforms none is available. Kernel and hypervisor events are excluded.
+ */
+#ifndef OPENSTEER_PERFORMANCECOUNTERS_H
+#define OPENSTEER_PERFORMANCECOUNTERS_H
+
+
+// Include std::string
+#include <string>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * A group of hardware counters of the calling thread, counting from
+     * @c open until @c close.
+     *
+     * Counts are returned as @c double to be summed up and normalized 
+     * without overflow.
+     */
+    class PerformanceCounters {
+    public:
+        typedef size_t size_type;
+        
+        enum Counter {
+            cycles,
+            instructions,
+            l1dReadMisses,
+            lastLevelCacheMisses,
+            branchMisses,
+            counterCount
+        };
+        
+        struct Values {
+            double counts[ counterCount ];
+        };
+        
+        PerformanceCounters();
+        ~PerformanceCounters();
+        
+        /**
+         * Opens all counters available and starts counting. Returns 
+         * @c false and describes why in @c errorMessage if none is.
+         */
+        bool open();
+        void close();
+        
+        bool available( Counter counter ) const;
+        size_type availableCount() const;
+        
+        /**
+         * Counts since @c open, @c 0 for unavailable counters.
+         */
+        void read( Values& values ) const;
+        
+        std::string const& errorMessage() const;
+        
+        static char const* name( Counter counter );
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PerformanceCounters( PerformanceCounters const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PerformanceCounters& operator=( PerformanceCounters const& );
+        
+    private:
+        // file descriptor of the group leader, -1 if closed
+        int leader_;
+        int descriptors_[ counterCount ];
+        // position of each counter in the group, -1 if unavailable
+        int slots_[ counterCount ];
+        size_type availableCount_;
+        std::string errorMessage_;
+    }; // class PerformanceCounters
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PERFORMANCECOUNTERS_H
@@ -60,6 +60,10 @@ class FooPlugIn : public PlugIn
     bool requestInitialSelection (void) {return true;}
     void handleFunctionKeys (int keyNumber) {...} // fkeys reserved for PlugIns
     void printMiniHelpForFunctionKeys (void) {...} // if fkeys are used
+    bool setOption (const char* name, const char* value) {...} // headless
+    void printStatistics (std::ostream& os) {...} // headless
+    bool passedChecks (std::ostream& os) {...} // headless
+    AbstractWorld* makeWorld (void) {...} // batch runs, see AbstractWorld
 };
 
 FooPlugIn gFooPlugIn;
@@ -73,6 +77,7 @@ FooPlugIn gFooPlugIn;
 #define OPENSTEER_PLUGIN_H
 
 #include <iostream>
+#include <string>
 #include "OpenSteer/AbstractVehicle.h"
 
 
@@ -81,6 +86,37 @@ FooPlugIn gFooPlugIn;
 
 namespace OpenSteer {
 
+    // A self-contained instance of a PlugIn's simulation.  A PlugIn which
+    // keeps all of its state in such a world (instead of globals and
+    // class statics) can hand out any number of them, so that many
+    // independent runs -- for example the points of a parameter sweep --
+    // can be updated side by side on several threads.  Worlds are opened
+    // and closed one at a time, their update must not touch OpenSteerDemo
+    // (camera, selected vehicle) nor shared state of other worlds.
+
+    class AbstractWorld
+    {
+    public:
+
+        virtual ~AbstractWorld() { /* Nothing to do. */ }
+
+        // set an option given by name and value as text before the world
+        // is opened, returns false if the option is not known
+        virtual bool setOption (const char* name, const char* value) = 0;
+
+        // create, step and destroy the simulation
+        virtual void open (void) = 0;
+        virtual void update (const float currentTime, const float elapsedTime) = 0;
+        virtual void close (void) = 0;
+
+        // print statistics (metrics of the run) after the last update
+        virtual void printStatistics (std::ostream& os) = 0;
+
+        // all vehicles of this world
+        virtual const AVGroup& allVehicles (void) = 0;
+    };
+
+
     class AbstractPlugIn
     {
     public:
@@ -111,6 +147,25 @@ namespace OpenSteer {
         // print "mini help" documenting function keys handled by this PlugIn
         virtual void printMiniHelpForFunctionKeys (void) = 0;
 
+        // set a PlugIn specific option given by name and value as text (for
+        // example a population size for a headless run) before the PlugIn is
+        // opened, returns false if the PlugIn does not know the option
+        virtual bool setOption (const char* name, const char* value) = 0;
+
+        // print PlugIn specific statistics (for example how often the goal
+        // was reached) at the end of a headless run
+        virtual void printStatistics (std::ostream& os) = 0;
+
+        // runs the checks of the PlugIn at the end of a headless run (for
+        // example a comparison with a golden trajectory), reports them to
+        // the given stream and returns false if one failed, which makes the
+        // run exit with a failure
+        virtual bool passedChecks (std::ostream& os) = 0;
+
+        // return a new, unopened world owned by the caller for batch runs,
+        // or NULL if the PlugIn can only run its one demo instance
+        virtual AbstractWorld* makeWorld (void) = 0;
+
         // return an AVGroup (an STL vector of AbstractVehicle pointers) of
         // all vehicles(/agents/characters) defined by the PlugIn
         virtual const AVGroup& allVehicles (void) = 0;
@@ -148,6 +203,19 @@ namespace OpenSteer {
         // default "mini help": print nothing
         void printMiniHelpForFunctionKeys (void) {}
 
+        // default option handler: no options are known
+        // (parameter names commented out to prevent compiler warning from "-W")
+        bool setOption (const char* /*name*/, const char* /*value*/) {return false;}
+
+        // default statistics: print nothing
+        void printStatistics (std::ostream& /*os*/) {}
+
+        // default is to have no checks to fail
+        bool passedChecks (std::ostream& /*os*/) {return true;}
+
+        // default is to not support batch runs
+        AbstractWorld* makeWorld (void) {return NULL;}
+
         // returns pointer to the next PlugIn in "selection order"
         PlugIn* next (void);
 
@@ -172,16 +240,23 @@ namespace OpenSteer {
         // returns pointer to default PlugIn (currently, first in registry)
         static PlugIn* findDefault (void);
 
+        // number of PlugIns in the class registry
+        static int count (void);
+
+        // load a shared library (.so, .dylib or .dll) built against
+        // OpenSteer whose static PlugIn instances register themselves like
+        // the built in ones.  Libraries stay loaded until exit.  Returns
+        // false and describes the problem in errorMessage if it fails.
+        static bool loadLibrary (const char* fileName,
+                                 std::string& errorMessage);
+
     private:
 
         // save this instance in the class's registry of instances
         void addToRegistry (void);
 
-        // This array stores a list of all PlugIns.  It is manipulated by the
-        // constructor and destructor, and used in findByName and applyToAll.
-        static const int totalSizeOfRegistry;
-        static int itemsInRegistry;
-        static PlugIn* registry[];
+        // remove this instance from the registry (in the destructor)
+        void removeFromRegistry (void);
     };
 
 } // namespace OpenSteer    
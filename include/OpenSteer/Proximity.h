@@ -47,6 +47,8 @@
 #include <vector>
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/lq.h"   // XXX temp?
+#include "OpenSteer/ZoneProfiler.h"
+#include "OpenSteer/FlightRecorder.h"
 
 
 namespace OpenSteer {
@@ -165,6 +167,9 @@ namespace OpenSteer {
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
+                ZoneProfiler::Scope zone (ZoneProfiler::proximity);
+                const size_t found = results.size();
+
                 // loop over all tokens
                 const float r2 = radius * radius;
                 for (tokenIterator i = bfpd->group.begin();
@@ -177,6 +182,7 @@ namespace OpenSteer {
                     // push onto result vector when within given radius
                     if (d2 < r2) results.push_back ((**i).object);
                 }
+                FlightRecorder::addNeighbors (results.size() - found);
             }
 
         private:
@@ -208,6 +214,19 @@ namespace OpenSteer {
 
     // ----------------------------------------------------------------------------
     // A AbstractProximityDatabase-style wrapper for the LQ bin lattice system
+    //
+    // With adaptive resolution on (setAdaptiveResolution) the database
+    // measures the cost of queries as the number of candidates -- objects
+    // tested against the search sphere -- per query.  After every few
+    // frames (a frame being one position update per token) it compares
+    // their average with a target, and if it strays further than the
+    // hysteresis allows, scales the subdivision of the axes which are
+    // subdivided: candidates grow with the volume of a bin.  Bins are kept
+    // at least as large as the largest query radius, past that point finer
+    // bins only add empty bins to visit.  The new subdivision is applied
+    // with lqResizeDatabase, which moves objects to the new bins over the
+    // following updates rather than at once, and measuring starts again
+    // when the move is complete.
 
 
     template <class ContentType>
@@ -228,6 +247,13 @@ namespace OpenSteer {
                                    (int) round (divisions.x),
                                    (int) round (divisions.y),
                                    (int) round (divisions.z));
+            size = dimensions;
+            tokenCount = 0;
+            targetCandidates = 0;
+            hysteresis = 0;
+            resolutionChanges = 0;
+            averageCandidates = 0;
+            resetMeasurement ();
         }
 
         // destructor
@@ -244,6 +270,11 @@ namespace OpenSteer {
 
             // constructor
             tokenType (ContentType parentObject, LQProximityDatabase& lqsd)
+                : database (&lqsd),
+                  queries (0),
+                  candidates (0),
+                  maxRadius (0),
+                  placed (false)
             {
                 lqInitClientProxy (&proxy, parentObject);
                 lq = lqsd.lq;
@@ -253,24 +284,46 @@ namespace OpenSteer {
             virtual ~tokenType (void)
             {
                 lqRemoveFromBin (&proxy);
+                if (placed) database->tokenCount--;
             }
 
             // the client object calls this each time its position changes
+            // (updates are serial, so this is where the query costs this
+            // token counted since its last update go to the database; the
+            // first update places the token in a bin, which makes it one
+            // of the tokens the database waits for before adapting)
             void updateForNewPosition (const Vec3& p)
             {
                 lqUpdateForNewLocation (lq, &proxy, p.x, p.y, p.z);
+                if (! placed)
+                {
+                    placed = true;
+                    database->tokenCount++;
+                }
+                database->recordQueries (queries, candidates, maxRadius);
+                queries = candidates = 0;
+                maxRadius = 0;
             }
 
             // find all neighbors within the given sphere (as center and radius)
+            // (queries may run in parallel, each token counts its own)
             void findNeighbors (const Vec3& center,
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
-                lqMapOverAllObjectsInLocality (lq, 
-                                               center.x, center.y, center.z,
-                                               radius,
-                                               perNeighborCallBackFunction,
-                                               (void*)&results);
+                ZoneProfiler::Scope zone (ZoneProfiler::proximity);
+                const size_t found = results.size();
+                candidates +=
+                    lqMapOverAllObjectsInLocalityCounted (lq, 
+                                                          center.x,
+                                                          center.y,
+                                                          center.z,
+                                                          radius,
+                                                          perNeighborCallBackFunction,
+                                                          (void*)&results);
+                queries++;
+                if (maxRadius < radius) maxRadius = radius;
+                FlightRecorder::addNeighbors (results.size() - found);
             }
 
             // called by LQ for each clientObject in the specified neighborhood:
@@ -298,6 +351,11 @@ namespace OpenSteer {
         private:
             lqClientProxy proxy;
             lqDB* lq;
+            LQProximityDatabase* database;
+            size_t queries;
+            size_t candidates;
+            float maxRadius;
+            bool placed;
         };
 
 
@@ -324,8 +382,154 @@ namespace OpenSteer {
             counter++;
         }
 
+        // turn adaptive resolution on: keep the average number of
+        // candidates per query within a factor of (1 + hysteresis) of
+        // targetCandidates.  A target of zero turns it off again.
+        void setAdaptiveResolution (const float target,
+                                    const float allowedDeviation = 0.3f)
+        {
+            targetCandidates = target;
+            hysteresis = allowedDeviation;
+            resetMeasurement ();
+        }
+
+        bool adaptiveResolution (void) const {return targetCandidates > 0;}
+
+        // current number of subdivisions along each axis
+        Vec3 getDivisions (void)
+        {
+            int x, y, z;
+            lqGetDivisions (lq, &x, &y, &z);
+            return Vec3 ((float) x, (float) y, (float) z);
+        }
+
+        // true while objects move to the bins of a new resolution
+        bool resizeInProgress (void) {return lqResizeInProgress (lq) != 0;}
+
+        // average candidates per query of the last measurement, and the
+        // number of changes of resolution made so far (adaptive only)
+        float getAverageCandidates (void) const {return averageCandidates;}
+        int getResolutionChanges (void) const {return resolutionChanges;}
+
+#ifndef NO_LQ_BIN_STATS
+        // statistics about bin populations: min, max and average of
+        // non-empty bins (completes a resize in progress)
+        void getBinPopulationStats (int& min, int& max, float& average)
+        {
+            lqGetBinPopulationStats (lq, &min, &max, &average);
+        }
+
+        // histogram of bin populations: histogram[i] is the number of bins
+        // holding i objects, the last entry counts the bins holding that
+        // many or more
+        void getBinPopulationHistogram (std::vector<int>& histogram)
+        {
+            if (! histogram.empty ())
+                lqGetBinPopulationHistogram (lq,
+                                             &histogram[0],
+                                             (int) histogram.size());
+        }
+#endif // NO_LQ_BIN_STATS
 
     private:
+
+        // frames measured before deciding on the resolution, and limits
+        // for the resolution along any axis and in total
+        enum {measuredFrames = 4, maxDivisions = 256, maxBinCount = 1 << 20};
+
+        void resetMeasurement (void)
+        {
+            measuredUpdates = 0;
+            measuredQueries = 0;
+            measuredCandidates = 0;
+            measuredRadius = 0;
+        }
+
+        // called by tokens on each position update
+        void recordQueries (const size_t queries,
+                            const size_t candidates,
+                            const float radius)
+        {
+            if (! adaptiveResolution ()) return;
+
+            measuredQueries += queries;
+            measuredCandidates += candidates;
+            if (measuredRadius < radius) measuredRadius = radius;
+
+            if (++measuredUpdates >= measuredFrames * tokenCount)
+                adaptResolution ();
+        }
+
+        void adaptResolution (void)
+        {
+            // measure only queries on a settled subdivision
+            if (lqResizeInProgress (lq) || (measuredQueries == 0))
+            {
+                resetMeasurement ();
+                return;
+            }
+
+            averageCandidates = ((float) measuredCandidates) / measuredQueries;
+            const float ratio = averageCandidates / targetCandidates;
+            const float radius = measuredRadius;
+            resetMeasurement ();
+            if ((ratio <= 1 + hysteresis) && (ratio * (1 + hysteresis) >= 1))
+                return;
+
+            // scale the subdivided axes (all if none is) by the root of
+            // the ratio, at most by a factor of two at once
+            int div[3];
+            lqGetDivisions (lq, &div[0], &div[1], &div[2]);
+            const float extent[3] = {size.x, size.y, size.z};
+            int scaledAxes = 0;
+            for (int i = 0; i < 3; i++) if (div[i] > 1) scaledAxes++;
+            const bool scaleAll = (scaledAxes == 0);
+            if (scaleAll) scaledAxes = 3;
+            const float factor =
+                clip (std::pow (ratio, 1.0f / scaledAxes), 0.5f, 2.0f);
+
+            int newDiv[3];
+            int binCount = 1;
+            for (int i = 0; i < 3; i++)
+            {
+                newDiv[i] = div[i];
+                if (scaleAll || (div[i] > 1))
+                {
+                    // no bins smaller than the largest query radius
+                    int limit = maxDivisions;
+                    if (radius > 0)
+                        limit = std::min (limit,
+                                          std::max (1, (int) (extent[i] / radius)));
+                    const int scaled = (int) round (div[i] * factor);
+                    newDiv[i] = std::max (1, std::min (limit, scaled));
+                }
+                binCount *= newDiv[i];
+            }
+
+            if ((binCount > maxBinCount) ||
+                ((newDiv[0] == div[0]) &&
+                 (newDiv[1] == div[1]) &&
+                 (newDiv[2] == div[2])))
+                return;
+
+            lqResizeDatabase (lq, newDiv[0], newDiv[1], newDiv[2]);
+            resolutionChanges++;
+        }
+
+        Vec3 size;
+        int tokenCount; // tokens placed in a bin, query-only ones excluded
+
+        float targetCandidates;
+        float hysteresis;
+        int resolutionChanges;
+        float averageCandidates;
+
+        int measuredUpdates;
+        size_t measuredQueries;
+        size_t measuredCandidates;
+        float measuredRadius;
+
+
         lqDB* lq;
     };
 
@@ -0,0 +1,113 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Optimal reciprocal collision avoidance (ORCA) on the XZ plane.
+ *
+ * Each neighbor contributes a half-plane of permitted velocities. The new
+ * velocity is the one closest to a preferred velocity that lies inside all
+ * half-planes and inside the max speed circle. If no such velocity exists
+ * the one least violating the half-planes is chosen.
+ *
+ * See Jur van den Berg, Stephen J. Guy, Ming Lin, Dinesh Manocha, 
+ * Reciprocal n-body Collision Avoidance, International Symposium on 
+ * Robotics Research, 2009.
+ */
+#ifndef OPENSTEER_RECIPROCALVELOCITYOBSTACLE_H
+#define OPENSTEER_RECIPROCALVELOCITYOBSTACLE_H
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    /**
+     * Maximal number of half-planes handled by 
+     * @c solveOrcaLinearProgram. The solver works on fixed size arrays on
+     * the stack so it never allocates and can run in parallel for many 
+     * agents.
+     */
+    size_t const maxOrcaLineCount = 32;
+    
+    
+    /**
+     * Directed line on the XZ plane bounding a half-plane of permitted 
+     * velocities. Velocities to the left of @c direction (seen from above,
+     * x to the right, z up) are permitted.
+     *
+     * The @c y components are ignored.
+     */
+    struct OrcaLine {
+        Vec3 point;
+        Vec3 direction;
+    };
+    
+    
+    /**
+     * Returns the half-plane of velocities permitted for an agent with 
+     * @a velocity to avoid a neighbor during the next @a timeHorizon 
+     * seconds, taking half of the responsibility for the avoidance.
+     *
+     * @a relativePosition is the neighbor's position minus ours,
+     * @a relativeVelocity is our velocity minus the neighbor's. If the
+     * agents already overlap the line resolves the collision within
+     * @a timeStep seconds, or within @a timeHorizon seconds if 
+     * @a timeStep isn't positive (while the simulation is paused).
+     */
+    OrcaLine computeOrcaLine( Vec3 const& velocity,
+                              Vec3 const& relativePosition,
+                              Vec3 const& relativeVelocity,
+                              float combinedRadius,
+                              float timeHorizon,
+                              float timeStep );
+    
+    
+    /**
+     * Returns the velocity nearest to @a preferredVelocity which satisfies
+     * all @a lineCount half-planes in @a lines and is not faster than
+     * @a maxSpeed. If the constraints are infeasible the velocity minimizing
+     * the maximal penetration of the half-planes is returned.
+     *
+     * Allocation free. @a lineCount must not exceed @c maxOrcaLineCount.
+     *
+     * The @c y component of the result is @c 0.
+     */
+    Vec3 solveOrcaLinearProgram( OrcaLine const* lines,
+                                 size_t lineCount,
+                                 float maxSpeed,
+                                 Vec3 const& preferredVelocity );
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_RECIPROCALVELOCITYOBSTACLE_H
@@ -0,0 +1,260 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Plugin independent description of a scenario: parameters, obstacles,
+ * paths and populations, stored in a compact binary file or as text.
+ *
+ * A scenario is plain data kept in a few contiguous arrays. It is read
+ * and written in bulk and builds the simulation objects it describes
+ * with one allocation per kind of object, so that scenarios with
+ * hundreds of thousands of agents can be generated by programs and
+ * loaded in milliseconds.
+ *
+ * Text format, one record per keyword, names are single words and
+ * @c # starts a comment running to the end of the line:
+ *
+ * <pre>
+ * parameter <name> <value to the end of the line>
+ * sphere <center x y z> <radius>
+ * box <position x y z> <forward x y z> <side x y z> <up x y z> <width> <height> <depth>
+ * path <name> <radius> open|cyclic <point count> <x y z of each point>
+ * population <name> <agent count> <position x y z, forward x y z, speed of each agent>
+ * </pre>
+ *
+ * The binary format stores the same records grouped by kind in the
+ * native byte order: the magic bytes @c OSSB, the version, the number of
+ * records of each kind, then each kind's records with floats written as 
+ * arrays and strings prefixed by their length.
+ */
+#ifndef OPENSTEER_SCENARIO_H
+#define OPENSTEER_SCENARIO_H
+
+
+// Include std::istream, std::ostream
+#include <iosfwd>
+
+// Include std::string
+#include <string>
+
+// Include std::pair
+#include <utility>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::SphereObstacle, OpenSteer::BoxObstacle, OpenSteer::ObstacleGroup
+#include "OpenSteer/Obstacle.h"
+
+// Include OpenSteer::PathRegistry
+#include "OpenSteer/PathRegistry.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Parameters, obstacles, paths and populations of a scenario. Paths and
+     * populations are identified by their index and name, their points and
+     * agents are stored one after the other in one array each.
+     *
+     * Loading functions return @c false and describe the problem in 
+     * @c errorMessage if the input is malformed, the scenario is left empty 
+     * then.
+     */
+    class Scenario {
+    public:
+        typedef size_t size_type;
+        typedef std::pair< std::string, std::string > Parameter;
+        
+        enum Format { binary, text };
+        
+        struct Sphere {
+            Vec3 center;
+            float radius;
+        };
+        
+        struct Box {
+            Vec3 position;
+            Vec3 forward;
+            Vec3 side;
+            Vec3 up;
+            float width;
+            float height;
+            float depth;
+        };
+        
+        struct Path {
+            std::string name;
+            float radius;
+            bool cyclic;
+            size_type firstPoint;
+            size_type pointCount;
+        };
+        
+        struct Agent {
+            Vec3 position;
+            Vec3 forward;
+            float speed;
+        };
+        
+        struct Population {
+            std::string name;
+            size_type firstAgent;
+            size_type agentCount;
+        };
+        
+        /**
+         * Returned by the find functions if there is no such path or 
+         * population.
+         */
+        static size_type const npos;
+        
+        Scenario();
+        
+        /**
+         * Removes all records and the name.
+         */
+        void clear();
+        
+        /**
+         * Name of the scenario, the file name if it was loaded from a file.
+         * Paths are shared through a @c PathRegistry under this name.
+         */
+        std::string const& name() const;
+        void setName( std::string const& name );
+        
+        void addParameter( std::string const& name, std::string const& value );
+        void addSphere( Vec3 const& center, float radius );
+        void addBox( Box const& box );
+        
+        /**
+         * Adds a path with @a pointCount @a points and returns its index.
+         */
+        size_type addPath( std::string const& name,
+                           float radius,
+                           bool cyclic,
+                           size_type pointCount, 
+                           Vec3 const points[] );
+        
+        /**
+         * Adds a population of @a agentCount @a agents and returns its index.
+         */
+        size_type addPopulation( std::string const& name,
+                                 size_type agentCount,
+                                 Agent const agents[] );
+        
+        std::vector< Parameter > const& parameters() const;
+        std::vector< Sphere > const& spheres() const;
+        std::vector< Box > const& boxes() const;
+        std::vector< Path > const& paths() const;
+        std::vector< Population > const& populations() const;
+        
+        /**
+         * First of the @c pointCount points of @a path.
+         */
+        Vec3 const* pathPoints( Path const& path ) const;
+        
+        /**
+         * First of the @c agentCount agents of @a population.
+         */
+        Agent const* populationAgents( Population const& population ) const;
+        
+        /**
+         * Index of the path or population called @a name, or @c npos.
+         */
+        size_type findPath( std::string const& name ) const;
+        size_type findPopulation( std::string const& name ) const;
+        
+        /**
+         * Reads a scenario in the format detected from its first bytes.
+         * The scenario is named after @a fileName.
+         */
+        bool load( std::string const& fileName );
+        
+        /**
+         * Writes the scenario in @a format.
+         */
+        bool save( std::string const& fileName, Format format ) const;
+        
+        bool read( std::istream& in, Format format );
+        void write( std::ostream& out, Format format ) const;
+        
+        std::string const& errorMessage() const;
+        
+        /**
+         * Constructs the sphere and box obstacles into @a sphereObstacles 
+         * and @a boxObstacles (one allocation each) and appends pointers to
+         * them to @a obstacles. Earlier contents of the two vectors are
+         * replaced, pointers to them become invalid.
+         */
+        void buildObstacles( std::vector< SphereObstacle >& sphereObstacles,
+                             std::vector< BoxObstacle >& boxObstacles,
+                             ObstacleGroup& obstacles ) const;
+        
+        /**
+         * Returns path @a pathIndex as shared pathway of @a registry,
+         * creating it unless a scenario with the same name registered the
+         * same path before.
+         */
+        PathRegistry::PathPointer acquirePath( size_type pathIndex, 
+                                               PathRegistry& registry ) const;
+        
+    private:
+        bool readText( std::istream& in );
+        bool readBinary( std::istream& in );
+        void writeText( std::ostream& out ) const;
+        void writeBinary( std::ostream& out ) const;
+        
+        /**
+         * Clears the scenario, stores @a message and returns @c false.
+         */
+        bool fail( std::string const& message );
+        
+    private:
+        std::string name_;
+        std::vector< Parameter > parameters_;
+        std::vector< Sphere > spheres_;
+        std::vector< Box > boxes_;
+        std::vector< Path > paths_;
+        std::vector< Vec3 > pathPoints_;
+        std::vector< Population > populations_;
+        std::vector< Agent > agents_;
+        std::string errorMessage_;
+    }; // class Scenario
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SCENARIO_H
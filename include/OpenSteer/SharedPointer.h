@@ -71,6 +71,10 @@ namespace OpenSteer {
      *
      * Doesn't manage arrays.
      *
+     * The reference count is allocated separately and isn't thread safe.
+     * Objects shared between threads should derive from 
+     * @c ReferenceCounted and be managed by an @c IntrusivePointer.
+     *
      * Isn't designed to be used outside of OpenSteer. Boost library
      * smart pointers are preferable if a solid and platform agnostic 
      * implementation is needed. It should be quite easy to replace this smart
@@ -0,0 +1,83 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Digest of the states of vehicles for telling quickly whether two runs of
+ * a simulation are bitwise identical.
+ *
+ * The digest is the 32 bit FNV-1a hash of the bytes of the position, 
+ * forward, side and up vectors, the speed and the radius of each vehicle
+ * in group order. Negative zero is hashed as zero, so only states that 
+ * compare equal component by component digest alike. Differing digests 
+ * say nothing about how far states diverged, see @c GoldenTrajectory for
+ * comparing with a tolerance.
+ */
+#ifndef OPENSTEER_SIMULATIONHASH_H
+#define OPENSTEER_SIMULATIONHASH_H
+
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Accumulates the digest of the floats, vectors and vehicle states 
+     * added to it, in order.
+     */
+    class SimulationHash {
+    public:
+        typedef unsigned int digest_type;
+        
+        SimulationHash();
+        
+        void add( float value );
+        void add( Vec3 const& value );
+        void add( AbstractVehicle const& vehicle );
+        void add( AVGroup const& vehicles );
+        
+        digest_type value() const;
+        
+        /**
+         * Digest of the states of all @a vehicles.
+         */
+        static digest_type digest( AVGroup const& vehicles );
+        
+    private:
+        digest_type hash_;
+    }; // class SimulationHash
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SIMULATIONHASH_H
@@ -0,0 +1,216 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Puts vehicles that stopped moving to sleep and skips their updates until
+ * something wakes them.
+ */
+#ifndef OPENSTEER_SLEEPSCHEDULER_H
+#define OPENSTEER_SLEEPSCHEDULER_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::map
+#include <map>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Replaces the plain "update every vehicle" loop of a plugin and skips
+     * vehicles which are at rest, for example queued pedestrians or parked
+     * cars.
+     *
+     * A vehicle whose speed and change of velocity stay below their 
+     * thresholds for @c framesUntilSleep consecutive updates falls asleep:
+     * its speed is set to @c 0 and it isn't updated anymore. Sleeping 
+     * vehicles don't move so their proximity database tokens stay valid.
+     *
+     * Sleeping vehicles are kept in an own bin lattice. After each update of
+     * a moving vehicle all sleepers within @c wakeRadius of it are woken, so
+     * a moving vehicle wakes the resting ones it approaches, which in turn
+     * wake their neighbors once they start moving. External events wake
+     * vehicles via @c wake or @c wakeWithin. The cost of sleeping vehicles 
+     * is only paid when they fall asleep or wake up.
+     *
+     * Vehicles are identified by their index in the group passed to 
+     * @c update. Adding vehicles at the end of the group is fine. Call
+     * @c remove before removing a vehicle from the group, and @c reset 
+     * after reordering it.
+     */
+    class SleepScheduler {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * The bin lattice for sleeping vehicles covers the box around 
+         * @a center with @a dimensions, split into @a divisions bins, like
+         * @c LQProximityDatabase.
+         */
+        SleepScheduler( Vec3 const& center, 
+                        Vec3 const& dimensions, 
+                        Vec3 const& divisions );
+        ~SleepScheduler();
+        
+        /**
+         * Vehicles slower than @a speed may fall asleep.
+         */
+        void setSpeedThreshold( float speed );
+        float speedThreshold() const;
+        
+        /**
+         * Vehicles whose velocity changes faster than @a acceleration 
+         * (length of the velocity change per second) are steering and stay
+         * awake.
+         */
+        void setAccelerationThreshold( float acceleration );
+        float accelerationThreshold() const;
+        
+        /**
+         * Number of consecutive resting updates before a vehicle falls 
+         * asleep.
+         */
+        void setFramesUntilSleep( size_type frames );
+        size_type framesUntilSleep() const;
+        
+        /**
+         * Moving vehicles wake all sleepers within @a radius.
+         */
+        void setWakeRadius( float radius );
+        float wakeRadius() const;
+        
+        /**
+         * Updates all awake vehicles of @a vehicles and puts resting ones to
+         * sleep.
+         */
+        void update( AVGroup const& vehicles, float currentTime, float elapsedTime );
+        
+        /**
+         * Wakes the vehicle at @a index of the group, for example because an
+         * external event targets it. Does nothing if it is awake.
+         */
+        void wake( size_type index );
+        
+        /**
+         * Wakes all sleeping vehicles within @a radius of @a center.
+         */
+        void wakeWithin( Vec3 const& center, float radius );
+        
+        /**
+         * Forgets the vehicle at @a index, which is about to be removed 
+         * from the group. The vehicles behind it move down one index.
+         */
+        void remove( size_type index );
+        
+        /**
+         * Wakes all vehicles and forgets their resting history.
+         */
+        void reset();
+        
+        bool isAsleep( size_type index ) const;
+        
+        size_type sleepingVehicleCount() const;
+        size_type awakeVehicleCount() const;
+        
+        /**
+         * Number of vehicles which fell asleep respectively were woken up 
+         * during the last call of @c update.
+         */
+        size_type fellAsleepVehicleCount() const;
+        size_type wokenVehicleCount() const;
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SleepScheduler( SleepScheduler const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SleepScheduler& operator=( SleepScheduler const& );
+        
+        typedef LQProximityDatabase< AbstractVehicle* > SleeperDatabase;
+        typedef AbstractTokenForProximityDatabase< AbstractVehicle* > SleeperToken;
+        
+        struct VehicleState {
+            VehicleState() : restingFrames( 0 ), vehicle( 0 ), sleeperToken( 0 ) {}
+            
+            size_type restingFrames;
+            
+            /**
+             * The sleeping vehicle, key into the sleeper index map.
+             */
+            AbstractVehicle const* vehicle;
+            
+            /**
+             * Token in the sleeper database, @c 0 while awake.
+             */
+            SleeperToken* sleeperToken;
+        };
+        
+        void resize( AVGroup const& vehicles );
+        void sleep( size_type index, AbstractVehicle& vehicle );
+        void forget( size_type index );
+        void wakeNeighborsOf( Vec3 const& position, float radius );
+        
+    private:
+        float speedThreshold_;
+        float accelerationThreshold_;
+        size_type framesUntilSleep_;
+        float wakeRadius_;
+        
+        SleeperDatabase sleepers_;
+        SleeperToken* queryToken_;
+        std::map< AbstractVehicle const*, size_type > sleeperIndices_;
+        std::vector< AbstractVehicle* > neighbors_;
+        
+        std::vector< VehicleState > states_;
+        size_type fellAsleepVehicleCount_;
+        size_type wokenVehicleCount_;
+    }; // class SleepScheduler
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SLEEPSCHEDULER_H
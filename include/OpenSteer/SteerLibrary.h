@@ -51,6 +51,9 @@
 #include "OpenSteer/Pathway.h"
 #include "OpenSteer/Obstacle.h"
 #include "OpenSteer/Utilities.h"
+#include "OpenSteer/ReciprocalVelocityObstacle.h"
+#include "OpenSteer/TrajectoryCache.h"
+#include "OpenSteer/FlightRecorder.h"
 
 // Include OpenSteer::Color, OpenSteer::gBlack, ...
 #include "Color.h"
@@ -97,26 +100,46 @@ namespace OpenSteer {
 
         // -------------------------------------------------- steering behaviors
 
+        // All steering behaviors but the convenience version of wander are
+        // const: they are pure functions of the vehicle's state and their
+        // arguments, so steering for one vehicle may be computed from
+        // several threads (or against a const snapshot) at the same time.
+        // The only writes are graphical annotation calls which are no-ops
+        // when annotation is switched off.
+
         // Wander behavior
+        //
+        // The random walk state lives in the agent and is passed explicitly
+        // (in/out) to the const version, together with the random values
+        // (between 0 and 1) stepping the walk of each axis.  The convenience
+        // version uses the agent's own WanderSide and WanderUp members and
+        // draws the random values from frandom01 (the global rand
+        // generator), so it must not be called from several threads.
         float WanderSide;
         float WanderUp;
         Vec3 steerForWander (float dt);
+        Vec3 steerForWander (float dt,
+                             float& wanderSide,
+                             float& wanderUp,
+                             const float sideRandom01,
+                             const float upRandom01) const;
 
         // Seek behavior
-        Vec3 steerForSeek (const Vec3& target);
+        Vec3 steerForSeek (const Vec3& target) const;
 
         // Flee behavior
-        Vec3 steerForFlee (const Vec3& target);
+        Vec3 steerForFlee (const Vec3& target) const;
 
         // xxx proposed, experimental new seek/flee [cwr 9-16-02]
-        Vec3 xxxsteerForFlee (const Vec3& target);
-        Vec3 xxxsteerForSeek (const Vec3& target);
+        Vec3 xxxsteerForFlee (const Vec3& target) const;
+        Vec3 xxxsteerForSeek (const Vec3& target) const;
 
         // Path Following behaviors
         Vec3 steerToFollowPath (const int direction,
                                 const float predictionTime,
-                                Pathway& path);
-        Vec3 steerToStayOnPath (const float predictionTime, Pathway& path);
+                                const Pathway& path) const;
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                const Pathway& path) const;
 
         // ------------------------------------------------------------------------
         // Obstacle Avoidance behavior
@@ -131,13 +154,13 @@ namespace OpenSteer {
 
 
         Vec3 steerToAvoidObstacle (const float minTimeToCollision,
-                                   const Obstacle& obstacle);
+                                   const Obstacle& obstacle) const;
 
 
         // avoids all obstacles in an ObstacleGroup
 
         Vec3 steerToAvoidObstacles (const float minTimeToCollision,
-                                    const ObstacleGroup& obstacles);
+                                    const ObstacleGroup& obstacles) const;
 
 
         // ------------------------------------------------------------------------
@@ -149,23 +172,23 @@ namespace OpenSteer {
 
 
         Vec3 steerToAvoidNeighbors (const float minTimeToCollision,
-                                    const AVGroup& others);
+                                    const AVGroup& others) const;
 
 
         // Given two vehicles, based on their current positions and velocities,
         // determine the time until nearest approach
-        float predictNearestApproachTime (AbstractVehicle& otherVehicle);
+        float predictNearestApproachTime (const AbstractVehicle& otherVehicle) const;
 
         // Given the time until nearest approach (predictNearestApproachTime)
         // determine position of each vehicle at that time, and the distance
-        // between them
-        float computeNearestApproachPositions (AbstractVehicle& otherVehicle,
-                                               float time);
+        // between them.  The positions are returned in the output arguments.
+        float computeNearestApproachPositions (const AbstractVehicle& otherVehicle,
+                                               float time,
+                                               Vec3& ourPositionAtNearestApproach,
+                                               Vec3& hisPositionAtNearestApproach) const;
 
-
-        /// XXX globals only for the sake of graphical annotation
-        Vec3 hisPositionAtNearestApproach;
-        Vec3 ourPositionAtNearestApproach;
+        float computeNearestApproachPositions (const AbstractVehicle& otherVehicle,
+                                               float time) const;
 
 
         // ------------------------------------------------------------------------
@@ -177,7 +200,23 @@ namespace OpenSteer {
 
 
         Vec3 steerToAvoidCloseNeighbors (const float minSeparationDistance,
-                                         const AVGroup& others);
+                                         const AVGroup& others) const;
+
+
+        // ------------------------------------------------------------------------
+        // Reciprocal collision avoidance (ORCA) on the XZ plane: returns the
+        // steering from our current velocity to the velocity nearest
+        // preferredVelocity which is collision free for timeHorizon seconds,
+        // assuming the other vehicles do the same.  Intended for the result
+        // of a proximity database query in dense crowds.  Does not allocate,
+        // only the maxOrcaLineCount nearest others are considered.  Returns
+        // zero when no time elapses (while the simulation is paused).
+
+
+        Vec3 steerToAvoidNeighborsReciprocally (const float timeHorizon,
+                                                const float elapsedTime,
+                                                const Vec3& preferredVelocity,
+                                                const AVGroup& others) const;
 
 
         // ------------------------------------------------------------------------
@@ -187,7 +226,7 @@ namespace OpenSteer {
         bool inBoidNeighborhood (const AbstractVehicle& otherVehicle,
                                  const float minDistance,
                                  const float maxDistance,
-                                 const float cosMaxAngle);
+                                 const float cosMaxAngle) const;
 
 
         // ------------------------------------------------------------------------
@@ -196,7 +235,7 @@ namespace OpenSteer {
 
         Vec3 steerForSeparation (const float maxDistance,
                                  const float cosMaxAngle,
-                                 const AVGroup& flock);
+                                 const AVGroup& flock) const;
 
 
         // ------------------------------------------------------------------------
@@ -204,7 +243,7 @@ namespace OpenSteer {
 
         Vec3 steerForAlignment (const float maxDistance,
                                 const float cosMaxAngle,
-                                const AVGroup& flock);
+                                const AVGroup& flock) const;
 
 
         // ------------------------------------------------------------------------
@@ -213,19 +252,32 @@ namespace OpenSteer {
 
         Vec3 steerForCohesion (const float maxDistance,
                                const float cosMaxAngle,
-                               const AVGroup& flock);
+                               const AVGroup& flock) const;
 
 
         // ------------------------------------------------------------------------
         // pursuit of another vehicle (& version with ceiling on prediction time)
 
 
-        Vec3 steerForPursuit (const AbstractVehicle& quarry);
+        Vec3 steerForPursuit (const AbstractVehicle& quarry) const;
+
+        Vec3 steerForPursuit (const AbstractVehicle& quarry,
+                              const float maxPredictionTime) const;
 
+        // version reading the quarry's future position from its trajectory
+        // sampled once per step, shared by many pursuers of one quarry
+        // (prediction times beyond the cached horizon ask the quarry)
         Vec3 steerForPursuit (const AbstractVehicle& quarry,
-                              const float maxPredictionTime);
+                              const TrajectoryCache& quarryTrajectory,
+                              const float maxPredictionTime) const;
 
-        // for annotation
+        // estimated time until intercept of quarry (at most
+        // maxPredictionTime), color selects the pursuit annotation
+        float predictInterceptTime (const AbstractVehicle& quarry,
+                                    const float maxPredictionTime,
+                                    Color& color) const;
+
+        // for annotation: configuration only, never written by steerForPursuit
         bool gaudyPursuitAnnotation;
 
 
@@ -234,7 +286,7 @@ namespace OpenSteer {
 
 
         Vec3 steerForEvasion (const AbstractVehicle& menace,
-                              const float maxPredictionTime);
+                              const float maxPredictionTime) const;
 
 
         // ------------------------------------------------------------------------
@@ -242,7 +294,7 @@ namespace OpenSteer {
         // force along the forward/backward axis
 
 
-        Vec3 steerForTargetSpeed (const float targetSpeed);
+        Vec3 steerForTargetSpeed (const float targetSpeed) const;
 
 
         // ----------------------------------------------------------- utilities
@@ -275,11 +327,14 @@ namespace OpenSteer {
 
         // ------------------------------------------------ graphical annotation
         // (parameter names commented out to prevent compiler warning from "-W")
+        //
+        // these hooks are const so they may be called from const behaviors,
+        // overloads should only draw annotation and not modify the vehicle
 
 
         // called when steerToAvoidObstacles decides steering is required
         // (default action is to do nothing, layered classes can overload it)
-        virtual void annotateAvoidObstacle (const float /*minDistanceToCollision*/)
+        virtual void annotateAvoidObstacle (const float /*minDistanceToCollision*/) const
         {
         }
 
@@ -288,14 +343,14 @@ namespace OpenSteer {
         virtual void annotatePathFollowing (const Vec3& /*future*/,
                                             const Vec3& /*onPath*/,
                                             const Vec3& /*target*/,
-                                            const float /*outside*/)
+                                            const float /*outside*/) const
         {
         }
 
         // called when steerToAvoidCloseNeighbors decides steering is required
         // (default action is to do nothing, layered classes can overload it)
         virtual void annotateAvoidCloseNeighbor (const AbstractVehicle& /*other*/,
-                                                 const float /*additionalDistance*/)
+                                                 const float /*additionalDistance*/) const
         {
         }
 
@@ -304,7 +359,7 @@ namespace OpenSteer {
         virtual void annotateAvoidNeighbor (const AbstractVehicle& /*threat*/,
                                             const float /*steer*/,
                                             const Vec3& /*ourFuture*/,
-                                            const Vec3& /*threatFuture*/)
+                                            const Vec3& /*threatFuture*/) const
         {
         }
     };
@@ -320,13 +375,29 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForWander (float dt)
 {
-    // random walk WanderSide and WanderUp between -1 and +1
+    // draw in this order: side first, then up
+    const float sideRandom01 = frandom01 ();
+    const float upRandom01 = frandom01 ();
+    return steerForWander (dt, WanderSide, WanderUp, sideRandom01, upRandom01);
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForWander (float dt,
+                float& wanderSide,
+                float& wanderUp,
+                const float sideRandom01,
+                const float upRandom01) const
+{
+    // random walk wanderSide and wanderUp between -1 and +1
     const float speed = 12.0f * dt; // maybe this (12) should be an argument?
-    WanderSide = scalarRandomWalk (WanderSide, speed, -1, +1);
-    WanderUp   = scalarRandomWalk (WanderUp,   speed, -1, +1);
+    wanderSide = scalarRandomWalk (wanderSide, speed, -1, +1, sideRandom01);
+    wanderUp   = scalarRandomWalk (wanderUp,   speed, -1, +1, upRandom01);
 
     // return a pure lateral steering vector: (+/-Side) + (+/-Up)
-    return (side() * WanderSide) + (up() * WanderUp);
+    return (side() * wanderSide) + (up() * wanderUp);
 }
 
 
@@ -337,7 +408,7 @@ steerForWander (float dt)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerForSeek (const Vec3& target)
+steerForSeek (const Vec3& target) const
 {
     const Vec3 desiredVelocity = target - position();
     return desiredVelocity - velocity();
@@ -351,9 +422,9 @@ steerForSeek (const Vec3& target)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerForFlee (const Vec3& target)
+steerForFlee (const Vec3& target) const
 {
-    const Vec3 desiredVelocity = position - target;
+    const Vec3 desiredVelocity = position() - target;
     return desiredVelocity - velocity();
 }
 
@@ -365,7 +436,7 @@ steerForFlee (const Vec3& target)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-xxxsteerForFlee (const Vec3& target)
+xxxsteerForFlee (const Vec3& target) const
 {
 //  const Vec3 offset = position - target;
     const Vec3 offset = position() - target;
@@ -377,7 +448,7 @@ xxxsteerForFlee (const Vec3& target)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-xxxsteerForSeek (const Vec3& target)
+xxxsteerForSeek (const Vec3& target) const
 {
 //  const Vec3 offset = target - position;
     const Vec3 offset = target - position();
@@ -393,7 +464,7 @@ xxxsteerForSeek (const Vec3& target)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerToStayOnPath (const float predictionTime, Pathway& path)
+steerToStayOnPath (const float predictionTime, const Pathway& path) const
 {
     // predict our future position
     const Vec3 futurePosition = predictFuturePosition (predictionTime);
@@ -427,7 +498,7 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToFollowPath (const int direction,
                    const float predictionTime,
-                   Pathway& path)
+                   const Pathway& path) const
 {
     // our goal will be offset from our path distance by this amount
     const float pathDistanceOffset = direction * predictionTime * speed();
@@ -505,8 +576,9 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidObstacle (const float minTimeToCollision,
-                      const Obstacle& obstacle)
+                      const Obstacle& obstacle) const
 {
+    FlightRecorder::addObstacles (1);
     const Vec3 avoidance = obstacle.steerToAvoid (*this, minTimeToCollision);
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
@@ -523,8 +595,9 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidObstacles (const float minTimeToCollision,
-                       const ObstacleGroup& obstacles)
+                       const ObstacleGroup& obstacles) const
 {
+    FlightRecorder::addObstacles (obstacles.size());
     const Vec3 avoidance = Obstacle::steerToAvoidObstacles (*this,
                                                             minTimeToCollision,
                                                             obstacles);
@@ -549,30 +622,34 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidNeighbors (const float minTimeToCollision,
-                       const AVGroup& others)
+                       const AVGroup& others) const
 {
     // first priority is to prevent immediate interpenetration
     const Vec3 separation = steerToAvoidCloseNeighbors (0, others);
-    if (separation != Vec3::zero) return separation;
+    if (separation != Vec3::zero)
+    {
+        FlightRecorder::setAvoidance (FlightRecorder::closeNeighbor);
+        return separation;
+    }
 
     // otherwise, go on to consider potential future collisions
     float steer = 0;
-    AbstractVehicle* threat = NULL;
+    const AbstractVehicle* threat = NULL;
 
     // Time (in seconds) until the most immediate collision threat found
     // so far.  Initial value is a threshold: don't look more than this
     // many frames into the future.
     float minTime = minTimeToCollision;
 
-    // xxx solely for annotation
-    Vec3 xxxThreatPositionAtNearestApproach;
-    Vec3 xxxOurPositionAtNearestApproach;
+    // predicted positions at nearest approach with the current threat
+    Vec3 threatPositionAtNearestApproach;
+    Vec3 ourPositionAtNearestApproach;
 
     // for each of the other vehicles, determine which (if any)
     // pose the most immediate threat of collision.
     for (AVIterator i = others.begin(); i != others.end(); i++)
     {
-        AbstractVehicle& other = **i;
+        const AbstractVehicle& other = **i;
         if (&other != this)
         {	
             // avoid when future positions are this close (or less)
@@ -587,15 +664,17 @@ steerToAvoidNeighbors (const float minTimeToCollision,
             {
                 // if the two will be close enough to collide,
                 // make a note of it
-                if (computeNearestApproachPositions (other, time)
+                Vec3 ourPosition;
+                Vec3 hisPosition;
+                if (computeNearestApproachPositions (other, time,
+                                                     ourPosition,
+                                                     hisPosition)
                     < collisionDangerThreshold)
                 {
                     minTime = time;
                     threat = &other;
-                    xxxThreatPositionAtNearestApproach
-                        = hisPositionAtNearestApproach;
-                    xxxOurPositionAtNearestApproach
-                        = ourPositionAtNearestApproach;
+                    threatPositionAtNearestApproach = hisPosition;
+                    ourPositionAtNearestApproach = ourPosition;
                 }
             }
         }
@@ -612,9 +691,10 @@ steerToAvoidNeighbors (const float minTimeToCollision,
         {
             // anti-parallel "head on" paths:
             // steer away from future threat position
-            Vec3 offset = xxxThreatPositionAtNearestApproach - position();
+            Vec3 offset = threatPositionAtNearestApproach - position();
             float sideDot = offset.dot(side());
             steer = (sideDot > 0) ? -1.0f : 1.0f;
+            FlightRecorder::setAvoidance (FlightRecorder::headOn);
         }
         else
         {
@@ -624,6 +704,7 @@ steerToAvoidNeighbors (const float minTimeToCollision,
                 Vec3 offset = threat->position() - position();
                 float sideDot = offset.dot(side());
                 steer = (sideDot > 0) ? -1.0f : 1.0f;
+                FlightRecorder::setAvoidance (FlightRecorder::parallel);
             }
             else
             {
@@ -633,14 +714,23 @@ steerToAvoidNeighbors (const float minTimeToCollision,
                 {
                     float sideDot = side().dot(threat->velocity());
                     steer = (sideDot > 0) ? -1.0f : 1.0f;
+                    FlightRecorder::setAvoidance (FlightRecorder::perpendicular);
+                }
+                else
+                {
+                    FlightRecorder::setAvoidance (FlightRecorder::perpendicularFaster);
                 }
             }
         }
 
         annotateAvoidNeighbor (*threat,
                                steer,
-                               xxxOurPositionAtNearestApproach,
-                               xxxThreatPositionAtNearestApproach);
+                               ourPositionAtNearestApproach,
+                               threatPositionAtNearestApproach);
+    }
+    else
+    {
+        FlightRecorder::setAvoidance (FlightRecorder::noThreat);
     }
 
     return side() * steer;
@@ -656,7 +746,7 @@ steerToAvoidNeighbors (const float minTimeToCollision,
 template<class Super>
 float
 OpenSteer::SteerLibraryMixin<Super>::
-predictNearestApproachTime (AbstractVehicle& otherVehicle)
+predictNearestApproachTime (const AbstractVehicle& otherVehicle) const
 {
     // imagine we are at the origin with no velocity,
     // compute the relative velocity of the other vehicle
@@ -694,20 +784,32 @@ predictNearestApproachTime (AbstractVehicle& otherVehicle)
 template<class Super>
 float
 OpenSteer::SteerLibraryMixin<Super>::
-computeNearestApproachPositions (AbstractVehicle& otherVehicle,
-                                 float time)
+computeNearestApproachPositions (const AbstractVehicle& otherVehicle,
+                                 float time,
+                                 Vec3& ourPositionAtNearestApproach,
+                                 Vec3& hisPositionAtNearestApproach) const
 {
     const Vec3    myTravel =       forward () *       speed () * time;
     const Vec3 otherTravel = otherVehicle.forward () * otherVehicle.speed () * time;
 
-    const Vec3    myFinal =       position () +    myTravel;
-    const Vec3 otherFinal = otherVehicle.position () + otherTravel;
+    ourPositionAtNearestApproach =       position () +    myTravel;
+    hisPositionAtNearestApproach = otherVehicle.position () + otherTravel;
+
+    return Vec3::distance (ourPositionAtNearestApproach,
+                           hisPositionAtNearestApproach);
+}
 
-    // xxx for annotation
-    ourPositionAtNearestApproach = myFinal;
-    hisPositionAtNearestApproach = otherFinal;
 
-    return Vec3::distance (myFinal, otherFinal);
+template<class Super>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+computeNearestApproachPositions (const AbstractVehicle& otherVehicle,
+                                 float time) const
+{
+    Vec3 ourPosition;
+    Vec3 hisPosition;
+    return computeNearestApproachPositions (otherVehicle, time,
+                                            ourPosition, hisPosition);
 }
 
 
@@ -724,12 +826,12 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidCloseNeighbors (const float minSeparationDistance,
-                            const AVGroup& others)
+                            const AVGroup& others) const
 {
     // for each of the other vehicles...
     for (AVIterator i = others.begin(); i != others.end(); i++)    
     {
-        AbstractVehicle& other = **i;
+        const AbstractVehicle& other = **i;
         if (&other != this)
         {
             const float sumOfRadii = radius() + other.radius();
@@ -750,6 +852,67 @@ steerToAvoidCloseNeighbors (const float minSeparationDistance,
 }
 
 
+// ----------------------------------------------------------------------------
+// Reciprocal collision avoidance (ORCA)
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToAvoidNeighborsReciprocally (const float timeHorizon,
+                                   const float elapsedTime,
+                                   const Vec3& preferredVelocity,
+                                   const AVGroup& others) const
+{
+    // no time to change velocity in
+    if (elapsedTime <= 0) return Vec3::zero;
+
+    // one half-plane per neighbor, kept on the stack: when there are more
+    // neighbors than slots the farthest one is replaced
+    OrcaLine lines [maxOrcaLineCount];
+    float distancesSquared [maxOrcaLineCount];
+    size_t lineCount = 0;
+
+    for (AVIterator i = others.begin(); i != others.end(); i++)
+    {
+        const AbstractVehicle& other = **i;
+        if (&other != this)
+        {
+            const Vec3 relativePosition = other.position() - position();
+            const float distanceSquared = relativePosition.lengthSquared ();
+
+            size_t slot = lineCount;
+            if (lineCount == maxOrcaLineCount)
+            {
+                // find the farthest neighbor so far
+                slot = 0;
+                for (size_t j = 1; j < lineCount; j++)
+                    if (distancesSquared[j] > distancesSquared[slot]) slot = j;
+                if (distanceSquared >= distancesSquared[slot]) continue;
+            }
+            else
+            {
+                lineCount++;
+            }
+
+            distancesSquared[slot] = distanceSquared;
+            lines[slot] = computeOrcaLine (velocity(),
+                                           relativePosition,
+                                           velocity() - other.velocity(),
+                                           radius() + other.radius(),
+                                           timeHorizon,
+                                           elapsedTime);
+        }
+    }
+
+    const Vec3 newVelocity = solveOrcaLinearProgram (lines,
+                                                     lineCount,
+                                                     maxSpeed (),
+                                                     preferredVelocity);
+    return (newVelocity - velocity()).setYtoZero ();
+}
+
+
 // ----------------------------------------------------------------------------
 // used by boid behaviors: is a given vehicle within this boid's neighborhood?
 
@@ -760,7 +923,7 @@ OpenSteer::SteerLibraryMixin<Super>::
 inBoidNeighborhood (const AbstractVehicle& otherVehicle,
                     const float minDistance,
                     const float maxDistance,
-                    const float cosMaxAngle)
+                    const float cosMaxAngle) const
 {
     if (&otherVehicle == this)
     {
@@ -804,7 +967,7 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForSeparation (const float maxDistance,
                     const float cosMaxAngle,
-                    const AVGroup& flock)
+                    const AVGroup& flock) const
 {
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
@@ -853,7 +1016,7 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForAlignment (const float maxDistance,
                    const float cosMaxAngle,
-                   const AVGroup& flock)
+                   const AVGroup& flock) const
 {
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
@@ -890,7 +1053,7 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForCohesion (const float maxDistance,
                   const float cosMaxAngle,
-                  const AVGroup& flock)
+                  const AVGroup& flock) const
 {
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
@@ -924,7 +1087,7 @@ steerForCohesion (const float maxDistance,
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerForPursuit (const AbstractVehicle& quarry)
+steerForPursuit (const AbstractVehicle& quarry) const
 {
     return steerForPursuit (quarry, FLT_MAX);
 }
@@ -934,7 +1097,53 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForPursuit (const AbstractVehicle& quarry,
-                 const float maxPredictionTime)
+                 const float maxPredictionTime) const
+{
+    Color color;
+    const float etl = predictInterceptTime (quarry, maxPredictionTime, color);
+
+    // estimated position of quarry at intercept
+    const Vec3 target = quarry.predictFuturePosition (etl);
+
+    // annotation
+    this->annotationLine (position(),
+                          target,
+                          gaudyPursuitAnnotation ? color : gGray40);
+
+    return steerForSeek (target);
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForPursuit (const AbstractVehicle& quarry,
+                 const TrajectoryCache& quarryTrajectory,
+                 const float maxPredictionTime) const
+{
+    Color color;
+    const float etl = predictInterceptTime (quarry, maxPredictionTime, color);
+
+    // estimated position of quarry at intercept
+    const Vec3 target = quarryTrajectory.covers (etl) ?
+                        quarryTrajectory.predictFuturePosition (etl) :
+                        quarry.predictFuturePosition (etl);
+
+    // annotation
+    this->annotationLine (position(),
+                          target,
+                          gaudyPursuitAnnotation ? color : gGray40);
+
+    return steerForSeek (target);
+}
+
+
+template<class Super>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+predictInterceptTime (const AbstractVehicle& quarry,
+                      const float maxPredictionTime,
+                      Color& color) const
 {
     // offset from this to quarry, that distance, unit vector toward quarry
     const Vec3 offset = quarry.position() - position();
@@ -954,7 +1163,7 @@ steerForPursuit (const AbstractVehicle& quarry,
     const int p = intervalComparison (parallelness, -0.707f, 0.707f);
 
     float timeFactor = 0; // to be filled in below
-    Color color;           // to be filled in below (xxx just for debugging)
+                          // (color is just for debugging)
 
     // Break the pursuit into nine cases, the cross product of the
     // quarry being [ahead, aside, or behind] us and heading
@@ -1018,17 +1227,7 @@ steerForPursuit (const AbstractVehicle& quarry,
     const float et = directTravelTime * timeFactor;
 
     // xxx experiment, if kept, this limit should be an argument
-    const float etl = (et > maxPredictionTime) ? maxPredictionTime : et;
-
-    // estimated position of quarry at intercept
-    const Vec3 target = quarry.predictFuturePosition (etl);
-
-    // annotation
-    this->annotationLine (position(),
-                          target,
-                          gaudyPursuitAnnotation ? color : gGray40);
-
-    return steerForSeek (target);
+    return (et > maxPredictionTime) ? maxPredictionTime : et;
 }
 
 // ----------------------------------------------------------------------------
@@ -1039,10 +1238,10 @@ template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForEvasion (const AbstractVehicle& menace,
-                 const float maxPredictionTime)
+                 const float maxPredictionTime) const
 {
     // offset from this to menace, that distance, unit vector toward menace
-    const Vec3 offset = this->menace.position - position;
+    const Vec3 offset = menace.position() - position();
     const float distance = offset.length ();
 
     const float roughTime = distance / menace.speed();
@@ -1064,7 +1263,7 @@ steerForEvasion (const AbstractVehicle& menace,
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerForTargetSpeed (const float targetSpeed)
+steerForTargetSpeed (const float targetSpeed) const
 {
     const float mf = maxForce ();
     const float speedError = targetSpeed - speed ();
@@ -0,0 +1,73 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * High resolution wall clock stopwatch for profiling and benchmarks.
+ */
+#ifndef OPENSTEER_STOPWATCH_H
+#define OPENSTEER_STOPWATCH_H
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Measures wall clock time with the best monotonic timer of the 
+     * platform. Unlike @c Clock it doesn't track simulation time and keeps
+     * the full precision of long runs by using @c double.
+     */
+    class Stopwatch {
+    public:
+        /**
+         * Creates a started stopwatch.
+         */
+        Stopwatch();
+        
+        /**
+         * Restarts measuring at @c 0.
+         */
+        void restart();
+        
+        /**
+         * Seconds since construction or the last @c restart.
+         */
+        double elapsedSeconds() const;
+        
+        /**
+         * Seconds since an arbitrary but fixed point in time.
+         */
+        static double now();
+        
+    private:
+        double start_;
+    }; // class Stopwatch
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_STOPWATCH_H
@@ -0,0 +1,110 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Future positions of a vehicle sampled once per simulation step.
+ *
+ * Pursuit asks the quarry where it will be at an estimated intercept time.
+ * When thousands of pursuers chase the same few quarries each of them
+ * would evaluate @c predictFuturePosition on its own. A trajectory cache
+ * evaluates it once per quarry at quantized times and pursuers
+ * interpolate between the two samples around their own estimate.
+ */
+#ifndef OPENSTEER_TRAJECTORYCACHE_H
+#define OPENSTEER_TRAJECTORYCACHE_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class AbstractVehicle;
+    
+    
+    /**
+     * Positions of a vehicle predicted at the times @c 0, @c step, 
+     * @c 2*step, ... up to (and including) @c horizon. Sample it after the 
+     * vehicle has been updated and before other vehicles query it.
+     *
+     * @c sample isn't reentrant, all const member functions are thread safe.
+     */
+    class TrajectoryCache {
+    public:
+        typedef size_t size_type;
+        
+        /**
+         * Creates an empty cache, @c predictFuturePosition returns 
+         * @c Vec3::zero until the first @c sample.
+         */
+        TrajectoryCache();
+        
+        /**
+         * Evaluates @c vehicle.predictFuturePosition at times @c 0 to
+         * @a horizon spaced @a step apart.
+         *
+         * @pre @a horizon >= 0, @a step > 0
+         */
+        void sample( AbstractVehicle const& vehicle, float horizon, float step );
+        
+        /**
+         * Position at @a predictionTime linearly interpolated between the 
+         * samples, clamped to the first and last sample outside of
+         * @c 0 .. @c horizon.
+         */
+        Vec3 predictFuturePosition( float predictionTime ) const;
+        
+        /**
+         * Returns @c true if @a predictionTime lies within the sampled 
+         * times.
+         */
+        bool covers( float predictionTime ) const;
+        
+        float horizon() const;
+        float step() const;
+        size_type sampleCount() const;
+        
+    private:
+        std::vector< Vec3 > positions_;
+        float horizon_;
+        float step_;
+        float inverseStep_;
+    }; // class TrajectoryCache
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_TRAJECTORYCACHE_H
@@ -97,6 +97,39 @@ namespace OpenSteer {
     }
 
 
+    // A random number generator with its own state (Marsaglia's xorshift),
+    // for simulations which must not share the global rand generator: its
+    // stream doesn't depend on other users of rand (other worlds stepped
+    // concurrently) and drawing takes no lock.  Not thread safe itself.
+
+    class RandomGenerator
+    {
+    public:
+
+        RandomGenerator (const unsigned int seed = 1) {setSeed (seed);}
+
+        // xorshift never leaves the zero state, so 0 is replaced
+        void setSeed (const unsigned int seed)
+        {
+            state = (seed != 0) ? seed : 0x9e3779b9u;
+        }
+
+        // returns a float randomly distributed between 0 and 1
+        float frandom01 (void)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            state &= 0xffffffffu;
+            return ((float) (state >> 8)) / 16777215.0f;
+        }
+
+    private:
+
+        unsigned int state;
+    };
+
+
     // ----------------------------------------------------------------------------
     // Constrain a given value (x) to be between two (ordered) bounds: min
     // and max.  Returns x if it is between the bounds, otherwise returns
@@ -164,18 +197,35 @@ namespace OpenSteer {
     // ----------------------------------------------------------------------------
 
 
+    // steps a random walk by up to walkspeed, random01 (between 0 and 1)
+    // picks the step, the result is clipped to remain between min and max
+
+
     inline float scalarRandomWalk (const float initial, 
                                    const float walkspeed,
                                    const float min,
-                                   const float max)
+                                   const float max,
+                                   const float random01)
     {
-        const float next = initial + (((frandom01() * 2) - 1) * walkspeed);
+        const float next = initial + (((random01 * 2) - 1) * walkspeed);
         if (next < min) return min;
         if (next > max) return max;
         return next;
     }
 
 
+    // as above, drawing the step from frandom01 (the global rand generator)
+
+
+    inline float scalarRandomWalk (const float initial, 
+                                   const float walkspeed,
+                                   const float min,
+                                   const float max)
+    {
+        return scalarRandomWalk (initial, walkspeed, min, max, frandom01 ());
+    }
+
+
     // ----------------------------------------------------------------------------
 
 
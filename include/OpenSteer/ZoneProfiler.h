@@ -0,0 +1,165 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Profiler of the zones of a frame: the update and draw phases of 
+ * @c OpenSteerDemo and the proximity queries made during the update.
+ *
+ * While the profiler is active each zone sums up the number of times it
+ * was entered, its wall time, the heap allocations made in it (see 
+ * @c AllocationCounter, allocations of other threads meanwhile included)
+ * and, if hardware counters were asked for and are available, the counts
+ * of @c PerformanceCounters. Zones nest, the
+ * update zone includes the proximity zone, and re-entering a zone that is
+ * already open isn't counted again.
+ *
+ * Only the thread that runs the frame is profiled: zones entered inside
+ * OpenMP parallel regions are skipped, and counters count the events of
+ * the profiling thread only.
+ */
+#ifndef OPENSTEER_ZONEPROFILER_H
+#define OPENSTEER_ZONEPROFILER_H
+
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include OpenSteer::PerformanceCounters
+#include "OpenSteer/PerformanceCounters.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    /**
+     * Process wide zone profiler, all members are static. Inactive until
+     * @c start is called, costing one branch per zone then.
+     */
+    class ZoneProfiler {
+    public:
+        typedef size_t size_type;
+        
+        enum Zone {
+            update,
+            proximity,
+            draw,
+            zoneCount
+        };
+        
+        struct Totals {
+            size_type calls;
+            double seconds;
+            size_type allocations;
+            size_type allocatedBytes;
+            PerformanceCounters::Values counters;
+        };
+        
+        /**
+         * Enters a zone for its lifetime if the profiler is active.
+         */
+        class Scope {
+        public:
+            explicit Scope( Zone zone );
+            ~Scope();
+            
+        private:
+            Zone zone_;
+            bool entered_;
+        }; // class Scope
+        
+        /**
+         * Clears the totals and starts profiling, opens the hardware 
+         * counters if @a withCounters is @c true. Profiling goes on 
+         * without counters if none are available.
+         */
+        static void start( bool withCounters );
+        static void stop();
+        static bool active();
+        
+        static void enter( Zone zone );
+        static void leave( Zone zone );
+        
+        static Totals const& totals( Zone zone );
+        static PerformanceCounters const& counters();
+        
+        static char const* name( Zone zone );
+        
+        /**
+         * Prints the totals of all zones per frame and per agent.
+         */
+        static void report( std::ostream& out, 
+                            size_type frameCount, 
+                            size_type agentCount );
+        
+    private:
+        /**
+         * Not implemented, all members are static.
+         */
+        ZoneProfiler();
+        
+    private:
+        static bool active_;
+    }; // class ZoneProfiler
+    
+    
+    
+    inline 
+    bool 
+    ZoneProfiler::active()
+    {
+        return active_;
+    }
+    
+    
+    
+    inline 
+    ZoneProfiler::Scope::Scope( Zone zone )
+        : zone_( zone ), entered_( ZoneProfiler::active() )
+    {
+        if ( entered_ ) {
+            ZoneProfiler::enter( zone_ );
+        }
+    }
+    
+    
+    
+    inline 
+    ZoneProfiler::Scope::~Scope()
+    {
+        if ( entered_ ) {
+            ZoneProfiler::leave( zone_ );
+        }
+    }
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ZONEPROFILER_H
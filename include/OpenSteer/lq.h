@@ -306,6 +306,72 @@ void lqGetBinPopulationStats (lqDB* lq,
                               float* average);
 #endif /* NO_LQ_BIN_STATS */
 
+
+/* ------------------------------------------------------------------ */
+/* Get a histogram of bin populations: histogram[i] is the number of
+   bins holding i objects, the last of the size entries counts the
+   bins holding size-1 or more objects.  Like lqGetBinPopulationStats
+   this completes a resize in progress. */
+
+
+#ifndef NO_LQ_BIN_STATS
+void lqGetBinPopulationHistogram (lqDB* lq,
+                                  int* histogram,
+                                  int size);
+#endif /* NO_LQ_BIN_STATS */
+
+
+/* ------------------------------------------------------------------ */
+/* Like lqMapOverAllObjectsInLocality, but returns the number of
+   objects tested against the search sphere (the "candidates", of
+   which those inside the sphere are passed to func).  Candidates per
+   query measure how well the subdivision fits the query radius: too
+   few bins and many objects are tested in vain, too many and most of
+   the visited bins are empty. */
+
+
+int lqMapOverAllObjectsInLocalityCounted (lqDB* lq, 
+					  float x, float y, float z,
+					  float radius,
+					  lqCallBackFunction func,
+					  void* clientQueryState);
+
+
+/* ------------------------------------------------------------------ */
+/* Change the number of subdivisions along each axis.  The new bins
+   are allocated at once but objects move to them incrementally, to
+   spread the cost over the following updates: an object moves on its
+   next lqUpdateForNewLocation, and each of those calls also empties
+   a few of the old bins so that objects which stop moving are moved
+   too.  Until the old bins are empty queries search both bin arrays
+   and the old array stays allocated.  A resize still in progress is
+   completed first. */
+
+
+void lqResizeDatabase (lqDB* lq, int divx, int divy, int divz);
+
+
+/* ------------------------------------------------------------------ */
+/* Returns non-zero while objects may be left in the old bins of a
+   resize. */
+
+
+int lqResizeInProgress (lqDB* lq);
+
+
+/* ------------------------------------------------------------------ */
+/* Moves all objects left in the old bins of a resize at once. */
+
+
+void lqFinishResize (lqDB* lq);
+
+
+/* ------------------------------------------------------------------ */
+/* Get the number of subdivisions along each axis. */
+
+
+void lqGetDivisions (lqDB* lq, int* divx, int* divy, int* divz);
+
 /* ------------------------------------------------------------------ */
 
 
@@ -29,6 +29,15 @@
 //
 //
 // OpenSteer Boids
+//
+// All state of a flock (boids, proximity database, obstacles and flocking
+// parameters) is kept in a BoidsWorld, so any number of flocks can be run
+// side by side for batch runs (see AbstractWorld).
+//
+// The "megaflock" (F7, or --option megaflock=1000000 for headless runs)
+// replaces the flock by a Megaflock of 100,000 or 1,000,000 boids without
+// obstacles, drawing only a sample of them unless decimation is turned off
+// (F8).  It is the benchmark for boid updates per second at large scale.
 // 
 // 09-26-02 cwr: created 
 //
@@ -36,12 +45,20 @@
 // ----------------------------------------------------------------------------
 
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Proximity.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/UnusedParameter.h"
+#include "OpenSteer/LevelOfDetailScheduler.h"
+#include "OpenSteer/Megaflock.h"
+#include "OpenSteer/Stopwatch.h"
+#include "OpenSteer/Metrics.h"
+#include "OpenSteer/FlightRecorder.h"
 
 #ifdef WIN32
 // Windows defines these as macros :(
@@ -70,22 +87,239 @@ namespace {
 
 
     // ----------------------------------------------------------------------------
+    // orders vehicles by their distance from a point, nearest first
 
 
-    class Boid : public OpenSteer::SimpleVehicle
+    class NearerTo
+    {
+    public:
+        NearerTo (const Vec3& p) : point (p) {}
+
+        bool operator() (const AbstractVehicle* a, const AbstractVehicle* b) const
+        {
+            return ((a->position() - point).lengthSquared () <
+                    (b->position() - point).lengthSquared ());
+        }
+
+    private:
+        Vec3 point;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // radius, angle (cosine of the half angle of the view cone) and weight
+    // of the three component behaviors of flocking
+
+
+    struct FlockingParameters
+    {
+        FlockingParameters (void)
+            : separationRadius (5.0f),
+              separationAngle (-0.707f),
+              separationWeight (12.0f),
+              alignmentRadius (7.5f),
+              alignmentAngle (0.7f),
+              alignmentWeight (8.0f),
+              cohesionRadius (9.0f),
+              cohesionAngle (-0.15f),
+              cohesionWeight (8.0f)
+        {}
+
+        float separationRadius;
+        float separationAngle;
+        float separationWeight;
+
+        float alignmentRadius;
+        float alignmentAngle;
+        float alignmentWeight;
+
+        float cohesionRadius;
+        float cohesionAngle;
+        float cohesionWeight;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // obstacles which know how to draw themselves
+
+
+    void tempDrawRectangle (const RectangleObstacle& rect, const Color& color);
+    void tempDrawBox (const BoxObstacle& box, const Color& color);
+
+    class SO : public SphereObstacle
+    {void draw (const bool filled, const Color& color, const Vec3& vp) const
+        {drawSphereObstacle (*this, 10.0f, filled, color, vp);}};
+
+    class RO : public RectangleObstacle
+    {void draw (const bool, const Color& color, const Vec3&) const
+        {tempDrawRectangle (*this, color);}};
+
+    class BO : public BoxObstacle
+    {void draw (const bool, const Color& color, const Vec3&) const
+        {tempDrawBox (*this, color);}};
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class Boid;
+
+
+    // ----------------------------------------------------------------------------
+    // exported metrics of a flock: neighbors per boid (collected during an
+    // update, added to the histogram after it), the resolution of the LQ
+    // database and its bin populations
+
+
+    struct BoidsMetrics
+    {
+        BoidsMetrics (MetricsRegistry& registry);
+
+        Histogram::Batch neighborCounts;
+        Gauge& lqBins;
+        Gauge& lqCandidates;
+        Gauge& lqBinPopulationMax;
+        Gauge& lqBinPopulationMean;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // one flock with everything it needs to be simulated
+
+
+    class BoidsWorld : public AbstractWorld
     {
     public:
 
         // type for a flock: an STL vector of Boid pointers
         typedef std::vector<Boid*> groupType;
+        typedef groupType::const_iterator iterator;
+
+        // a world exports its metrics to the given registry, if any (the
+        // series have fixed names, so only one world may export them: batch
+        // worlds made by the PlugIn export none)
+        BoidsWorld (MetricsRegistry* registry = NULL);
+        virtual ~BoidsWorld() {delete metrics;}
+
+        // "boids" sets the initial flock size, "proximity" the initial
+        // proximity database ("lq", "adaptive" or "bruteforce"),
+        // "targetCandidates" the candidates per query the adaptive LQ
+        // database aims for, the other options are the members of
+        // FlockingParameters, like "separationWeight"
+        bool setOption (const char* name, const char* value);
+
+        void open (void);
+        void update (const float currentTime, const float elapsedTime);
+        void close (void);
+        void printStatistics (std::ostream& os);
+
+        // update only the boids the scheduler says are due this frame,
+        // with the same statistics and metrics as a full update
+        void updateLevelOfDetail (LevelOfDetailScheduler& scheduler,
+                                  const float currentTime,
+                                  const float elapsedTime);
+
+        // return an AVGroup containing each boid of the flock
+        const AVGroup& allVehicles (void) {return (const AVGroup&)flock;}
+
+        void addBoidToFlock (void);
+        void removeBoidFromFlock (void);
+
+        // for purposes of demonstration, allow cycling through various
+        // types of proximity databases.
+        void nextPD (void);
+
+        // start collecting neighbor statistics of a new frame
+        void resetNeighborStatistics (void);
+
+        // flock: a group (STL vector) of pointers to all boids
+        groupType flock;
+
+        // pointer to database used to accelerate proximity queries
+        ProximityDatabase* pd;
+
+        // keep track of current flock size, and the size it starts with
+        int population;
+        int startPopulation;
+
+        // which of the various proximity databases is currently in use,
+        // and the one used when the world is opened
+        int cyclePD;
+        int initialPD;
+
+        // candidates per query the LQ database adapts its resolution to
+        // (0 for a fixed resolution)
+        float targetCandidates;
+
+        // boids wrap around at this distance from the origin
+        float worldRadius;
 
+        // flocking considers only this many nearest neighbors (0 for all),
+        // lowered by the PlugIn while frames take too long
+        size_t neighborCap;
+
+        FlockingParameters parameters;
+
+    #ifndef NO_LQ_BIN_STATS
+        // max/min/ave neighbors per boids during the last update
+        size_t minNeighbors, maxNeighbors, totalNeighbors;
+    #endif // NO_LQ_BIN_STATS
+
+        // exported metrics (NULL when the world exports none)
+        BoidsMetrics* metrics;
+        int updateCount;
+
+        void updateMetrics (void);
+
+        // --------------------------------------------------------
+        // the rest of the world supports the various obstacles:
+        // --------------------------------------------------------
+
+        // enumerate demos of various constraints on the flock
+        enum ConstraintType {none, insideSphere,
+                             outsideSphere, outsideSpheres, outsideSpheresNoBig,
+                             rectangle, rectangleNoBig,
+                             outsideBox, insideBox};
+
+        ConstraintType constraint;
+
+        // group of all obstacles to be avoided by each Boid
+        ObstacleGroup obstacles;
+
+        RO bigRectangle;
+        BO outsideBigBox, insideBigBox;
+        SO insideBigSphere, outsideSphere0, outsideSphere1, outsideSphere2,
+           outsideSphere3, outsideSphere4, outsideSphere5, outsideSphere6;
+
+        void initObstacles (void);
+
+        // select next "boundary condition / constraint / obstacle"
+        void nextBoundaryCondition (void);
+
+        // update the obstacles list when constraint changes
+        void updateObstacles (void);
+
+    private:
+
+        // not copyable: a world owns its metrics
+        BoidsWorld (const BoidsWorld&);
+        BoidsWorld& operator= (const BoidsWorld&);
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class Boid : public OpenSteer::SimpleVehicle
+    {
+    public:
 
         // constructor
-        Boid (ProximityDatabase& pd)
+        Boid (BoidsWorld& flockWorld) : world (flockWorld)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
-            newPD (pd);
+            newPD (*world.pd);
 
             // reset all boid state
             reset ();
@@ -138,6 +372,7 @@ namespace {
         void update (const float currentTime, const float elapsedTime)
         {
             OPENSTEER_UNUSED_PARAMETER(currentTime);
+            FlightRecorder::AgentScope flight (serialNumber);
             
             // steer to flock and avoid obstacles if any
             applySteeringForce (steerToFlock (), elapsedTime);
@@ -155,24 +390,14 @@ namespace {
         {
             // avoid obstacles if needed
             // XXX this should probably be moved elsewhere
-            const Vec3 avoidance = steerToAvoidObstacles (1.0f, obstacles);
+            const Vec3 avoidance = steerToAvoidObstacles (1.0f, world.obstacles);
             if (avoidance != Vec3::zero) return avoidance;
 
-            const float separationRadius =  5.0f;
-            const float separationAngle  = -0.707f;
-            const float separationWeight =  12.0f;
-
-            const float alignmentRadius = 7.5f;
-            const float alignmentAngle  = 0.7f;
-            const float alignmentWeight = 8.0f;
+            const FlockingParameters& p = world.parameters;
 
-            const float cohesionRadius = 9.0f;
-            const float cohesionAngle  = -0.15f;
-            const float cohesionWeight = 8.0f;
-
-            const float maxRadius = maxXXX (separationRadius,
-                                            maxXXX (alignmentRadius,
-                                                    cohesionRadius));
+            const float maxRadius = maxXXX (p.separationRadius,
+                                            maxXXX (p.alignmentRadius,
+                                                    p.cohesionRadius));
 
             // find all flockmates within maxRadius using proximity database
             neighbors.clear();
@@ -181,26 +406,39 @@ namespace {
     #ifndef NO_LQ_BIN_STATS
             // maintain stats on max/min/ave neighbors per boids
             size_t count = neighbors.size();
-            if (maxNeighbors < count) maxNeighbors = count;
-            if (minNeighbors > count) minNeighbors = count;
-            totalNeighbors += count;
+            if (world.maxNeighbors < count) world.maxNeighbors = count;
+            if (world.minNeighbors > count) world.minNeighbors = count;
+            world.totalNeighbors += count;
     #endif // NO_LQ_BIN_STATS
+            if (world.metrics)
+                world.metrics->neighborCounts.observe ((double) neighbors.size());
+
+            // consider only the nearest neighbors if the world caps them
+            const size_t cap = world.neighborCap;
+            if ((cap > 0) && (neighbors.size() > cap))
+            {
+                std::nth_element (neighbors.begin(),
+                                  neighbors.begin() + cap,
+                                  neighbors.end(),
+                                  NearerTo (position()));
+                neighbors.resize (cap);
+            }
 
             // determine each of the three component behaviors of flocking
-            const Vec3 separation = steerForSeparation (separationRadius,
-                                                        separationAngle,
+            const Vec3 separation = steerForSeparation (p.separationRadius,
+                                                        p.separationAngle,
                                                         neighbors);
-            const Vec3 alignment  = steerForAlignment  (alignmentRadius,
-                                                        alignmentAngle,
+            const Vec3 alignment  = steerForAlignment  (p.alignmentRadius,
+                                                        p.alignmentAngle,
                                                         neighbors);
-            const Vec3 cohesion   = steerForCohesion   (cohesionRadius,
-                                                        cohesionAngle,
+            const Vec3 cohesion   = steerForCohesion   (p.cohesionRadius,
+                                                        p.cohesionAngle,
                                                         neighbors);
 
             // apply weights to components (save in variables for annotation)
-            const Vec3 separationW = separation * separationWeight;
-            const Vec3 alignmentW = alignment * alignmentWeight;
-            const Vec3 cohesionW = cohesion * cohesionWeight;
+            const Vec3 separationW = separation * p.separationWeight;
+            const Vec3 alignmentW = alignment * p.alignmentWeight;
+            const Vec3 cohesionW = cohesion * p.cohesionWeight;
 
             // annotation
             // const float s = 0.1;
@@ -216,11 +454,11 @@ namespace {
         void sphericalWrapAround (void)
         {
             // when outside the sphere
-            if (position().length() > worldRadius)
+            if (position().length() > world.worldRadius)
             {
                 // wrap around (teleport)
                 setPosition (position().sphericalWrapAround (Vec3::zero,
-                                                             worldRadius));
+                                                             world.worldRadius));
                 if (this == OpenSteerDemo::selectedVehicle)
                 {
                     OpenSteerDemo::position3dCamera
@@ -281,22 +519,20 @@ namespace {
         }
 
 
-        // group of all obstacles to be avoided by each Boid
-        static ObstacleGroup obstacles;
+        // the flock this boid belongs to
+        BoidsWorld& world;
 
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
-
-        static float worldRadius;
+        // flockmates found by the last proximity query (per-instance so
+        // that boids of different worlds can be updated concurrently)
+        AVGroup neighbors;
 
         // xxx perhaps this should be a call to a general purpose annotation for
         // xxx "local xxx axis aligned box in XZ plane" -- same code in in
         // xxx CaptureTheFlag.cpp
-        void annotateAvoidObstacle (const float minDistanceToCollision)
+        void annotateAvoidObstacle (const float minDistanceToCollision) const
         {
             const Vec3 boxSide = side() * radius();
             const Vec3 boxFront = forward() * minDistanceToCollision;
@@ -310,19 +546,390 @@ namespace {
             annotationLine (BL, BR, white);
             annotationLine (BR, FR, white);
         }
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    // buckets of the neighbors per boid histogram
+    std::vector<double> neighborCountBounds (void)
+    {
+        const double bounds[] = {0, 1, 2, 4, 8, 16, 32, 64, 128};
+        return std::vector<double> (bounds,
+                                    bounds + sizeof (bounds) / sizeof (bounds[0]));
+    }
+
+
+    BoidsMetrics::BoidsMetrics (MetricsRegistry& registry)
+        : neighborCounts (registry.histogram
+                          ("opensteer_boids_neighbors",
+                           "Neighbors found per boid and update.",
+                           neighborCountBounds ())),
+          lqBins (registry.gauge
+                  ("opensteer_boids_lq_bins",
+                   "Bins of the LQ proximity database.")),
+          lqCandidates (registry.gauge
+                        ("opensteer_boids_lq_candidates_per_query",
+                         "Objects tested per query by the adaptive LQ database.")),
+          lqBinPopulationMax (registry.gauge
+                              ("opensteer_boids_lq_bin_population_max",
+                               "Largest population of an LQ bin.")),
+          lqBinPopulationMean (registry.gauge
+                               ("opensteer_boids_lq_bin_population_mean",
+                                "Mean population of non-empty LQ bins."))
+    {}
+
+
+    BoidsWorld::BoidsWorld (MetricsRegistry* registry)
+        : pd (NULL),
+          population (0),
+          startPopulation (200),
+          cyclePD (-1),
+          initialPD (0),
+          targetCandidates (0),
+          worldRadius (50.0f),
+          neighborCap (0),
+          metrics (registry ? new BoidsMetrics (*registry) : NULL),
+          updateCount (0),
+          constraint (none)
+    {
+        resetNeighborStatistics ();
+    }
+
+
+    bool BoidsWorld::setOption (const char* name, const char* value)
+    {
+        const float number = (float) std::atof (value);
+        if (std::strcmp (name, "boids") == 0)
+            startPopulation = std::atoi (value);
+        else if ((std::strcmp (name, "proximity") == 0) &&
+                 (std::strcmp (value, "lq") == 0))
+            initialPD = 0;
+        else if ((std::strcmp (name, "proximity") == 0) &&
+                 (std::strcmp (value, "bruteforce") == 0))
+            initialPD = 1;
+        else if ((std::strcmp (name, "proximity") == 0) &&
+                 (std::strcmp (value, "adaptive") == 0))
+        {
+            initialPD = 0;
+            if (targetCandidates <= 0) targetCandidates = 40;
+        }
+        else if (std::strcmp (name, "targetCandidates") == 0)
+            targetCandidates = number;
+        else if (std::strcmp (name, "separationRadius") == 0)
+            parameters.separationRadius = number;
+        else if (std::strcmp (name, "separationAngle") == 0)
+            parameters.separationAngle = number;
+        else if (std::strcmp (name, "separationWeight") == 0)
+            parameters.separationWeight = number;
+        else if (std::strcmp (name, "alignmentRadius") == 0)
+            parameters.alignmentRadius = number;
+        else if (std::strcmp (name, "alignmentAngle") == 0)
+            parameters.alignmentAngle = number;
+        else if (std::strcmp (name, "alignmentWeight") == 0)
+            parameters.alignmentWeight = number;
+        else if (std::strcmp (name, "cohesionRadius") == 0)
+            parameters.cohesionRadius = number;
+        else if (std::strcmp (name, "cohesionAngle") == 0)
+            parameters.cohesionAngle = number;
+        else if (std::strcmp (name, "cohesionWeight") == 0)
+            parameters.cohesionWeight = number;
+        else
+            return false;
+        return true;
+    }
+
+
+    void BoidsWorld::open (void)
+    {
+        // make the database used to accelerate proximity queries
+        cyclePD = initialPD - 1;
+        nextPD ();
+
+        // make default-sized flock
+        population = 0;
+        for (int i = 0; i < startPopulation; i++) addBoidToFlock ();
+
+        // set up obstacles
+        initObstacles ();
+    }
+
+
+    void BoidsWorld::update (const float currentTime, const float elapsedTime)
+    {
+        resetNeighborStatistics ();
+
+        // update flock simulation for each boid
+        for (iterator i = flock.begin(); i != flock.end(); i++)
+        {
+            (**i).update (currentTime, elapsedTime);
+        }
+
+        updateMetrics ();
+    }
+
+
+    void BoidsWorld::updateLevelOfDetail (LevelOfDetailScheduler& scheduler,
+                                          const float currentTime,
+                                          const float elapsedTime)
+    {
+        resetNeighborStatistics ();
+        scheduler.update (allVehicles (), currentTime, elapsedTime);
+        updateMetrics ();
+    }
+
+
+    void BoidsWorld::updateMetrics (void)
+    {
+        if (metrics == NULL) return;
+        metrics->neighborCounts.flush ();
+        updateCount++;
+
+        typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+        LQPDAV* lqpd = dynamic_cast<LQPDAV*> (pd);
+        if (lqpd == NULL) return;
+
+        const Vec3 d = lqpd->getDivisions ();
+        metrics->lqBins.set (d.x * d.y * d.z);
+        if (lqpd->adaptiveResolution ())
+            metrics->lqCandidates.set (lqpd->getAverageCandidates ());
+
+    #ifndef NO_LQ_BIN_STATS
+        // bin statistics visit every bin, and would complete a resize:
+        // only now and then, and not while the database is resizing
+        if (((updateCount % 60) == 0) && (population > 0) &&
+            !lqpd->resizeInProgress ())
+        {
+            int min, max; float average;
+            lqpd->getBinPopulationStats (min, max, average);
+            metrics->lqBinPopulationMax.set (max);
+            metrics->lqBinPopulationMean.set (average);
+        }
+    #endif // NO_LQ_BIN_STATS
+    }
+
+
+    void BoidsWorld::close (void)
+    {
+        // delete each member of the flock
+        while (population > 0) removeBoidFromFlock ();
+
+        // delete the proximity database
+        delete pd;
+        pd = NULL;
+    }
+
+
+    void BoidsWorld::printStatistics (std::ostream& os)
+    {
+        // average speed, and how well the flock is aligned: the length of
+        // the average forward direction (1 when all boids head the same way)
+        float speed = 0;
+        Vec3 heading;
+        for (iterator i = flock.begin(); i != flock.end(); i++)
+        {
+            speed += (**i).speed ();
+            heading += (**i).forward ();
+        }
+        const float count = maxXXX (1.0f, (float) population);
 
+        os << "boids:               " << population << std::endl
+           << "mean speed:          " << speed / count << std::endl
+           << "polarization:        " << heading.length () / count << std::endl;
     #ifndef NO_LQ_BIN_STATS
-            static size_t minNeighbors, maxNeighbors, totalNeighbors;
+        os << "mean neighbors:      " << totalNeighbors / count << std::endl;
     #endif // NO_LQ_BIN_STATS
-    };
+
+        // resolution the adaptive LQ database settled on
+        typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+        LQPDAV* lqpd = dynamic_cast<LQPDAV*> (pd);
+        if (lqpd && lqpd->adaptiveResolution ())
+        {
+            const Vec3 d = lqpd->getDivisions ();
+            os << "lq divisions:        " << (int) d.x << 'x' << (int) d.y
+               << 'x' << (int) d.z << std::endl
+               << "lq candidates:       " << lqpd->getAverageCandidates ()
+               << " per query" << std::endl
+               << "lq regrids:          " << lqpd->getResolutionChanges ()
+               << std::endl;
+        }
+    }
+
+
+    void BoidsWorld::addBoidToFlock (void)
+    {
+        population++;
+        flock.push_back (new Boid (*this));
+    }
+
+
+    void BoidsWorld::removeBoidFromFlock (void)
+    {
+        if (population > 0)
+        {
+            // save a pointer to the last boid, then remove it from the flock
+            const Boid* boid = flock.back();
+            flock.pop_back();
+            population--;
+
+            // delete the Boid
+            delete boid;
+        }
+    }
 
 
-    AVGroup Boid::neighbors;
-    float Boid::worldRadius = 50.0f;
-    ObstacleGroup Boid::obstacles;
+    void BoidsWorld::nextPD (void)
+    {
+        // save pointer to old PD
+        ProximityDatabase* oldPD = pd;
+
+        // allocate new PD
+        const int totalPD = 2;
+        switch (cyclePD = (cyclePD + 1) % totalPD)
+        {
+        case 0:
+            {
+                const Vec3 center;
+                const float div = 10.0f;
+                const Vec3 divisions (div, div, div);
+                const float diameter = worldRadius * 1.1f * 2;
+                const Vec3 dimensions (diameter, diameter, diameter);
+                typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+                LQPDAV* lqpd = new LQPDAV (center, dimensions, divisions);
+                if (targetCandidates > 0)
+                    lqpd->setAdaptiveResolution (targetCandidates);
+                pd = lqpd;
+                break;
+            }
+        case 1:
+            {
+                pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
+                break;
+            }
+        }
+
+        // switch each boid to new PD
+        for (iterator i=flock.begin(); i!=flock.end(); i++) (**i).newPD(*pd);
+
+        // delete old PD (if any)
+        delete oldPD;
+    }
+
+
+    void BoidsWorld::resetNeighborStatistics (void)
+    {
     #ifndef NO_LQ_BIN_STATS
-    size_t Boid::minNeighbors, Boid::maxNeighbors, Boid::totalNeighbors;
+        maxNeighbors = totalNeighbors = 0;
+        minNeighbors = std::numeric_limits<int>::max();
     #endif // NO_LQ_BIN_STATS
+    }
+
+
+    void BoidsWorld::initObstacles (void)
+    {
+        constraint = none;
+
+        insideBigSphere.radius = worldRadius;
+        insideBigSphere.setSeenFrom (Obstacle::inside);
+
+        outsideSphere0.radius = worldRadius * 0.5f;
+
+        const float r = worldRadius * 0.33f;
+        outsideSphere1.radius = r;
+        outsideSphere2.radius = r;
+        outsideSphere3.radius = r;
+        outsideSphere4.radius = r;
+        outsideSphere5.radius = r;
+        outsideSphere6.radius = r;
+
+        const float p = worldRadius * 0.5f;
+        const float m = -p;
+        const float z = 0.0f;
+        outsideSphere1.center.set (p, z, z);
+        outsideSphere2.center.set (m, z, z);
+        outsideSphere3.center.set (z, p, z);
+        outsideSphere4.center.set (z, m, z);
+        outsideSphere5.center.set (z, z, p);
+        outsideSphere6.center.set (z, z, m);
+
+        const Vec3 tiltF = Vec3 (1.0f, 1.0f, 0.0f).normalize ();
+        const Vec3 tiltS (0.0f, 0.0f, 1.0f);
+        const Vec3 tiltU = Vec3 (-1.0f, 1.0f, 0.0f).normalize ();
+
+        bigRectangle.width = 50.0f;
+        bigRectangle.height = 80.0f;
+        bigRectangle.setSeenFrom (Obstacle::both);
+        bigRectangle.setForward (tiltF);
+        bigRectangle.setSide (tiltS);
+        bigRectangle.setUp (tiltU);
+
+        outsideBigBox.width = 50.0f;
+        outsideBigBox.height = 80.0f;
+        outsideBigBox.depth = 20.0f;
+        outsideBigBox.setForward (tiltF);
+        outsideBigBox.setSide (tiltS);
+        outsideBigBox.setUp (tiltU);
+
+        insideBigBox = outsideBigBox;
+        insideBigBox.setSeenFrom (Obstacle::inside);
+
+        updateObstacles ();
+    }
+
+
+    void BoidsWorld::nextBoundaryCondition (void)
+    {
+        constraint = (ConstraintType) ((int) constraint + 1);
+        updateObstacles ();
+    }
+
+
+    void BoidsWorld::updateObstacles (void)
+    {
+        // first clear out obstacle list
+        obstacles.clear ();
+
+        // add back obstacles based on mode
+        switch (constraint)
+        {
+        default:
+            // reset for wrap-around, fall through to first case:
+            constraint = none;
+        case none:
+            break;
+        case insideSphere:
+            obstacles.push_back (&insideBigSphere);
+            break;
+        case outsideSphere:
+            obstacles.push_back (&insideBigSphere);
+            obstacles.push_back (&outsideSphere0);
+            break;
+        case outsideSpheres:
+            obstacles.push_back (&insideBigSphere);
+        case outsideSpheresNoBig:
+            obstacles.push_back (&outsideSphere1);
+            obstacles.push_back (&outsideSphere2);
+            obstacles.push_back (&outsideSphere3);
+            obstacles.push_back (&outsideSphere4);
+            obstacles.push_back (&outsideSphere5);
+            obstacles.push_back (&outsideSphere6);
+            break;
+        case rectangle:
+            obstacles.push_back (&insideBigSphere);
+            obstacles.push_back (&bigRectangle);
+        case rectangleNoBig:
+            obstacles.push_back (&bigRectangle);
+            break;
+        case outsideBox:
+            obstacles.push_back (&insideBigSphere);
+            obstacles.push_back (&outsideBigBox);
+            break;
+        case insideBox:
+            obstacles.push_back (&insideBigBox);
+            break;
+        }
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -337,17 +944,40 @@ namespace {
 
         float selectionOrderSortKey (void) {return 0.03f;}
 
+        BoidsPlugIn (void)
+            : world (&MetricsRegistry::global ()),
+              useLevelOfDetail (false),
+              levelOfDetailWasActive (false),
+              megaflockSize (0),
+              decimateDrawing (true),
+              megaflockSeconds (0),
+              megaflockUpdates (0)
+        {}
+
         virtual ~BoidsPlugIn() {} // be more "nice" to avoid a compiler warning
 
         void open (void)
         {
-            // make the database used to accelerate proximity queries
-            cyclePD = -1;
-            nextPD ();
+            if (megaflockSize > 0)
+            {
+                openMegaflock ();
+                return;
+            }
+
+            // make the flock, its proximity database and obstacles
+            world.open ();
+            OpenSteerDemo::selectedVehicle = world.flock.front ();
+
+            // boids far from the camera are updated less often when
+            // level of detail scheduling is enabled
+            lodMetric.setFullDetailDistance (15);
+            lodScheduler.setImportanceMetric (&lodMetric);
+            lodScheduler.reset ();
 
-            // make default-sized flock
-            population = 0;
-            for (int i = 0; i < 200; i++) addBoidToFlock ();
+            // when frames take too long the frame budget may cap neighbors
+            // and update distant boids less often
+            OpenSteerDemo::frameBudget.setSupported (FrameBudget::neighborCapKnob, true);
+            OpenSteerDemo::frameBudget.setSupported (FrameBudget::distantUpdatesKnob, true);
 
             // initialize camera
             OpenSteerDemo::init3dCamera (*OpenSteerDemo::selectedVehicle);
@@ -357,27 +987,56 @@ namespace {
             OpenSteerDemo::camera.lookdownDistance = 20;
             OpenSteerDemo::camera.aimLeadTime = 0.5;
             OpenSteerDemo::camera.povOffset.set (0, 0.5, -2);
-
-            // set up obstacles
-            initObstacles ();
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
-    #ifndef NO_LQ_BIN_STATS
-            Boid::maxNeighbors = Boid::totalNeighbors = 0;
-            Boid::minNeighbors = std::numeric_limits<int>::max();
-    #endif // NO_LQ_BIN_STATS
+            // pass the neighbor cap of the frame budget on to the flock
+            world.neighborCap = OpenSteerDemo::frameBudget.neighborCap ();
 
-            // update flock simulation for each boid
-            for (iterator i = flock.begin(); i != flock.end(); i++)
+            if (megaflockSize > 0)
+            {
+                const Stopwatch stopwatch;
+                megaflock.update (elapsedTime);
+                megaflockSeconds += stopwatch.elapsedSeconds ();
+                megaflockUpdates += megaflock.size ();
+            }
+            else if (levelOfDetailActive ())
             {
-                (**i).update (currentTime, elapsedTime);
+                // update only the boids due this frame, distant ones get
+                // the time accumulated since their last update
+                lodMetric.setObserverPosition (OpenSteerDemo::camera.position ());
+                lodMetric.setFullDetailDistance
+                    (15 * OpenSteerDemo::frameBudget.fullDetailScale ());
+                world.updateLevelOfDetail (lodScheduler, currentTime, elapsedTime);
             }
+            else
+            {
+                // update flock simulation for each boid
+                world.update (currentTime, elapsedTime);
+            }
+        }
+
+        // level of detail scheduling is on when toggled by F6 or while the
+        // frame budget reduces distant updates, it starts over with every
+        // boid on the full detail level when switched on
+        bool levelOfDetailActive (void)
+        {
+            const bool active = (useLevelOfDetail ||
+                                 OpenSteerDemo::frameBudget.reduceDistantUpdates ());
+            if (active && !levelOfDetailWasActive) lodScheduler.reset ();
+            levelOfDetailWasActive = active;
+            return active;
         }
 
         void redraw (const float currentTime, const float elapsedTime)
         {
+            if (megaflockSize > 0)
+            {
+                redrawMegaflock (currentTime, elapsedTime);
+                return;
+            }
+
             // selected vehicle (user can mouse click to select another)
             AbstractVehicle& selected = *OpenSteerDemo::selectedVehicle;
 
@@ -388,7 +1047,7 @@ namespace {
             OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
 
             // draw each boid in flock
-            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).draw ();
+            for (iterator i = world.flock.begin(); i != world.flock.end(); i++) (**i).draw ();
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::drawCircleHighlightOnVehicle (nearMouse, 1, gGray70);
@@ -398,35 +1057,47 @@ namespace {
 
             // display status in the upper left corner of the window
             std::ostringstream status;
-            status << "[F1/F2] " << population << " boids";
+            status << "[F1/F2] " << world.population << " boids";
             status << "\n[F3]    PD type: ";
-            switch (cyclePD)
+            switch (world.cyclePD)
             {
             case 0: status << "LQ bin lattice"; break;
             case 1: status << "brute force";    break;
             }
             status << "\n[F4]    Obstacles: ";
-            switch (constraint)
+            switch (world.constraint)
             {
-            case none:
+            case BoidsWorld::none:
                 status << "none (wrap-around at sphere boundary)" ; break;
-            case insideSphere:
+            case BoidsWorld::insideSphere:
                 status << "inside a sphere" ; break;
-            case outsideSphere:
+            case BoidsWorld::outsideSphere:
                 status << "inside a sphere, outside another" ; break;
-            case outsideSpheres:
+            case BoidsWorld::outsideSpheres:
                 status << "inside a sphere, outside several" ; break;
-            case outsideSpheresNoBig:
+            case BoidsWorld::outsideSpheresNoBig:
                 status << "outside several spheres, with wrap-around" ; break;
-            case rectangle:
+            case BoidsWorld::rectangle:
                 status << "inside a sphere, with a rectangle" ; break;
-            case rectangleNoBig:
+            case BoidsWorld::rectangleNoBig:
                 status << "a rectangle, with wrap-around" ; break;
-            case outsideBox:
+            case BoidsWorld::outsideBox:
                 status << "inside a sphere, outside a box" ; break;
-            case insideBox:
+            case BoidsWorld::insideBox:
                 status << "inside a box" ; break;
             }
+            status << "\n[F6]    Level of detail: ";
+            if (levelOfDetailWasActive)
+            {
+                status << lodScheduler.updatedVehicleCount ()
+                       << " updated, per level:";
+                for (size_t level = 0; level < lodScheduler.levelCount (); level++)
+                    status << " " << lodScheduler.vehicleCountOnLevel (level);
+            }
+            else
+            {
+                status << "off";
+            }
             status << std::endl;
             const float h = drawGetWindowHeight ();
             const Vec3 screenLocation (10, h-50, 0);
@@ -437,18 +1108,26 @@ namespace {
 
         void close (void)
         {
-            // delete each member of the flock
-            while (population > 0) removeBoidFromFlock ();
-
-            // delete the proximity database
-            delete pd;
-            pd = NULL;
+            // delete the flock and its proximity database
+            OpenSteerDemo::selectedVehicle = NULL;
+            if (megaflockSize > 0)
+                megaflock.clear ();
+            else
+                world.close ();
         }
 
         void reset (void)
         {
+            // start the megaflock over at random positions
+            if (megaflockSize > 0)
+            {
+                close ();
+                open ();
+                return;
+            }
+
             // reset each boid in flock
-            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).reset();
+            for (iterator i = world.flock.begin(); i != world.flock.end(); i++) (**i).reset();
 
             // reset camera position
             OpenSteerDemo::position3dCamera (*OpenSteerDemo::selectedVehicle);
@@ -457,52 +1136,21 @@ namespace {
             OpenSteerDemo::camera.doNotSmoothNextMove ();
         }
 
-        // for purposes of demonstration, allow cycling through various
-        // types of proximity databases.  this routine is called when the
-        // OpenSteerDemo user pushes a function key.
-        void nextPD (void)
-        {
-            // save pointer to old PD
-            ProximityDatabase* oldPD = pd;
-
-            // allocate new PD
-            const int totalPD = 2;
-            switch (cyclePD = (cyclePD + 1) % totalPD)
-            {
-            case 0:
-                {
-                    const Vec3 center;
-                    const float div = 10.0f;
-                    const Vec3 divisions (div, div, div);
-                    const float diameter = Boid::worldRadius * 1.1f * 2;
-                    const Vec3 dimensions (diameter, diameter, diameter);
-                    typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
-                    pd = new LQPDAV (center, dimensions, divisions);
-                    break;
-                }
-            case 1:
-                {
-                    pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
-                    break;
-                }
-            }
-
-            // switch each boid to new PD
-            for (iterator i=flock.begin(); i!=flock.end(); i++) (**i).newPD(*pd);
-
-            // delete old PD (if any)
-            delete oldPD;
-        }
-
         void handleFunctionKeys (int keyNumber)
         {
+            // the megaflock has no flock to edit, obstacles or level of detail
+            if ((megaflockSize > 0) && (keyNumber < 7)) return;
+
             switch (keyNumber)
             {
-            case 1:  addBoidToFlock ();         break;
-            case 2:  removeBoidFromFlock ();    break;
-            case 3:  nextPD ();                 break;
-            case 4:  nextBoundaryCondition ();  break;
-            case 5:  printLQbinStats ();        break;
+            case 1:  addBoidToFlock ();               break;
+            case 2:  removeBoidFromFlock ();          break;
+            case 3:  world.nextPD ();                 break;
+            case 4:  world.nextBoundaryCondition ();  break;
+            case 5:  printLQbinStats ();              break;
+            case 6:  toggleLevelOfDetail ();          break;
+            case 7:  nextMegaflockSize ();            break;
+            case 8:  decimateDrawing = !decimateDrawing; break;
             }
         }
 
@@ -510,7 +1158,7 @@ namespace {
         {
     #ifndef NO_LQ_BIN_STATS
             int min, max; float average;
-            Boid& aBoid = **(flock.begin());
+            Boid& aBoid = **(world.flock.begin());
             aBoid.proximityToken->getBinPopulationStats (min, max, average);
             std::cout << std::setprecision (2)
                       << std::setiosflags (std::ios::fixed);
@@ -518,10 +1166,33 @@ namespace {
                       << min << ", " << max << ", " << average
                       << " (non-empty bins)" << std::endl; 
             std::cout << "Boid neighbors:  min, max, average: "
-                      << Boid::minNeighbors << ", "
-                      << Boid::maxNeighbors << ", "
-                      << ((float)Boid::totalNeighbors) / ((float)population)
+                      << world.minNeighbors << ", "
+                      << world.maxNeighbors << ", "
+                      << ((float)world.totalNeighbors) / ((float)world.population)
                       << std::endl;
+
+            typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+            LQPDAV* lqpd = dynamic_cast<LQPDAV*> (world.pd);
+            if (lqpd)
+            {
+                const Vec3 d = lqpd->getDivisions ();
+                std::vector<int> histogram (8);
+                lqpd->getBinPopulationHistogram (histogram);
+                std::cout << "Bins per population 0.." << histogram.size() - 1
+                          << "+:";
+                for (size_t i = 0; i < histogram.size(); i++)
+                    std::cout << ' ' << histogram[i];
+                std::cout << std::endl
+                          << "Divisions: " << (int) d.x << 'x' << (int) d.y
+                          << 'x' << (int) d.z;
+                if (lqpd->adaptiveResolution ())
+                    std::cout << " (adaptive, "
+                              << lqpd->getAverageCandidates ()
+                              << " candidates per query, "
+                              << lqpd->getResolutionChanges ()
+                              << " changes)";
+                std::cout << std::endl;
+            }
     #endif // NO_LQ_BIN_STATS
         }
      
@@ -535,256 +1206,250 @@ namespace {
             OpenSteerDemo::printMessage ("  F2     remove a boid from the flock.");
             OpenSteerDemo::printMessage ("  F3     use next proximity database.");
             OpenSteerDemo::printMessage ("  F4     next flock boundary condition.");
+            OpenSteerDemo::printMessage ("  F5     print proximity database statistics.");
+            OpenSteerDemo::printMessage ("  F6     toggle level of detail scheduling.");
+            OpenSteerDemo::printMessage ("  F7     next megaflock size (off, 100k, 1M).");
+            OpenSteerDemo::printMessage ("  F8     toggle drawing only a sample of the megaflock.");
             OpenSteerDemo::printMessage ("");
         }
 
-        void addBoidToFlock (void)
+        // options and statistics of headless runs are those of the world
+        // "megaflock" sets the size of the megaflock (0 for the normal flock)
+        bool setOption (const char* name, const char* value)
         {
-            population++;
-            Boid* boid = new Boid (*pd);
-            flock.push_back (boid);
-            if (population == 1) OpenSteerDemo::selectedVehicle = boid;
+            if (std::strcmp (name, "megaflock") != 0)
+                return world.setOption (name, value);
+
+            megaflockSize = std::max (0, std::atoi (value));
+            return true;
         }
 
-        void removeBoidFromFlock (void)
+        void printStatistics (std::ostream& os)
         {
-            if (population > 0)
+            if (megaflockSize == 0)
             {
-                // save a pointer to the last boid, then remove it from the flock
-                const Boid* boid = flock.back();
-                flock.pop_back();
-                population--;
-
-                // if it is OpenSteerDemo's selected vehicle, unselect it
-                if (boid == OpenSteerDemo::selectedVehicle)
-                    OpenSteerDemo::selectedVehicle = NULL;
-
-                // delete the Boid
-                delete boid;
+                world.printStatistics (os);
+                return;
             }
-        }
 
-        // return an AVGroup containing each boid of the flock
-        const AVGroup& allVehicles (void) {return (const AVGroup&)flock;}
-
-        // flock: a group (STL vector) of pointers to all boids
-        Boid::groupType flock;
-        typedef Boid::groupType::const_iterator iterator;
-
-        // pointer to database used to accelerate proximity queries
-        ProximityDatabase* pd;
-
-        // keep track of current flock size
-        int population;
-
-        // which of the various proximity databases is currently in use
-        int cyclePD;
+            Vec3 heading;
+            for (size_t i = 0; i < megaflock.size (); i++)
+                heading += megaflock.forward (i);
+            const float count = maxXXX (1.0f, (float) megaflock.size ());
+
+            os << "boids:               " << megaflock.size () << std::endl
+               << "grid cells:          " << megaflock.cellCount () << std::endl
+               << "mean neighbors:      " << megaflock.neighborCount () / count
+               << std::endl
+               << "polarization:        " << heading.length () / count << std::endl
+               << "boid updates/s:      ";
+            // no updates timed yet, e.g. when run for zero frames
+            if (megaflockSeconds > 0)
+                os << megaflockUpdates / megaflockSeconds << std::endl;
+            else
+                os << "n/a" << std::endl;
+        }
 
-        // --------------------------------------------------------
-        // the rest of this plug-in supports the various obstacles:
-        // --------------------------------------------------------
+        // any number of flocks can be run in batches
+        AbstractWorld* makeWorld (void) {return new BoidsWorld;}
 
-        // enumerate demos of various constraints on the flock
-        enum ConstraintType {none, insideSphere,
-                             outsideSphere, outsideSpheres, outsideSpheresNoBig,
-                             rectangle, rectangleNoBig,
-                             outsideBox, insideBox};
+        void toggleLevelOfDetail (void)
+        {
+            useLevelOfDetail = !useLevelOfDetail;
 
-        ConstraintType constraint;
+            // start over with every boid on the full detail level
+            lodScheduler.reset ();
+        }
 
-        // select next "boundary condition / constraint / obstacle"
-        void nextBoundaryCondition (void)
+        void addBoidToFlock (void)
         {
-            constraint = (ConstraintType) ((int) constraint + 1);
-            updateObstacles ();
+            world.addBoidToFlock ();
+            if (world.population == 1)
+                OpenSteerDemo::selectedVehicle = world.flock.back ();
         }
 
-        class SO : public SphereObstacle
-        {void draw (const bool filled, const Color& color, const Vec3& vp) const
-            {drawSphereObstacle (*this, 10.0f, filled, color, vp);}};
-
-        class RO : public RectangleObstacle
-        {void draw (const bool, const Color& color, const Vec3&) const
-            {tempDrawRectangle (*this, color);}};
-
-        class BO : public BoxObstacle
-        {void draw (const bool, const Color& color, const Vec3&) const
-            {tempDrawBox (*this, color);}};
-
-        RO bigRectangle;
-        BO outsideBigBox, insideBigBox;
-        SO insideBigSphere, outsideSphere0, outsideSphere1, outsideSphere2,
-           outsideSphere3, outsideSphere4, outsideSphere5, outsideSphere6;
-
-
-        void initObstacles (void)
+        void removeBoidFromFlock (void)
         {
-            constraint = none;
-
-            insideBigSphere.radius = Boid::worldRadius;
-            insideBigSphere.setSeenFrom (Obstacle::inside);
-
-            outsideSphere0.radius = Boid::worldRadius * 0.5f;
-
-            const float r = Boid::worldRadius * 0.33f;
-            outsideSphere1.radius = r;
-            outsideSphere2.radius = r;
-            outsideSphere3.radius = r;
-            outsideSphere4.radius = r;
-            outsideSphere5.radius = r;
-            outsideSphere6.radius = r;
-
-            const float p = Boid::worldRadius * 0.5f;
-            const float m = -p;
-            const float z = 0.0f;
-            outsideSphere1.center.set (p, z, z);
-            outsideSphere2.center.set (m, z, z);
-            outsideSphere3.center.set (z, p, z);
-            outsideSphere4.center.set (z, m, z);
-            outsideSphere5.center.set (z, z, p);
-            outsideSphere6.center.set (z, z, m);
-
-            const Vec3 tiltF = Vec3 (1.0f, 1.0f, 0.0f).normalize ();
-            const Vec3 tiltS (0.0f, 0.0f, 1.0f);
-            const Vec3 tiltU = Vec3 (-1.0f, 1.0f, 0.0f).normalize ();
-
-            bigRectangle.width = 50.0f;
-            bigRectangle.height = 80.0f;
-            bigRectangle.setSeenFrom (Obstacle::both);
-            bigRectangle.setForward (tiltF);
-            bigRectangle.setSide (tiltS);
-            bigRectangle.setUp (tiltU);
+            // if the last boid is OpenSteerDemo's selected vehicle, unselect it
+            if ((world.population > 0) &&
+                (world.flock.back () == OpenSteerDemo::selectedVehicle))
+                OpenSteerDemo::selectedVehicle = NULL;
 
-            outsideBigBox.width = 50.0f;
-            outsideBigBox.height = 80.0f;
-            outsideBigBox.depth = 20.0f;
-            outsideBigBox.setForward (tiltF);
-            outsideBigBox.setSide (tiltS);
-            outsideBigBox.setUp (tiltU);
-
-            insideBigBox = outsideBigBox;
-            insideBigBox.setSeenFrom (Obstacle::inside);
+            world.removeBoidFromFlock ();
+        }
 
-            updateObstacles ();
+        // return an AVGroup containing each boid of the flock (the boids
+        // of the megaflock are no vehicles)
+        const AVGroup& allVehicles (void)
+        {
+            return (megaflockSize > 0) ? noVehicles : world.allVehicles ();
         }
 
+        // cycle through the megaflock sizes: off, 100k, 1M boids
+        void nextMegaflockSize (void)
+        {
+            close ();
+            switch (megaflockSize)
+            {
+            case 0:      megaflockSize = 100000;  break;
+            case 100000: megaflockSize = 1000000; break;
+            default:     megaflockSize = 0;       break;
+            }
+            open ();
+        }
 
-        // update Boid::obstacles list when constraint changes
-        void updateObstacles (void)
+        void openMegaflock (void)
         {
-            // first clear out obstacle list
-            Boid::obstacles.clear ();
+            // the world grows with the flock, so that a boid has about 8
+            // others within cohesion radius when they are spread evenly
+            const FlockingParameters& p = world.parameters;
+            Megaflock::Parameters parameters;
+            parameters.separationRadius = p.separationRadius;
+            parameters.separationAngle = p.separationAngle;
+            parameters.separationWeight = p.separationWeight;
+            parameters.alignmentRadius = p.alignmentRadius;
+            parameters.alignmentAngle = p.alignmentAngle;
+            parameters.alignmentWeight = p.alignmentWeight;
+            parameters.cohesionRadius = p.cohesionRadius;
+            parameters.cohesionAngle = p.cohesionAngle;
+            parameters.cohesionWeight = p.cohesionWeight;
+            parameters.worldRadius = maxXXX (world.worldRadius,
+                                             p.cohesionRadius * powf (megaflockSize / 8.0f, 1.0f / 3.0f));
+            megaflock.setParameters (parameters);
+
+            // all boids are allocated in one go
+            megaflock.clear ();
+            megaflock.spawn (megaflockSize, parameters.worldRadius);
+            megaflockSeconds = 0;
+            megaflockUpdates = 0;
+
+            // look at the whole flock from outside
+            const float r = parameters.worldRadius;
+            OpenSteerDemo::selectedVehicle = NULL;
+            OpenSteerDemo::camera.mode = Camera::cmFixed;
+            OpenSteerDemo::camera.fixedTarget = Vec3::zero;
+            OpenSteerDemo::camera.fixedPosition.set (r * 1.5f, r, r * 1.5f);
+            OpenSteerDemo::camera.doNotSmoothNextMove ();
+        }
 
-            // add back obstacles based on mode
-            switch (constraint)
+        void redrawMegaflock (const float currentTime, const float elapsedTime)
+        {
+            // update camera (there is no vehicle to track)
+            OpenSteerDemo::camera.vehicleToTrack = NULL;
+            OpenSteerDemo::camera.update (currentTime, elapsedTime,
+                                          OpenSteerDemo::clock.getPausedState ());
+
+            // draw each boid as a short line along its heading, or only
+            // every n-th boid so that no more than drawLimit are drawn
+            const size_t drawLimit = 10000;
+            const size_t stride = (decimateDrawing ?
+                                   (megaflock.size () + drawLimit - 1) / drawLimit :
+                                   1);
+            size_t drawn = 0;
+            for (size_t i = 0; i < megaflock.size (); i += stride, drawn++)
             {
-            default:
-                // reset for wrap-around, fall through to first case:
-                constraint = none;
-            case none:
-                break;
-            case insideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
-                break;
-            case outsideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideSphere0);
-                break;
-            case outsideSpheres:
-                Boid::obstacles.push_back (&insideBigSphere);
-            case outsideSpheresNoBig:
-                Boid::obstacles.push_back (&outsideSphere1);
-                Boid::obstacles.push_back (&outsideSphere2);
-                Boid::obstacles.push_back (&outsideSphere3);
-                Boid::obstacles.push_back (&outsideSphere4);
-                Boid::obstacles.push_back (&outsideSphere5);
-                Boid::obstacles.push_back (&outsideSphere6);
-                break;
-            case rectangle:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&bigRectangle);
-            case rectangleNoBig:
-                Boid::obstacles.push_back (&bigRectangle);
-                break;
-            case outsideBox:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideBigBox);
-                break;
-            case insideBox:
-                Boid::obstacles.push_back (&insideBigBox);
-                break;
+                const Vec3 position = megaflock.position (i);
+                drawLine (position, position - megaflock.forward (i), gGray70);
             }
+
+            // display status in the upper left corner of the window
+            std::ostringstream status;
+            status << "[F7]    Megaflock: " << megaflock.size () << " boids";
+            status << "\n[F8]    Drawing: " << drawn << " boids";
+            if (decimateDrawing) status << " (sample)";
+            status << std::endl;
+            const float h = drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            draw2dTextAt2dLocation (status, screenLocation, gGray80, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
+        // the flock shown by the demo, the only one exporting metrics
+        BoidsWorld world;
+        typedef BoidsWorld::iterator iterator;
+
+        // update distant boids less often (toggled by F6)
+        bool useLevelOfDetail;
+        bool levelOfDetailWasActive;
+        ObserverDistanceImportanceMetric lodMetric;
+        LevelOfDetailScheduler lodScheduler;
+
+        // boids of the megaflock (when megaflockSize is not 0)
+        int megaflockSize;
+        Megaflock megaflock;
+        AVGroup noVehicles;
+        bool decimateDrawing;
+
+        // time spent in and boids moved by the megaflock's update
+        double megaflockSeconds;
+        double megaflockUpdates;
 
         void drawObstacles (void)
         {
-            for (ObstacleIterator o = Boid::obstacles.begin();
-                 o != Boid::obstacles.end();
+            for (ObstacleIterator o = world.obstacles.begin();
+                 o != world.obstacles.end();
                  o++)
             {
                 (**o).draw (false, // draw in wireframe
-                            ((*o == &insideBigSphere) ?
+                            ((*o == &world.insideBigSphere) ?
                              Color (0.2f, 0.2f, 0.4f) :
                              Color (0.1f, 0.1f, 0.2f)),
                             OpenSteerDemo::camera.position ());
             }
         }
+    };
 
 
-        static void tempDrawRectangle (const RectangleObstacle& rect, const Color& color)
-        {
-            float w = rect.width / 2;
-            float h = rect.height / 2;
-
-            Vec3 v1 = rect.globalizePosition (Vec3 ( w,  h, 0));
-            Vec3 v2 = rect.globalizePosition (Vec3 (-w,  h, 0));
-            Vec3 v3 = rect.globalizePosition (Vec3 (-w, -h, 0));
-            Vec3 v4 = rect.globalizePosition (Vec3 ( w, -h, 0));
-
-            drawLine (v1, v2, color);
-            drawLine (v2, v3, color);
-            drawLine (v3, v4, color);
-            drawLine (v4, v1, color);
-        }
-
+    // ----------------------------------------------------------------------------
 
-        static void tempDrawBox (const BoxObstacle& box, const Color& color)
-        {
-            const float w = box.width / 2;
-            const float h = box.height / 2;
-            const float d = box.depth / 2;
-            const Vec3 p = box.position ();
-            const Vec3 s = box.side ();
-            const Vec3 u = box.up ();
-            const Vec3 f = box.forward ();
 
-            const Vec3 v1 = box.globalizePosition (Vec3 ( w,  h,  d));
-            const Vec3 v2 = box.globalizePosition (Vec3 (-w,  h,  d));
-            const Vec3 v3 = box.globalizePosition (Vec3 (-w, -h,  d));
-            const Vec3 v4 = box.globalizePosition (Vec3 ( w, -h,  d));
+    void tempDrawRectangle (const RectangleObstacle& rect, const Color& color)
+    {
+        float w = rect.width / 2;
+        float h = rect.height / 2;
 
-            const Vec3 v5 = box.globalizePosition (Vec3 ( w,  h, -d));
-            const Vec3 v6 = box.globalizePosition (Vec3 (-w,  h, -d));
-            const Vec3 v7 = box.globalizePosition (Vec3 (-w, -h, -d));
-            const Vec3 v8 = box.globalizePosition (Vec3 ( w, -h, -d));
+        Vec3 v1 = rect.globalizePosition (Vec3 ( w,  h, 0));
+        Vec3 v2 = rect.globalizePosition (Vec3 (-w,  h, 0));
+        Vec3 v3 = rect.globalizePosition (Vec3 (-w, -h, 0));
+        Vec3 v4 = rect.globalizePosition (Vec3 ( w, -h, 0));
 
-            drawLine (v1, v2, color);
-            drawLine (v2, v3, color);
-            drawLine (v3, v4, color);
-            drawLine (v4, v1, color);
+        drawLine (v1, v2, color);
+        drawLine (v2, v3, color);
+        drawLine (v3, v4, color);
+        drawLine (v4, v1, color);
+    }
 
-            drawLine (v5, v6, color);
-            drawLine (v6, v7, color);
-            drawLine (v7, v8, color);
-            drawLine (v8, v5, color);
 
-            drawLine (v1, v5, color);
-            drawLine (v2, v6, color);
-            drawLine (v3, v7, color);
-            drawLine (v4, v8, color);
-        }
-    };
+    void tempDrawBox (const BoxObstacle& box, const Color& color)
+    {
+        const float w = box.width / 2;
+        const float h = box.height / 2;
+        const float d = box.depth / 2;
+
+        const Vec3 v1 = box.globalizePosition (Vec3 ( w,  h,  d));
+        const Vec3 v2 = box.globalizePosition (Vec3 (-w,  h,  d));
+        const Vec3 v3 = box.globalizePosition (Vec3 (-w, -h,  d));
+        const Vec3 v4 = box.globalizePosition (Vec3 ( w, -h,  d));
+
+        const Vec3 v5 = box.globalizePosition (Vec3 ( w,  h, -d));
+        const Vec3 v6 = box.globalizePosition (Vec3 (-w,  h, -d));
+        const Vec3 v7 = box.globalizePosition (Vec3 (-w, -h, -d));
+        const Vec3 v8 = box.globalizePosition (Vec3 ( w, -h, -d));
+
+        drawLine (v1, v2, color);
+        drawLine (v2, v3, color);
+        drawLine (v3, v4, color);
+        drawLine (v4, v1, color);
+
+        drawLine (v5, v6, color);
+        drawLine (v6, v7, color);
+        drawLine (v7, v8, color);
+        drawLine (v8, v5, color);
+
+        drawLine (v1, v5, color);
+        drawLine (v2, v6, color);
+        drawLine (v3, v7, color);
+        drawLine (v4, v8, color);
+    }
 
 
     BoidsPlugIn gBoidsPlugIn;
@@ -43,6 +43,12 @@
 // Note that the enemies do not make use of their knowledge of the 
 // seeker's goal by "guarding" it.  
 //
+// Any number of seekers and enemies can take part (F3 cycles through team
+// sizes, headless runs use the options "seekers" and "enemies").  Each team
+// is kept in its own proximity database: enemies pursue the nearest running
+// seeker, seekers look for enemies blocking their corridor to the goal or
+// close enough to evade.  The arena grows with the total population.
+//
 // XXX hmm, rename them "attacker" and "defender"?
 //
 // 08-12-02 cwr: created 
@@ -51,11 +57,15 @@
 // ----------------------------------------------------------------------------
 
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <string>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/Proximity.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -72,6 +82,13 @@ namespace {
     typedef SOG::const_iterator SOI;           // SphereObstacle iterator
 
 
+    // ----------------------------------------------------------------------------
+
+
+    typedef AbstractProximityDatabase<AbstractVehicle*> ProximityDatabase;
+    typedef AbstractTokenForProximityDatabase<AbstractVehicle*> ProximityToken;
+
+
     // ----------------------------------------------------------------------------
     // This PlugIn uses two vehicle types: CtfSeeker and CtfEnemy.  They have a
     // common base class: CtfBase which is a specialization of SimpleVehicle.
@@ -81,16 +98,27 @@ namespace {
     {
     public:
         // constructor
-        CtfBase () {reset ();}
+        CtfBase () : proximityToken (NULL) {reset ();}
+
+        // destructor
+        virtual ~CtfBase () {delete proximityToken;}
 
         // reset state
         void reset (void);
 
+        // switch to a new proximity database
+        void newPD (ProximityDatabase& pd)
+        {
+            delete proximityToken;
+            proximityToken = pd.allocateToken (this);
+            proximityToken->updateForNewPosition (position());
+        }
+
         // draw this character/vehicle into the scene
         void draw (void);
 
         // annotate when actively avoiding obstacles
-        void annotateAvoidObstacle (const float minDistanceToCollision);
+        void annotateAvoidObstacle (const float minDistanceToCollision) const;
 
         void drawHomeBase (void);
 
@@ -103,8 +131,16 @@ namespace {
         // xxx store steer sub-state for anotation
         bool avoiding;
 
+        // this vehicle's token in the proximity database of its team
+        ProximityToken* proximityToken;
+
+        // results of proximity queries (one vector per vehicle so teams can
+        // be updated in parallel)
+        AVGroup neighbors;
+
         // dynamic obstacle registry
         static void initializeObstacles (void);
+        static void clearObstacles (void);
         static void addOneObstacle (void);
         static void removeOneObstacle (void);
         float minDistanceToObstacle (const Vec3 point);
@@ -130,6 +166,12 @@ namespace {
         // is there a clear path to the goal?
         bool clearPathToGoal (void);
 
+        // find the enemies within radius of the given point
+        void findEnemies (const Vec3& center, const float radius);
+
+        // text describing the current state, for annotation
+        const char* stateDescription (void) const;
+
         Vec3 steeringForSeeker (void);
         void updateState (const float currentTime);
         void draw (void);
@@ -143,6 +185,9 @@ namespace {
         seekerState state;
         bool evading; // xxx store steer sub-state for anotation
         float lastRunningTime; // for auto-reset
+
+        // obstacle avoidance look ahead time
+        float avoidancePredictTime;
     };
 
 
@@ -158,6 +203,16 @@ namespace {
 
         // per frame simulation update
         void update (const float currentTime, const float elapsedTime);
+
+        // nearest seeker which is still running, NULL if there is none
+        CtfSeeker* nearestRunningSeeker (void);
+
+        // tag the seekers touched during the last update (called after all
+        // enemies are updated, the update itself only reads seeker state)
+        void tagTouchedSeekers (void);
+
+        // seekers touched during the last update
+        std::vector<CtfSeeker*> touchedSeekers;
     };
 
 
@@ -171,8 +226,19 @@ namespace {
     const Vec3 gHomeBaseCenter (0, 0, 0);
     const float gHomeBaseRadius = 1.5;
 
-    const float gMinStartRadius = 30;
-    const float gMaxStartRadius = 40;
+    // start radii for the default population of one seeker and four enemies,
+    // the arena grows with the total population to keep its density
+    const float gDefaultMinStartRadius = 30;
+    const float gDefaultMaxStartRadius = 40;
+    const int gDefaultPopulation = 5;
+    float gMinStartRadius = gDefaultMinStartRadius;
+    float gMaxStartRadius = gDefaultMaxStartRadius;
+
+    // enemies farther along the corridor to the goal do not block it
+    const float gClearPathLookAhead = 2 * gDefaultMaxStartRadius;
+
+    // seekers evade enemies within this distance
+    const float gEvadeRadius = 20;
 
     const float gBrakingRate = 0.75;
 
@@ -182,17 +248,17 @@ namespace {
 
     const float gAvoidancePredictTimeMin  = 0.9f;
     const float gAvoidancePredictTimeMax  = 2;
-    float gAvoidancePredictTime = gAvoidancePredictTimeMin;
 
     bool enableAttackSeek  = true; // for testing (perhaps retain for UI control?)
     bool enableAttackEvade = true; // for testing (perhaps retain for UI control?)
 
-    CtfSeeker* gSeeker = NULL;
-
-
     // count the number of times the simulation has reset (e.g. for overnight runs)
     int resetCount = 0;
 
+    // seekers tagged and seekers which reached the goal in all finished runs
+    int totalTaggedCount = 0;
+    int totalAtGoalCount = 0;
+
 
     // ----------------------------------------------------------------------------
     // state for OpenSteerDemo PlugIn
@@ -201,9 +267,17 @@ namespace {
     // XXX consider using STL (any advantage? consistency?)
 
 
-    CtfSeeker* ctfSeeker;
-    const int ctfEnemyCount = 4;
-    CtfEnemy* ctfEnemies [ctfEnemyCount];
+    int ctfSeekerCount = 1;
+    int ctfEnemyCount = 4;
+    std::vector<CtfSeeker*> ctfSeekers;
+    std::vector<CtfEnemy*> ctfEnemies;
+
+    // one proximity database per team, plus a token (never positioned) to
+    // query each of them
+    ProximityDatabase* ctfSeekerDatabase = NULL;
+    ProximityDatabase* ctfEnemyDatabase = NULL;
+    ProximityToken* ctfSeekerQuery = NULL;
+    ProximityToken* ctfEnemyQuery = NULL;
 
 
     // ----------------------------------------------------------------------------
@@ -230,9 +304,9 @@ namespace {
     {
         CtfBase::reset ();
         bodyColor.set (0.4f, 0.4f, 0.6f); // blueish
-        gSeeker = this;
         state = running;
         evading = false;
+        avoidancePredictTime = gAvoidancePredictTimeMin;
     }
 
 
@@ -285,19 +359,22 @@ namespace {
 
     void CtfEnemy::update (const float currentTime, const float elapsedTime)
     {
-        // determine upper bound for pursuit prediction time
-        const float seekerToGoalDist = Vec3::distance (gHomeBaseCenter,
-                                                       gSeeker->position());
-        const float adjustedDistance = seekerToGoalDist - radius()-gHomeBaseRadius;
-        const float seekerToGoalTime = ((adjustedDistance < 0 ) ?
-                                        0 :
-                                        (adjustedDistance/gSeeker->speed()));
-        const float maxPredictionTime = seekerToGoalTime * 0.9f;
+        // pursue the nearest seeker which is still running
+        CtfSeeker* seeker = nearestRunningSeeker ();
 
         // determine steering (pursuit, obstacle avoidance, or braking)
         Vec3 steer (0, 0, 0);
-        if (gSeeker->state == running)
+        if (seeker)
         {
+            // determine upper bound for pursuit prediction time
+            const float seekerToGoalDist = Vec3::distance (gHomeBaseCenter,
+                                                           seeker->position());
+            const float adjustedDistance = seekerToGoalDist - radius()-gHomeBaseRadius;
+            const float seekerToGoalTime = ((adjustedDistance < 0 ) ?
+                                            0 :
+                                            (adjustedDistance/seeker->speed()));
+            const float maxPredictionTime = seekerToGoalTime * 0.9f;
+
             const Vec3 avoidance =
                 steerToAvoidObstacles (gAvoidancePredictTimeMin,
                                        (ObstacleGroup&) allObstacles);
@@ -306,7 +383,7 @@ namespace {
             avoiding = (avoidance == Vec3::zero);
 
             if (avoiding)
-                steer = steerForPursuit (*gSeeker, maxPredictionTime);
+                steer = steerForPursuit (*seeker, maxPredictionTime);
             else
                 steer = avoidance;
         }
@@ -321,20 +398,68 @@ namespace {
         recordTrailVertex (currentTime, position());
 
 
-        // detect and record interceptions ("tags") of seeker
-        const float seekerToMeDist = Vec3::distance (position(), 
-                                                     gSeeker->position());
-        const float sumOfRadii = radius() + gSeeker->radius();
-        if (seekerToMeDist < sumOfRadii)
+        // detect interceptions ("tags") of seekers, they are recorded after
+        // all enemies are updated
+        touchedSeekers.clear ();
+        neighbors.clear ();
+        ctfSeekerQuery->findNeighbors (position(), radius() * 4, neighbors);
+        for (AVIterator i = neighbors.begin(); i != neighbors.end(); i++)
+        {
+            CtfSeeker& s = *static_cast<CtfSeeker*> (*i);
+            const float seekerToMeDist = Vec3::distance (position(), s.position());
+            const float sumOfRadii = radius() + s.radius();
+            if (seekerToMeDist < sumOfRadii) touchedSeekers.push_back (&s);
+        }
+    }
+
+
+    // ----------------------------------------------------------------------------
+    // search for running seekers in growing circles, up to the arena size
+
+
+    CtfSeeker* CtfEnemy::nearestRunningSeeker (void)
+    {
+        const float maxSearchRadius = gMaxStartRadius * 4;
+        for (float searchRadius = 10; ; searchRadius *= 2)
         {
-            if (gSeeker->state == running) gSeeker->state = tagged;
+            CtfSeeker* nearest = NULL;
+            float nearestDistance = searchRadius;
+
+            neighbors.clear ();
+            ctfSeekerQuery->findNeighbors (position(), searchRadius, neighbors);
+            for (AVIterator i = neighbors.begin(); i != neighbors.end(); i++)
+            {
+                CtfSeeker& s = *static_cast<CtfSeeker*> (*i);
+                const float d = Vec3::distance (position(), s.position());
+                if ((s.state == running) && (d < nearestDistance))
+                {
+                    nearest = &s;
+                    nearestDistance = d;
+                }
+            }
+
+            if (nearest || (searchRadius > maxSearchRadius)) return nearest;
+        }
+    }
+
+
+    // ----------------------------------------------------------------------------
+
+
+    void CtfEnemy::tagTouchedSeekers (void)
+    {
+        for (size_t i = 0; i < touchedSeekers.size(); i++)
+        {
+            CtfSeeker& s = *touchedSeekers[i];
+            if (s.state == running) s.state = tagged;
 
             // annotation:
-            if (gSeeker->state == tagged)
+            if (s.state == tagged)
             {
+                const float sumOfRadii = radius() + s.radius();
                 const Color color (0.8f, 0.5f, 0.5f);
                 annotationXZDisk (sumOfRadii,
-                            (position() + gSeeker->position()) / 2,
+                            (position() + s.position()) / 2,
                             color,
                             20);
             }
@@ -360,11 +485,30 @@ namespace {
         // for annotation: loop over all and save result, instead of early return 
         bool xxxReturn = true;
 
+        // collect the enemies near the corridor with circles spaced along it,
+        // up to gClearPathLookAhead (beyond that enemies are too far away to
+        // block).  Enemies are then checked by their predicted positions.
+        neighbors.clear ();
+        const float corridorLength = minXXX (goalDistance, gClearPathLookAhead);
+        for (float along = -behindThreshold;
+             along < corridorLength + sideThreshold;
+             along += sideThreshold)
+        {
+            ctfEnemyQuery->findNeighbors (position() + (goalDirection * along),
+                                          sideThreshold * 2,
+                                          neighbors);
+        }
+
+        // the circles overlap, consider each enemy once
+        std::sort (neighbors.begin(), neighbors.end());
+        neighbors.erase (std::unique (neighbors.begin(), neighbors.end()),
+                         neighbors.end());
+
         // loop over enemies
-        for (int i = 0; i < ctfEnemyCount; i++)
+        for (AVIterator i = neighbors.begin(); i != neighbors.end(); i++)
         {
             // short name for this enemy
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *static_cast<CtfEnemy*> (*i);
             const float eDistance = Vec3::distance (position(), e.position());
             const float timeEstimate = 0.3f * eDistance / e.speed(); //xxx
             const Vec3 eFuture = e.predictFuturePosition (timeEstimate);
@@ -447,7 +591,7 @@ namespace {
     // xxx Pedestrian.cpp
 
 
-    void CtfBase::annotateAvoidObstacle (const float minDistanceToCollision)
+    void CtfBase::annotateAvoidObstacle (const float minDistanceToCollision) const
     {
         const Vec3 boxSide = side() * radius();
         const Vec3 boxFront = forward() * minDistanceToCollision;
@@ -466,15 +610,26 @@ namespace {
     // ----------------------------------------------------------------------------
 
 
+    void CtfSeeker::findEnemies (const Vec3& center, const float radius)
+    {
+        neighbors.clear ();
+        ctfEnemyQuery->findNeighbors (center, radius, neighbors);
+    }
+
+
+    // ----------------------------------------------------------------------------
+
+
     Vec3 CtfSeeker::steerToEvadeAllDefenders (void)
     {
         Vec3 evade (0, 0, 0);
         const float goalDistance = Vec3::distance (gHomeBaseCenter, position());
 
         // sum up weighted evasion
-        for (int i = 0; i < ctfEnemyCount; i++)
+        findEnemies (position(), goalDistance * 1.2f);
+        for (AVIterator i = neighbors.begin(); i != neighbors.end(); i++)
         {
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *static_cast<CtfEnemy*> (*i);
             const Vec3 eOffset = e.position() - position();
             const float eDistance = eOffset.length();
 
@@ -506,11 +661,12 @@ namespace {
 
     Vec3 CtfSeeker::XXXsteerToEvadeAllDefenders (void)
     {
-        // sum up weighted evasion
+        // sum up weighted evasion of the enemies near enough to matter
         Vec3 evade (0, 0, 0);
-        for (int i = 0; i < ctfEnemyCount; i++)
+        findEnemies (position(), gEvadeRadius);
+        for (AVIterator i = neighbors.begin(); i != neighbors.end(); i++)
         {
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *static_cast<CtfEnemy*> (*i);
             const Vec3 eOffset = e.position() - position();
             const float eDistance = eOffset.length();
 
@@ -548,7 +704,7 @@ namespace {
         const bool clearPath = clearPathToGoal ();
         adjustObstacleAvoidanceLookAhead (clearPath);
         const Vec3 obstacleAvoidance =
-            steerToAvoidObstacles (gAvoidancePredictTime,
+            steerToAvoidObstacles (avoidancePredictTime,
                                    (ObstacleGroup&) allObstacles);
 
         // saved for annotation
@@ -619,13 +775,13 @@ namespace {
             const bool headingTowardGoal = isAhead (gHomeBaseCenter, 0.98f);
             const bool isNear = (goalDistance/speed()) < gAvoidancePredictTimeMax;
             const bool useMax = headingTowardGoal && !isNear;
-            gAvoidancePredictTime =
+            avoidancePredictTime =
                 (useMax ? gAvoidancePredictTimeMax : gAvoidancePredictTimeMin);
         }
         else
         {
             evading = true;
-            gAvoidancePredictTime = gAvoidancePredictTimeMin;
+            avoidancePredictTime = gAvoidancePredictTimeMin;
         }
     }
 
@@ -642,21 +798,8 @@ namespace {
             if (baseDistance < (radius() + gHomeBaseRadius)) state = atGoal;
         }
 
-        // update lastRunningTime (holds off reset time)
-        if (state == running)
-        {
-            lastRunningTime = currentTime;
-        }
-        else
-        {
-            const float resetDelay = 4;
-            const float resetTime = lastRunningTime + resetDelay;
-            if (currentTime > resetTime) 
-            {
-                // xxx a royal hack (should do this internal to CTF):
-                OpenSteerDemo::queueDelayedResetPlugInXXX ();
-            }
-        }
+        // update lastRunningTime (holds off reset time, see CtfPlugIn::update)
+        if (state == running) lastRunningTime = currentTime;
     }
 
 
@@ -668,38 +811,35 @@ namespace {
         // first call the draw method in the base class
         CtfBase::draw();
 
-        // select string describing current seeker state
-        std::string seekerStateString("");
-        switch (state)
-        {
-        case running:
-            if (avoiding)
-                seekerStateString = "avoid obstacle";
-            else if (evading)
-                seekerStateString = "seek and evade";
-            else
-                seekerStateString = "seek goal";
-            break;
-        case tagged: seekerStateString = "tagged"; break;
-        case atGoal: seekerStateString = "reached goal"; break;
-        }
-
         // annote seeker with its state as text
         const Vec3 textOrigin = position() + Vec3 (0, 0.25, 0);
         std::ostringstream annote;
-        annote << seekerStateString << std::endl;
+        annote << stateDescription () << std::endl;
         annote << std::setprecision(2) << std::setiosflags(std::ios::fixed)
                << speed() << std::ends;
         draw2dTextAt3dLocation (annote, textOrigin, gWhite, drawGetWindowWidth(), drawGetWindowHeight());
+    }
+
 
-        // display status in the upper left corner of the window
-        std::ostringstream status;
-        status << seekerStateString << std::endl;
-        status << obstacleCount << " obstacles [F1/F2]" << std::endl;
-        status << resetCount << " restarts" << std::ends;
-        const float h = drawGetWindowHeight ();
-        const Vec3 screenLocation (10, h-50, 0);
-        draw2dTextAt2dLocation (status, screenLocation, gGray80, drawGetWindowWidth(), drawGetWindowHeight());
+    // ----------------------------------------------------------------------------
+    // select string describing current seeker state
+
+
+    const char* CtfSeeker::stateDescription (void) const
+    {
+        switch (state)
+        {
+        case running:
+            if (avoiding)
+                return "avoid obstacle";
+            else if (evading)
+                return "seek and evade";
+            else
+                return "seek goal";
+        case tagged: return "tagged";
+        case atGoal: return "reached goal";
+        }
+        return "";
     }
 
 
@@ -762,6 +902,14 @@ namespace {
     }
 
 
+    void CtfBase::clearObstacles (void)
+    {
+        // delete all obstacles, initializeObstacles will create new ones
+        while (obstacleCount > 0) removeOneObstacle ();
+        obstacleCount = -1;
+    }
+
+
     void CtfBase::addOneObstacle (void)
     {
         if (obstacleCount < maxObstacleCount)
@@ -771,7 +919,7 @@ namespace {
             float r;
             Vec3 c;
             float minClearance;
-            const float requiredClearance = gSeeker->radius() * 4; // 2 x diameter
+            const float requiredClearance = ctfSeekers.front()->radius() * 4; // 2 x diameter
             do
             {
                 r = frandom2 (1.5, 4);
@@ -813,6 +961,7 @@ namespace {
         if (obstacleCount > 0)
         {
             obstacleCount--;
+            delete allObstacles.back();
             allObstacles.pop_back();
         }
     }
@@ -834,20 +983,45 @@ namespace {
 
         void open (void)
         {
-            // create the seeker ("hero"/"attacker")
-            ctfSeeker = new CtfSeeker;
-            all.push_back (ctfSeeker);
+            // grow the arena with the population, keeping the density of
+            // the default one seeker versus four enemies
+            const int population = ctfSeekerCount + ctfEnemyCount;
+            const float arenaScale =
+                sqrtXXX (maxXXX (1, population / (float) gDefaultPopulation));
+            gMinStartRadius = gDefaultMinStartRadius * arenaScale;
+            gMaxStartRadius = gDefaultMaxStartRadius * arenaScale;
+
+            // make one proximity database per team covering the arena
+            const float diameter = gMaxStartRadius * 3;
+            const float div = clip (floorXXX (diameter / 8), 1, 200);
+            const Vec3 dimensions (diameter, diameter, diameter);
+            const Vec3 divisions (div, 1.0f, div);
+            typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+            ctfSeekerDatabase = new LQPDAV (gHomeBaseCenter, dimensions, divisions);
+            ctfEnemyDatabase = new LQPDAV (gHomeBaseCenter, dimensions, divisions);
+            ctfSeekerQuery = ctfSeekerDatabase->allocateToken (NULL);
+            ctfEnemyQuery = ctfEnemyDatabase->allocateToken (NULL);
+
+            // create the seekers ("heroes"/"attackers")
+            for (int i = 0; i < ctfSeekerCount; i++)
+            {
+                CtfSeeker* seeker = new CtfSeeker;
+                seeker->newPD (*ctfSeekerDatabase);
+                ctfSeekers.push_back (seeker);
+                all.push_back (seeker);
+            }
 
-            // create the specified number of enemies, 
-            // storing pointers to them in an array.
-            for (int i = 0; i<ctfEnemyCount; i++)
+            // create the specified number of enemies
+            for (int i = 0; i < ctfEnemyCount; i++)
             {
-                ctfEnemies[i] = new CtfEnemy;
-                all.push_back (ctfEnemies[i]);
+                CtfEnemy* enemy = new CtfEnemy;
+                enemy->newPD (*ctfEnemyDatabase);
+                ctfEnemies.push_back (enemy);
+                all.push_back (enemy);
             }
 
             // initialize camera
-            OpenSteerDemo::init2dCamera (*ctfSeeker);
+            OpenSteerDemo::init2dCamera (*ctfSeekers.front());
             OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
             OpenSteerDemo::camera.fixedTarget.set (15, 0, 0);
             OpenSteerDemo::camera.fixedPosition.set (80, 60, 0);
@@ -857,14 +1031,56 @@ namespace {
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update the seeker
-            ctfSeeker->update (currentTime, elapsedTime);
-          
-            // update each enemy
-            for (int i = 0; i < ctfEnemyCount; i++)
+            // During each team's update only the other team's proximity
+            // database is queried and only seekers' states are read, so the
+            // members of a team can be updated in parallel.  Annotation is
+            // collected in shared buffers, so stay serial while it is on.
+            const bool parallel = !annotationIsOn ();
+
+            // update each seeker, then move their proximity tokens
+            const int seekerCount = (int) ctfSeekers.size();
+            #pragma omp parallel for if (parallel)
+            for (int i = 0; i < seekerCount; i++)
+            {
+                ctfSeekers[i]->update (currentTime, elapsedTime);
+            }
+            updateProximityTokens (ctfSeekers);
+
+            // update each enemy, then move their proximity tokens
+            const int enemyCount = (int) ctfEnemies.size();
+            #pragma omp parallel for if (parallel)
+            for (int i = 0; i < enemyCount; i++)
             {
                 ctfEnemies[i]->update (currentTime, elapsedTime);
             }
+            updateProximityTokens (ctfEnemies);
+
+            // record the seekers tagged during this update
+            for (int i = 0; i < enemyCount; i++) ctfEnemies[i]->tagTouchedSeekers ();
+
+            // restart a while after the last seeker stopped running
+            float lastRunningTime = 0;
+            for (int i = 0; i < seekerCount; i++)
+            {
+                const CtfSeeker& s = *ctfSeekers[i];
+                if (s.state == CtfBase::running) return;
+                lastRunningTime = maxXXX (lastRunningTime, s.lastRunningTime);
+            }
+            const float resetDelay = 4;
+            if (currentTime > (lastRunningTime + resetDelay))
+            {
+                // xxx a royal hack (should do this internal to CTF):
+                OpenSteerDemo::queueDelayedResetPlugInXXX ();
+            }
+        }
+
+        template <class Team>
+        void updateProximityTokens (const Team& team)
+        {
+            for (size_t i = 0; i < team.size(); i++)
+            {
+                team[i]->proximityToken->updateForNewPosition (team[i]->position());
+            }
         }
 
         void redraw (const float currentTime, const float elapsedTime)
@@ -889,57 +1105,107 @@ namespace {
                                                  gHomeBaseCenter);
             OpenSteerDemo::gridUtility (gridCenter);
 
-            // draw the seeker, obstacles and home base
-            ctfSeeker->draw();
+            // draw the seekers, obstacles and home base
+            for (size_t i = 0; i < ctfSeekers.size(); i++) ctfSeekers[i]->draw ();
             drawObstacles ();
             drawHomeBase();
 
             // draw each enemy
-            for (int i = 0; i < ctfEnemyCount; i++) ctfEnemies[i]->draw ();
+            for (size_t i = 0; i < ctfEnemies.size(); i++) ctfEnemies[i]->draw ();
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::highlightVehicleUtility (nearMouse);
+
+            // display status in the upper left corner of the window
+            std::ostringstream status;
+            if (ctfSeekers.size() == 1)
+            {
+                status << ctfSeekers.front()->stateDescription () << std::endl;
+            }
+            else
+            {
+                status << countSeekers (CtfBase::running) << " running, "
+                       << countSeekers (CtfBase::tagged) << " tagged, "
+                       << countSeekers (CtfBase::atGoal) << " reached goal"
+                       << std::endl;
+            }
+            status << ctfSeekers.size() << " seekers versus "
+                   << ctfEnemies.size() << " enemies [F3]" << std::endl;
+            status << CtfBase::obstacleCount << " obstacles [F1/F2]" << std::endl;
+            status << resetCount << " restarts" << std::ends;
+            const float h = drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            draw2dTextAt2dLocation (status, screenLocation, gGray80, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
         void close (void)
         {
-            // delete seeker
-            delete (ctfSeeker);
-            ctfSeeker = NULL;
-
-            // delete each enemy
-            for (int i = 0; i < ctfEnemyCount; i++)
-            {
-                delete (ctfEnemies[i]);
-                ctfEnemies[i] = NULL;
-            }
+            // delete the seekers and enemies
+            for (size_t i = 0; i < ctfSeekers.size(); i++) delete ctfSeekers[i];
+            for (size_t i = 0; i < ctfEnemies.size(); i++) delete ctfEnemies[i];
+            ctfSeekers.clear ();
+            ctfEnemies.clear ();
 
             // clear the group of all vehicles
             all.clear();
+
+            // delete the proximity databases
+            delete ctfSeekerQuery;
+            delete ctfEnemyQuery;
+            delete ctfSeekerDatabase;
+            delete ctfEnemyDatabase;
+            ctfSeekerQuery = ctfEnemyQuery = NULL;
+            ctfSeekerDatabase = ctfEnemyDatabase = NULL;
         }
 
         void reset (void)
         {
-            // count resets
+            // count resets and the results of the finished run
             resetCount++;
+            totalTaggedCount += countSeekers (CtfBase::tagged);
+            totalAtGoalCount += countSeekers (CtfBase::atGoal);
 
-            // reset the seeker ("hero"/"attacker") and enemies
-            ctfSeeker->reset ();
-            for (int i = 0; i<ctfEnemyCount; i++) ctfEnemies[i]->reset ();
+            // reset the seekers ("heroes"/"attackers") and enemies
+            for (size_t i = 0; i < ctfSeekers.size(); i++) ctfSeekers[i]->reset ();
+            for (size_t i = 0; i < ctfEnemies.size(); i++) ctfEnemies[i]->reset ();
+            updateProximityTokens (ctfSeekers);
+            updateProximityTokens (ctfEnemies);
 
             // reset camera position
-            OpenSteerDemo::position2dCamera (*ctfSeeker);
+            OpenSteerDemo::position2dCamera (*ctfSeekers.front());
 
             // make camera jump immediately to new position
             OpenSteerDemo::camera.doNotSmoothNextMove ();
         }
 
+        int countSeekers (const CtfBase::seekerState state)
+        {
+            int count = 0;
+            for (size_t i = 0; i < ctfSeekers.size(); i++)
+            {
+                if (ctfSeekers[i]->state == state) count++;
+            }
+            return count;
+        }
+
+        // cycle through team sizes: 1 versus 4, 10 versus 40, ...
+        void nextTeamSize (void)
+        {
+            close ();
+            CtfBase::clearObstacles ();
+            ctfSeekerCount = (ctfSeekerCount >= 1000) ? 1 : ctfSeekerCount * 10;
+            ctfEnemyCount = ctfSeekerCount * 4;
+            open ();
+            OpenSteerDemo::selectedVehicle = ctfSeekers.front();
+        }
+
         void handleFunctionKeys (int keyNumber)
         {
             switch (keyNumber)
             {
             case 1: CtfBase::addOneObstacle ();    break;
             case 2: CtfBase::removeOneObstacle (); break;
+            case 3: nextTeamSize ();               break;
             }
         }
 
@@ -951,9 +1217,35 @@ namespace {
             OpenSteerDemo::printMessage (message);
             OpenSteerDemo::printMessage ("  F1     add one obstacle.");
             OpenSteerDemo::printMessage ("  F2     remove one obstacle.");
+            OpenSteerDemo::printMessage ("  F3     next team size.");
             OpenSteerDemo::printMessage ("");
         }
 
+        // "seekers" and "enemies" set the team sizes
+        bool setOption (const char* name, const char* value)
+        {
+            const int count = std::atoi (value);
+            if ((std::strcmp (name, "seekers") == 0) && (count > 0))
+                ctfSeekerCount = count;
+            else if ((std::strcmp (name, "enemies") == 0) && (count >= 0))
+                ctfEnemyCount = count;
+            else
+                return false;
+
+            // the arena changes size, so obstacles have to be placed anew
+            CtfBase::clearObstacles ();
+            return true;
+        }
+
+        void printStatistics (std::ostream& os)
+        {
+            os << "restarts:            " << resetCount << std::endl
+               << "seekers tagged:      "
+               << totalTaggedCount + countSeekers (CtfBase::tagged) << std::endl
+               << "seekers at goal:     "
+               << totalAtGoalCount + countSeekers (CtfBase::atGoal) << std::endl;
+        }
+
         const AVGroup& allVehicles (void) {return (const AVGroup&) all;}
 
         void drawHomeBase (void)
@@ -961,7 +1253,7 @@ namespace {
             const Vec3 up (0, 0.01f, 0);
             const Color atColor (0.3f, 0.3f, 0.5f);
             const Color noColor = gGray50;
-            const bool reached = ctfSeeker->state == CtfSeeker::atGoal;
+            const bool reached = countSeekers (CtfBase::atGoal) > 0;
             const Color baseColor = (reached ? atColor : noColor);
             drawXZDisk (gHomeBaseRadius,    gHomeBaseCenter, baseColor, 40);
             drawXZDisk (gHomeBaseRadius/15, gHomeBaseCenter+up, gBlack, 20);
@@ -33,16 +33,33 @@
 // Used to evaluate vehicle response at low speed to backward-directed
 // steering force
 //
+// Also a deterministic microbenchmark of applySteeringForce: run headless
+// the vehicles get the same inputs on every run, "banking=1" selects
+// regenerateLocalSpaceForBanking and "stepsPerFrame" runs many locomotion
+// steps per frame.  Every "goldenInterval" steps the states are recorded,
+// "saveGolden=file" writes them and "golden=file" compares them with a
+// reference trajectory (within "goldenTolerance", 0 for bitwise equal):
+//
+//     OpenSteerDemo --headless "Low Speed Turn" --frames 6000
+//                   --option golden=test/golden/LowSpeedTurn.txt
+//
+// A trajectory that doesn't match makes the run exit with a failure,
+// "make golden" in linux checks all four trajectories of test/golden.
+//
 // 08-20-02 cwr: created 
 //
 //
 // ----------------------------------------------------------------------------
 
 
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/GoldenTrajectory.h"
+#include "OpenSteer/Stopwatch.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -115,14 +132,28 @@ namespace {
         // constant steering force
         Vec3 steering (void) {return Vec3 (1, 0, -1);}
 
+        // the default or the banking version of aligning with the velocity
+        void regenerateLocalSpace (const Vec3& newVelocity,
+                                   const float elapsedTime)
+        {
+            if (banking)
+                regenerateLocalSpaceForBanking (newVelocity, elapsedTime);
+            else
+                SimpleVehicle::regenerateLocalSpace (newVelocity, elapsedTime);
+        }
+
         // for stepping the starting conditions for next vehicle
         static float startX;
         static float startSpeed;
+
+        // use regenerateLocalSpaceForBanking
+        static bool banking;
     };
 
 
     float LowSpeedTurn::startX;
     float LowSpeedTurn::startSpeed;
+    bool LowSpeedTurn::banking = false;
 
 
     // ----------------------------------------------------------------------------
@@ -143,6 +174,12 @@ namespace {
 
         float selectionOrderSortKey (void) {return 0.05f;}
 
+        LowSpeedTurnPlugIn (void)
+            : stepsPerFrame (1),
+              steps (0),
+              locomotionSeconds (0)
+        {}
+
         // be more "nice" to avoid a compiler warning
         virtual ~LowSpeedTurnPlugIn() {}
 
@@ -152,6 +189,9 @@ namespace {
             // store pointers to them in an array.
             LowSpeedTurn::resetStarts ();
             for (int i = 0; i < lstCount; i++) all.push_back (new LowSpeedTurn);
+            steps = 0;
+            locomotionSeconds = 0;
+            golden.clear ();
 
             // initial selected vehicle
             OpenSteerDemo::selectedVehicle = *all.begin();
@@ -169,11 +209,19 @@ namespace {
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update, draw and annotate each agent
-            for (iterator i = all.begin(); i != all.end(); i++)
+            const double start = Stopwatch::now ();
+            for (int step = 0; step < stepsPerFrame; step++)
             {
-                (**i).update (currentTime, elapsedTime);
+                // update, draw and annotate each agent
+                for (iterator i = all.begin(); i != all.end(); i++)
+                {
+                    (**i).update (currentTime, elapsedTime);
+                }
+
+                // sample the trajectories for golden output comparison
+                golden.sample (++steps, allVehicles ());
             }
+            locomotionSeconds += Stopwatch::now () - start;
         }
 
         void redraw (const float currentTime, const float elapsedTime)
@@ -224,12 +272,54 @@ namespace {
             // reset each agent
             LowSpeedTurn::resetStarts ();
             for (iterator i = all.begin(); i!=all.end(); i++) (**i).reset();
+            steps = 0;
+            golden.clear ();
         }
 
+        // "banking" (0 or 1) selects the local space regeneration,
+        // "stepsPerFrame" is a step count, the golden trajectory options
+        // are those of GoldenTrajectoryCheck
+        bool setOption (const char* name, const char* value)
+        {
+            if (std::strcmp (name, "banking") == 0)
+            {
+                LowSpeedTurn::banking = (std::atoi (value) != 0);
+                return true;
+            }
+            if (GoldenTrajectoryCheck::isOption (name))
+                return golden.setOption (name, value);
+            if (std::strcmp (name, "stepsPerFrame") == 0)
+            {
+                stepsPerFrame = std::atoi (value);
+                return stepsPerFrame >= 1;
+            }
+            return false;
+        }
+
+        void printStatistics (std::ostream& os)
+        {
+            os << "locomotion:          "
+               << (LowSpeedTurn::banking ? "banking" : "default") << std::endl
+               << "locomotion steps:    " << steps << std::endl
+               << "vehicle steps/s:     " << (all.size() * steps) / locomotionSeconds
+               << std::endl;
+
+        }
+
+        // fail the headless run if the golden trajectory couldn't be
+        // saved, loaded or doesn't match
+        bool passedChecks (std::ostream& os) {return golden.check (os);}
+
         const AVGroup& allVehicles (void) {return (const AVGroup&) all;}
 
         std::vector<LowSpeedTurn*> all; // for allVehicles
         typedef std::vector<LowSpeedTurn*>::const_iterator iterator;
+
+        // microbenchmark settings and golden trajectory
+        int stepsPerFrame;
+        int steps;
+        double locomotionSeconds;
+        GoldenTrajectoryCheck golden;
     };
 
 
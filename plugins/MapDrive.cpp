@@ -53,6 +53,8 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/Color.h"
@@ -1988,7 +1990,7 @@ namespace {
         void annotatePathFollowing (const Vec3& future,
                                     const Vec3& onPath,
                                     const Vec3& target,
-                                    const float outside)
+                                    const float outside) const
         {
             const Color toTargetColor (gGreen * 0.6f);
             const Color insidePathColor (gCyan * 0.6f);
@@ -2864,6 +2866,16 @@ namespace {
             OpenSteerDemo::printMessage (message);
         }
 
+        // "demo" selects the demo mode (0, 1 or 2, see selectNextDemo)
+        bool setOption (const char* name, const char* value)
+        {
+            const int demo = std::atoi (value);
+            if ((std::strcmp (name, "demo") != 0) || (demo < 0) || (demo > 2))
+                return false;
+            MapDriver::demoSelect = demo;
+            return true;
+        }
+
         // random utility, worth moving to Utilities.h?
         int irandom2 (int min, int max)
         {
@@ -32,12 +32,20 @@
 //
 // 08-22-02 cwr: created 
 //
+// Many pursuers per wanderer read the wanderer's future positions from a
+// trajectory cache sampled once per step (F2 toggles the cache).
+//
 //
 // ----------------------------------------------------------------------------
 
 
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/TrajectoryCache.h"
+#include "OpenSteer/Stopwatch.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -45,6 +53,14 @@ namespace {
 
     using namespace OpenSteer;
 
+
+    // pursuers cap their prediction of the wanderer's position at this time,
+    // the wanderer's trajectory is sampled up to it
+    const float maxPredictionTime = 20; // xxx hard-to-justify value
+
+    // spacing of the wanderer's trajectory samples
+    const float trajectoryStep = 0.25f;
+
     // ----------------------------------------------------------------------------
     // This PlugIn uses two vehicle types: MpWanderer and MpPursuer.  They have
     // a common base class, MpBase, which is a specialization of SimpleVehicle.
@@ -105,6 +121,14 @@ namespace {
             recordTrailVertex (currentTime, position());
         }
 
+        // sample future positions for this step's pursuers
+        void sampleTrajectory (void)
+        {
+            trajectory.sample (*this, maxPredictionTime, trajectoryStep);
+        }
+
+        // future positions, sampled after each update
+        TrajectoryCache trajectory;
     };
 
 
@@ -113,7 +137,7 @@ namespace {
     public:
 
         // constructor
-        MpPursuer (MpWanderer* w) {wanderer = w; reset ();}
+        MpPursuer (MpWanderer* w) : catches (0) {wanderer = w; reset ();}
 
         // reset state
         void reset (void)
@@ -125,14 +149,25 @@ namespace {
 
         // one simulation step
         void update (const float currentTime, const float elapsedTime)
+        {
+            update (currentTime, elapsedTime, false);
+        }
+
+        // one simulation step, optionally reading the wanderer's sampled
+        // trajectory instead of predicting its position
+        void update (const float currentTime,
+                     const float elapsedTime,
+                     const bool useTrajectoryCache)
         {
             // when pursuer touches quarry ("wanderer"), reset its position
             const float d = Vec3::distance (position(), wanderer->position());
             const float r = radius() + wanderer->radius();
-            if (d < r) reset ();
+            if (d < r) {reset (); catches++;}
 
-            const float maxTime = 20; // xxx hard-to-justify value
-            applySteeringForce (steerForPursuit (*wanderer, maxTime), elapsedTime);
+            const Vec3 steering = useTrajectoryCache ?
+                steerForPursuit (*wanderer, wanderer->trajectory, maxPredictionTime) :
+                steerForPursuit (*wanderer, maxPredictionTime);
+            applySteeringForce (steering, elapsedTime);
 
             // for annotation
             recordTrailVertex (currentTime, position());
@@ -154,6 +189,9 @@ namespace {
         }
 
         MpWanderer* wanderer;
+
+        // how often this pursuer touched its wanderer
+        int catches;
     };
 
 
@@ -165,6 +203,10 @@ namespace {
     {
     public:
 
+        MpPlugIn ()
+            : wandererCount (1), pursuerCount (30), useTrajectoryCache (true),
+              updateSeconds (0), pursuerUpdates (0) {}
+
         const char* name (void) {return "Multiple Pursuit";}
 
         float selectionOrderSortKey (void) {return 0.04f;}
@@ -173,34 +215,52 @@ namespace {
 
         void open (void)
         {
-            // create the wanderer, saving a pointer to it
-            wanderer = new MpWanderer;
-            allMP.push_back (wanderer);
+            // create the wanderers, saving pointers to them
+            for (int i = 0; i < wandererCount; i++)
+            {
+                wanderers.push_back (new MpWanderer);
+                allMP.push_back (wanderers.back());
+            }
 
-            // create the specified number of pursuers, save pointers to them
-            const int pursuerCount = 30;
+            // create the specified number of pursuers, save pointers to
+            // them, each chases one of the wanderers
             for (int i = 0; i < pursuerCount; i++)
-                allMP.push_back (new MpPursuer (wanderer));
-            pBegin = allMP.begin() + 1;  // iterator pointing to first pursuer
-            pEnd = allMP.end();          // iterator pointing to last pursuer
+            {
+                MpPursuer* pursuer = new MpPursuer (wanderers[i % wandererCount]);
+                pursuers.push_back (pursuer);
+                allMP.push_back (pursuer);
+            }
 
             // initialize camera
-            OpenSteerDemo::selectedVehicle = wanderer;
+            OpenSteerDemo::selectedVehicle = wanderers.front();
             OpenSteerDemo::camera.mode = Camera::cmStraightDown;
             OpenSteerDemo::camera.fixedDistDistance = OpenSteerDemo::cameraTargetDistance;
             OpenSteerDemo::camera.fixedDistVOffset = OpenSteerDemo::camera2dElevation;
+
+            updateSeconds = 0;
+            pursuerUpdates = 0;
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update the wanderer
-            wanderer->update (currentTime, elapsedTime);
-          
+            const Stopwatch stopwatch;
+
+            // update the wanderers, then sample where they are going once
+            // for all of their pursuers
+            for (int i = 0; i < wandererCount; i++)
+            {
+                wanderers[i]->update (currentTime, elapsedTime);
+                if (useTrajectoryCache) wanderers[i]->sampleTrajectory ();
+            }
+
             // update each pursuer
-            for (iterator i = pBegin; i != pEnd; i++)
+            for (int i = 0; i < pursuerCount; i++)
             {
-                ((MpPursuer&) (**i)).update (currentTime, elapsedTime);
+                pursuers[i]->update (currentTime, elapsedTime, useTrajectoryCache);
             }
+
+            updateSeconds += stopwatch.elapsedSeconds ();
+            pursuerUpdates += pursuerCount;
         }
 
         void redraw (const float currentTime, const float elapsedTime)
@@ -218,40 +278,122 @@ namespace {
             OpenSteerDemo::gridUtility (selected.position());
 
             // draw each vehicles
-            for (iterator i = allMP.begin(); i != pEnd; i++) (**i).draw ();
+            for (iterator i = allMP.begin(); i != allMP.end(); i++) (**i).draw ();
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::highlightVehicleUtility (nearMouse);
             OpenSteerDemo::circleHighlightVehicleUtility (selected);
+
+            // display status in the upper left corner of the window
+            std::ostringstream status;
+            status << "[F1] " << pursuerCount << " pursuers of "
+                   << wandererCount << " wanderer"
+                   << ((wandererCount == 1) ? "" : "s") << std::endl
+                   << "[F2] trajectory cache "
+                   << (useTrajectoryCache ? "on" : "off") << std::ends;
+            const float h = drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            draw2dTextAt2dLocation (status, screenLocation, gGray80, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
         void close (void)
         {
-            // delete wanderer, all pursuers, and clear list
-            delete (wanderer);
-            for (iterator i = pBegin; i != pEnd; i++) delete ((MpPursuer*)*i);
+            // delete wanderers, all pursuers, and clear lists
+            for (iterator i = allMP.begin(); i != allMP.end(); i++) delete (*i);
             allMP.clear();
+            wanderers.clear();
+            pursuers.clear();
         }
 
         void reset (void)
         {
-            // reset wanderer and pursuers
-            wanderer->reset ();
-            for (iterator i = pBegin; i != pEnd; i++) ((MpPursuer&)(**i)).reset ();
+            // reset wanderers and pursuers
+            for (int i = 0; i < wandererCount; i++) wanderers[i]->reset ();
+            for (int i = 0; i < pursuerCount; i++) pursuers[i]->reset ();
 
             // immediately jump to default camera position
             OpenSteerDemo::camera.doNotSmoothNextMove ();
             OpenSteerDemo::camera.resetLocalSpace ();
         }
 
+        // cycle through the number of pursuers: 30, 300, 3000
+        void nextPursuerCount (void)
+        {
+            close ();
+            pursuerCount = (pursuerCount >= 3000) ? 30 : pursuerCount * 10;
+            open ();
+        }
+
+        void handleFunctionKeys (int keyNumber)
+        {
+            switch (keyNumber)
+            {
+            case 1: nextPursuerCount (); break;
+            case 2: useTrajectoryCache = !useTrajectoryCache; break;
+            }
+        }
+
+        void printMiniHelpForFunctionKeys (void)
+        {
+            std::ostringstream message;
+            message << "Function keys handled by ";
+            message << '"' << name() << '"' << ':' << std::ends;
+            OpenSteerDemo::printMessage (message);
+            OpenSteerDemo::printMessage ("  F1     next number of pursuers.");
+            OpenSteerDemo::printMessage ("  F2     toggle wanderer trajectory cache.");
+            OpenSteerDemo::printMessage ("");
+        }
+
+        // "pursuers" and "wanderers" set the population, "trajectoryCache"
+        // (0 or 1) selects how pursuers predict their wanderer's position
+        bool setOption (const char* name, const char* value)
+        {
+            const int count = std::atoi (value);
+            if (std::strcmp (name, "trajectoryCache") == 0)
+            {
+                useTrajectoryCache = (count != 0);
+                return true;
+            }
+            if (count < 1) return false;
+            if (std::strcmp (name, "pursuers") == 0)  {pursuerCount = count; return true;}
+            if (std::strcmp (name, "wanderers") == 0) {wandererCount = count; return true;}
+            return false;
+        }
+
+        void printStatistics (std::ostream& os)
+        {
+            int catches = 0;
+            for (int i = 0; i < pursuerCount; i++) catches += pursuers[i]->catches;
+
+            os << "wanderers:           " << wandererCount << std::endl
+               << "pursuers:            " << pursuerCount << std::endl
+               << "trajectory cache:    " << (useTrajectoryCache ? "on" : "off") << std::endl
+               << "catches:             " << catches << std::endl
+               << "pursuer updates/s:   ";
+            // no updates timed yet, e.g. when run for zero frames
+            if (updateSeconds > 0)
+                os << pursuerUpdates / updateSeconds << std::endl;
+            else
+                os << "n/a" << std::endl;
+        }
+
         const AVGroup& allVehicles (void) {return (const AVGroup&) allMP;}
 
         // a group (STL vector) of all vehicles
         std::vector<MpBase*> allMP;
         typedef std::vector<MpBase*>::const_iterator iterator;
-        iterator pBegin, pEnd;
 
-        MpWanderer* wanderer;
+        // the vehicles by kind
+        std::vector<MpWanderer*> wanderers;
+        std::vector<MpPursuer*> pursuers;
+
+        int wandererCount;
+        int pursuerCount;
+        bool useTrajectoryCache;
+
+        // time spent in update and number of pursuers updated, for statistics
+        double updateSeconds;
+        double pursuerUpdates;
     };
 
 
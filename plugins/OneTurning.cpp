@@ -30,16 +30,25 @@
 //
 // One vehicle turning way: a (near) minimal OpenSteerDemo PlugIn
 //
+// Run headless it is a deterministic microbenchmark of applySteeringForce
+// for one vehicle, with the options of "Low Speed Turn": "banking",
+// "stepsPerFrame", "goldenInterval", "golden", "saveGolden" and
+// "goldenTolerance".
+//
 // 06-24-02 cwr: created 
 //
 //
 // ----------------------------------------------------------------------------
 
 
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/GoldenTrajectory.h"
+#include "OpenSteer/Stopwatch.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -55,7 +64,7 @@ namespace {
     public:
 
         // constructor
-        OneTurning () {reset ();}
+        OneTurning () : banking (false) {reset ();}
 
         // reset state
         void reset (void)
@@ -81,6 +90,19 @@ namespace {
             drawBasic2dCircularVehicle (*this, gGray50);
             drawTrail ();
         }
+
+        // the default or the banking version of aligning with the velocity
+        void regenerateLocalSpace (const Vec3& newVelocity,
+                                   const float elapsedTime)
+        {
+            if (banking)
+                regenerateLocalSpaceForBanking (newVelocity, elapsedTime);
+            else
+                SimpleVehicle::regenerateLocalSpace (newVelocity, elapsedTime);
+        }
+
+        // use regenerateLocalSpaceForBanking
+        bool banking;
     };
 
 
@@ -96,12 +118,23 @@ namespace {
 
         float selectionOrderSortKey (void) {return 0.06f;}
 
+        OneTurningPlugIn (void)
+            : banking (false),
+              stepsPerFrame (1),
+              steps (0),
+              locomotionSeconds (0)
+        {}
+
         // be more "nice" to avoid a compiler warning
         virtual ~OneTurningPlugIn() {}
 
         void open (void)
         {
             gOneTurning = new OneTurning;
+            gOneTurning->banking = banking;
+            steps = 0;
+            locomotionSeconds = 0;
+            golden.clear ();
             OpenSteerDemo::selectedVehicle = gOneTurning;
             theVehicle.push_back (gOneTurning);
 
@@ -115,8 +148,16 @@ namespace {
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update simulation of test vehicle
-            gOneTurning->update (currentTime, elapsedTime);
+            const double start = Stopwatch::now ();
+            for (int step = 0; step < stepsPerFrame; step++)
+            {
+                // update simulation of test vehicle
+                gOneTurning->update (currentTime, elapsedTime);
+
+                // sample the trajectory for golden output comparison
+                golden.sample (++steps, allVehicles ());
+            }
+            locomotionSeconds += Stopwatch::now () - start;
         }
 
         void redraw (const float currentTime, const float elapsedTime)
@@ -149,12 +190,55 @@ namespace {
         {
             // reset vehicle
             gOneTurning->reset ();
+            steps = 0;
+            golden.clear ();
         }
 
+        // "banking" (0 or 1) selects the local space regeneration,
+        // "stepsPerFrame" is a step count, the golden trajectory options
+        // are those of GoldenTrajectoryCheck
+        bool setOption (const char* name, const char* value)
+        {
+            if (std::strcmp (name, "banking") == 0)
+            {
+                banking = (std::atoi (value) != 0);
+                return true;
+            }
+            if (GoldenTrajectoryCheck::isOption (name))
+                return golden.setOption (name, value);
+            if (std::strcmp (name, "stepsPerFrame") == 0)
+            {
+                stepsPerFrame = std::atoi (value);
+                return stepsPerFrame >= 1;
+            }
+            return false;
+        }
+
+        void printStatistics (std::ostream& os)
+        {
+            os << "locomotion:          "
+               << (banking ? "banking" : "default") << std::endl
+               << "locomotion steps:    " << steps << std::endl
+               << "vehicle steps/s:     " << steps / locomotionSeconds
+               << std::endl;
+
+        }
+
+        // fail the headless run if the golden trajectory couldn't be
+        // saved, loaded or doesn't match
+        bool passedChecks (std::ostream& os) {return golden.check (os);}
+
         const AVGroup& allVehicles (void) {return (const AVGroup&) theVehicle;}
 
         OneTurning* gOneTurning;
         std::vector<OneTurning*> theVehicle; // for allVehicles
+
+        // microbenchmark settings and golden trajectory
+        bool banking;
+        int stepsPerFrame;
+        int steps;
+        double locomotionSeconds;
+        GoldenTrajectoryCheck golden;
     };
 
 
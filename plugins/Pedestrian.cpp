@@ -31,19 +31,41 @@
 // An autonomous "pedestrian":
 // follows paths, avoids collisions with obstacles and other pedestrians
 //
+// All state of a crowd (path, obstacles, proximity database and the
+// switches of the demo) is kept in a PedestrianWorld, so any number of
+// crowds can be run side by side for batch runs (see AbstractWorld).
+// Worlds walking the same path share it through the PathRegistry.
+//
+// With --option scenario=<file> the path, obstacles and pedestrians are
+// loaded from a scenario file (see Scenario), --option saveScenario=<file>
+// writes the opened world as one (as text if the name ends with ".txt").
+//
+// For large crowds (headless: --option pedestrians=50000 --option
+// density=0.5) the path is scaled up to hold the crowd at the requested
+// density and the proximity grid is sized from the path and the
+// population.  With --option stageTimings=1 the time spent in each stage of
+// the pedestrians' update is reported.
+//
 // 10-29-01 cwr: created
 //
 //
 // ----------------------------------------------------------------------------
 
 
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
-#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/PathRegistry.h"
+#include "OpenSteer/Scenario.h"
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Proximity.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/ContinuumCrowd.h"
+#include "OpenSteer/SleepScheduler.h"
+#include "OpenSteer/Stopwatch.h"
+#include "OpenSteer/FlightRecorder.h"
 
 namespace {
 
@@ -60,41 +82,221 @@ namespace {
     // ----------------------------------------------------------------------------
 
 
-    // How many pedestrians to create when the plugin starts first?
-    int const gPedestrianStartCount = 100;
-    // creates a path for the PlugIn
-    PolylineSegmentedPathwaySingleRadius* getTestPath (void);
-    PolylineSegmentedPathwaySingleRadius* gTestPath = NULL;
-    SphereObstacle gObstacle1;
-    SphereObstacle gObstacle2;
-    ObstacleGroup gObstacles;
-    Vec3 gEndpoint0;
-    Vec3 gEndpoint1;
-    bool gUseDirectedPathFollowing = true;
-    // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
-    RectangleObstacle gObstacle3 (7,7);
-    // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+    class Pedestrian;
+
+
+    // ----------------------------------------------------------------------------
+    // like randomVectorOnUnitRadiusXZDisk and RandomUnitVectorOnXZPlane but
+    // drawing from a world's own generator instead of the global one
+
 
-    // this was added for debugging tool, but I might as well leave it in
-    bool gWanderSwitch = true;
+    Vec3 randomVectorOnUnitRadiusXZDisk (RandomGenerator& random)
+    {
+        Vec3 v;
+        do
+        {
+            v.set ((random.frandom01()*2) - 1,
+                   0,
+                   (random.frandom01()*2) - 1);
+        }
+        while (v.length() >= 1);
+        return v;
+    }
+
+
+    Vec3 randomUnitVectorOnXZPlane (RandomGenerator& random)
+    {
+        Vec3 v;
+        do
+        {
+            v = randomVectorOnUnitRadiusXZDisk (random);
+        }
+        while (v.length() == 0);
+        return v.normalize();
+    }
 
 
     // ----------------------------------------------------------------------------
+    // one crowd with everything it needs to be simulated
 
 
-    class Pedestrian : public SimpleVehicle
+    class PedestrianWorld : public AbstractWorld
     {
     public:
 
         // type for a group of Pedestrians
         typedef std::vector<Pedestrian*> groupType;
+        typedef groupType::const_iterator iterator;
+
+        PedestrianWorld (void);
+        virtual ~PedestrianWorld() {}
+
+        // "pedestrians" sets the initial crowd size, "seed" the seed of
+        // the random generator, lead times and switches have the names of
+        // the members below
+        bool setOption (const char* name, const char* value);
+
+        void open (void);
+        void update (const float currentTime, const float elapsedTime);
+        void close (void);
+        void printStatistics (std::ostream& os);
+
+        const AVGroup& allVehicles (void) {return (const AVGroup&) crowd;}
+
+        void addPedestrianToCrowd (void);
+        void removePedestrianFromCrowd (void);
+
+        // add many pedestrians at once
+        void addPedestriansToCrowd (const int count);
+
+        // for purposes of demonstration, allow cycling through various
+        // types of proximity databases.
+        void nextPD (void);
+
+        // sleepers are only skipped while sleeping is on
+        void toggleSleeping (void);
+
+        // creates the path and obstacles, the path is scaled up to hold
+        // the crowd at the given density (if any)
+        void makePath (void);
+
+        // choose the box and the divisions of the proximity grid (and the
+        // sleepers' grid) from the extent of the path and the population
+        void sizeProximityGrid (void);
+
+        // creates the continuum crowd grid covering the path
+        void makeContinuumGrid (void);
+
+        // splat the crowd onto the continuum grid and recompute the
+        // potentials toward both endpoints
+        void updateContinuumCrowd (void);
+
+        // crowd: a group (STL vector) of all Pedestrians
+        groupType crowd;
+
+        // pointer to database used to accelerate proximity queries
+        ProximityDatabase* pd;
+
+        // keep track of current crowd size, and the size it starts with
+        int population;
+        int startPopulation;
+
+        // which of the various proximity databases is currently in use
+        int cyclePD;
+
+        // pedestrians per square meter of path the path is scaled for, 0
+        // keeps the path at its original size
+        float density;
+
+        // box covered by the proximity grid and its number of bins
+        Vec3 gridCenter;
+        Vec3 gridDimensions;
+        Vec3 gridDivisions;
+
+        // path followed by all pedestrians (shared with the worlds walking
+        // the same path, see PathRegistry), its endpoints and the obstacles
+        // placed along it
+        PathRegistry::PathPointer path;
+        Vec3 endpoint0;
+        Vec3 endpoint1;
+        SphereObstacle obstacle1;
+        SphereObstacle obstacle2;
+        // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+        RectangleObstacle obstacle3;
+        // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+        ObstacleGroup obstacles;
+
+        // random generator of the pedestrians' placement and updates (leak
+        // through and wander), one per world so that worlds stepped
+        // concurrently don't share a stream.  Seeded with seed when the
+        // world is opened, or from rand if seed is 0
+        RandomGenerator random;
+        unsigned int seed;
+
+        // look ahead times (in seconds) of obstacle avoidance, neighbor
+        // avoidance and path following
+        float obstacleLeadTime;
+        float avoidanceLeadTime;
+        float pathFollowingLeadTime;
+
+        bool useDirectedPathFollowing;
+
+        // this was added for debugging tool, but I might as well leave it in
+        bool wanderSwitch;
+
+        // use reciprocal (ORCA) instead of predictive neighbor avoidance
+        bool useReciprocalAvoidance;
+
+        // steer along a continuum crowd potential field instead of following
+        // the path: one density grid shared by all pedestrians, one potential
+        // for each walking direction (index 0: toward endpoint0, 1: endpoint1)
+        bool useContinuumCrowd;
+        ContinuumCrowdGrid* continuumGrid;
+        ContinuumCrowdPotential potentialToEndpoint[2];
+
+        // skip the update of pedestrians which came to rest until a moving
+        // neighbor approaches them.  While sleeping is on pedestrians stop
+        // for endpointRestTime seconds when they reach an endpoint, so there
+        // are resting pedestrians to put to sleep
+        bool useSleeping;
+        SleepScheduler* sleepScheduler;
+        float endpointRestTime;
+
+        // number of times a pedestrian reached an endpoint and turned back
+        int endpointsReached;
+
+        // scenario loaded by option "scenario", it replaces the path and
+        // obstacles and places the pedestrians (if it is not empty)
+        Scenario scenario;
+        std::vector<SphereObstacle> scenarioSpheres;
+        std::vector<BoxObstacle> scenarioBoxes;
+        double scenarioLoadSeconds;
+
+        // load the scenario and apply its parameters as options
+        bool loadScenario (const char* fileName);
+
+        // write the path, obstacles and crowd of the open world
+        bool saveScenario (const std::string& fileName);
+        std::string saveScenarioFileName;
+
+        // stages of the pedestrians' update timed when measureStages is set
+        // (the neighbor query includes updating the proximity database)
+        enum Stage {neighborQueryStage, avoidanceStage, pathFollowingStage,
+                    integrationStage, stageCount};
+        bool measureStages;
+        double stageSeconds[stageCount];
+
+        // when measuring, the start of the first stage
+        double startStage (void) const
+        {
+            return measureStages ? Stopwatch::now () : 0;
+        }
+
+        // when measuring, add the time since start to the given stage and
+        // return the current time as start of the next stage
+        double endStage (const Stage stage, const double start)
+        {
+            if (!measureStages) return 0;
+            const double now = Stopwatch::now ();
+            stageSeconds[stage] += now - start;
+            return now;
+        }
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class Pedestrian : public SimpleVehicle
+    {
+    public:
 
         // constructor
-        Pedestrian (ProximityDatabase& pd)
+        Pedestrian (PedestrianWorld& crowdWorld) : world (crowdWorld)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
-            newPD (pd);
+            newPD (*world.pd);
 
             // reset Pedestrian state
             reset ();
@@ -124,20 +326,27 @@ namespace {
             setRadius (0.5); // width = 0.7, add 0.3 margin, take half
 
             // set the path for this Pedestrian to follow
-            path = getTestPath ();
+            path = world.path.get ();
 
             // set initial position
-            // (random point on path + random horizontal offset)
-            const float d = path->length() * frandom01();
+            // (random point on path + random horizontal offset), drawn from
+            // the world's generator so that a seeded world is reproducible
+            RandomGenerator& random = world.random;
+            const float d = path->length() * random.frandom01();
             const float r = path->radius();
-            const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk () * r;
+            const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk (random) * r;
             setPosition (path->mapPathDistanceToPoint (d) + randomOffset);
 
             // randomize 2D heading
-            randomizeHeadingOnXZPlane ();
+            setUp (Vec3::up);
+            setForward (randomUnitVectorOnXZPlane (random));
+            setSide (localRotateForwardToSide (forward()));
 
             // pick a random direction for path following (upstream or downstream)
-            pathDirection = (frandom01() > 0.5) ? -1 : +1;
+            pathDirection = (random.frandom01() > 0.5) ? -1 : +1;
+
+            // not resting at an endpoint
+            restUntil = 0;
 
             // trail parameters: 3 seconds with 60 points along the trail
             setTrailParameters (3, 60);
@@ -146,37 +355,75 @@ namespace {
             proximityToken->updateForNewPosition (position());
         }
 
+        // place this pedestrian as given by a scenario
+        void place (const Scenario::Agent& agent)
+        {
+            setPosition (agent.position);
+            regenerateOrthonormalBasisUF (agent.forward);
+            setSpeed (agent.speed);
+            proximityToken->updateForNewPosition (position());
+        }
+
         // per frame simulation update
         void update (const float currentTime, const float elapsedTime)
         {
-            // apply steering force to our momentum
-            applySteeringForce (determineCombinedSteering (elapsedTime),
-                                elapsedTime);
+            FlightRecorder::AgentScope flight (serialNumber);
+
+            // apply steering force to our momentum, or come to a stop while
+            // resting at an endpoint
+            const bool atRest = resting (currentTime);
+            const Vec3 steering = (atRest ?
+                                   Vec3::zero :
+                                   determineCombinedSteering (elapsedTime));
+            const double integrationStart = world.startStage ();
+            if (atRest)
+                applyBrakingForce (4, elapsedTime);
+            else
+                applySteeringForce (steering, elapsedTime);
 
             // reverse direction when we reach an endpoint
-            if (gUseDirectedPathFollowing)
+            if (world.useDirectedPathFollowing)
             {
                 const Color darkRed (0.7f, 0, 0);
                 float const pathRadius = path->radius();
                 
-                if (Vec3::distance (position(), gEndpoint0) < pathRadius )
+                if (Vec3::distance (position(), world.endpoint0) < pathRadius )
                 {
+                    if (pathDirection != +1) reachEndpoint (currentTime);
                     pathDirection = +1;
-                    annotationXZCircle (pathRadius, gEndpoint0, darkRed, 20);
+                    annotationXZCircle (pathRadius, world.endpoint0, darkRed, 20);
                 }
-                if (Vec3::distance (position(), gEndpoint1) < pathRadius )
+                if (Vec3::distance (position(), world.endpoint1) < pathRadius )
                 {
+                    if (pathDirection != -1) reachEndpoint (currentTime);
                     pathDirection = -1;
-                    annotationXZCircle (pathRadius, gEndpoint1, darkRed, 20);
+                    annotationXZCircle (pathRadius, world.endpoint1, darkRed, 20);
                 }
             }
 
             // annotation
             annotationVelocityAcceleration (5, 0);
             recordTrailVertex (currentTime, position());
+            const double tokenStart = world.endStage (PedestrianWorld::integrationStage,
+                                                      integrationStart);
 
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
+            world.endStage (PedestrianWorld::neighborQueryStage, tokenStart);
+        }
+
+        // count a turn at an endpoint and rest there while sleeping is on
+        void reachEndpoint (const float currentTime)
+        {
+            world.endpointsReached++;
+            if (world.useSleeping)
+                restUntil = currentTime + world.endpointRestTime;
+        }
+
+        // true while this pedestrian rests at an endpoint
+        bool resting (const float currentTime) const
+        {
+            return currentTime < restUntil;
         }
 
         // compute combined steering force: move forward, avoid obstacles
@@ -192,16 +439,17 @@ namespace {
             const float leakThrough = 0.1f;
 
             // determine if obstacle avoidance is required
+            double stageStart = world.startStage ();
             Vec3 obstacleAvoidance;
-            if (leakThrough < frandom01())
+            if (leakThrough < world.random.frandom01 ())
             {
-                const float oTime = 6; // minTimeToCollision = 6 seconds
+                const float oTime = world.obstacleLeadTime; // minTimeToCollision
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
     // just for testing
-    //             obstacleAvoidance = steerToAvoidObstacles (oTime, gObstacles);
-    //             obstacleAvoidance = steerToAvoidObstacle (oTime, gObstacle1);
-    //             obstacleAvoidance = steerToAvoidObstacle (oTime, gObstacle3);
-                obstacleAvoidance = steerToAvoidObstacles (oTime, gObstacles);
+    //             obstacleAvoidance = steerToAvoidObstacles (oTime, world.obstacles);
+    //             obstacleAvoidance = steerToAvoidObstacle (oTime, world.obstacle1);
+    //             obstacleAvoidance = steerToAvoidObstacle (oTime, world.obstacle3);
+                obstacleAvoidance = steerToAvoidObstacles (oTime, world.obstacles);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
             }
 
@@ -209,23 +457,37 @@ namespace {
             if (obstacleAvoidance != Vec3::zero)
             {
                 steeringForce += obstacleAvoidance;
+                world.endStage (PedestrianWorld::avoidanceStage, stageStart);
             }
             else
             {
                 // otherwise consider avoiding collisions with others
                 Vec3 collisionAvoidance;
-                const float caLeadTime = 3;
+                const float caLeadTime = world.avoidanceLeadTime;
 
                 // find all neighbors within maxRadius using proximity database
                 // (radius is largest distance between vehicles traveling head-on
                 // where a collision is possible within caLeadTime seconds.)
                 const float maxRadius = caLeadTime * maxSpeed() * 2;
+                stageStart = world.endStage (PedestrianWorld::avoidanceStage, stageStart);
                 neighbors.clear();
                 proximityToken->findNeighbors (position(), maxRadius, neighbors);
+                stageStart = world.endStage (PedestrianWorld::neighborQueryStage, stageStart);
 
-                if (leakThrough < frandom01())
-                    collisionAvoidance =
-                        steerToAvoidNeighbors (caLeadTime, neighbors) * 10;
+                if (leakThrough < world.random.frandom01 ())
+                {
+                    if (world.useReciprocalAvoidance)
+                        collisionAvoidance =
+                            steerToAvoidNeighborsReciprocally (caLeadTime,
+                                                               elapsedTime,
+                                                               velocity(),
+                                                               neighbors) * 10;
+                    else
+                        collisionAvoidance =
+                            steerToAvoidNeighbors (caLeadTime, neighbors) * 10;
+                }
+
+                stageStart = world.endStage (PedestrianWorld::avoidanceStage, stageStart);
 
                 // if collision avoidance is needed, do it
                 if (collisionAvoidance != Vec3::zero)
@@ -235,18 +497,38 @@ namespace {
                 else
                 {
                     // add in wander component (according to user switch)
-                    if (gWanderSwitch)
-                        steeringForce += steerForWander (elapsedTime);
+                    if (world.wanderSwitch)
+                    {
+                        const float sideRandom01 = world.random.frandom01 ();
+                        const float upRandom01 = world.random.frandom01 ();
+                        steeringForce += steerForWander (elapsedTime,
+                                                         WanderSide,
+                                                         WanderUp,
+                                                         sideRandom01,
+                                                         upRandom01);
+                    }
 
                     // do (interactively) selected type of path following
-                    const float pfLeadTime = 3;
-                    const Vec3 pathFollow =
-                        (gUseDirectedPathFollowing ?
+                    const float pfLeadTime = world.pathFollowingLeadTime;
+                    Vec3 pathFollow =
+                        (world.useDirectedPathFollowing ?
                          steerToFollowPath (pathDirection, pfLeadTime, *path) :
                          steerToStayOnPath (pfLeadTime, *path));
 
+                    // or follow the continuum crowd flow toward our endpoint
+                    // (falls back to path following where there is no flow)
+                    if (world.useContinuumCrowd)
+                    {
+                        const int goal = (pathDirection > 0) ? 1 : 0;
+                        const Vec3 flow = world.potentialToEndpoint[goal].
+                            sampleDirection (*world.continuumGrid, position());
+                        if (flow != Vec3::zero)
+                            pathFollow = (flow * maxSpeed()) - velocity();
+                    }
+
                     // add in to steeringForce
                     steeringForce += pathFollow * 0.5;
+                    world.endStage (PedestrianWorld::pathFollowingStage, stageStart);
                 }
             }
 
@@ -267,7 +549,7 @@ namespace {
         void annotatePathFollowing (const Vec3& future,
                                     const Vec3& onPath,
                                     const Vec3& target,
-                                    const float outside)
+                                    const float outside) const
         {
             const Color yellow (1, 1, 0);
             const Color lightOrange (1.0f, 0.5f, 0.0f);
@@ -292,7 +574,7 @@ namespace {
         // called when steerToAvoidCloseNeighbors decides steering is required
         // (parameter names commented out to prevent compiler warning from "-W")
         void annotateAvoidCloseNeighbor (const AbstractVehicle& other,
-                                         const float /*additionalDistance*/)
+                                         const float /*additionalDistance*/) const
         {
             // draw the word "Ouch!" above colliding vehicles
             const float headOn = forward().dot(other.forward()) < 0;
@@ -310,7 +592,7 @@ namespace {
         void annotateAvoidNeighbor (const AbstractVehicle& threat,
                                     const float /*steer*/,
                                     const Vec3& ourFuture,
-                                    const Vec3& threatFuture)
+                                    const Vec3& threatFuture) const
         {
             const Color green (0.15f, 0.6f, 0.0f);
 
@@ -324,7 +606,7 @@ namespace {
         // xxx perhaps this should be a call to a general purpose annotation for
         // xxx "local xxx axis aligned box in XZ plane" -- same code in in
         // xxx CaptureTheFlag.cpp
-        void annotateAvoidObstacle (const float minDistanceToCollision)
+        void annotateAvoidObstacle (const float minDistanceToCollision) const
         {
             const Vec3 boxSide = side() * radius();
             const Vec3 boxFront = forward() * minDistanceToCollision;
@@ -349,26 +631,306 @@ namespace {
             proximityToken = pd.allocateToken (this);
         }
 
+        // the crowd this pedestrian belongs to
+        PedestrianWorld& world;
+
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
+        // neighbors found by the last proximity query (per-instance so that
+        // pedestrians of different worlds can be updated concurrently)
+        AVGroup neighbors;
 
         // path to be followed by this pedestrian
         // XXX Ideally this should be a generic Pathway, but we use the
         // XXX getTotalPathLength and radius methods (currently defined only
         // XXX on PolylinePathway) to set random initial positions.  Could
         // XXX there be a "random position inside path" method on Pathway?
-        PolylineSegmentedPathwaySingleRadius* path;
+        const IndexedPathway* path;
 
         // direction for path following (upstream or downstream)
         int pathDirection;
+
+        // time at which resting at the last reached endpoint ends
+        float restUntil;
     };
 
 
-    AVGroup Pedestrian::neighbors;
+    // ----------------------------------------------------------------------------
+
+
+    PedestrianWorld::PedestrianWorld (void)
+        : pd (NULL),
+          population (0),
+          startPopulation (100),
+          cyclePD (-1),
+          density (0),
+          path (),
+          obstacle3 (7,7),
+          seed (0),
+          obstacleLeadTime (6),
+          avoidanceLeadTime (3),
+          pathFollowingLeadTime (3),
+          useDirectedPathFollowing (true),
+          wanderSwitch (true),
+          useReciprocalAvoidance (false),
+          useContinuumCrowd (false),
+          continuumGrid (NULL),
+          useSleeping (false),
+          sleepScheduler (NULL),
+          endpointRestTime (10),
+          endpointsReached (0),
+          scenarioLoadSeconds (0),
+          measureStages (false)
+    {
+        for (int i = 0; i < stageCount; i++) stageSeconds[i] = 0;
+    }
+
+
+    bool PedestrianWorld::setOption (const char* name, const char* value)
+    {
+        const float number = (float) std::atof (value);
+        const bool on = (std::atoi (value) != 0);
+        if (std::strcmp (name, "pedestrians") == 0)
+            startPopulation = std::atoi (value);
+        else if (std::strcmp (name, "seed") == 0)
+            seed = (unsigned int) std::strtoul (value, NULL, 10);
+        else if (std::strcmp (name, "obstacleLeadTime") == 0)
+            obstacleLeadTime = number;
+        else if (std::strcmp (name, "avoidanceLeadTime") == 0)
+            avoidanceLeadTime = number;
+        else if (std::strcmp (name, "pathFollowingLeadTime") == 0)
+            pathFollowingLeadTime = number;
+        else if (std::strcmp (name, "useDirectedPathFollowing") == 0)
+            useDirectedPathFollowing = on;
+        else if (std::strcmp (name, "wanderSwitch") == 0)
+            wanderSwitch = on;
+        else if (std::strcmp (name, "useReciprocalAvoidance") == 0)
+            useReciprocalAvoidance = on;
+        else if (std::strcmp (name, "useContinuumCrowd") == 0)
+            useContinuumCrowd = on;
+        else if (std::strcmp (name, "useSleeping") == 0)
+            useSleeping = on;
+        else if (std::strcmp (name, "endpointRestTime") == 0)
+            endpointRestTime = number;
+        else if (std::strcmp (name, "density") == 0)
+            density = number;
+        else if (std::strcmp (name, "stageTimings") == 0)
+            measureStages = on;
+        else if (std::strcmp (name, "scenario") == 0)
+            return loadScenario (value);
+        else if (std::strcmp (name, "saveScenario") == 0)
+            saveScenarioFileName = value;
+        else
+            return false;
+        return true;
+    }
+
+
+    void PedestrianWorld::open (void)
+    {
+        makePath ();
+        makeContinuumGrid ();
+        sizeProximityGrid ();
+
+        // make the database used to accelerate proximity queries
+        cyclePD = -1;
+        nextPD ();
+
+        // seed before the crowd is made, the pedestrians are placed with it.
+        // Worlds are opened one at a time, so seeds drawn from rand are
+        // reproducible too
+        random.setSeed ((seed != 0) ? seed : (unsigned int) std::rand ());
+
+        // sleeping pedestrians are kept in their own bin lattice
+        sleepScheduler = new SleepScheduler (gridCenter, gridDimensions,
+                                             gridDivisions);
+        // resting pedestrians don't steer, so they are only woken when
+        // someone is about to bump into them
+        sleepScheduler->setWakeRadius (1);
+
+        // create the specified number of Pedestrians
+        population = 0;
+        addPedestriansToCrowd (startPopulation);
+
+        // place them as the scenario says
+        const Scenario::size_type walkers = scenario.findPopulation ("pedestrians");
+        if (walkers != Scenario::npos)
+        {
+            const Scenario::Population& p = scenario.populations()[walkers];
+            const Scenario::Agent* agents = scenario.populationAgents (p);
+            const int count = minXXX ((int) p.agentCount, population);
+            for (int i = 0; i < count; i++) crowd[i]->place (agents[i]);
+        }
+
+        if (!saveScenarioFileName.empty () && !saveScenario (saveScenarioFileName))
+            std::cerr << "can't write scenario " << saveScenarioFileName
+                      << std::endl;
+
+        endpointsReached = 0;
+        for (int i = 0; i < stageCount; i++) stageSeconds[i] = 0;
+    }
+
+
+    void PedestrianWorld::update (const float currentTime,
+                                  const float elapsedTime)
+    {
+        // rebuild the continuum crowd fields for this frame
+        if (useContinuumCrowd) updateContinuumCrowd ();
+
+        if (useSleeping)
+        {
+            // wake the sleepers whose rest at an endpoint is over
+            for (size_t i = 0; i < crowd.size (); i++)
+                if (sleepScheduler->isAsleep (i) &&
+                    !crowd[i]->resting (currentTime))
+                    sleepScheduler->wake (i);
+
+            // update each awake Pedestrian
+            sleepScheduler->update (allVehicles (), currentTime, elapsedTime);
+        }
+        else
+        {
+            // update each Pedestrian
+            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            {
+                (**i).update (currentTime, elapsedTime);
+            }
+        }
+    }
+
+
+    void PedestrianWorld::close (void)
+    {
+        // delete all Pedestrians
+        while (population > 0) removePedestrianFromCrowd ();
+
+        delete sleepScheduler;
+        sleepScheduler = NULL;
+
+        delete pd;
+        pd = NULL;
+
+        delete continuumGrid;
+        continuumGrid = NULL;
+        potentialToEndpoint[0].clearGoals ();
+        potentialToEndpoint[1].clearGoals ();
+
+        obstacles.clear ();
+
+        scenarioSpheres.clear ();
+        scenarioBoxes.clear ();
+
+        // release the path, destroy it unless other worlds still walk it
+        path.reset ();
+        PathRegistry::shared().removeUnused ();
+    }
+
+
+    void PedestrianWorld::printStatistics (std::ostream& os)
+    {
+        float speed = 0;
+        for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            speed += (**i).speed ();
+
+        os << "pedestrians:         " << population << std::endl
+           << "mean speed:          "
+           << speed / maxXXX (1.0f, (float) population) << std::endl
+           << "endpoints reached:   " << endpointsReached << std::endl
+           << "path length:         " << path->length () << std::endl
+           << "path grid cells:     " << path->cellCount () << " ("
+           << path->meanSegmentsPerCell () << " of "
+           << path->polyline().segmentCount () << " segments per cell)"
+           << std::endl
+           << "grid divisions:      " << gridDivisions.x << " x "
+           << gridDivisions.z << std::endl;
+        if (!scenario.name().empty ())
+            os << "scenario:            " << scenario.name () << " (loaded in "
+               << scenarioLoadSeconds * 1000 << " ms)" << std::endl;
+        if (useSleeping)
+            os << "asleep:              "
+               << sleepScheduler->sleepingVehicleCount () << std::endl;
+        if (measureStages)
+        {
+            const char* names[stageCount] = {"neighbor query (s): ",
+                                             "avoidance (s):      ",
+                                             "path following (s): ",
+                                             "integration (s):    "};
+            for (int i = 0; i < stageCount; i++)
+                os << names[i] << " " << stageSeconds[i] << std::endl;
+        }
+    }
+
+
+    void PedestrianWorld::addPedestrianToCrowd (void)
+    {
+        population++;
+        crowd.push_back (new Pedestrian (*this));
+    }
+
+
+    void PedestrianWorld::addPedestriansToCrowd (const int count)
+    {
+        crowd.reserve (crowd.size() + count);
+        for (int i = 0; i < count; i++)
+            crowd.push_back (new Pedestrian (*this));
+        population += count;
+    }
+
+
+    void PedestrianWorld::removePedestrianFromCrowd (void)
+    {
+        if (population > 0)
+        {
+            // save pointer to last pedestrian, then remove it from the crowd
+            const Pedestrian* pedestrian = crowd.back();
+            sleepScheduler->remove (crowd.size() - 1);
+            crowd.pop_back();
+            population--;
+
+            // delete the Pedestrian
+            delete pedestrian;
+        }
+    }
+
+
+    void PedestrianWorld::nextPD (void)
+    {
+        // save pointer to old PD
+        ProximityDatabase* oldPD = pd;
+
+        // allocate new PD
+        const int totalPD = 2;
+        switch (cyclePD = (cyclePD + 1) % totalPD)
+        {
+        case 0:
+            {
+                typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+                pd = new LQPDAV (gridCenter, gridDimensions, gridDivisions);
+                break;
+            }
+        case 1:
+            {
+                pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
+                break;
+            }
+        }
+
+        // switch each boid to new PD
+        for (iterator i=crowd.begin(); i!=crowd.end(); i++) (**i).newPD(*pd);
+
+        // delete old PD (if any)
+        delete oldPD;
+    }
+
+
+    void PedestrianWorld::toggleSleeping (void)
+    {
+        useSleeping = !useSleeping;
+
+        // sleepers are only skipped while sleeping is on
+        sleepScheduler->reset ();
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -393,74 +955,291 @@ namespace {
     //
 
 
-    PolylineSegmentedPathwaySingleRadius* getTestPath (void)
+    void PedestrianWorld::makePath (void)
     {
-        if (gTestPath == NULL)
-        {
-            const float pathRadius = 2;
-
-            const PolylineSegmentedPathwaySingleRadius::size_type pathPointCount = 7;
-            const float size = 30;
-            const float top = 2 * size;
-            const float gap = 1.2f * size;
-            const float out = 2 * size;
-            const float h = 0.5;
-            const Vec3 pathPoints[pathPointCount] =
-                {Vec3 (h+gap-out,     0,  h+top-out),  // 0 a
-                 Vec3 (h+gap,         0,  h+top),      // 1 b
-                 Vec3 (h+gap+(top/2), 0,  h+top/2),    // 2 c
-                 Vec3 (h+gap,         0,  h),          // 3 d
-                 Vec3 (h,             0,  h),          // 4 e
-                 Vec3 (h,             0,  h+top),      // 5 f
-                 Vec3 (h+gap,         0,  h+top/2)};   // 6 g
-
-            gObstacle1.center = interpolate (0.2f, pathPoints[0], pathPoints[1]);
-            gObstacle2.center = interpolate (0.5f, pathPoints[2], pathPoints[3]);
-            gObstacle1.radius = 3;
-            gObstacle2.radius = 5;
-            gObstacles.push_back (&gObstacle1);
-            gObstacles.push_back (&gObstacle2);
+        // a scenario brings its own path and obstacles
+        const Scenario::size_type scenarioPath = scenario.findPath ("pedestrians");
+        if (scenarioPath != Scenario::npos)
+        {
+            path = scenario.acquirePath (scenarioPath, PathRegistry::shared ());
+            endpoint0 = path->point (0);
+            endpoint1 = path->point (path->pointCount () - 1);
+            scenario.buildObstacles (scenarioSpheres, scenarioBoxes, obstacles);
+            return;
+        }
+
+        const float pathRadius = 2;
+
+        const IndexedPathway::size_type pathPointCount = 7;
+
+        // the figure is about 10.4 times as long as its size: make it long
+        // enough for the crowd at the requested density
+        const float originalSize = 30;
+        const float originalArea = 10.42f * originalSize * 2 * pathRadius;
+        const float scale = ((density > 0) ?
+                             maxXXX (1.0f, startPopulation / (density * originalArea)) :
+                             1.0f);
+
+        const float size = originalSize * scale;
+        const float top = 2 * size;
+        const float gap = 1.2f * size;
+        const float out = 2 * size;
+        const float h = 0.5;
+        const Vec3 pathPoints[pathPointCount] =
+            {Vec3 (h+gap-out,     0,  h+top-out),  // 0 a
+             Vec3 (h+gap,         0,  h+top),      // 1 b
+             Vec3 (h+gap+(top/2), 0,  h+top/2),    // 2 c
+             Vec3 (h+gap,         0,  h),          // 3 d
+             Vec3 (h,             0,  h),          // 4 e
+             Vec3 (h,             0,  h+top),      // 5 f
+             Vec3 (h+gap,         0,  h+top/2)};   // 6 g
+
+        obstacle1.center = interpolate (0.2f, pathPoints[0], pathPoints[1]);
+        obstacle2.center = interpolate (0.5f, pathPoints[2], pathPoints[3]);
+        obstacle1.radius = 3;
+        obstacle2.radius = 5;
+        obstacles.push_back (&obstacle1);
+        obstacles.push_back (&obstacle2);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
 
-            gObstacles.push_back (&gObstacle3);
+        obstacles.push_back (&obstacle3);
 
-    //         // rotated to be perpendicular with path
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, 0, 1);
-    //         gObstacle3.setPosition (20, 0, h);
+    //     // rotated to be perpendicular with path
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, 0, 1);
+    //     obstacle3.setPosition (20, 0, h);
 
-    //         // moved up to test off-center
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, 0, 1);
-    //         gObstacle3.setPosition (20, 3, h);
+    //     // moved up to test off-center
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, 0, 1);
+    //     obstacle3.setPosition (20, 3, h);
 
-    //         // rotated 90 degrees around path to test other local axis
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, -1, 0);
-    //         gObstacle3.setUp (0, 0, -1);
-    //         gObstacle3.setPosition (20, 0, h);
+    //     // rotated 90 degrees around path to test other local axis
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, -1, 0);
+    //     obstacle3.setUp (0, 0, -1);
+    //     obstacle3.setPosition (20, 0, h);
 
-            // tilted 45 degrees
-            gObstacle3.setForward (Vec3(1,1,0).normalize());
-            gObstacle3.setSide (0,0,1);
-            gObstacle3.setUp (Vec3(-1,1,0).normalize());
-            gObstacle3.setPosition (20, 0, h);
+        // tilted 45 degrees
+        obstacle3.setForward (Vec3(1,1,0).normalize());
+        obstacle3.setSide (0,0,1);
+        obstacle3.setUp (Vec3(-1,1,0).normalize());
+        obstacle3.setPosition (20 * scale, 0, h);
 
-    //         gObstacle3.setSeenFrom (Obstacle::outside);
-    //         gObstacle3.setSeenFrom (Obstacle::inside);
-            gObstacle3.setSeenFrom (Obstacle::both);
+    //     obstacle3.setSeenFrom (Obstacle::outside);
+    //     obstacle3.setSeenFrom (Obstacle::inside);
+        obstacle3.setSeenFrom (Obstacle::both);
 
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
 
-            gEndpoint0 = pathPoints[0];
-            gEndpoint1 = pathPoints[pathPointCount-1];
+        endpoint0 = pathPoints[0];
+        endpoint1 = pathPoints[pathPointCount-1];
+
+        // worlds scaled alike share the path and its segment grid (nine
+        // digits tell all floats apart)
+        std::ostringstream pathName;
+        pathName << "Pedestrians figure at scale " << std::setprecision (9)
+                 << scale;
+        path = PathRegistry::shared().acquire (pathName.str (),
+                                               pathPointCount,
+                                               pathPoints,
+                                               pathRadius,
+                                               false);
+    }
+
+
+    // ----------------------------------------------------------------------------
+    // a scenario for this PlugIn has a path called "pedestrians", it may have
+    // obstacles, a population called "pedestrians" and parameters (which are
+    // options of this PlugIn)
+
 
-            gTestPath = new PolylineSegmentedPathwaySingleRadius (pathPointCount,
-                                                                  pathPoints,
-                                                                  pathRadius,
-                                                                  false);
+    bool PedestrianWorld::loadScenario (const char* fileName)
+    {
+        const Stopwatch stopwatch;
+        if (!scenario.load (fileName))
+        {
+            std::cerr << scenario.errorMessage () << std::endl;
+            return false;
+        }
+        if (scenario.findPath ("pedestrians") == Scenario::npos)
+        {
+            std::cerr << fileName << ": no path \"pedestrians\"" << std::endl;
+            scenario.clear ();
+            return false;
+        }
+        scenarioLoadSeconds = stopwatch.elapsedSeconds ();
+
+        for (size_t i = 0; i < scenario.parameters().size(); i++)
+        {
+            const Scenario::Parameter& parameter = scenario.parameters()[i];
+            if ((parameter.first == "scenario") ||
+                !setOption (parameter.first.c_str (), parameter.second.c_str ()))
+            {
+                std::cerr << fileName << ": unknown parameter "
+                          << parameter.first << std::endl;
+                return false;
+            }
+        }
+
+        const Scenario::size_type walkers = scenario.findPopulation ("pedestrians");
+        if (walkers != Scenario::npos)
+            startPopulation = (int) scenario.populations()[walkers].agentCount;
+        return true;
+    }
+
+
+    bool PedestrianWorld::saveScenario (const std::string& fileName)
+    {
+        Scenario saved;
+
+        std::vector<Vec3> points;
+        for (size_t i = 0; i < path->pointCount (); i++)
+            points.push_back (path->point (i));
+        saved.addPath ("pedestrians", path->radius (), path->isCyclic (),
+                       points.size (), &points[0]);
+
+        // the format has no planar obstacles (the tilted rectangle)
+        for (ObstacleIterator i = obstacles.begin(); i != obstacles.end(); i++)
+        {
+            const SphereObstacle* sphere = dynamic_cast<const SphereObstacle*> (*i);
+            const BoxObstacle* box = dynamic_cast<const BoxObstacle*> (*i);
+            if (sphere) saved.addSphere (sphere->center, sphere->radius);
+            if (box)
+            {
+                const Scenario::Box record =
+                    {box->position (), box->forward (), box->side (), box->up (),
+                     box->width, box->height, box->depth};
+                saved.addBox (record);
+            }
+        }
+
+        std::vector<Scenario::Agent> agents (crowd.size ());
+        for (size_t i = 0; i < crowd.size (); i++)
+        {
+            agents[i].position = crowd[i]->position ();
+            agents[i].forward = crowd[i]->forward ();
+            agents[i].speed = crowd[i]->speed ();
+        }
+        if (!agents.empty ())
+            saved.addPopulation ("pedestrians", agents.size (), &agents[0]);
+
+        const bool asText = (fileName.size () > 4) &&
+            (fileName.compare (fileName.size () - 4, 4, ".txt") == 0);
+        return saved.save (fileName, asText ? Scenario::text : Scenario::binary);
+    }
+
+
+    // ----------------------------------------------------------------------------
+    // the proximity grid covers the path's bounding box (the original one
+    // is 80 meters wide with 20 by 20 bins), its bins are made smaller when
+    // the path is crowded so that each holds about binPopulation pedestrians
+
+
+    void PedestrianWorld::sizeProximityGrid (void)
+    {
+        typedef IndexedPathway::size_type size_type;
+
+        // bounding box of the path, with a margin for pedestrians pushed
+        // out of the path
+        Vec3 minCorner = path->point (0);
+        Vec3 maxCorner = path->point (0);
+        for (size_type i = 1; i < path->pointCount(); i++)
+        {
+            const Vec3 p = path->point (i);
+            minCorner.set (minXXX (minCorner.x, p.x), 0, minXXX (minCorner.z, p.z));
+            maxCorner.set (maxXXX (maxCorner.x, p.x), 0, maxXXX (maxCorner.z, p.z));
         }
-        return gTestPath;
+        const float margin = path->radius() * 4;
+        const float width = maxXXX (80.0f, maxXXX (maxCorner.x - minCorner.x,
+                                                   maxCorner.z - minCorner.z) + 2 * margin);
+
+        // pedestrians per square meter on the path
+        const float pathArea = path->length() * 2 * path->radius();
+        const float crowdDensity = maxXXX (startPopulation, population) / pathArea;
+
+        // bins are at least 1 meter (two pedestrians) wide, at most 4
+        // meters (the 80 meter box with 20 bins), and there are no more than
+        // 1024 of them along each side
+        const float binPopulation = 8;
+        const float binSize = clip (sqrtXXX (binPopulation / crowdDensity), 1.0f, 4.0f);
+        const float divisions = minXXX (1024.0f, ceilf (width / binSize));
+
+        gridCenter = interpolate (0.5f, minCorner, maxCorner);
+        gridDimensions.set (width, width, width);
+        gridDivisions.set (divisions, 1, divisions);
+    }
+
+
+    // ----------------------------------------------------------------------------
+    // create the continuum crowd grid covering the test path: cells outside
+    // the path or inside the round obstacles are impassable, the goals of the
+    // two potentials are the path's endpoints
+
+
+    void PedestrianWorld::makeContinuumGrid (void)
+    {
+        typedef IndexedPathway::size_type size_type;
+        typedef ContinuumCrowdGrid::size_type cell_type;
+
+        // bounding box of the path
+        Vec3 minCorner = path->point (0);
+        Vec3 maxCorner = path->point (0);
+        for (size_type i = 1; i < path->pointCount(); i++)
+        {
+            const Vec3 p = path->point (i);
+            minCorner.set (minXXX (minCorner.x, p.x), 0, minXXX (minCorner.z, p.z));
+            maxCorner.set (maxXXX (maxCorner.x, p.x), 0, maxXXX (maxCorner.z, p.z));
+        }
+        const float margin = path->radius() + 1;
+        const Vec3 size = maxCorner - minCorner;
+
+        ContinuumCrowdGrid::Parameters parameters;
+        parameters.maxSpeed = 2; // Pedestrian's maxSpeed
+        continuumGrid = new ContinuumCrowdGrid (interpolate (0.5f, minCorner, maxCorner),
+                                                size.x + 2 * margin,
+                                                size.z + 2 * margin,
+                                                1, // cell size
+                                                parameters);
+
+        for (cell_type row = 0; row < continuumGrid->rowCount(); row++)
+        {
+            for (cell_type column = 0; column < continuumGrid->columnCount(); column++)
+            {
+                const Vec3 center = continuumGrid->cellCenter (column, row);
+                Vec3 tangent;
+                float outside;
+                path->mapPointToPath (center, tangent, outside);
+                bool inObstacle = false;
+                for (ObstacleIterator o = obstacles.begin(); o != obstacles.end(); o++)
+                {
+                    const SphereObstacle* sphere = dynamic_cast<const SphereObstacle*> (*o);
+                    if (sphere && (Vec3::distance (center, sphere->center) < sphere->radius))
+                        inObstacle = true;
+                }
+                continuumGrid->setPassable (column, row,
+                                            (outside < 0) && !inObstacle);
+            }
+        }
+
+        potentialToEndpoint[0].addGoal (*continuumGrid, endpoint0, path->radius());
+        potentialToEndpoint[1].addGoal (*continuumGrid, endpoint1, path->radius());
+    }
+
+
+    void PedestrianWorld::updateContinuumCrowd (void)
+    {
+        ContinuumCrowdGrid& grid = *continuumGrid;
+
+        grid.clear ();
+        for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            grid.splat ((**i).position(), (**i).velocity());
+        grid.computeCosts ();
+
+        // (in parallel, they share the grid)
+        #pragma omp parallel for
+        for (int goal = 0; goal < 2; goal++)
+            potentialToEndpoint[goal].compute (grid);
     }
 
 
@@ -480,16 +1259,12 @@ namespace {
 
         void open (void)
         {
-            // make the database used to accelerate proximity queries
-            cyclePD = -1;
-            nextPD ();
-
-            // create the specified number of Pedestrians
-            population = 0;
-            for (int i = 0; i < gPedestrianStartCount; i++) addPedestrianToCrowd ();
+            // make the path, obstacles and the crowd
+            world.open ();
 
             // initialize camera and selectedVehicle
-            Pedestrian& firstPedestrian = **crowd.begin();
+            Pedestrian& firstPedestrian = **world.crowd.begin();
+            OpenSteerDemo::selectedVehicle = &firstPedestrian;
             OpenSteerDemo::init3dCamera (firstPedestrian);
             OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
             OpenSteerDemo::camera.fixedTarget.set (15, 0, 30);
@@ -498,11 +1273,7 @@ namespace {
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++)
-            {
-                (**i).update (currentTime, elapsedTime);
-            }
+            world.update (currentTime, elapsedTime);
         }
 
         void redraw (const float currentTime, const float elapsedTime)
@@ -521,7 +1292,7 @@ namespace {
             OpenSteerDemo::gridUtility (gridCenter);
 
             // draw and annotate each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).draw (); 
+            for (iterator i = world.crowd.begin(); i != world.crowd.end(); i++) (**i).draw (); 
 
             // draw the path they follow and obstacles they avoid
             drawPathAndObstacles ();
@@ -554,20 +1325,33 @@ namespace {
 
             // display status in the upper left corner of the window
             std::ostringstream status;
-            status << "[F1/F2] Crowd size: " << population;
+            status << "[F1/F2] Crowd size: " << world.population;
             status << "\n[F3] PD type: ";
-            switch (cyclePD)
+            switch (world.cyclePD)
             {
             case 0: status << "LQ bin lattice"; break;
             case 1: status << "brute force";    break;
             }
             status << "\n[F4] ";
-            if (gUseDirectedPathFollowing)
+            if (world.useDirectedPathFollowing)
                 status << "Directed path following.";
             else
                 status << "Stay on the path.";
             status << "\n[F5] Wander: ";
-            if (gWanderSwitch) status << "yes"; else status << "no";
+            if (world.wanderSwitch) status << "yes"; else status << "no";
+            status << "\n[F6] Neighbor avoidance: ";
+            if (world.useReciprocalAvoidance)
+                status << "reciprocal (ORCA)";
+            else
+                status << "predictive";
+            status << "\n[F7] Continuum crowd: ";
+            if (world.useContinuumCrowd) status << "yes"; else status << "no";
+            status << "\n[F8] Sleep at rest: ";
+            if (world.useSleeping)
+                status << world.sleepScheduler->sleepingVehicleCount () << " asleep, "
+                       << world.sleepScheduler->awakeVehicleCount () << " awake";
+            else
+                status << "no";
             status << std::endl;
             const float h = drawGetWindowHeight ();
             const Vec3 screenLocation (10, h-50, 0);
@@ -582,7 +1366,7 @@ namespace {
             // screen position when it is near the selected vehicle or mouse.
             if (&selected && &nearMouse && OpenSteer::annotationIsOn())
             {
-                for (iterator i = crowd.begin(); i != crowd.end(); i++)
+                for (iterator i = world.crowd.begin(); i != world.crowd.end(); i++)
                 {
                     AbstractVehicle* vehicle = *i;
                     const float nearDistance = 6;
@@ -607,28 +1391,46 @@ namespace {
 
         void drawPathAndObstacles (void)
         {
-            typedef PolylineSegmentedPathwaySingleRadius::size_type size_type;
+            typedef IndexedPathway::size_type size_type;
             
             // draw a line along each segment of path
-            const PolylineSegmentedPathwaySingleRadius& path = *getTestPath ();
+            const IndexedPathway& path = *world.path;
             for (size_type i = 1; i < path.pointCount(); ++i ) {
                 drawLine (path.point( i ), path.point( i-1) , gRed);
             }
             
             // draw obstacles
-            drawXZCircle (gObstacle1.radius, gObstacle1.center, gWhite, 40);
-            drawXZCircle (gObstacle2.radius, gObstacle2.center, gWhite, 40);
+            for (ObstacleIterator o = world.obstacles.begin(); o != world.obstacles.end(); o++)
+            {
+                const SphereObstacle* sphere = dynamic_cast<const SphereObstacle*> (*o);
+                const BoxObstacle* box = dynamic_cast<const BoxObstacle*> (*o);
+                if (sphere) drawXZCircle (sphere->radius, sphere->center, gWhite, 40);
+                if (box)
+                {
+                    // the twelve edges join corners differing in one axis
+                    Vec3 corners[8];
+                    for (int i = 0; i < 8; i++)
+                        corners[i] = box->globalizePosition
+                            (Vec3 (box->width  * ((i & 1) ? 0.5f : -0.5f),
+                                   box->height * ((i & 2) ? 0.5f : -0.5f),
+                                   box->depth  * ((i & 4) ? 0.5f : -0.5f)));
+                    for (int i = 0; i < 8; i++)
+                        for (int axis = 1; axis < 8; axis *= 2)
+                            if (!(i & axis)) drawLine (corners[i], corners[i | axis], gWhite);
+                }
+            }
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+            if (world.scenario.name().empty ())
             {
-                float w = gObstacle3.width * 0.5f;
-                Vec3 p = gObstacle3.position ();
-                Vec3 s = gObstacle3.side ();
+                float w = world.obstacle3.width * 0.5f;
+                Vec3 p = world.obstacle3.position ();
+                Vec3 s = world.obstacle3.side ();
                 drawLine (p + (s * w), p + (s * -w), gWhite);
 
-                Vec3 v1 = gObstacle3.globalizePosition (Vec3 (w, w, 0));
-                Vec3 v2 = gObstacle3.globalizePosition (Vec3 (-w, w, 0));
-                Vec3 v3 = gObstacle3.globalizePosition (Vec3 (-w, -w, 0));
-                Vec3 v4 = gObstacle3.globalizePosition (Vec3 (w, -w, 0));
+                Vec3 v1 = world.obstacle3.globalizePosition (Vec3 (w, w, 0));
+                Vec3 v2 = world.obstacle3.globalizePosition (Vec3 (-w, w, 0));
+                Vec3 v3 = world.obstacle3.globalizePosition (Vec3 (-w, -w, 0));
+                Vec3 v4 = world.obstacle3.globalizePosition (Vec3 (w, -w, 0));
 
                 drawLine (v1, v2, gWhite);
                 drawLine (v2, v3, gWhite);
@@ -640,14 +1442,18 @@ namespace {
 
         void close (void)
         {
-            // delete all Pedestrians
-           while (population > 0) removePedestrianFromCrowd ();
+            // delete all Pedestrians and what they walk on
+            OpenSteerDemo::selectedVehicle = NULL;
+            world.close ();
         }
 
         void reset (void)
         {
             // reset each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).reset ();
+            for (iterator i = world.crowd.begin(); i != world.crowd.end(); i++) (**i).reset ();
+
+            // wake everyone up
+            world.sleepScheduler->reset ();
 
             // reset camera position
             OpenSteerDemo::position2dCamera (*OpenSteerDemo::selectedVehicle);
@@ -660,11 +1466,14 @@ namespace {
         {
             switch (keyNumber)
             {
-            case 1:  addPedestrianToCrowd ();                               break;
-            case 2:  removePedestrianFromCrowd ();                          break;
-            case 3:  nextPD ();                                             break;
-            case 4: gUseDirectedPathFollowing = !gUseDirectedPathFollowing; break;
-            case 5: gWanderSwitch = !gWanderSwitch;                         break;
+            case 1:  addPedestrianToCrowd ();                                           break;
+            case 2:  removePedestrianFromCrowd ();                                      break;
+            case 3:  world.nextPD ();                                                   break;
+            case 4: world.useDirectedPathFollowing = !world.useDirectedPathFollowing;   break;
+            case 5: world.wanderSwitch = !world.wanderSwitch;                           break;
+            case 6: world.useReciprocalAvoidance = !world.useReciprocalAvoidance;       break;
+            case 7: world.useContinuumCrowd = !world.useContinuumCrowd;                 break;
+            case 8: world.toggleSleeping ();                                            break;
             }
         }
 
@@ -680,92 +1489,50 @@ namespace {
             OpenSteerDemo::printMessage ("  F3     use next proximity database.");
             OpenSteerDemo::printMessage ("  F4     toggle directed path follow.");
             OpenSteerDemo::printMessage ("  F5     toggle wander component on/off.");
+            OpenSteerDemo::printMessage ("  F6     toggle reciprocal neighbor avoidance.");
+            OpenSteerDemo::printMessage ("  F7     toggle continuum crowd steering.");
+            OpenSteerDemo::printMessage ("  F8     toggle sleeping of pedestrians at rest.");
             OpenSteerDemo::printMessage ("");
         }
 
-
-        void addPedestrianToCrowd (void)
+        // options and statistics of headless runs are those of the world
+        bool setOption (const char* name, const char* value)
         {
-            population++;
-            Pedestrian* pedestrian = new Pedestrian (*pd);
-            crowd.push_back (pedestrian);
-            if (population == 1) OpenSteerDemo::selectedVehicle = pedestrian;
+            return world.setOption (name, value);
         }
 
-
-        void removePedestrianFromCrowd (void)
+        void printStatistics (std::ostream& os)
         {
-            if (population > 0)
-            {
-                // save pointer to last pedestrian, then remove it from the crowd
-                const Pedestrian* pedestrian = crowd.back();
-                crowd.pop_back();
-                population--;
-
-                // if it is OpenSteerDemo's selected vehicle, unselect it
-                if (pedestrian == OpenSteerDemo::selectedVehicle)
-                    OpenSteerDemo::selectedVehicle = NULL;
-
-                // delete the Pedestrian
-                delete pedestrian;
-            }
+            world.printStatistics (os);
         }
 
+        // any number of crowds can be run in batches
+        AbstractWorld* makeWorld (void) {return new PedestrianWorld;}
 
-        // for purposes of demonstration, allow cycling through various
-        // types of proximity databases.  this routine is called when the
-        // OpenSteerDemo user pushes a function key.
-        void nextPD (void)
+        void addPedestrianToCrowd (void)
         {
-            // save pointer to old PD
-            ProximityDatabase* oldPD = pd;
-
-            // allocate new PD
-            const int totalPD = 2;
-            switch (cyclePD = (cyclePD + 1) % totalPD)
-            {
-            case 0:
-                {
-                    const Vec3 center;
-                    const float div = 20.0f;
-                    const Vec3 divisions (div, 1.0f, div);
-                    const float diameter = 80.0f; //XXX need better way to get this
-                    const Vec3 dimensions (diameter, diameter, diameter);
-                    typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
-                    pd = new LQPDAV (center, dimensions, divisions);
-                    break;
-                }
-            case 1:
-                {
-                    pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
-                    break;
-                }
-            }
+            world.addPedestrianToCrowd ();
+            if (world.population == 1)
+                OpenSteerDemo::selectedVehicle = world.crowd.back ();
+        }
 
-            // switch each boid to new PD
-            for (iterator i=crowd.begin(); i!=crowd.end(); i++) (**i).newPD(*pd);
+        void removePedestrianFromCrowd (void)
+        {
+            // if the last one is OpenSteerDemo's selected vehicle, unselect it
+            if ((world.population > 0) &&
+                (world.crowd.back () == OpenSteerDemo::selectedVehicle))
+                OpenSteerDemo::selectedVehicle = NULL;
 
-            // delete old PD (if any)
-            delete oldPD;
+            world.removePedestrianFromCrowd ();
         }
 
+        const AVGroup& allVehicles (void) {return world.allVehicles ();}
 
-        const AVGroup& allVehicles (void) {return (const AVGroup&) crowd;}
-
-        // crowd: a group (STL vector) of all Pedestrians
-        Pedestrian::groupType crowd;
-        typedef Pedestrian::groupType::const_iterator iterator;
+        // the crowd shown by the demo
+        PedestrianWorld world;
+        typedef PedestrianWorld::iterator iterator;
 
         Vec3 gridCenter;
-
-        // pointer to database used to accelerate proximity queries
-        ProximityDatabase* pd;
-
-        // keep track of current flock size
-        int population;
-
-        // which of the various proximity databases is currently in use
-        int cyclePD;
     };
 
 
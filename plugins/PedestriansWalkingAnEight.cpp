@@ -39,7 +39,7 @@
 
 #include <iomanip>
 #include <sstream>
-#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/PathRegistry.h"
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Proximity.h"
@@ -62,9 +62,9 @@ namespace {
     
     // How many pedestrians to create when the plugin starts first?
     int const gPedestrianStartCount = 1; // 100
-    // creates a path for the PlugIn
-    PolylineSegmentedPathwaySingleRadius* getTestPath (void);
-    PolylineSegmentedPathwaySingleRadius* gTestPath = NULL;
+    // acquires the path for the PlugIn from the shared PathRegistry
+    const IndexedPathway* getTestPath (void);
+    PathRegistry::PathPointer gTestPath;
     ObstacleGroup gObstacles;
     Vec3 gEndpoint0;
     Vec3 gEndpoint1;
@@ -262,7 +262,7 @@ public:
         void annotatePathFollowing (const Vec3& future,
                                     const Vec3& onPath,
                                     const Vec3& target,
-                                    const float outside)
+                                    const float outside) const
         {
             const Color yellow (1, 1, 0);
             const Color lightOrange (1.0f, 0.5f, 0.0f);
@@ -287,7 +287,7 @@ public:
         // called when steerToAvoidCloseNeighbors decides steering is required
         // (parameter names commented out to prevent compiler warning from "-W")
         void annotateAvoidCloseNeighbor (const AbstractVehicle& other,
-                                         const float /*additionalDistance*/)
+                                         const float /*additionalDistance*/) const
                                          {
             // draw the word "Ouch!" above colliding vehicles
             const float headOn = forward().dot(other.forward()) < 0;
@@ -305,7 +305,7 @@ public:
                                          void annotateAvoidNeighbor (const AbstractVehicle& threat,
                                                                      const float /*steer*/,
                                                                      const Vec3& ourFuture,
-                                                                     const Vec3& threatFuture)
+                                                                     const Vec3& threatFuture) const
                                          {
                                              const Color green (0.15f, 0.6f, 0.0f);
                                              
@@ -319,7 +319,7 @@ public:
                                          // xxx perhaps this should be a call to a general purpose annotation for
                                          // xxx "local xxx axis aligned box in XZ plane" -- same code in in
                                          // xxx CaptureTheFlag.cpp
-                                         void annotateAvoidObstacle (const float minDistanceToCollision)
+                                         void annotateAvoidObstacle (const float minDistanceToCollision) const
                                          {
                                              const Vec3 boxSide = side() * radius();
                                              const Vec3 boxFront = forward() * minDistanceToCollision;
@@ -356,7 +356,7 @@ public:
                                          // XXX getTotalPathLength and radius methods (currently defined only
                                          // XXX on PolylinePathway) to set random initial positions.  Could
                                          // XXX there be a "random position inside path" method on Pathway?
-                                         PolylineSegmentedPathwaySingleRadius* path;
+                                         const IndexedPathway* path;
                                          
                                          // direction for path following (upstream or downstream)
                                          int pathDirection;
@@ -370,13 +370,13 @@ AVGroup Pedestrian::neighbors;
 /**
  * Creates a path of the form of an eight. Data provided by Nick Porcino.
  */
-PolylineSegmentedPathwaySingleRadius* getTestPath (void)
+const IndexedPathway* getTestPath (void)
 {
-    if (gTestPath == NULL)
+    if (!gTestPath)
     {
         const float pathRadius = 2;
         
-        const PolylineSegmentedPathwaySingleRadius::size_type pathPointCount = 16;
+        const IndexedPathway::size_type pathPointCount = 16;
         // const float size = 30;
         const Vec3 pathPoints[pathPointCount] = {
             Vec3( -12.678730011f, 0.0144290002063f, 0.523285984993f ),
@@ -405,12 +405,13 @@ PolylineSegmentedPathwaySingleRadius* getTestPath (void)
         gEndpoint0 = pathPoints[0];
         gEndpoint1 = pathPoints[pathPointCount-1];
         
-        gTestPath = new PolylineSegmentedPathwaySingleRadius (pathPointCount,
-                                                              pathPoints,
-                                                              pathRadius,
-                                                              false);
+        gTestPath = PathRegistry::shared().acquire ("Walking an eight",
+                                                    pathPointCount,
+                                                    pathPoints,
+                                                    pathRadius,
+                                                    false);
     }
-    return gTestPath;
+    return gTestPath.get ();
 }
 
 
@@ -557,10 +558,10 @@ public:
     
     void drawPathAndObstacles (void)
     {
-        typedef PolylineSegmentedPathwaySingleRadius::size_type size_type;
+        typedef IndexedPathway::size_type size_type;
         
         // draw a line along each segment of path
-        const PolylineSegmentedPathwaySingleRadius& path = *getTestPath ();
+        const IndexedPathway& path = *getTestPath ();
         for (size_type i = 1; i < path.pointCount(); ++i ) {
             drawLine (path.point( i ), path.point( i-1) , gRed);
         }
@@ -571,6 +572,10 @@ public:
     {
         // delete all Pedestrians
         while (population > 0) removePedestrianFromCrowd ();
+
+        // release the path, destroy it unless another PlugIn walks it
+        gTestPath.reset ();
+        PathRegistry::shared().removeUnused ();
     }
     
     void reset (void)
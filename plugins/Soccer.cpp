@@ -35,15 +35,24 @@
 //
 // (contributed on July 9, 2003)
 //
+// Any number of independent matches can be simulated side by side (F1, or
+// the option "matches" for headless runs), each on its own pitch with its
+// own proximity database.  Matches are updated in parallel when annotation
+// is off.
+//
 // ----------------------------------------------------------------------------
 
 
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Draw.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/Proximity.h"
+#include "OpenSteer/Stopwatch.h"
 #include "OpenSteer/UnusedParameter.h"
 
 
@@ -52,6 +61,10 @@ namespace {
     using namespace OpenSteer;
 
 
+    typedef AbstractProximityDatabase<AbstractVehicle*> ProximityDatabase;
+    typedef AbstractTokenForProximityDatabase<AbstractVehicle*> ProximityToken;
+
+
     Vec3 playerPosition[9] = {
         Vec3(4,0,0),
         Vec3(7,0,-5),
@@ -91,7 +104,7 @@ namespace {
     // The ball object
     class Ball : public SimpleVehicle{
     public:
-        Ball(AABBox *bbox) : m_bbox(bbox) {reset();}
+        Ball(AABBox *bbox, const Vec3& kickOff) : m_bbox(bbox), m_kickOff(kickOff) {reset();}
 
         // reset state
         void reset (void)
@@ -101,7 +114,7 @@ namespace {
             setMaxForce (9.0f);      // steering force is clipped to this magnitude
             setMaxSpeed (9.0f);         // velocity is clipped to this magnitude
 
-            setPosition(0,0,0);
+            setPosition(m_kickOff);
             clearTrailHistory ();    // prevent long streaks due to teleportation 
             setTrailParameters (100, 6000);
         }
@@ -142,6 +155,37 @@ namespace {
         }
 
         AABBox *m_bbox;
+        Vec3 m_kickOff;
+    };
+
+    class Player;
+
+    // ----------------------------------------------------------------------------
+    // One match: a pitch centered at m_center with its goals, ball, both teams
+    // and a proximity database holding the players of this pitch only.  The
+    // players refer to the team lists of their match instead of copying them.
+
+    class Match
+    {
+    public:
+        Match (const Vec3& center, unsigned int playersPerTeam);
+        ~Match ();
+
+        void update (const float currentTime, const float elapsedTime);
+        void draw (void);
+        void reset (void);
+
+        const Vec3		m_center;
+        AABBox			m_bbox;
+        AABBox			m_TeamAGoal;
+        AABBox			m_TeamBGoal;
+        Ball			m_Ball;
+        ProximityDatabase*	m_pd;
+        std::vector<Player*> TeamA;
+        std::vector<Player*> TeamB;
+        std::vector<Player*> m_AllPlayers;
+        int		m_redScore;
+        int		m_blueScore;
     };
 
     class Player : public SimpleVehicle
@@ -149,7 +193,14 @@ namespace {
     public:
 
         // constructor
-        Player (std::vector<Player*> others, std::vector<Player*> allplayers, Ball* ball, bool isTeamA, int id) : m_others(others), m_AllPlayers(allplayers), m_Ball(ball), b_ImTeamA(isTeamA), m_MyID(id) {reset ();}
+        Player (Match& match, bool isTeamA, int id) : m_Match(match), m_Ball(&match.m_Ball), b_ImTeamA(isTeamA), m_MyID(id)
+        {
+            m_proximityToken = match.m_pd->allocateToken (this);
+            reset ();
+        }
+
+        // destructor
+        virtual ~Player () {delete m_proximityToken;}
 
         // reset state
         void reset (void)
@@ -160,15 +211,16 @@ namespace {
             setMaxSpeed (10);         // velocity is clipped to this magnitude
 
             // Place me on my part of the field, looking at oponnents goal
-            setPosition(b_ImTeamA ? frandom01()*20 : -frandom01()*20, 0, (frandom01()-0.5f)*20);
+            setPosition(m_Match.m_center + Vec3(b_ImTeamA ? frandom01()*20 : -frandom01()*20, 0, (frandom01()-0.5f)*20));
             if(m_MyID < 9)
                 {
                 if(b_ImTeamA)
-                    setPosition(playerPosition[m_MyID]);
+                    setPosition(m_Match.m_center + playerPosition[m_MyID]);
                 else
-                    setPosition(Vec3(-playerPosition[m_MyID].x, playerPosition[m_MyID].y, playerPosition[m_MyID].z));
+                    setPosition(m_Match.m_center + Vec3(-playerPosition[m_MyID].x, playerPosition[m_MyID].y, playerPosition[m_MyID].z));
                 }
             m_home = position();
+            m_proximityToken->updateForNewPosition (position());
             clearTrailHistory ();    // prevent long streaks due to teleportation 
             setTrailParameters (10, 60);
         }
@@ -185,8 +237,11 @@ namespace {
                 m_Ball->kick((m_Ball->position()-position())*50, elapsedTime);
 
 
-            // otherwise consider avoiding collisions with others
-            Vec3 collisionAvoidance = steerToAvoidNeighbors(1, (AVGroup&)m_AllPlayers);
+            // otherwise consider avoiding collisions with the players on
+            // this pitch which could be reached within one second
+            m_neighbors.clear ();
+            m_proximityToken->findNeighbors (position(), speed() + maxSpeed(), m_neighbors);
+            Vec3 collisionAvoidance = steerToAvoidNeighbors(1, m_neighbors);
             if(collisionAvoidance != Vec3::zero)
                 applySteeringForce (collisionAvoidance, elapsedTime);
             else
@@ -223,22 +278,127 @@ namespace {
                 }
         }
 
+        // move my token in the proximity database of my pitch (done for all
+        // players after all of them are updated)
+        void updateProximityToken (void)
+        {
+            m_proximityToken->updateForNewPosition (position());
+        }
+
         // draw this character/vehicle into the scene
         void draw (void)
         {
             drawBasic2dCircularVehicle (*this, b_ImTeamA ? Color(1.0f,0.0f,0.0f):Color(0.0f,0.0f,1.0f));
             drawTrail ();
         }
-        // per-instance reference to its group
-        const std::vector<Player*>	m_others;
-        const std::vector<Player*>	m_AllPlayers;
+        // per-instance reference to the match it plays in
+        Match&	m_Match;
         Ball*	m_Ball;
         bool	b_ImTeamA;
         int		m_MyID;
         Vec3		m_home;
+        ProximityToken*	m_proximityToken;
+        AVGroup	m_neighbors;
     };
 
 
+    // ----------------------------------------------------------------------------
+
+
+    Match::Match (const Vec3& center, unsigned int playersPerTeam)
+        : m_center(center),
+          // Make a field
+          m_bbox(center + Vec3(-20,0,-10), center + Vec3(20,0,10)),
+          // Red goal
+          m_TeamAGoal(center + Vec3(-21,0,-7), center + Vec3(-19,0,7)),
+          // Blue Goal
+          m_TeamBGoal(center + Vec3(19,0,-7), center + Vec3(21,0,7)),
+          // Make a ball
+          m_Ball(&m_bbox, center),
+          m_redScore(0),
+          m_blueScore(0)
+    {
+        // a proximity database covering the pitch and its surroundings
+        typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+        m_pd = new LQPDAV (center, Vec3 (50, 50, 30), Vec3 (10, 1, 6));
+
+        // Build team A
+        for(unsigned int i=0; i < playersPerTeam ; i++)
+        {
+            Player *pMicTest = new Player(*this, true, i);
+            TeamA.push_back (pMicTest);
+            m_AllPlayers.push_back(pMicTest);
+        }
+        // Build Team B
+        for(unsigned int i=0; i < playersPerTeam ; i++)
+        {
+            Player *pMicTest = new Player(*this, false, i);
+            TeamB.push_back (pMicTest);
+            m_AllPlayers.push_back(pMicTest);
+        }
+    }
+
+    Match::~Match ()
+    {
+        for(unsigned int i=0; i < m_AllPlayers.size() ; i++)
+            delete m_AllPlayers[i];
+        delete m_pd;
+    }
+
+    void Match::update (const float currentTime, const float elapsedTime)
+    {
+        // update simulation of test vehicle
+        for(unsigned int i=0; i < TeamA.size() ; i++)
+            TeamA[i]->update (currentTime, elapsedTime);
+        for(unsigned int i=0; i < TeamB.size() ; i++)
+            TeamB[i]->update (currentTime, elapsedTime);
+        m_Ball.update(currentTime, elapsedTime);
+
+        // players query the positions of the previous frame
+        for(unsigned int i=0; i < m_AllPlayers.size() ; i++)
+            m_AllPlayers[i]->updateProximityToken ();
+
+        if(m_TeamAGoal.InsideX(m_Ball.position()) && m_TeamAGoal.InsideZ(m_Ball.position()))
+        {
+            m_Ball.reset();	// Ball in blue teams goal, red scores
+            m_redScore++;
+        }
+        if(m_TeamBGoal.InsideX(m_Ball.position()) && m_TeamBGoal.InsideZ(m_Ball.position()))
+        {
+            m_Ball.reset();	// Ball in red teams goal, blue scores
+                m_blueScore++;
+        }
+    }
+
+    void Match::draw (void)
+    {
+        for(unsigned int i=0; i < m_AllPlayers.size() ; i++)
+            m_AllPlayers[i]->draw ();
+        m_Ball.draw();
+        m_bbox.draw();
+        m_TeamAGoal.draw();
+        m_TeamBGoal.draw();
+        {
+            std::ostringstream annote;
+            annote << "Red: "<< m_redScore;
+            draw2dTextAt3dLocation (annote, m_center + Vec3(23,0,0), Color(1.0f,0.7f,0.7f), drawGetWindowWidth(), drawGetWindowHeight());
+        }
+        {
+            std::ostringstream annote;
+            annote << "Blue: "<< m_blueScore;
+            draw2dTextAt3dLocation (annote, m_center + Vec3(-23,0,0), Color(0.7f,0.7f,1.0f), drawGetWindowWidth(), drawGetWindowHeight());
+        }
+    }
+
+    void Match::reset (void)
+    {
+        // reset vehicle
+        for(unsigned int i=0; i < m_AllPlayers.size() ; i++)
+            m_AllPlayers[i]->reset ();
+        m_Ball.reset();
+    }
+
+
 
     // ----------------------------------------------------------------------------
     // PlugIn for OpenSteerDemo
@@ -246,6 +406,8 @@ namespace {
     {
     public:
         
+        MicTestPlugIn () : m_MatchCount(1), m_updateSeconds(0), m_matchUpdates(0) {}
+
         const char* name (void) {return "Michael's Simple Soccer";}
 
         // float selectionOrderSortKey (void) {return 0.06f;}
@@ -257,138 +419,147 @@ namespace {
 
         void open (void)
         {
-            // Make a field
-            m_bbox = new AABBox(Vec3(-20,0,-10), Vec3(20,0,10));
-            // Red goal
-            m_TeamAGoal = new AABBox(Vec3(-21,0,-7), Vec3(-19,0,7));
-            // Blue Goal
-            m_TeamBGoal = new AABBox(Vec3(19,0,-7), Vec3(21,0,7));
-            // Make a ball
-            m_Ball = new Ball(m_bbox);
-            // Build team A
-            m_PlayerCountA = 8;
-            for(unsigned int i=0; i < m_PlayerCountA ; i++)
+            // lay the pitches out in a square
+            const int columns = (int) ceilf (sqrtXXX ((float) m_MatchCount));
+            for(int i=0; i < m_MatchCount ; i++)
             {
-                Player *pMicTest = new Player(TeamA, m_AllPlayers, m_Ball, true, i);
-                OpenSteerDemo::selectedVehicle = pMicTest;
-                TeamA.push_back (pMicTest);
-                m_AllPlayers.push_back(pMicTest);
-            }
-            // Build Team B
-            m_PlayerCountB = 8;
-            for(unsigned int i=0; i < m_PlayerCountB ; i++)
-            {
-                Player *pMicTest = new Player(TeamB, m_AllPlayers, m_Ball, false, i);
-                OpenSteerDemo::selectedVehicle = pMicTest;
-                TeamB.push_back (pMicTest);
-                m_AllPlayers.push_back(pMicTest);
+                const Vec3 center ((i % columns) * 50.0f, 0, (i / columns) * 30.0f);
+                Match* match = new Match (center, 8);
+                m_Matches.push_back (match);
+                m_AllPlayers.insert (m_AllPlayers.end(), match->m_AllPlayers.begin(), match->m_AllPlayers.end());
             }
+            OpenSteerDemo::selectedVehicle = m_AllPlayers.back();
+
             // initialize camera
-            OpenSteerDemo::init2dCamera (*m_Ball);
+            OpenSteerDemo::init2dCamera (m_Matches.front()->m_Ball);
             OpenSteerDemo::camera.setPosition (10, OpenSteerDemo::camera2dElevation, 10);
             OpenSteerDemo::camera.fixedPosition.set (40, 40, 40);
             OpenSteerDemo::camera.mode = Camera::cmFixed;
-            m_redScore = 0;
-            m_blueScore = 0;
+
+            m_updateSeconds = 0;
+            m_matchUpdates = 0;
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update simulation of test vehicle
-            for(unsigned int i=0; i < m_PlayerCountA ; i++)
-                TeamA[i]->update (currentTime, elapsedTime);
-            for(unsigned int i=0; i < m_PlayerCountB ; i++)
-                TeamB[i]->update (currentTime, elapsedTime);
-            m_Ball->update(currentTime, elapsedTime);
-
-            if(m_TeamAGoal->InsideX(m_Ball->position()) && m_TeamAGoal->InsideZ(m_Ball->position()))
-            {
-                m_Ball->reset();	// Ball in blue teams goal, red scores
-                m_redScore++;
-            }
-            if(m_TeamBGoal->InsideX(m_Ball->position()) && m_TeamBGoal->InsideZ(m_Ball->position()))
-            {
-                m_Ball->reset();	// Ball in red teams goal, blue scores
-                    m_blueScore++;
-            }
-
+            const Stopwatch stopwatch;
+
+            // matches are independent, so they can be updated in parallel
+            // (annotation is collected in shared buffers, stay serial while
+            // it is on)
+            const bool parallel = !annotationIsOn ();
+            #pragma omp parallel for if (parallel)
+            for(int i=0; i < m_MatchCount ; i++)
+                m_Matches[i]->update (currentTime, elapsedTime);
+
+            m_updateSeconds += stopwatch.elapsedSeconds ();
+            m_matchUpdates += m_MatchCount;
         }
 
         void redraw (const float currentTime, const float elapsedTime)
         {
-            // draw test vehicle
-            for(unsigned int i=0; i < m_PlayerCountA ; i++)
-                TeamA[i]->draw ();
-            for(unsigned int i=0; i < m_PlayerCountB ; i++)
-                TeamB[i]->draw ();
-            m_Ball->draw();
-            m_bbox->draw();
-            m_TeamAGoal->draw();
-            m_TeamBGoal->draw();
-            {
-                std::ostringstream annote;
-                annote << "Red: "<< m_redScore;
-                draw2dTextAt3dLocation (annote, Vec3(23,0,0), Color(1.0f,0.7f,0.7f), drawGetWindowWidth(), drawGetWindowHeight());
-            }
-            {
-                std::ostringstream annote;
-                annote << "Blue: "<< m_blueScore;
-                draw2dTextAt3dLocation (annote, Vec3(-23,0,0), Color(0.7f,0.7f,1.0f), drawGetWindowWidth(), drawGetWindowHeight());
-            }
+            for(int i=0; i < m_MatchCount ; i++)
+                m_Matches[i]->draw ();
 
             // textual annotation (following the test vehicle's screen position)
     if(0)
-        for(unsigned int i=0; i < m_PlayerCountA ; i++)
+        for(unsigned int i=0; i < m_Matches.front()->TeamA.size() ; i++)
             {
+                const Player& player = *m_Matches.front()->TeamA[i];
                 std::ostringstream annote;
                 annote << std::setprecision (2) << std::setiosflags (std::ios::fixed);
-                annote << "      speed: " << TeamA[i]->speed() << "ID:" << i << std::ends;
-                draw2dTextAt3dLocation (annote, TeamA[i]->position(), gRed, drawGetWindowWidth(), drawGetWindowHeight());
+                annote << "      speed: " << player.speed() << "ID:" << i << std::ends;
+                draw2dTextAt3dLocation (annote, player.position(), gRed, drawGetWindowWidth(), drawGetWindowHeight());
                 draw2dTextAt3dLocation (*"start", Vec3::zero, gGreen, drawGetWindowWidth(), drawGetWindowHeight());
             }
             // update camera, tracking test vehicle
             OpenSteerDemo::updateCamera (currentTime, elapsedTime, *OpenSteerDemo::selectedVehicle);
 
             // draw "ground plane"
-            OpenSteerDemo::gridUtility (Vec3(0,0,0));
+            OpenSteerDemo::gridUtility (OpenSteerDemo::selectedVehicle->position());
+
+            // display status in the upper left corner of the window
+            std::ostringstream status;
+            status << "[F1] " << m_MatchCount << " matches" << std::ends;
+            const float h = drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            draw2dTextAt2dLocation (status, screenLocation, gGray80, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
         void close (void)
         {
-            for(unsigned int i=0; i < m_PlayerCountA ; i++)
-                delete TeamA[i];
-            TeamA.clear ();
-            for(unsigned int i=0; i < m_PlayerCountB ; i++)
-                delete TeamB[i];
-            TeamB.clear ();
-                    m_AllPlayers.clear();
+            for(int i=0; i < m_MatchCount ; i++)
+                delete m_Matches[i];
+            m_Matches.clear ();
+            m_AllPlayers.clear();
         }
 
         void reset (void)
         {
-            // reset vehicle
-            for(unsigned int i=0; i < m_PlayerCountA ; i++)
-                TeamA[i]->reset ();
-            for(unsigned int i=0; i < m_PlayerCountB ; i++)
-                TeamB[i]->reset ();
-            m_Ball->reset();
+            for(int i=0; i < m_MatchCount ; i++)
+                m_Matches[i]->reset ();
         }
 
-        const AVGroup& allVehicles (void) {return (const AVGroup&) TeamA;}
+        // cycle through the number of matches: 1, 4, 16, 64
+        void nextMatchCount (void)
+        {
+            close ();
+            m_MatchCount = (m_MatchCount >= 64) ? 1 : m_MatchCount * 4;
+            open ();
+        }
 
-        unsigned int	m_PlayerCountA;
-        unsigned int	m_PlayerCountB;
-        std::vector<Player*> TeamA;
-        std::vector<Player*> TeamB;
+        void handleFunctionKeys (int keyNumber)
+        {
+            switch (keyNumber)
+            {
+            case 1: nextMatchCount (); break;
+            }
+        }
+
+        void printMiniHelpForFunctionKeys (void)
+        {
+            std::ostringstream message;
+            message << "Function keys handled by ";
+            message << '"' << name() << '"' << ':' << std::ends;
+            OpenSteerDemo::printMessage (message);
+            OpenSteerDemo::printMessage ("  F1     next number of matches.");
+            OpenSteerDemo::printMessage ("");
+        }
+
+        // "matches" sets the number of matches played side by side
+        bool setOption (const char* name, const char* value)
+        {
+            const int count = std::atoi (value);
+            if ((std::strcmp (name, "matches") != 0) || (count < 1)) return false;
+            m_MatchCount = count;
+            return true;
+        }
+
+        void printStatistics (std::ostream& os)
+        {
+            int goals = 0;
+            for(int i=0; i < m_MatchCount ; i++)
+                goals += m_Matches[i]->m_redScore + m_Matches[i]->m_blueScore;
+
+            os << "matches:             " << m_MatchCount << std::endl
+               << "goals:               " << goals << std::endl
+               << "match updates/s:     ";
+            // no updates timed yet, e.g. when run for zero frames
+            if (m_updateSeconds > 0)
+                os << m_matchUpdates / m_updateSeconds << std::endl;
+            else
+                os << "n/a" << std::endl;
+        }
+
+        const AVGroup& allVehicles (void) {return (const AVGroup&) m_AllPlayers;}
+
+        int		m_MatchCount;
+        std::vector<Match*> m_Matches;
         std::vector<Player*> m_AllPlayers;
 
-        Ball	*m_Ball;
-        AABBox	*m_bbox;
-        AABBox	*m_TeamAGoal;
-        AABBox	*m_TeamBGoal;
-        int junk;
-        int		m_redScore;
-        int		m_blueScore;
+        // time spent in update and number of matches updated, for statistics
+        double	m_updateSeconds;
+        double	m_matchUpdates;
     };
 
 
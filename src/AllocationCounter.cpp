@@ -0,0 +1,186 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Counters of the heap allocations, updated by the replaced operator new
+ * of AllocationCounterOperators.cpp.
+ */
+#include "OpenSteer/AllocationCounter.h"
+
+// Include std::abort
+#include <cstdlib>
+
+// Include std::fputs, stderr
+#include <cstdio>
+
+#if defined( _WIN32 )
+    // Include InterlockedExchangeAdd
+    #include <windows.h>
+#endif
+
+
+#if defined( _MSC_VER )
+    #define OPENSTEER_THREAD_LOCAL __declspec( thread )
+#else
+    #define OPENSTEER_THREAD_LOCAL __thread
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    AllocationCounter::size_type volatile allocationCount_ = 0;
+    AllocationCounter::size_type volatile allocatedBytes_ = 0;
+    bool volatile allocationsForbidden_ = false;
+    
+    // Allocations of threads running next to the measured code aren't
+    // counted, see UncountedScope.
+    OPENSTEER_THREAD_LOCAL bool threadUncounted_ = false;
+    
+    
+    void 
+    abortOnAllocation( AllocationCounter::size_type )
+    {
+        std::fputs( "OpenSteer: heap allocation while allocations are forbidden\n", stderr );
+        std::abort();
+    }
+    
+    
+    AllocationCounter::ForbiddenAllocationHandler volatile forbiddenAllocationHandler_ = abortOnAllocation;
+    
+    
+    void 
+    atomicAdd( AllocationCounter::size_type volatile& counter, 
+               AllocationCounter::size_type value )
+    {
+#if defined( __GNUC__ )
+        __sync_fetch_and_add( &counter, value );
+#elif defined( _WIN32 ) && defined( _WIN64 )
+        InterlockedExchangeAdd64( reinterpret_cast< LONGLONG volatile* >( &counter ), static_cast< LONGLONG >( value ) );
+#elif defined( _WIN32 )
+        InterlockedExchangeAdd( reinterpret_cast< LONG volatile* >( &counter ), static_cast< LONG >( value ) );
+#else
+        counter += value;
+#endif
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::AllocationCounter::size_type 
+OpenSteer::AllocationCounter::allocationCount()
+{
+    return allocationCount_;
+}
+
+
+
+OpenSteer::AllocationCounter::size_type 
+OpenSteer::AllocationCounter::allocatedBytes()
+{
+    return allocatedBytes_;
+}
+
+
+
+void 
+OpenSteer::AllocationCounter::countAllocation( size_type bytes )
+{
+    if ( threadUncounted_ ) {
+        return;
+    }
+    
+    atomicAdd( allocationCount_, 1 );
+    atomicAdd( allocatedBytes_, bytes );
+    if ( allocationsForbidden_ ) {
+        forbiddenAllocationHandler_( bytes );
+    }
+}
+
+
+
+void 
+OpenSteer::AllocationCounter::forbidAllocations( bool forbid )
+{
+    allocationsForbidden_ = forbid;
+}
+
+
+
+bool 
+OpenSteer::AllocationCounter::allocationsForbidden()
+{
+    return allocationsForbidden_;
+}
+
+
+
+void 
+OpenSteer::AllocationCounter::setForbiddenAllocationHandler( ForbiddenAllocationHandler handler )
+{
+    forbiddenAllocationHandler_ = ( 0 != handler ) ? handler : abortOnAllocation;
+}
+
+
+
+bool 
+OpenSteer::AllocationCounter::threadCounted()
+{
+    return ! threadUncounted_;
+}
+
+
+
+OpenSteer::AllocationCounter::ForbiddenScope::ForbiddenScope()
+    : wasForbidden_( allocationsForbidden() )
+{
+    forbidAllocations( true );
+}
+
+
+
+OpenSteer::AllocationCounter::ForbiddenScope::~ForbiddenScope()
+{
+    forbidAllocations( wasForbidden_ );
+}
+
+
+
+OpenSteer::AllocationCounter::UncountedScope::UncountedScope()
+    : wasUncounted_( threadUncounted_ )
+{
+    threadUncounted_ = true;
+}
+
+
+
+OpenSteer::AllocationCounter::UncountedScope::~UncountedScope()
+{
+    threadUncounted_ = wasUncounted_;
+}
@@ -0,0 +1,341 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Replacements of the global operator new and delete counting all heap
+ * allocations with OpenSteer::AllocationCounter. Only linked into the
+ * programs measuring allocations (OpenSteerDemo, the benchmark and the 
+ * unit tests), so that the library doesn't replace them for everybody.
+ */
+#include "OpenSteer/AllocationCounter.h"
+
+// Include std::malloc, std::free, posix_memalign
+#include <cstdlib>
+
+// Include std::bad_alloc, std::nothrow_t, std::new_handler, std::align_val_t
+#include <new>
+
+#if defined( _WIN32 )
+    // Include _aligned_malloc, _aligned_free
+    #include <malloc.h>
+#endif
+
+
+// Dynamic exception specifications were removed in C++17.
+#if __cplusplus >= 201103L
+    #define OPENSTEER_THROW_BAD_ALLOC
+    #define OPENSTEER_THROW_NOTHING noexcept
+#else
+    #define OPENSTEER_THROW_BAD_ALLOC throw( std::bad_alloc )
+    #define OPENSTEER_THROW_NOTHING throw()
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    std::new_handler 
+    currentNewHandler()
+    {
+#if __cplusplus >= 201103L
+        return std::get_new_handler();
+#else
+        std::new_handler const handler = std::set_new_handler( 0 );
+        std::set_new_handler( handler );
+        return handler;
+#endif
+    }
+    
+    
+    /**
+     * Counts the allocation, then asks @c std::malloc for the memory and
+     * calls the new handler until it gets some, throws @c std::bad_alloc
+     * if there is no handler, as operator new must.
+     */
+    void* 
+    allocate( std::size_t bytes )
+    {
+        AllocationCounter::countAllocation( bytes );
+        
+        for ( ;; ) {
+            void* const memory = std::malloc( bytes ? bytes : 1 );
+            if ( 0 != memory ) {
+                return memory;
+            }
+            
+            std::new_handler const handler = currentNewHandler();
+            if ( 0 == handler ) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+    
+    
+    void* 
+    allocateNothrow( std::size_t bytes )
+    {
+        try {
+            return allocate( bytes );
+        } catch ( std::bad_alloc const& ) {
+            return 0;
+        }
+    }
+    
+    
+#if defined( __cpp_aligned_new )
+    
+    void* 
+    alignedMalloc( std::size_t bytes, std::size_t alignment )
+    {
+#if defined( _WIN32 )
+        return _aligned_malloc( bytes, alignment );
+#else
+        // posix_memalign needs at least the alignment of a pointer.
+        void* memory = 0;
+        if ( alignment < sizeof( void* ) ) {
+            alignment = sizeof( void* );
+        }
+        return ( 0 == posix_memalign( &memory, alignment, bytes ) ) ? memory : 0;
+#endif
+    }
+    
+    
+    void 
+    alignedFree( void* memory )
+    {
+#if defined( _WIN32 )
+        _aligned_free( memory );
+#else
+        std::free( memory );
+#endif
+    }
+    
+    
+    void* 
+    allocateAligned( std::size_t bytes, std::align_val_t alignment )
+    {
+        AllocationCounter::countAllocation( bytes );
+        
+        for ( ;; ) {
+            void* const memory = alignedMalloc( bytes ? bytes : 1, static_cast< std::size_t >( alignment ) );
+            if ( 0 != memory ) {
+                return memory;
+            }
+            
+            std::new_handler const handler = currentNewHandler();
+            if ( 0 == handler ) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+    
+    
+    void* 
+    allocateAlignedNothrow( std::size_t bytes, std::align_val_t alignment )
+    {
+        try {
+            return allocateAligned( bytes, alignment );
+        } catch ( std::bad_alloc const& ) {
+            return 0;
+        }
+    }
+    
+#endif
+    
+} // anonymous namespace
+
+
+
+void* 
+operator new( std::size_t bytes ) OPENSTEER_THROW_BAD_ALLOC
+{
+    return allocate( bytes );
+}
+
+
+
+void* 
+operator new[]( std::size_t bytes ) OPENSTEER_THROW_BAD_ALLOC
+{
+    return allocate( bytes );
+}
+
+
+
+void* 
+operator new( std::size_t bytes, std::nothrow_t const& ) OPENSTEER_THROW_NOTHING
+{
+    return allocateNothrow( bytes );
+}
+
+
+
+void* 
+operator new[]( std::size_t bytes, std::nothrow_t const& ) OPENSTEER_THROW_NOTHING
+{
+    return allocateNothrow( bytes );
+}
+
+
+
+void 
+operator delete( void* memory ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+
+
+void 
+operator delete( void* memory, std::nothrow_t const& ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory, std::nothrow_t const& ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+
+
+#if defined( __cpp_sized_deallocation )
+
+void 
+operator delete( void* memory, std::size_t ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory, std::size_t ) OPENSTEER_THROW_NOTHING
+{
+    std::free( memory );
+}
+
+#endif
+
+
+
+#if defined( __cpp_aligned_new )
+
+void* 
+operator new( std::size_t bytes, std::align_val_t alignment )
+{
+    return allocateAligned( bytes, alignment );
+}
+
+
+
+void* 
+operator new[]( std::size_t bytes, std::align_val_t alignment )
+{
+    return allocateAligned( bytes, alignment );
+}
+
+
+
+void* 
+operator new( std::size_t bytes, std::align_val_t alignment, std::nothrow_t const& ) noexcept
+{
+    return allocateAlignedNothrow( bytes, alignment );
+}
+
+
+
+void* 
+operator new[]( std::size_t bytes, std::align_val_t alignment, std::nothrow_t const& ) noexcept
+{
+    return allocateAlignedNothrow( bytes, alignment );
+}
+
+
+
+void 
+operator delete( void* memory, std::align_val_t ) noexcept
+{
+    alignedFree( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory, std::align_val_t ) noexcept
+{
+    alignedFree( memory );
+}
+
+
+
+void 
+operator delete( void* memory, std::align_val_t, std::nothrow_t const& ) noexcept
+{
+    alignedFree( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory, std::align_val_t, std::nothrow_t const& ) noexcept
+{
+    alignedFree( memory );
+}
+
+
+
+void 
+operator delete( void* memory, std::size_t, std::align_val_t ) noexcept
+{
+    alignedFree( memory );
+}
+
+
+
+void 
+operator delete[]( void* memory, std::size_t, std::align_val_t ) noexcept
+{
+    alignedFree( memory );
+}
+
+#endif
@@ -0,0 +1,567 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the continuum crowd grid and potential fields.
+ */
+#include "OpenSteer/ContinuumCrowd.h"
+
+// Include std::push_heap, std::pop_heap, std::greater
+#include <algorithm>
+#include <functional>
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include std::ceil
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::clamp, OpenSteer::interpolate, OpenSteer::square
+#include "OpenSteer/Utilities.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Cost and potential of impassable and unreachable cells. A finite 
+     * sentinel instead of infinity because of -ffast-math.
+     */
+    float const unreachable = std::numeric_limits< float >::max();
+    
+    
+    /**
+     * Splits the continuous grid coordinate @a x into the lower cell index
+     * and the interpolation weight toward the upper cell. Clamps to the 
+     * grid borders.
+     */
+    void splitCoordinate( float x, 
+                          ContinuumCrowdGrid::size_type count,
+                          ContinuumCrowdGrid::size_type& lower, 
+                          float& weight ) 
+    {
+        float const maxCoordinate = static_cast< float >( count - 1 );
+        x = clamp( x, 0.0f, maxCoordinate );
+        float const base = floorXXX( x );
+        lower = static_cast< ContinuumCrowdGrid::size_type >( base );
+        if ( lower + 1 >= count ) {
+            lower = ( count > 1 ) ? count - 2 : 0;
+        }
+        weight = clamp( x - static_cast< float >( lower ), 0.0f, 1.0f );
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::ContinuumCrowdGrid::Parameters::Parameters()
+    : maxSpeed( 2.0f ),
+      minSpeed( 0.1f ),
+      minDensity( 0.5f ),
+      maxDensity( 0.8f ),
+      lengthWeight( 1.0f ),
+      timeWeight( 1.0f ),
+      discomfortWeight( 1.0f )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::ContinuumCrowdGrid( Vec3 const& center, 
+                                                   float width, 
+                                                   float depth, 
+                                                   float cellSize,
+                                                   Parameters const& parameters )
+    : origin_( center - Vec3( width * 0.5f, 0.0f, depth * 0.5f ) ), 
+      cellSize_( cellSize ), 
+      columns_( 0 ), 
+      rows_( 0 ),
+      parameters_( parameters )
+{
+    assert( 0.0f < cellSize && "cellSize must be greater than 0." );
+    
+    columns_ = static_cast< size_type >( maxXXX( 2.0f, std::ceil( width / cellSize ) ) );
+    rows_ = static_cast< size_type >( maxXXX( 2.0f, std::ceil( depth / cellSize ) ) );
+    
+    density_.resize( cellCount(), 0.0f );
+    velocitySum_.resize( cellCount(), Vec3::zero );
+    averageVelocity_.resize( cellCount(), Vec3::zero );
+    cost_.resize( cellCount(), 0.0f );
+    passable_.resize( cellCount(), 1 );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::setParameters( Parameters const& parameters )
+{
+    parameters_ = parameters;
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::Parameters const& 
+OpenSteer::ContinuumCrowdGrid::parameters() const
+{
+    return parameters_;
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::size_type 
+OpenSteer::ContinuumCrowdGrid::columnCount() const
+{
+    return columns_;
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::size_type 
+OpenSteer::ContinuumCrowdGrid::rowCount() const
+{
+    return rows_;
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::size_type 
+OpenSteer::ContinuumCrowdGrid::cellCount() const
+{
+    return columns_ * rows_;
+}
+
+
+
+float 
+OpenSteer::ContinuumCrowdGrid::cellSize() const
+{
+    return cellSize_;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::ContinuumCrowdGrid::cellCenter( size_type column, size_type row ) const
+{
+    return origin_ + Vec3( ( column + 0.5f ) * cellSize_, 
+                           0.0f, 
+                           ( row + 0.5f ) * cellSize_ );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::setPassable( size_type column, size_type row, bool passable )
+{
+    passable_[ cellIndex( column, row ) ] = passable ? 1 : 0;
+}
+
+
+
+bool 
+OpenSteer::ContinuumCrowdGrid::isPassable( size_type column, size_type row ) const
+{
+    return 0 != passable_[ cellIndex( column, row ) ];
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::clear()
+{
+    std::fill( density_.begin(), density_.end(), 0.0f );
+    std::fill( velocitySum_.begin(), velocitySum_.end(), Vec3::zero );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::splat( Vec3 const& position, Vec3 const& velocity )
+{
+    float x = 0.0f;
+    float z = 0.0f;
+    mapPositionToGrid( position, x, z );
+    
+    if ( ( x < -0.5f ) || ( z < -0.5f ) || 
+         ( x > columns_ - 0.5f ) || ( z > rows_ - 0.5f ) ) {
+        return;
+    }
+    
+    size_type column = 0;
+    size_type row = 0;
+    float wx = 0.0f;
+    float wz = 0.0f;
+    splitCoordinate( x, columns_, column, wx );
+    splitCoordinate( z, rows_, row, wz );
+    
+    float const weights[ 4 ] = { ( 1.0f - wx ) * ( 1.0f - wz ),
+                                 wx * ( 1.0f - wz ),
+                                 ( 1.0f - wx ) * wz,
+                                 wx * wz };
+    size_type const indices[ 4 ] = { cellIndex( column, row ),
+                                     cellIndex( column + 1, row ),
+                                     cellIndex( column, row + 1 ),
+                                     cellIndex( column + 1, row + 1 ) };
+    
+    for ( size_type i = 0; i < 4; ++i ) {
+        density_[ indices[ i ] ] += weights[ i ];
+        velocitySum_[ indices[ i ] ] += velocity * weights[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::computeCosts()
+{
+    float const densityRange = maxXXX( parameters_.maxDensity - parameters_.minDensity, 0.0001f );
+    int const count = static_cast< int >( cellCount() );
+    
+    #pragma omp parallel for
+    for ( int i = 0; i < count; ++i ) {
+        if ( ! passable_[ i ] ) {
+            averageVelocity_[ i ] = Vec3::zero;
+            cost_[ i ] = unreachable;
+            continue;
+        }
+        
+        float const density = density_[ i ];
+        
+        // The splatted velocity sum is kept so computing again gives the
+        // same average.
+        averageVelocity_[ i ] = velocitySum_[ i ];
+        if ( 0.0f < density ) {
+            averageVelocity_[ i ] /= density;
+        }
+        
+        // Sparse crowds walk at max speed, dense crowds move with the flow.
+        float const flowSpeed = clamp( averageVelocity_[ i ].length(), 
+                                       parameters_.minSpeed, 
+                                       parameters_.maxSpeed );
+        float const alpha = clamp( ( density - parameters_.minDensity ) / densityRange, 0.0f, 1.0f );
+        float const speed = maxXXX( interpolate( alpha, parameters_.maxSpeed, flowSpeed ), 
+                                    parameters_.minSpeed );
+        
+        cost_[ i ] = ( parameters_.lengthWeight * speed + 
+                       parameters_.timeWeight + 
+                       parameters_.discomfortWeight * density ) / speed;
+    }
+}
+
+
+
+float 
+OpenSteer::ContinuumCrowdGrid::sampleDensity( Vec3 const& position ) const
+{
+    float x = 0.0f;
+    float z = 0.0f;
+    mapPositionToGrid( position, x, z );
+    
+    size_type column = 0;
+    size_type row = 0;
+    float wx = 0.0f;
+    float wz = 0.0f;
+    splitCoordinate( x, columns_, column, wx );
+    splitCoordinate( z, rows_, row, wz );
+    
+    float const near = interpolate( wx, 
+                                    density_[ cellIndex( column, row ) ], 
+                                    density_[ cellIndex( column + 1, row ) ] );
+    float const far = interpolate( wx, 
+                                   density_[ cellIndex( column, row + 1 ) ], 
+                                   density_[ cellIndex( column + 1, row + 1 ) ] );
+    return interpolate( wz, near, far );
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::ContinuumCrowdGrid::sampleAverageVelocity( Vec3 const& position ) const
+{
+    size_type column = 0;
+    size_type row = 0;
+    if ( ! mapPositionToCell( position, column, row ) ) {
+        return Vec3::zero;
+    }
+    
+    return averageVelocity_[ cellIndex( column, row ) ];
+}
+
+
+
+OpenSteer::ContinuumCrowdGrid::size_type 
+OpenSteer::ContinuumCrowdGrid::cellIndex( size_type column, size_type row ) const
+{
+    assert( column < columns_ && row < rows_ && "Cell out of grid." );
+    return row * columns_ + column;
+}
+
+
+
+float 
+OpenSteer::ContinuumCrowdGrid::cost( size_type index ) const
+{
+    return cost_[ index ];
+}
+
+
+
+bool 
+OpenSteer::ContinuumCrowdGrid::mapPositionToCell( Vec3 const& position, 
+                                                  size_type& column, 
+                                                  size_type& row ) const
+{
+    float const x = ( position.x - origin_.x ) / cellSize_;
+    float const z = ( position.z - origin_.z ) / cellSize_;
+    
+    if ( ( x < 0.0f ) || ( z < 0.0f ) || ( x >= columns_ ) || ( z >= rows_ ) ) {
+        return false;
+    }
+    
+    column = static_cast< size_type >( x );
+    row = static_cast< size_type >( z );
+    return true;
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdGrid::mapPositionToGrid( Vec3 const& position, float& x, float& z ) const
+{
+    x = ( position.x - origin_.x ) / cellSize_ - 0.5f;
+    z = ( position.z - origin_.z ) / cellSize_ - 0.5f;
+}
+
+
+
+
+
+OpenSteer::ContinuumCrowdPotential::ContinuumCrowdPotential()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdPotential::clearGoals()
+{
+    goals_.clear();
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdPotential::addGoal( ContinuumCrowdGrid const& grid, 
+                                             Vec3 const& position, 
+                                             float radius )
+{
+    float const radiusSquared = square( maxXXX( radius, grid.cellSize() * 0.5f ) );
+    
+    for ( size_type row = 0; row < grid.rowCount(); ++row ) {
+        for ( size_type column = 0; column < grid.columnCount(); ++column ) {
+            Vec3 const offset( grid.cellCenter( column, row ) - position );
+            if ( ( offset.x * offset.x + offset.z * offset.z ) <= radiusSquared &&
+                 grid.isPassable( column, row ) ) {
+                goals_.push_back( grid.cellIndex( column, row ) );
+            }
+        }
+    }
+    
+    // Make sure there is a goal even if the radius is smaller than a cell.
+    size_type column = 0;
+    size_type row = 0;
+    if ( grid.mapPositionToCell( position, column, row ) && grid.isPassable( column, row ) ) {
+        goals_.push_back( grid.cellIndex( column, row ) );
+    }
+}
+
+
+
+float 
+OpenSteer::ContinuumCrowdPotential::acceptedPotential( size_type index, bool inGrid ) const
+{
+    return ( inGrid && accepted_[ index ] ) ? potential_[ index ] : unreachable;
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdPotential::compute( ContinuumCrowdGrid const& grid )
+{
+    size_type const columns = grid.columnCount();
+    size_type const rows = grid.rowCount();
+    size_type const count = grid.cellCount();
+    float const h = grid.cellSize();
+    
+    potential_.assign( count, unreachable );
+    direction_.assign( count, Vec3::zero );
+    accepted_.assign( count, 0 );
+    front_.clear();
+    
+    typedef std::greater< std::pair< float, size_type > > MinHeapOrder;
+    
+    for ( size_type i = 0; i < goals_.size(); ++i ) {
+        potential_[ goals_[ i ] ] = 0.0f;
+        front_.push_back( std::make_pair( 0.0f, goals_[ i ] ) );
+        std::push_heap( front_.begin(), front_.end(), MinHeapOrder() );
+    }
+    
+    // Fast marching: accept the cell with the lowest tentative potential and
+    // update its neighbors by solving the upwind discretization of the 
+    // eikonal equation |grad potential| = cost.
+    while ( ! front_.empty() ) {
+        std::pop_heap( front_.begin(), front_.end(), MinHeapOrder() );
+        size_type const index = front_.back().second;
+        front_.pop_back();
+        
+        if ( accepted_[ index ] ) {
+            // Stale heap entry.
+            continue;
+        }
+        accepted_[ index ] = 1;
+        
+        size_type const column = index % columns;
+        size_type const row = index / columns;
+        
+        size_type neighbors[ 4 ];
+        size_type neighborCount = 0;
+        if ( column > 0 ) neighbors[ neighborCount++ ] = index - 1;
+        if ( column + 1 < columns ) neighbors[ neighborCount++ ] = index + 1;
+        if ( row > 0 ) neighbors[ neighborCount++ ] = index - columns;
+        if ( row + 1 < rows ) neighbors[ neighborCount++ ] = index + columns;
+        
+        for ( size_type n = 0; n < neighborCount; ++n ) {
+            size_type const neighbor = neighbors[ n ];
+            float const c = grid.cost( neighbor );
+            
+            if ( accepted_[ neighbor ] || unreachable == c ) {
+                continue;
+            }
+            
+            size_type const nc = neighbor % columns;
+            size_type const nr = neighbor / columns;
+            
+            // Only accepted potentials are final, tentative ones of the
+            // front could still drop and must not feed the update.
+            float const a = minXXX( acceptedPotential( neighbor - 1, nc > 0 ),
+                                    acceptedPotential( neighbor + 1, nc + 1 < columns ) );
+            float const b = minXXX( acceptedPotential( neighbor - columns, nr > 0 ),
+                                    acceptedPotential( neighbor + columns, nr + 1 < rows ) );
+            float const ch = c * h;
+            
+            float candidate = 0.0f;
+            if ( ( unreachable == a ) || ( unreachable == b ) || ( absXXX( a - b ) >= ch ) ) {
+                candidate = minXXX( a, b ) + ch;
+            } else {
+                candidate = ( a + b + sqrtXXX( 2.0f * ch * ch - square( a - b ) ) ) * 0.5f;
+            }
+            
+            if ( candidate < potential_[ neighbor ] ) {
+                potential_[ neighbor ] = candidate;
+                front_.push_back( std::make_pair( candidate, neighbor ) );
+                std::push_heap( front_.begin(), front_.end(), MinHeapOrder() );
+            }
+        }
+    }
+    
+    // Direction of steepest descent per cell.
+    int const intCount = static_cast< int >( count );
+    
+    #pragma omp parallel for
+    for ( int i = 0; i < intCount; ++i ) {
+        float const p = potential_[ i ];
+        if ( unreachable == p ) {
+            continue;
+        }
+        
+        size_type const column = i % columns;
+        size_type const row = i / columns;
+        
+        float const left = ( column > 0 ) ? potential_[ i - 1 ] : unreachable;
+        float const right = ( column + 1 < columns ) ? potential_[ i + 1 ] : unreachable;
+        float const back = ( row > 0 ) ? potential_[ i - columns ] : unreachable;
+        float const front = ( row + 1 < rows ) ? potential_[ i + columns ] : unreachable;
+        
+        float const x = ( left < right ) ? -maxXXX( 0.0f, p - left ) : maxXXX( 0.0f, p - right );
+        float const z = ( back < front ) ? -maxXXX( 0.0f, p - back ) : maxXXX( 0.0f, p - front );
+        
+        direction_[ i ] = Vec3( x, 0.0f, z ).normalize();
+    }
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::ContinuumCrowdPotential::sampleDirection( ContinuumCrowdGrid const& grid, 
+                                                     Vec3 const& position ) const
+{
+    if ( direction_.size() != grid.cellCount() ) {
+        return Vec3::zero;
+    }
+    
+    float x = 0.0f;
+    float z = 0.0f;
+    grid.mapPositionToGrid( position, x, z );
+    
+    size_type column = 0;
+    size_type row = 0;
+    float wx = 0.0f;
+    float wz = 0.0f;
+    splitCoordinate( x, grid.columnCount(), column, wx );
+    splitCoordinate( z, grid.rowCount(), row, wz );
+    
+    Vec3 const near( interpolate( wx, 
+                                  direction_[ grid.cellIndex( column, row ) ], 
+                                  direction_[ grid.cellIndex( column + 1, row ) ] ) );
+    Vec3 const far( interpolate( wx, 
+                                 direction_[ grid.cellIndex( column, row + 1 ) ], 
+                                 direction_[ grid.cellIndex( column + 1, row + 1 ) ] ) );
+    
+    return interpolate( wz, near, far ).normalize();
+}
+
+
+
+float 
+OpenSteer::ContinuumCrowdPotential::samplePotential( ContinuumCrowdGrid const& grid, 
+                                                     Vec3 const& position ) const
+{
+    size_type column = 0;
+    size_type row = 0;
+    if ( ( potential_.size() != grid.cellCount() ) || 
+         ! grid.mapPositionToCell( position, column, row ) ) {
+        return unreachable;
+    }
+    
+    return potential_[ grid.cellIndex( column, row ) ];
+}
@@ -0,0 +1,578 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Per thread ring buffers of per agent work records.
+ */
+#include "OpenSteer/FlightRecorder.h"
+
+// Include std::memcpy, std::memcmp
+#include <cstring>
+
+// Include std::ifstream, std::ofstream
+#include <fstream>
+
+// Include std::ostream, std::endl
+#include <ostream>
+
+// Include std::setw
+#include <iomanip>
+
+// Include std::remove, std::rename
+#include <cstdio>
+
+// Include std::map
+#include <map>
+
+// Include std::ostringstream
+#include <sstream>
+
+#if defined( _WIN32 )
+    // Include InterlockedCompareExchangePointer, InterlockedIncrement,
+    // MemoryBarrier
+    #include <windows.h>
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef FlightRecorder::Record Record;
+    typedef FlightRecorder::size_type size_type;
+    
+    char const dumpMagic[ 4 ] = { 'O', 'S', 'F', 'R' };
+    uint32_t const dumpVersion = 1;
+    
+    
+    // Store that makes the writes before it visible to a thread loading
+    // the value with loadAcquire.
+    void 
+    storeRelease( size_type volatile& target, size_type value )
+    {
+#if defined( __ATOMIC_RELEASE )
+        __atomic_store_n( &target, value, __ATOMIC_RELEASE );
+#elif defined( __GNUC__ )
+        __sync_synchronize();
+        target = value;
+#else
+        MemoryBarrier();
+        target = value;
+#endif
+    }
+    
+    
+    size_type 
+    loadAcquire( size_type volatile const& source )
+    {
+#if defined( __ATOMIC_ACQUIRE )
+        return __atomic_load_n( &source, __ATOMIC_ACQUIRE );
+#elif defined( __GNUC__ )
+        size_type const value = source;
+        __sync_synchronize();
+        return value;
+#else
+        size_type const value = source;
+        MemoryBarrier();
+        return value;
+#endif
+    }
+    
+    
+    // Orders the loads of the records copied before it before the loads
+    // after it.
+    void 
+    acquireFence()
+    {
+#if defined( __ATOMIC_ACQUIRE )
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+#elif defined( __GNUC__ )
+        __sync_synchronize();
+#else
+        MemoryBarrier();
+#endif
+    }
+    
+    
+    uint16_t 
+    saturatedAdd( uint16_t count, size_type added )
+    {
+        size_type const sum = count + added;
+        return static_cast< uint16_t >( sum < 0xffff ? sum : 0xffff );
+    }
+    
+    
+    size_type 
+    roundUpToPowerOfTwo( size_type value )
+    {
+        size_type result = 1;
+        while ( result < value ) {
+            result *= 2;
+        }
+        return result;
+    }
+    
+    
+    bool 
+    writeUint32( std::ostream& out, uint32_t value )
+    {
+        return static_cast< bool >( out.write( reinterpret_cast< char const* >( &value ), sizeof( value ) ) );
+    }
+    
+    
+    // Work of all agents recorded in one frame.
+    struct FrameSummary {
+        FrameSummary() : records( 0 ), neighbors( 0 ), obstacles( 0 ), busiest( 0 ) {}
+        size_type records;
+        size_type neighbors;
+        size_type obstacles;
+        Record const* busiest;
+    };
+    
+    
+    bool 
+    readUint32( std::istream& in, uint32_t& value )
+    {
+        return static_cast< bool >( in.read( reinterpret_cast< char* >( &value ), sizeof( value ) ) );
+    }
+    
+} // anonymous namespace
+
+
+
+struct OpenSteer::FlightRecorder::Ring {
+    Record* records;
+    size_type mask;
+    // Number of records ever written, the last mask + 1 of them are kept.
+    size_type volatile written;
+    Record current;
+    bool recording;
+    Ring* next;
+};
+
+
+
+namespace {
+    
+    uint32_t volatile ringCount = 0;
+    size_type capacity_ = 16384;
+    
+    size_type frame_ = 0;
+    
+    std::string spikePrefix = "flight-";
+    double spikeThreshold = 0.0;
+    size_type maxSpikeDumps = 0;
+    size_type spikeDumps = 0;
+    std::string lastDumpFile_;
+    
+} // anonymous namespace
+
+
+
+bool OpenSteer::FlightRecorder::enabled_ = true;
+OpenSteer::FlightRecorder::Ring* volatile OpenSteer::FlightRecorder::rings_ = 0;
+OPENSTEER_THREAD_LOCAL OpenSteer::FlightRecorder::Ring* OpenSteer::FlightRecorder::currentRing_ = 0;
+
+
+
+void 
+OpenSteer::FlightRecorder::setEnabled( bool enabled )
+{
+    enabled_ = enabled;
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::setCapacity( size_type records )
+{
+    capacity_ = roundUpToPowerOfTwo( records < 1 ? 1 : records );
+}
+
+
+
+OpenSteer::FlightRecorder::size_type 
+OpenSteer::FlightRecorder::capacity()
+{
+    return capacity_;
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::beginFrame()
+{
+    ++frame_;
+}
+
+
+
+OpenSteer::FlightRecorder::size_type 
+OpenSteer::FlightRecorder::frame()
+{
+    return frame_;
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::beginAgent( size_type agent )
+{
+    Ring& ring = threadRing();
+    ring.current.frame = static_cast< uint32_t >( frame_ );
+    ring.current.agent = static_cast< uint32_t >( agent );
+    ring.current.neighbors = 0;
+    ring.current.obstacles = 0;
+    ring.current.avoidance = notEvaluated;
+    ring.recording = true;
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::endAgent()
+{
+    Ring* const ring = currentRing_;
+    if ( 0 != ring && ring->recording ) {
+        size_type const written = ring->written;
+        ring->records[ written & ring->mask ] = ring->current;
+        storeRelease( ring->written, written + 1 );
+        ring->recording = false;
+    }
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::addNeighbors( size_type count )
+{
+    Ring* const ring = currentRing_;
+    if ( 0 != ring && ring->recording ) {
+        ring->current.neighbors = saturatedAdd( ring->current.neighbors, count );
+    }
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::addObstacles( size_type count )
+{
+    Ring* const ring = currentRing_;
+    if ( 0 != ring && ring->recording ) {
+        ring->current.obstacles = saturatedAdd( ring->current.obstacles, count );
+    }
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::setAvoidance( Avoidance avoidance )
+{
+    Ring* const ring = currentRing_;
+    if ( 0 != ring && ring->recording ) {
+        ring->current.avoidance = static_cast< uint16_t >( avoidance );
+    }
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::setSpikeDump( std::string const& prefix, 
+                                         double thresholdSeconds,
+                                         size_type maxDumps )
+{
+    spikePrefix = prefix;
+    spikeThreshold = thresholdSeconds;
+    maxSpikeDumps = maxDumps;
+    spikeDumps = 0;
+}
+
+
+
+bool 
+OpenSteer::FlightRecorder::endFrame( double seconds )
+{
+    if ( 0.0 >= spikeThreshold || seconds <= spikeThreshold || spikeDumps >= maxSpikeDumps ) {
+        return false;
+    }
+    
+    ++spikeDumps;
+    std::string errorMessage;
+    if ( ! dumpNow( errorMessage ) ) {
+        // Don't try again on every slow frame.
+        spikeDumps = maxSpikeDumps;
+        return false;
+    }
+    return true;
+}
+
+
+
+std::string const& 
+OpenSteer::FlightRecorder::lastDumpFile()
+{
+    return lastDumpFile_;
+}
+
+
+
+bool 
+OpenSteer::FlightRecorder::dumpNow( std::string& errorMessage )
+{
+    std::ostringstream fileName;
+    fileName << spikePrefix << frame_ << ".flight";
+    return dump( fileName.str(), errorMessage );
+}
+
+
+
+std::vector< OpenSteer::FlightRecorder::Record > 
+OpenSteer::FlightRecorder::records()
+{
+    std::vector< Record > result;
+    for ( Ring* ring = loadRings(); 0 != ring; ring = ring->next ) {
+        // The slot of the record being written next holds the oldest one.
+        size_type const kept = ring->mask;
+        size_type const end = loadAcquire( ring->written );
+        size_type const begin = end > kept ? end - kept : 0;
+        
+        std::vector< Record > copied;
+        copied.reserve( end - begin );
+        for ( size_type i = begin; i < end; ++i ) {
+            copied.push_back( ring->records[ i & ring->mask ] );
+        }
+        
+        // The recording thread might have overwritten the oldest records
+        // meanwhile, the record at index i is intact if the writer hasn't
+        // started on i + mask + 1.
+        acquireFence();
+        size_type const writing = loadAcquire( ring->written );
+        size_type const firstIntact = writing > kept ? writing - kept : 0;
+        size_type const skipped = firstIntact > begin ? firstIntact - begin : 0;
+        if ( skipped < copied.size() ) {
+            result.insert( result.end(), copied.begin() + skipped, copied.end() );
+        }
+    }
+    return result;
+}
+
+
+
+bool 
+OpenSteer::FlightRecorder::dump( std::string const& fileName, std::string& errorMessage )
+{
+    std::vector< Record > const recorded = records();
+    
+    std::string const temporary = fileName + ".tmp";
+    std::ofstream out( temporary.c_str(), std::ios::binary );
+    bool written = static_cast< bool >( out.write( dumpMagic, sizeof( dumpMagic ) ) )
+        && writeUint32( out, dumpVersion )
+        && writeUint32( out, sizeof( Record ) )
+        && writeUint32( out, static_cast< uint32_t >( recorded.size() ) );
+    for ( size_type i = 0; written && i < recorded.size(); ++i ) {
+        written = static_cast< bool >( out.write( reinterpret_cast< char const* >( &recorded[ i ] ), sizeof( Record ) ) );
+    }
+    out.close();
+    
+    if ( ! written || out.fail() ) {
+        std::remove( temporary.c_str() );
+        errorMessage = "can't write " + temporary;
+        return false;
+    }
+    
+    std::remove( fileName.c_str() );
+    if ( 0 != std::rename( temporary.c_str(), fileName.c_str() ) ) {
+        errorMessage = "can't rename " + temporary + " to " + fileName;
+        return false;
+    }
+    
+    lastDumpFile_ = fileName;
+    return true;
+}
+
+
+
+bool 
+OpenSteer::FlightRecorder::readDump( std::string const& fileName, 
+                                     std::vector< Record >& records,
+                                     std::string& errorMessage )
+{
+    std::ifstream in( fileName.c_str(), std::ios::binary );
+    if ( ! in ) {
+        errorMessage = "can't open " + fileName;
+        return false;
+    }
+    
+    char magic[ sizeof( dumpMagic ) ];
+    uint32_t version = 0;
+    uint32_t recordSize = 0;
+    uint32_t count = 0;
+    if ( ! in.read( magic, sizeof( magic ) ) 
+         || 0 != std::memcmp( magic, dumpMagic, sizeof( magic ) ) 
+         || ! readUint32( in, version ) 
+         || ! readUint32( in, recordSize ) 
+         || ! readUint32( in, count ) ) {
+        errorMessage = fileName + " isn't a flight recorder dump";
+        return false;
+    }
+    
+    if ( dumpVersion != version || sizeof( Record ) != recordSize ) {
+        errorMessage = fileName + " has an unsupported version or was written on another kind of machine";
+        return false;
+    }
+    
+    std::vector< Record > read( count );
+    if ( 0 < count && ! in.read( reinterpret_cast< char* >( &read[ 0 ] ), static_cast< std::streamsize >( count * sizeof( Record ) ) ) ) {
+        errorMessage = fileName + " is truncated";
+        return false;
+    }
+    
+    records.swap( read );
+    return true;
+}
+
+
+
+void 
+OpenSteer::FlightRecorder::print( std::ostream& out, std::vector< Record > const& records )
+{
+    out << std::setw( 10 ) << "frame" 
+        << std::setw( 10 ) << "agent" 
+        << std::setw( 8 ) << "thread"
+        << std::setw( 11 ) << "neighbors" 
+        << std::setw( 11 ) << "obstacles" 
+        << "  avoidance" << std::endl;
+    
+    std::map< uint32_t, FrameSummary > frames;
+    
+    for ( size_type i = 0; i < records.size(); ++i ) {
+        Record const& record = records[ i ];
+        out << std::setw( 10 ) << record.frame 
+            << std::setw( 10 ) << record.agent 
+            << std::setw( 8 ) << record.thread
+            << std::setw( 11 ) << record.neighbors 
+            << std::setw( 11 ) << record.obstacles 
+            << "  " << name( static_cast< Avoidance >( record.avoidance ) ) << std::endl;
+        
+        FrameSummary& frame = frames[ record.frame ];
+        ++frame.records;
+        frame.neighbors += record.neighbors;
+        frame.obstacles += record.obstacles;
+        if ( 0 == frame.busiest || frame.busiest->neighbors < record.neighbors ) {
+            frame.busiest = &record;
+        }
+    }
+    
+    out << std::endl 
+        << std::setw( 10 ) << "frame" 
+        << std::setw( 10 ) << "agents" 
+        << std::setw( 11 ) << "neighbors" 
+        << std::setw( 11 ) << "obstacles" 
+        << "  most neighbors (agent)" << std::endl;
+    for ( std::map< uint32_t, FrameSummary >::const_iterator i = frames.begin(); i != frames.end(); ++i ) {
+        out << std::setw( 10 ) << i->first 
+            << std::setw( 10 ) << i->second.records 
+            << std::setw( 11 ) << i->second.neighbors 
+            << std::setw( 11 ) << i->second.obstacles 
+            << "  " << i->second.busiest->neighbors 
+            << " (" << i->second.busiest->agent << ")" << std::endl;
+    }
+}
+
+
+
+char const* 
+OpenSteer::FlightRecorder::name( Avoidance avoidance )
+{
+    switch ( avoidance ) {
+        case notEvaluated: return "-";
+        case noThreat: return "no threat";
+        case closeNeighbor: return "close neighbor";
+        case headOn: return "head on";
+        case parallel: return "parallel";
+        case perpendicular: return "perpendicular";
+        case perpendicularFaster: return "perpendicular, faster";
+        default: return "unknown";
+    }
+}
+
+
+
+OpenSteer::FlightRecorder::Ring* 
+OpenSteer::FlightRecorder::loadRings()
+{
+#if defined( __ATOMIC_ACQUIRE )
+    return __atomic_load_n( &rings_, __ATOMIC_ACQUIRE );
+#else
+    Ring* const head = rings_;
+    acquireFence();
+    return head;
+#endif
+}
+
+
+
+OpenSteer::FlightRecorder::Ring& 
+OpenSteer::FlightRecorder::threadRing()
+{
+    if ( 0 != currentRing_ ) {
+        return *currentRing_;
+    }
+    
+    // Each thread allocates its ring once and never frees it, threads
+    // come from the main thread and thread pools that live as long.
+    Ring* const ring = new Ring();
+    ring->records = new Record[ capacity_ ];
+    ring->mask = capacity_ - 1;
+    ring->written = 0;
+    ring->recording = false;
+    
+#if defined( __GNUC__ )
+    ring->current.thread = static_cast< uint16_t >( __sync_fetch_and_add( &ringCount, 1 ) );
+    for ( Ring* head = loadRings(); ; ) {
+        ring->next = head;
+        Ring* const previous = __sync_val_compare_and_swap( &rings_, head, ring );
+        if ( previous == head ) {
+            break;
+        }
+        head = previous;
+    }
+#else
+    ring->current.thread = static_cast< uint16_t >( InterlockedIncrement( reinterpret_cast< LONG volatile* >( &ringCount ) ) - 1 );
+    for ( Ring* head = loadRings(); ; ) {
+        ring->next = head;
+        Ring* const previous = static_cast< Ring* >( InterlockedCompareExchangePointer( reinterpret_cast< PVOID volatile* >( &rings_ ), ring, head ) );
+        if ( previous == head ) {
+            break;
+        }
+        head = previous;
+    }
+#endif
+    
+    currentRing_ = ring;
+    return *ring;
+}
@@ -0,0 +1,434 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the frame time budget.
+ */
+#include "OpenSteer/FrameBudget.h"
+
+// Include std::ostream, std::endl
+#include <ostream>
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::setprecision
+#include <iomanip>
+
+// Include assert
+#include <cassert>
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    // The phase whose cost a knob reduces.
+    FrameBudget::Phase 
+    phaseOf( FrameBudget::Knob knob )
+    {
+        return knob == FrameBudget::annotationKnob ? FrameBudget::drawPhase
+                                                   : FrameBudget::updatePhase;
+    }
+    
+    
+    float 
+    milliseconds( float seconds )
+    {
+        return seconds * 1000.0f;
+    }
+    
+    
+} // anonymous namespace
+
+
+
+OpenSteer::FrameBudget::size_type const OpenSteer::FrameBudget::degradeAfterFrames;
+OpenSteer::FrameBudget::size_type const OpenSteer::FrameBudget::restoreAfterFrames;
+int const OpenSteer::FrameBudget::maxStep;
+
+
+
+OpenSteer::FrameBudget::FrameBudget()
+    : budget_( 0.0f ), log_( 0 )
+{
+    reset();
+}
+
+
+
+void 
+OpenSteer::FrameBudget::setBudget( float seconds )
+{
+    budget_ = seconds > 0.0f ? seconds : 0.0f;
+    framesOver_ = 0;
+    framesWithHeadroom_ = 0;
+    exhausted_ = false;
+    
+    if ( ! enabled() ) {
+        for ( int knob = 0; knob < knobCount; ++knob ) {
+            steps_[ knob ] = 0;
+        }
+        turned_.clear();
+    }
+}
+
+
+
+float 
+OpenSteer::FrameBudget::budget() const
+{
+    return budget_;
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::enabled() const
+{
+    return budget_ > 0.0f;
+}
+
+
+
+void 
+OpenSteer::FrameBudget::setLog( std::ostream* log )
+{
+    log_ = log;
+}
+
+
+
+void 
+OpenSteer::FrameBudget::setSupported( Knob knob, bool supported )
+{
+    assert( knob < knobCount && "Knob out of range." );
+    supported_[ knob ] = supported;
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::supported( Knob knob ) const
+{
+    assert( knob < knobCount && "Knob out of range." );
+    return supported_[ knob ];
+}
+
+
+
+void 
+OpenSteer::FrameBudget::reset()
+{
+    for ( int knob = 0; knob < knobCount; ++knob ) {
+        supported_[ knob ] = false;
+        steps_[ knob ] = 0;
+    }
+    supported_[ annotationKnob ] = true;
+    turned_.clear();
+    
+    for ( int phase = 0; phase < phaseCount; ++phase ) {
+        phaseSeconds_[ phase ] = 0.0f;
+        lastPhaseSeconds_[ phase ] = 0.0f;
+    }
+    
+    frame_ = 0;
+    framesOver_ = 0;
+    framesWithHeadroom_ = 0;
+    exhausted_ = false;
+    decisionCount_ = 0;
+    lastDecision_.clear();
+}
+
+
+
+void 
+OpenSteer::FrameBudget::addPhaseSeconds( Phase phase, float seconds )
+{
+    assert( phase < phaseCount && "Phase out of range." );
+    phaseSeconds_[ phase ] += seconds;
+}
+
+
+
+void 
+OpenSteer::FrameBudget::beginFrame()
+{
+    float frameSeconds = 0.0f;
+    for ( int phase = 0; phase < phaseCount; ++phase ) {
+        lastPhaseSeconds_[ phase ] = phaseSeconds_[ phase ];
+        phaseSeconds_[ phase ] = 0.0f;
+        frameSeconds += lastPhaseSeconds_[ phase ];
+    }
+    
+    // Nothing was measured before the first frame.
+    if ( enabled() && frame_ > 0 ) {
+        
+        if ( frameSeconds > budget_ ) {
+            ++framesOver_;
+            framesWithHeadroom_ = 0;
+        } else if ( frameSeconds < headroom() * budget_ ) {
+            ++framesWithHeadroom_;
+            framesOver_ = 0;
+        } else {
+            framesOver_ = 0;
+            framesWithHeadroom_ = 0;
+        }
+        
+        if ( framesOver_ >= degradeAfterFrames ) {
+            framesOver_ = 0;
+            degrade();
+        } else if ( framesWithHeadroom_ >= restoreAfterFrames ) {
+            framesWithHeadroom_ = 0;
+            restore();
+        }
+    }
+    
+    ++frame_;
+}
+
+
+
+OpenSteer::FrameBudget::size_type 
+OpenSteer::FrameBudget::frame() const
+{
+    return frame_;
+}
+
+
+
+float 
+OpenSteer::FrameBudget::phaseSeconds( Phase phase ) const
+{
+    assert( phase < phaseCount && "Phase out of range." );
+    return lastPhaseSeconds_[ phase ];
+}
+
+
+
+int 
+OpenSteer::FrameBudget::step( Knob knob ) const
+{
+    assert( knob < knobCount && "Knob out of range." );
+    return steps_[ knob ];
+}
+
+
+
+OpenSteer::FrameBudget::size_type 
+OpenSteer::FrameBudget::neighborCap() const
+{
+    int const step = steps_[ neighborCapKnob ];
+    return step == 0 ? 0 : ( size_type( 32 ) >> ( step - 1 ) );
+}
+
+
+
+OpenSteer::FrameBudget::size_type 
+OpenSteer::FrameBudget::annotationInterval() const
+{
+    int const step = steps_[ annotationKnob ];
+    return step == maxStep ? 0 : ( size_type( 1 ) << step );
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::annotateFrame() const
+{
+    size_type const interval = annotationInterval();
+    return interval != 0 && frame_ % interval == 0;
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::reduceDistantUpdates() const
+{
+    return steps_[ distantUpdatesKnob ] > 0;
+}
+
+
+
+float 
+OpenSteer::FrameBudget::fullDetailScale() const
+{
+    int const step = steps_[ distantUpdatesKnob ];
+    return step == 0 ? 1.0f : 1.0f / float( 1 << ( step - 1 ) );
+}
+
+
+
+OpenSteer::FrameBudget::size_type 
+OpenSteer::FrameBudget::decisionCount() const
+{
+    return decisionCount_;
+}
+
+
+
+std::string const& 
+OpenSteer::FrameBudget::lastDecision() const
+{
+    return lastDecision_;
+}
+
+
+
+char const* 
+OpenSteer::FrameBudget::name( Knob knob )
+{
+    switch ( knob ) {
+        case annotationKnob: return "annotation";
+        case distantUpdatesKnob: return "distant updates";
+        case neighborCapKnob: return "neighbor cap";
+        default: return "unknown";
+    }
+}
+
+
+
+std::string 
+OpenSteer::FrameBudget::describe( Knob knob, int step )
+{
+    std::ostringstream description;
+    switch ( knob ) {
+        case annotationKnob:
+            if ( step == 0 ) {
+                description << "every frame";
+            } else if ( step == maxStep ) {
+                description << "off";
+            } else {
+                description << "every " << ( 1 << step ) << ( step == 1 ? "nd" : "th" ) << " frame";
+            }
+            break;
+        case distantUpdatesKnob:
+            if ( step == 0 ) {
+                description << "every frame";
+            } else {
+                description << "reduced beyond " 
+                            << 1.0f / float( 1 << ( step - 1 ) ) 
+                            << " x full detail distance";
+            }
+            break;
+        case neighborCapKnob:
+            if ( step == 0 ) {
+                description << "unlimited";
+            } else {
+                description << ( 32 >> ( step - 1 ) );
+            }
+            break;
+        default:
+            description << step;
+    }
+    return description.str();
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::degrade()
+{
+    // The most expensive phase.
+    Phase const costly = 
+        lastPhaseSeconds_[ drawPhase ] > lastPhaseSeconds_[ updatePhase ] ? drawPhase : updatePhase;
+    
+    // Prefer a knob of the costly phase, then the least turned one.
+    int chosen = knobCount;
+    for ( int knob = 0; knob < knobCount; ++knob ) {
+        if ( ! supported_[ knob ] || steps_[ knob ] == maxStep ) {
+            continue;
+        }
+        if ( chosen == knobCount ) {
+            chosen = knob;
+            continue;
+        }
+        
+        bool const costlyKnob = phaseOf( Knob( knob ) ) == costly;
+        bool const costlyChosen = phaseOf( Knob( chosen ) ) == costly;
+        if ( ( costlyKnob && ! costlyChosen ) || 
+             ( costlyKnob == costlyChosen && steps_[ knob ] < steps_[ chosen ] ) ) {
+            chosen = knob;
+        }
+    }
+    
+    if ( chosen == knobCount ) {
+        if ( ! exhausted_ ) {
+            exhausted_ = true;
+            decide( knobCount, 0, "over budget" );
+        }
+        return false;
+    }
+    
+    turned_.push_back( Knob( chosen ) );
+    decide( Knob( chosen ), steps_[ chosen ] + 1, "over budget" );
+    return true;
+}
+
+
+
+bool 
+OpenSteer::FrameBudget::restore()
+{
+    exhausted_ = false;
+    if ( turned_.empty() ) {
+        return false;
+    }
+    
+    Knob const knob = turned_.back();
+    turned_.pop_back();
+    decide( knob, steps_[ knob ] - 1, "under budget" );
+    return true;
+}
+
+
+
+void 
+OpenSteer::FrameBudget::decide( Knob knob, int step, char const* reason )
+{
+    std::ostringstream decision;
+    decision << std::fixed << std::setprecision( 2 );
+    decision << "frame " << frame_ << ": " 
+             << milliseconds( lastPhaseSeconds_[ updatePhase ] + lastPhaseSeconds_[ drawPhase ] ) << " ms"
+             << " (update " << milliseconds( lastPhaseSeconds_[ updatePhase ] ) << " ms"
+             << ", draw " << milliseconds( lastPhaseSeconds_[ drawPhase ] ) << " ms) "
+             << reason << " " << milliseconds( budget_ ) << " ms, ";
+    
+    if ( knob == knobCount ) {
+        decision << "nothing left to lower";
+    } else {
+        decision << name( knob ) << " " << describe( knob, steps_[ knob ] ) 
+                 << " -> " << describe( knob, step );
+        steps_[ knob ] = step;
+        ++decisionCount_;
+    }
+    
+    lastDecision_ = decision.str();
+    if ( log_ ) {
+        *log_ << lastDecision_ << std::endl;
+    }
+}
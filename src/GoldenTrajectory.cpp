@@ -0,0 +1,431 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of recording, comparing, reading and writing golden 
+ * trajectories.
+ */
+#include "OpenSteer/GoldenTrajectory.h"
+
+// Include std::atoi, std::atof
+#include <cstdlib>
+
+// Include std::strcmp
+#include <cstring>
+
+// Include std::ifstream, std::ofstream
+#include <fstream>
+
+// Include std::istream, std::ostream
+#include <istream>
+#include <ostream>
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::min, std::max, std::max_element
+#include <algorithm>
+
+// Include std::fabs
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Relative deviation of @a value from @a golden.
+     */
+    float 
+    deviation( float value, float golden )
+    {
+        return std::fabs( value - golden ) / std::max( 1.0f, std::fabs( golden ) );
+    }
+    
+    
+    /**
+     * Largest relative deviation of the components of @a value from
+     * @a golden.
+     */
+    float 
+    deviation( GoldenTrajectory::Sample const& value, 
+               GoldenTrajectory::Sample const& golden )
+    {
+        float const components[] = {
+            deviation( value.position.x, golden.position.x ),
+            deviation( value.position.y, golden.position.y ),
+            deviation( value.position.z, golden.position.z ),
+            deviation( value.forward.x, golden.forward.x ),
+            deviation( value.forward.y, golden.forward.y ),
+            deviation( value.forward.z, golden.forward.z ),
+            deviation( value.up.x, golden.up.x ),
+            deviation( value.up.y, golden.up.y ),
+            deviation( value.up.z, golden.up.z ),
+            deviation( value.speed, golden.speed ) };
+        
+        return *std::max_element( components, components + sizeof( components ) / sizeof( components[ 0 ] ) );
+    }
+    
+    
+    /**
+     * @c true if all components of the samples are equal.
+     */
+    bool 
+    equal( GoldenTrajectory::Sample const& lhs, 
+           GoldenTrajectory::Sample const& rhs )
+    {
+        return lhs.position == rhs.position && 
+               lhs.forward == rhs.forward && 
+               lhs.up == rhs.up && 
+               lhs.speed == rhs.speed;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::GoldenTrajectory::size_type const OpenSteer::GoldenTrajectory::npos = static_cast< size_type >( -1 );
+
+
+
+OpenSteer::GoldenTrajectory::GoldenTrajectory()
+    : samples_(), errorMessage_()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectory::clear()
+{
+    samples_.clear();
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectory::record( size_type step, 
+                                     size_type vehicleIndex, 
+                                     AbstractVehicle const& vehicle )
+{
+    Sample const sample = { step, 
+                            vehicleIndex, 
+                            vehicle.position(), 
+                            vehicle.forward(), 
+                            vehicle.up(), 
+                            vehicle.speed() };
+    samples_.push_back( sample );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectory::add( Sample const& sample )
+{
+    samples_.push_back( sample );
+}
+
+
+
+OpenSteer::GoldenTrajectory::size_type 
+OpenSteer::GoldenTrajectory::size() const
+{
+    return samples_.size();
+}
+
+
+
+OpenSteer::GoldenTrajectory::Sample const& 
+OpenSteer::GoldenTrajectory::sample( size_type index ) const
+{
+    assert( index < samples_.size() && "index out of range" );
+    return samples_[ index ];
+}
+
+
+
+OpenSteer::GoldenTrajectory::Comparison 
+OpenSteer::GoldenTrajectory::compare( GoldenTrajectory const& golden, 
+                                      float tolerance ) const
+{
+    Comparison result = { true, npos, 0.0f, std::string() };
+    
+    size_type const count = std::min( size(), golden.size() );
+    for ( size_type i = 0; i < count; ++i ) {
+        Sample const& value = samples_[ i ];
+        Sample const& expected = golden.samples_[ i ];
+        
+        if ( value.step != expected.step || value.vehicle != expected.vehicle ) {
+            std::ostringstream message;
+            message << "sample " << i << " is of step " << value.step 
+                    << " vehicle " << value.vehicle << " instead of step "
+                    << expected.step << " vehicle " << expected.vehicle;
+            result.match = false;
+            result.firstMismatch = i;
+            result.message = message.str();
+            return result;
+        }
+        
+        float const sampleDeviation = deviation( value, expected );
+        result.maxDeviation = std::max( result.maxDeviation, sampleDeviation );
+        
+        bool const agrees = ( 0.0f == tolerance ) ? equal( value, expected ) : ( sampleDeviation <= tolerance );
+        if ( ! agrees && result.match ) {
+            std::ostringstream message;
+            message << "step " << value.step << " vehicle " << value.vehicle
+                    << " deviates by " << sampleDeviation;
+            result.match = false;
+            result.firstMismatch = i;
+            result.message = message.str();
+        }
+    }
+    
+    if ( size() != golden.size() && result.match ) {
+        std::ostringstream message;
+        message << size() << " samples instead of " << golden.size();
+        result.match = false;
+        result.firstMismatch = count;
+        result.message = message.str();
+    }
+    
+    return result;
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectory::load( std::string const& fileName )
+{
+    std::ifstream in( fileName.c_str() );
+    if ( ! in ) {
+        return fail( "can't open trajectory file " + fileName );
+    }
+    
+    if ( ! read( in ) ) {
+        errorMessage_ = fileName + ": " + errorMessage_;
+        return false;
+    }
+    return true;
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectory::save( std::string const& fileName ) const
+{
+    std::ofstream out( fileName.c_str(), std::ios::out | std::ios::trunc );
+    write( out );
+    return out.good();
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectory::read( std::istream& in )
+{
+    clear();
+    errorMessage_.clear();
+    
+    while ( in >> std::ws && ! in.eof() ) {
+        if ( '#' == in.peek() ) {
+            in.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+            continue;
+        }
+        
+        Sample sample;
+        in >> sample.step >> sample.vehicle
+           >> sample.position.x >> sample.position.y >> sample.position.z
+           >> sample.forward.x >> sample.forward.y >> sample.forward.z
+           >> sample.up.x >> sample.up.y >> sample.up.z
+           >> sample.speed;
+        if ( in.fail() ) {
+            std::ostringstream message;
+            message << "malformed sample " << samples_.size();
+            return fail( message.str() );
+        }
+        samples_.push_back( sample );
+    }
+    return true;
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectory::write( std::ostream& out ) const
+{
+    std::streamsize const precision = out.precision( std::numeric_limits< float >::digits10 + 3 );
+    
+    out << "# step vehicle position forward up speed" << '\n';
+    for ( size_type i = 0; i < samples_.size(); ++i ) {
+        Sample const& s = samples_[ i ];
+        out << s.step << ' ' << s.vehicle << ' '
+            << s.position.x << ' ' << s.position.y << ' ' << s.position.z << ' '
+            << s.forward.x << ' ' << s.forward.y << ' ' << s.forward.z << ' '
+            << s.up.x << ' ' << s.up.y << ' ' << s.up.z << ' '
+            << s.speed << '\n';
+    }
+    
+    out.precision( precision );
+}
+
+
+
+std::string const& 
+OpenSteer::GoldenTrajectory::errorMessage() const
+{
+    return errorMessage_;
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectory::fail( std::string const& message )
+{
+    clear();
+    errorMessage_ = message;
+    return false;
+}
+
+
+
+
+OpenSteer::GoldenTrajectoryCheck::GoldenTrajectoryCheck()
+    : interval_( 60 ), 
+      tolerance_( 1e-5f ), 
+      goldenFile_(), 
+      saveGoldenFile_(), 
+      trajectory_()
+{
+    // Nothing to do.
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectoryCheck::isOption( char const* name )
+{
+    return ( 0 == std::strcmp( name, "golden" ) ) ||
+           ( 0 == std::strcmp( name, "saveGolden" ) ) ||
+           ( 0 == std::strcmp( name, "goldenTolerance" ) ) ||
+           ( 0 == std::strcmp( name, "goldenInterval" ) );
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectoryCheck::setOption( char const* name, char const* value )
+{
+    if ( 0 == std::strcmp( name, "golden" ) ) {
+        goldenFile_ = value;
+    } else if ( 0 == std::strcmp( name, "saveGolden" ) ) {
+        saveGoldenFile_ = value;
+    } else if ( 0 == std::strcmp( name, "goldenTolerance" ) ) {
+        float const tolerance = static_cast< float >( std::atof( value ) );
+        if ( tolerance < 0.0f ) {
+            return false;
+        }
+        tolerance_ = tolerance;
+    } else if ( 0 == std::strcmp( name, "goldenInterval" ) ) {
+        int const interval = std::atoi( value );
+        if ( interval < 1 ) {
+            return false;
+        }
+        interval_ = static_cast< size_type >( interval );
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryCheck::clear()
+{
+    trajectory_.clear();
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryCheck::sample( size_type step, AVGroup const& vehicles )
+{
+    if ( ( 0 != step % interval_ ) || ( ! recording() ) ) {
+        return;
+    }
+    
+    for ( size_type i = 0; i < vehicles.size(); ++i ) {
+        trajectory_.record( step, i, *vehicles[ i ] );
+    }
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectoryCheck::check( std::ostream& report ) const
+{
+    bool passed = true;
+    
+    if ( ! saveGoldenFile_.empty() ) {
+        bool const saved = trajectory_.save( saveGoldenFile_ );
+        report << "golden trajectory:   " 
+               << ( saved ? "saved to " : "can't save " ) << saveGoldenFile_ << '\n';
+        passed = saved;
+    }
+    
+    if ( ! goldenFile_.empty() ) {
+        GoldenTrajectory golden;
+        if ( ! golden.load( goldenFile_ ) ) {
+            report << "golden trajectory:   " << golden.errorMessage() << '\n';
+            return false;
+        }
+        
+        GoldenTrajectory::Comparison const result = trajectory_.compare( golden, tolerance_ );
+        report << "golden trajectory:   " 
+               << ( result.match ? "match" : "MISMATCH, " ) << result.message << '\n'
+               << "golden deviation:    " << result.maxDeviation << '\n';
+        passed = passed && result.match;
+    }
+    
+    return passed;
+}
+
+
+
+bool 
+OpenSteer::GoldenTrajectoryCheck::recording() const
+{
+    return ( ! goldenFile_.empty() ) || ( ! saveGoldenFile_.empty() );
+}
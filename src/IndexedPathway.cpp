@@ -0,0 +1,370 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the pathway with a segment grid.
+ */
+#include "OpenSteer/IndexedPathway.h"
+
+// Include std::lower_bound, std::max, std::min
+#include <algorithm>
+
+// Include std::ceil, std::floor, std::sqrt
+#include <cmath>
+
+// Include std::numeric_limits< float >::max
+#include <limits>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::mapPointToPathAlike, OpenSteer::PointToPathAlikeBaseDataExtractionPolicy
+#include "OpenSteer/QueryPathAlike.h"
+
+// Include OpenSteer::PointToPathMapping, OpenSteer::PointToPathDistanceMapping
+#include "OpenSteer/QueryPathAlikeMappings.h"
+
+// Include OpenSteer::clamp, OpenSteer::modulo
+#include "OpenSteer/Utilities.h"
+
+#ifdef _MSC_VER
+#undef min
+#undef max
+#endif
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * The longest side of the path's bounding box is divided into at most 
+     * this many cells. Cells aren't made smaller than the path radius.
+     */
+    float const maxCellsPerSide = 32.0f;
+    
+    /**
+     * Cells the grid extends beyond the path's tube on each side.
+     */
+    float const marginCells = 2.0f;
+    
+    /**
+     * Distance of @a point to the center line of segment @a segmentIndex.
+     */
+    float 
+    distanceToCenterLine( PolylineSegmentedPathwaySingleRadius const& path,
+                          PolylineSegmentedPathwaySingleRadius::size_type segmentIndex,
+                          Vec3 const& point )
+    {
+        float segmentDistance = 0.0f;
+        Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+        Vec3 tangent( 0.0f, 0.0f, 0.0f );
+        float radius = 0.0f;
+        path.mapPointToSegmentDistanceAndPointAndTangentAndRadius( segmentIndex, point, segmentDistance, pointOnPathCenterLine, tangent, radius );
+        return distance( point, pointOnPathCenterLine );
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::IndexedPathway::IndexedPathway( size_type numOfPoints,
+                                           Vec3 const points[],
+                                           float r,
+                                           bool closeCycle )
+    : polyline_( numOfPoints, points, r, closeCycle ),
+      segmentStartDistance_(),
+      gridMin_( 0.0f, 0.0f, 0.0f ),
+      cellSize_( 1.0f ),
+      inverseCellSize_( 1.0f ),
+      cellStart_(),
+      cellSegments_()
+{
+    assert( numOfPoints >= 2 && "A pathway needs at least two points." );
+    
+    // accumulated in segment order, like the distance along the path is by
+    // mapPointToPathAlike
+    size_type const segmentCount = polyline_.segmentCount();
+    segmentStartDistance_.resize( segmentCount );
+    float distanceOnPath = 0.0f;
+    for ( size_type i = 0; i < segmentCount; ++i ) {
+        segmentStartDistance_[ i ] = distanceOnPath;
+        distanceOnPath += polyline_.segmentLength( i );
+    }
+    
+    buildSegmentGrid();
+}
+
+
+
+OpenSteer::IndexedPathway::~IndexedPathway()
+{
+    // Nothing to do.
+}
+
+
+
+bool 
+OpenSteer::IndexedPathway::isValid() const
+{
+    return polyline_.isValid();
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::IndexedPathway::mapPointToPath( Vec3 const& point, 
+                                           Vec3& tangent, 
+                                           float& outside ) const
+{
+    PointToPathMapping mapping;
+    mapPointToIndexedPath( point, mapping );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::IndexedPathway::mapPathDistanceToPoint( float pathDistance ) const
+{
+    float const pathLength = length();
+    
+    if ( isCyclic() ) {
+        pathDistance = modulo( pathDistance, pathLength );
+    }
+    pathDistance = clamp( pathDistance, 0.0f, pathLength );
+    
+    // the first segment ending at or beyond pathDistance
+    std::vector< float >::const_iterator const nextStart = 
+        std::lower_bound( segmentStartDistance_.begin() + 1, 
+                          segmentStartDistance_.end(), 
+                          pathDistance );
+    size_type const segmentIndex = ( nextStart - segmentStartDistance_.begin() ) - 1;
+    
+    return polyline_.mapSegmentDistanceToPoint( segmentIndex, 
+                                                pathDistance - segmentStartDistance_[ segmentIndex ] );
+}
+
+
+
+float 
+OpenSteer::IndexedPathway::mapPointToPathDistance( Vec3 const& point ) const
+{
+    PointToPathDistanceMapping mapping;
+    mapPointToIndexedPath( point, mapping );
+    return mapping.distanceOnPath;
+}
+
+
+
+bool 
+OpenSteer::IndexedPathway::isCyclic() const
+{
+    return polyline_.isCyclic();
+}
+
+
+
+float 
+OpenSteer::IndexedPathway::length() const
+{
+    return polyline_.length();
+}
+
+
+
+OpenSteer::PolylineSegmentedPathwaySingleRadius const& 
+OpenSteer::IndexedPathway::polyline() const
+{
+    return polyline_;
+}
+
+
+
+float 
+OpenSteer::IndexedPathway::radius() const
+{
+    return polyline_.radius();
+}
+
+
+
+OpenSteer::IndexedPathway::size_type 
+OpenSteer::IndexedPathway::pointCount() const
+{
+    return polyline_.pointCount();
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::IndexedPathway::point( size_type pointIndex ) const
+{
+    return polyline_.point( pointIndex );
+}
+
+
+
+OpenSteer::IndexedPathway::size_type 
+OpenSteer::IndexedPathway::cellCount() const
+{
+    return cells_[ 0 ] * cells_[ 1 ] * cells_[ 2 ];
+}
+
+
+
+float 
+OpenSteer::IndexedPathway::meanSegmentsPerCell() const
+{
+    return static_cast< float >( cellSegments_.size() ) / cellCount();
+}
+
+
+
+void 
+OpenSteer::IndexedPathway::buildSegmentGrid()
+{
+    Vec3 minCorner = polyline_.point( 0 );
+    Vec3 maxCorner = polyline_.point( 0 );
+    for ( size_type i = 1; i < polyline_.pointCount(); ++i ) {
+        Vec3 const p = polyline_.point( i );
+        minCorner.set( std::min( minCorner.x, p.x ), std::min( minCorner.y, p.y ), std::min( minCorner.z, p.z ) );
+        maxCorner.set( std::max( maxCorner.x, p.x ), std::max( maxCorner.y, p.y ), std::max( maxCorner.z, p.z ) );
+    }
+    
+    Vec3 const extent = maxCorner - minCorner;
+    float const longestSide = std::max( extent.x, std::max( extent.y, extent.z ) );
+    cellSize_ = std::max( polyline_.radius(), longestSide / maxCellsPerSide );
+    if ( cellSize_ <= 0.0f ) {
+        cellSize_ = 1.0f;
+    }
+    inverseCellSize_ = 1.0f / cellSize_;
+    
+    float const margin = polyline_.radius() + marginCells * cellSize_;
+    gridMin_ = minCorner - Vec3( margin, margin, margin );
+    float const sides[ 3 ] = { extent.x, extent.y, extent.z };
+    for ( int axis = 0; axis < 3; ++axis ) {
+        cells_[ axis ] = static_cast< size_type >( std::ceil( ( sides[ axis ] + 2.0f * margin ) * inverseCellSize_ ) );
+    }
+    
+    // A point of a cell is at most halfDiagonal away from the cell's
+    // center, so its nearest segment is at most 2 * halfDiagonal farther
+    // from the center than the segment nearest to the center.
+    float const halfDiagonal = 0.5f * std::sqrt( 3.0f ) * cellSize_;
+    float const slack = 2.0f * halfDiagonal * 1.001f;
+    
+    size_type const segmentCount = polyline_.segmentCount();
+    std::vector< float > centerDistance( segmentCount );
+    
+    cellStart_.resize( cellCount() + 1 );
+    cellSegments_.clear();
+    for ( size_type z = 0; z < cells_[ 2 ]; ++z ) {
+        for ( size_type y = 0; y < cells_[ 1 ]; ++y ) {
+            for ( size_type x = 0; x < cells_[ 0 ]; ++x ) {
+                cellStart_[ ( z * cells_[ 1 ] + y ) * cells_[ 0 ] + x ] = cellSegments_.size();
+                
+                Vec3 const center = gridMin_ + Vec3( x + 0.5f, y + 0.5f, z + 0.5f ) * cellSize_;
+                float minDistance = std::numeric_limits< float >::max();
+                for ( size_type i = 0; i < segmentCount; ++i ) {
+                    centerDistance[ i ] = distanceToCenterLine( polyline_, i, center );
+                    minDistance = std::min( minDistance, centerDistance[ i ] );
+                }
+                
+                for ( size_type i = 0; i < segmentCount; ++i ) {
+                    if ( centerDistance[ i ] <= minDistance + slack ) {
+                        cellSegments_.push_back( i );
+                    }
+                }
+            }
+        }
+    }
+    cellStart_[ cellCount() ] = cellSegments_.size();
+}
+
+
+
+OpenSteer::IndexedPathway::size_type 
+OpenSteer::IndexedPathway::cellIndex( Vec3 const& point ) const
+{
+    Vec3 const local = ( point - gridMin_ ) * inverseCellSize_;
+    float const coordinates[ 3 ] = { local.x, local.y, local.z };
+    size_type index = 0;
+    for ( int axis = 2; axis >= 0; --axis ) {
+        float const c = std::floor( coordinates[ axis ] );
+        if ( ! ( c >= 0.0f && c < cells_[ axis ] ) ) {
+            return cellCount();
+        }
+        index = index * cells_[ axis ] + static_cast< size_type >( c );
+    }
+    return index;
+}
+
+
+
+template< class Mapping >
+void 
+OpenSteer::IndexedPathway::mapPointToIndexedPath( Vec3 const& point, Mapping& mapping ) const
+{
+    size_type const cell = cellIndex( point );
+    if ( cell == cellCount() ) {
+        mapPointToPathAlike( polyline_, point, mapping );
+        return;
+    }
+    
+    // Same as PointToPathAlikeMapping::map restricted to the segments of
+    // the cell, which are listed in increasing order so that ties are 
+    // resolved the same way.
+    typedef PointToPathAlikeBaseDataExtractionPolicy< PolylineSegmentedPathwaySingleRadius > BaseDataExtractionPolicy;
+    
+    float minDistancePointToPath = std::numeric_limits< float >::max();
+    for ( size_type k = cellStart_[ cell ]; k < cellStart_[ cell + 1 ]; ++k ) {
+        size_type const segmentIndex = cellSegments_[ k ];
+        mapping.setDistanceOnPathFlag( segmentStartDistance_[ segmentIndex ] );
+        
+        float segmentDistance = 0.0f;
+        float radius = 0.0f;
+        float distancePointToPath = 0.0f;
+        Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+        Vec3 tangent( 0.0f, 0.0f, 0.0f );
+        
+        BaseDataExtractionPolicy::extract( polyline_, segmentIndex, point, segmentDistance, radius, distancePointToPath, pointOnPathCenterLine, tangent );
+        
+        if ( distancePointToPath < minDistancePointToPath ) {
+            minDistancePointToPath = distancePointToPath;
+            mapping.setPointOnPathCenterLine( pointOnPathCenterLine );
+            mapping.setPointOnPathBoundary( pointOnPathCenterLine + ( ( point - pointOnPathCenterLine ).normalize() * radius ) );
+            mapping.setRadius( radius );
+            mapping.setTangent( tangent );
+            mapping.setSegmentIndex( segmentIndex );
+            mapping.setDistancePointToPath( distancePointToPath );
+            mapping.setDistancePointToPathCenterLine( distancePointToPath + radius );
+            mapping.setDistanceOnPath( mapping.distanceOnPathFlag() + segmentDistance );
+            mapping.setDistanceOnSegment( segmentDistance );
+        }
+    }
+}
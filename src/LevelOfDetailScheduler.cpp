@@ -0,0 +1,241 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the level of detail scheduler.
+ */
+#include "OpenSteer/LevelOfDetailScheduler.h"
+
+// Include std::fill
+#include <algorithm>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::clamp
+#include "OpenSteer/Utilities.h"
+
+
+
+OpenSteer::ObserverDistanceImportanceMetric::ObserverDistanceImportanceMetric( float fullDetailDistance )
+    : observerPosition_( Vec3::zero ), fullDetailDistance_( fullDetailDistance )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ObserverDistanceImportanceMetric::~ObserverDistanceImportanceMetric()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObserverDistanceImportanceMetric::setObserverPosition( Vec3 const& position )
+{
+    observerPosition_ = position;
+}
+
+
+
+OpenSteer::Vec3 const& 
+OpenSteer::ObserverDistanceImportanceMetric::observerPosition() const
+{
+    return observerPosition_;
+}
+
+
+
+void 
+OpenSteer::ObserverDistanceImportanceMetric::setFullDetailDistance( float distance )
+{
+    fullDetailDistance_ = distance;
+}
+
+
+
+float 
+OpenSteer::ObserverDistanceImportanceMetric::fullDetailDistance() const
+{
+    return fullDetailDistance_;
+}
+
+
+
+float 
+OpenSteer::ObserverDistanceImportanceMetric::importance( AbstractVehicle const& vehicle ) const
+{
+    float const distance = Vec3::distance( vehicle.position(), observerPosition_ );
+    
+    if ( distance <= fullDetailDistance_ ) {
+        return 1.0f;
+    }
+    
+    return clamp( fullDetailDistance_ / distance, 0.0f, 1.0f );
+}
+
+
+
+
+OpenSteer::LevelOfDetailScheduler::LevelOfDetailScheduler( size_type levelCount )
+    : metric_( 0 ), 
+      thresholds_( levelCount, 0.0f ), 
+      states_(), 
+      levelPopulation_( levelCount, 0 ), 
+      updatedVehicleCount_( 0 ), 
+      frame_( 0 )
+{
+    assert( 0 < levelCount && "At least one level is needed." );
+    
+    float threshold = 1.0f;
+    for ( size_type level = 0; level + 1 < levelCount; ++level ) {
+        threshold *= 0.5f;
+        thresholds_[ level ] = threshold;
+    }
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailScheduler::setImportanceMetric( AbstractImportanceMetric const* metric )
+{
+    metric_ = metric;
+}
+
+
+
+OpenSteer::AbstractImportanceMetric const* 
+OpenSteer::LevelOfDetailScheduler::importanceMetric() const
+{
+    return metric_;
+}
+
+
+
+OpenSteer::LevelOfDetailScheduler::size_type 
+OpenSteer::LevelOfDetailScheduler::levelCount() const
+{
+    return thresholds_.size();
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailScheduler::setThreshold( size_type level, float minImportance )
+{
+    assert( level < levelCount() && "level out of range." );
+    thresholds_[ level ] = minImportance;
+}
+
+
+
+float 
+OpenSteer::LevelOfDetailScheduler::threshold( size_type level ) const
+{
+    assert( level < levelCount() && "level out of range." );
+    return thresholds_[ level ];
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailScheduler::update( AVGroup const& vehicles, 
+                                           float currentTime, 
+                                           float elapsedTime )
+{
+    if ( states_.size() != vehicles.size() ) {
+        states_.resize( vehicles.size() );
+    }
+    
+    std::fill( levelPopulation_.begin(), levelPopulation_.end(), 0 );
+    updatedVehicleCount_ = 0;
+    
+    for ( size_type i = 0; i < vehicles.size(); ++i ) {
+        VehicleState& state = states_[ i ];
+        state.accumulatedTime += elapsedTime;
+        
+        // Stagger the updates of vehicles on the same level by their index.
+        size_type const interval = size_type( 1 ) << state.level;
+        if ( 0 == ( ( frame_ + i ) % interval ) ) {
+            AbstractVehicle& vehicle = *vehicles[ i ];
+            vehicle.update( currentTime, state.accumulatedTime );
+            state.accumulatedTime = 0.0f;
+            ++updatedVehicleCount_;
+            
+            state.level = ( 0 != metric_ ) ? levelForImportance( metric_->importance( vehicle ) ) : 0;
+        }
+        
+        ++levelPopulation_[ state.level ];
+    }
+    
+    ++frame_;
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailScheduler::reset()
+{
+    states_.clear();
+    std::fill( levelPopulation_.begin(), levelPopulation_.end(), 0 );
+    updatedVehicleCount_ = 0;
+    frame_ = 0;
+}
+
+
+
+OpenSteer::LevelOfDetailScheduler::size_type 
+OpenSteer::LevelOfDetailScheduler::updatedVehicleCount() const
+{
+    return updatedVehicleCount_;
+}
+
+
+
+OpenSteer::LevelOfDetailScheduler::size_type 
+OpenSteer::LevelOfDetailScheduler::vehicleCountOnLevel( size_type level ) const
+{
+    assert( level < levelCount() && "level out of range." );
+    return levelPopulation_[ level ];
+}
+
+
+
+OpenSteer::LevelOfDetailScheduler::size_type 
+OpenSteer::LevelOfDetailScheduler::levelForImportance( float importance ) const
+{
+    size_type const lastLevel = levelCount() - 1;
+    
+    for ( size_type level = 0; level < lastLevel; ++level ) {
+        if ( importance >= thresholds_[ level ] ) {
+            return level;
+        }
+    }
+    
+    return lastLevel;
+}
@@ -0,0 +1,540 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the structure of arrays flock.
+ */
+#include "OpenSteer/Megaflock.h"
+
+// Include std::fill, std::max, std::min
+#include <algorithm>
+
+// Include std::sqrt, std::floor, std::pow
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::clip, OpenSteer::interpolate
+#include "OpenSteer/Utilities.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * The grid has at most this many cells per boid, larger cells are used
+     * for sparse flocks in big worlds.
+     */
+    float const maxCellsPerBoid = 4.0f;
+    
+    
+    /**
+     * Scales @a x, @a y, @a z to unit length unless it's zero (like 
+     * @c Vec3::normalize).
+     */
+    void normalize( float& x, float& y, float& z ) 
+    {
+        float const length = std::sqrt( x * x + y * y + z * z );
+        if ( length > 0.0f ) {
+            x /= length;
+            y /= length;
+            z /= length;
+        }
+    }
+    
+    
+    /**
+     * @c SteerLibraryMixin::inBoidNeighborhood for an @a offset of 
+     * squared length @a distanceSquared.
+     */
+    bool inNeighborhood( float offsetDotForward,
+                         float distanceSquared,
+                         float minDistance,
+                         float maxDistance,
+                         float cosMaxAngle )
+    {
+        if ( distanceSquared < minDistance * minDistance ) {
+            return true;
+        }
+        if ( distanceSquared > maxDistance * maxDistance ) {
+            return false;
+        }
+        return offsetDotForward / std::sqrt( distanceSquared ) > cosMaxAngle;
+    }
+    
+    
+} // anonymous namespace
+
+
+
+OpenSteer::Megaflock::Parameters::Parameters()
+    : separationRadius( 5.0f ), 
+      separationAngle( -0.707f ), 
+      separationWeight( 12.0f ),
+      alignmentRadius( 7.5f ), 
+      alignmentAngle( 0.7f ), 
+      alignmentWeight( 8.0f ),
+      cohesionRadius( 9.0f ), 
+      cohesionAngle( -0.15f ), 
+      cohesionWeight( 8.0f ),
+      maxSpeed( 9.0f ), 
+      maxForce( 27.0f ), 
+      radius( 0.5f ), 
+      worldRadius( 50.0f )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Megaflock::Megaflock( Parameters const& parameters )
+    : parameters_( parameters ), 
+      size_( 0 ), 
+      capacity_( 0 ), 
+      storage_(),
+      cellsPerSide_( 0 ), 
+      cellSize_( 0.0f ),
+      cellOfBoid_(), 
+      cellStart_(), 
+      cellFill_(), 
+      boidInCellOrder_(),
+      neighborCount_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Megaflock::setParameters( Parameters const& parameters )
+{
+    parameters_ = parameters;
+}
+
+
+
+OpenSteer::Megaflock::Parameters const& 
+OpenSteer::Megaflock::parameters() const
+{
+    return parameters_;
+}
+
+
+
+void 
+OpenSteer::Megaflock::reserve( size_type count )
+{
+    if ( count <= capacity_ ) {
+        return;
+    }
+    
+    // move each field of the existing boids to its place in the new block
+    std::vector< float > storage( count * fieldCount );
+    for ( size_type f = 0; f < fieldCount; ++f ) {
+        std::copy( storage_.begin() + f * capacity_, 
+                   storage_.begin() + f * capacity_ + size_, 
+                   storage.begin() + f * count );
+    }
+    storage_.swap( storage );
+    capacity_ = count;
+    
+    cellOfBoid_.resize( count );
+    boidInCellOrder_.resize( count );
+}
+
+
+
+void 
+OpenSteer::Megaflock::spawn( size_type count, float spawnRadius )
+{
+    reserve( std::max( capacity_, size_ + count ) );
+    for ( size_type i = 0; i < count; ++i ) {
+        add( RandomVectorInUnitRadiusSphere() * spawnRadius, 
+             RandomUnitVector(), 
+             parameters_.maxSpeed * 0.3f );
+    }
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::add( Vec3 const& position, Vec3 const& forward, float speed )
+{
+    if ( size_ == capacity_ ) {
+        reserve( std::max( size_type( 64 ), capacity_ * 2 ) );
+    }
+    
+    size_type const index = size_++;
+    field( positionX )[ index ] = position.x;
+    field( positionY )[ index ] = position.y;
+    field( positionZ )[ index ] = position.z;
+    field( forwardX )[ index ] = forward.x;
+    field( forwardY )[ index ] = forward.y;
+    field( forwardZ )[ index ] = forward.z;
+    field( speedField )[ index ] = speed;
+    field( accelerationX )[ index ] = 0.0f;
+    field( accelerationY )[ index ] = 0.0f;
+    field( accelerationZ )[ index ] = 0.0f;
+    return index;
+}
+
+
+
+void 
+OpenSteer::Megaflock::clear()
+{
+    size_ = 0;
+    neighborCount_ = 0;
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::size() const
+{
+    return size_;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::Megaflock::position( size_type index ) const
+{
+    assert( index < size_ && "Boid index out of range." );
+    return Vec3( field( positionX )[ index ], 
+                 field( positionY )[ index ], 
+                 field( positionZ )[ index ] );
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::Megaflock::forward( size_type index ) const
+{
+    assert( index < size_ && "Boid index out of range." );
+    return Vec3( field( forwardX )[ index ], 
+                 field( forwardY )[ index ], 
+                 field( forwardZ )[ index ] );
+}
+
+
+
+float 
+OpenSteer::Megaflock::speed( size_type index ) const
+{
+    assert( index < size_ && "Boid index out of range." );
+    return field( speedField )[ index ];
+}
+
+
+
+void 
+OpenSteer::Megaflock::update( float elapsedTime )
+{
+    buildGrid();
+    
+    // steering only reads the state of other boids, integration only 
+    // touches the boid's own state, so both run in parallel. Boids are 
+    // steered in cell order, consecutive ones scan mostly the same cells.
+    int const count = static_cast< int >( size_ );
+    size_type neighbors = 0;
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(+:neighbors)
+    for ( int i = 0; i < count; ++i ) {
+        neighbors += steer( boidInCellOrder_[ i ] );
+    }
+    neighborCount_ = neighbors;
+    
+    #pragma omp parallel for schedule(static)
+    for ( int i = 0; i < count; ++i ) {
+        integrate( i, elapsedTime );
+    }
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::neighborCount() const
+{
+    return neighborCount_;
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::cellCount() const
+{
+    return cellsPerSide_ * cellsPerSide_ * cellsPerSide_;
+}
+
+
+
+float* 
+OpenSteer::Megaflock::field( Field field )
+{
+    // An empty flock has no storage to point into.
+    if ( storage_.empty() ) {
+        return 0;
+    }
+    return &storage_[ 0 ] + field * capacity_;
+}
+
+
+
+float const* 
+OpenSteer::Megaflock::field( Field field ) const
+{
+    if ( storage_.empty() ) {
+        return 0;
+    }
+    return &storage_[ 0 ] + field * capacity_;
+}
+
+
+
+void 
+OpenSteer::Megaflock::buildGrid()
+{
+    // cells at least as large as the largest behavior radius, so that the
+    // neighbors of a boid are in its own and the 26 adjacent cells
+    float const maxRadius = std::max( parameters_.separationRadius,
+                                      std::max( parameters_.alignmentRadius,
+                                                parameters_.cohesionRadius ) );
+    float const extent = 2.0f * parameters_.worldRadius;
+    float const maxCellsPerSide = std::pow( maxCellsPerBoid * size_ + 1.0f, 1.0f / 3.0f );
+    cellsPerSide_ = static_cast< size_type >( 
+        std::max( 1.0f, std::min( std::floor( extent / maxRadius ), 
+                                  std::floor( maxCellsPerSide ) ) ) );
+    cellSize_ = extent / cellsPerSide_;
+    
+    size_type const cells = cellCount();
+    cellStart_.assign( cells + 1, 0 );
+    
+    // count the boids per cell
+    float const* const x = field( positionX );
+    float const* const y = field( positionY );
+    float const* const z = field( positionZ );
+    for ( size_type i = 0; i < size_; ++i ) {
+        size_type const cell = ( cellCoordinate( z[ i ] ) * cellsPerSide_ + 
+                                 cellCoordinate( y[ i ] ) ) * cellsPerSide_ + 
+                               cellCoordinate( x[ i ] );
+        cellOfBoid_[ i ] = static_cast< unsigned int >( cell );
+        ++cellStart_[ cell + 1 ];
+    }
+    
+    // the boids of cell c are stored from cellStart_[ c ] on
+    for ( size_type c = 0; c < cells; ++c ) {
+        cellStart_[ c + 1 ] += cellStart_[ c ];
+    }
+    
+    // copy positions and headings into cell order
+    cellFill_.assign( cellStart_.begin(), cellStart_.end() - 1 );
+    float const* const fx = field( forwardX );
+    float const* const fy = field( forwardY );
+    float const* const fz = field( forwardZ );
+    float* const cx = field( cellPositionX );
+    float* const cy = field( cellPositionY );
+    float* const cz = field( cellPositionZ );
+    float* const cfx = field( cellForwardX );
+    float* const cfy = field( cellForwardY );
+    float* const cfz = field( cellForwardZ );
+    for ( size_type i = 0; i < size_; ++i ) {
+        unsigned int const slot = cellFill_[ cellOfBoid_[ i ] ]++;
+        boidInCellOrder_[ slot ] = static_cast< unsigned int >( i );
+        cx[ slot ] = x[ i ];
+        cy[ slot ] = y[ i ];
+        cz[ slot ] = z[ i ];
+        cfx[ slot ] = fx[ i ];
+        cfy[ slot ] = fy[ i ];
+        cfz[ slot ] = fz[ i ];
+    }
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::cellCoordinate( float x ) const
+{
+    float const cell = std::floor( ( x + parameters_.worldRadius ) / cellSize_ );
+    if ( cell <= 0.0f ) {
+        return 0;
+    }
+    return std::min( static_cast< size_type >( cell ), cellsPerSide_ - 1 );
+}
+
+
+
+OpenSteer::Megaflock::size_type 
+OpenSteer::Megaflock::steer( size_type index )
+{
+    Parameters const& p = parameters_;
+    float const maxRadius = std::max( p.separationRadius,
+                                      std::max( p.alignmentRadius,
+                                                p.cohesionRadius ) );
+    float const minDistance = p.radius * 3.0f;
+    
+    float const x = field( positionX )[ index ];
+    float const y = field( positionY )[ index ];
+    float const z = field( positionZ )[ index ];
+    float const fx = field( forwardX )[ index ];
+    float const fy = field( forwardY )[ index ];
+    float const fz = field( forwardZ )[ index ];
+    
+    float const* const cx = field( cellPositionX );
+    float const* const cy = field( cellPositionY );
+    float const* const cz = field( cellPositionZ );
+    float const* const cfx = field( cellForwardX );
+    float const* const cfy = field( cellForwardY );
+    float const* const cfz = field( cellForwardZ );
+    
+    float separationX = 0.0f, separationY = 0.0f, separationZ = 0.0f;
+    float alignmentX = 0.0f, alignmentY = 0.0f, alignmentZ = 0.0f;
+    float cohesionX = 0.0f, cohesionY = 0.0f, cohesionZ = 0.0f;
+    size_type alignmentCount = 0;
+    size_type cohesionCount = 0;
+    size_type neighbors = 0;
+    
+    // scan the boid's cell and its neighbors
+    size_type const ix = cellCoordinate( x );
+    size_type const iy = cellCoordinate( y );
+    size_type const iz = cellCoordinate( z );
+    size_type const last = cellsPerSide_ - 1;
+    for ( size_type cz0 = ( iz > 0 ? iz - 1 : 0 ); cz0 <= std::min( iz + 1, last ); ++cz0 ) {
+        for ( size_type cy0 = ( iy > 0 ? iy - 1 : 0 ); cy0 <= std::min( iy + 1, last ); ++cy0 ) {
+            
+            // the cells along x are adjacent in memory, scan them in one go
+            size_type const row = ( cz0 * cellsPerSide_ + cy0 ) * cellsPerSide_;
+            size_type const begin = cellStart_[ row + ( ix > 0 ? ix - 1 : 0 ) ];
+            size_type const end = cellStart_[ row + std::min( ix + 1, last ) + 1 ];
+            for ( size_type j = begin; j < end; ++j ) {
+                float const ox = cx[ j ] - x;
+                float const oy = cy[ j ] - y;
+                float const oz = cz[ j ] - z;
+                float const distanceSquared = ox * ox + oy * oy + oz * oz;
+                if ( distanceSquared > maxRadius * maxRadius || 
+                     boidInCellOrder_[ j ] == index ) {
+                    continue;
+                }
+                ++neighbors;
+                
+                float const forwardness = ox * fx + oy * fy + oz * fz;
+                if ( distanceSquared > 0.0f && 
+                     inNeighborhood( forwardness, distanceSquared, minDistance, 
+                                     p.separationRadius, p.separationAngle ) ) {
+                    // 1/d falloff away from the neighbor
+                    separationX -= ox / distanceSquared;
+                    separationY -= oy / distanceSquared;
+                    separationZ -= oz / distanceSquared;
+                }
+                if ( inNeighborhood( forwardness, distanceSquared, minDistance, 
+                                     p.alignmentRadius, p.alignmentAngle ) ) {
+                    alignmentX += cfx[ j ];
+                    alignmentY += cfy[ j ];
+                    alignmentZ += cfz[ j ];
+                    ++alignmentCount;
+                }
+                if ( inNeighborhood( forwardness, distanceSquared, minDistance, 
+                                     p.cohesionRadius, p.cohesionAngle ) ) {
+                    cohesionX += cx[ j ];
+                    cohesionY += cy[ j ];
+                    cohesionZ += cz[ j ];
+                    ++cohesionCount;
+                }
+            }
+        }
+    }
+    
+    normalize( separationX, separationY, separationZ );
+    if ( alignmentCount > 0 ) {
+        alignmentX = alignmentX / alignmentCount - fx;
+        alignmentY = alignmentY / alignmentCount - fy;
+        alignmentZ = alignmentZ / alignmentCount - fz;
+        normalize( alignmentX, alignmentY, alignmentZ );
+    }
+    if ( cohesionCount > 0 ) {
+        cohesionX = cohesionX / cohesionCount - x;
+        cohesionY = cohesionY / cohesionCount - y;
+        cohesionZ = cohesionZ / cohesionCount - z;
+        normalize( cohesionX, cohesionY, cohesionZ );
+    }
+    
+    field( steeringX )[ index ] = separationX * p.separationWeight + 
+                                  alignmentX * p.alignmentWeight + 
+                                  cohesionX * p.cohesionWeight;
+    field( steeringY )[ index ] = separationY * p.separationWeight + 
+                                  alignmentY * p.alignmentWeight + 
+                                  cohesionY * p.cohesionWeight;
+    field( steeringZ )[ index ] = separationZ * p.separationWeight + 
+                                  alignmentZ * p.alignmentWeight + 
+                                  cohesionZ * p.cohesionWeight;
+    return neighbors;
+}
+
+
+
+void 
+OpenSteer::Megaflock::integrate( size_type index, float elapsedTime )
+{
+    Parameters const& p = parameters_;
+    
+    // clip the steering force, the mass of a boid is 1
+    Vec3 const force = Vec3( field( steeringX )[ index ],
+                             field( steeringY )[ index ],
+                             field( steeringZ )[ index ] ).truncateLength( p.maxForce );
+    
+    // damp out abrupt changes and oscillations in steering acceleration
+    Vec3 acceleration( field( accelerationX )[ index ],
+                       field( accelerationY )[ index ],
+                       field( accelerationZ )[ index ] );
+    if ( elapsedTime > 0.0f ) {
+        float const smoothRate = clip( 9.0f * elapsedTime, 0.15f, 0.4f );
+        acceleration = interpolate( smoothRate, acceleration, force );
+    }
+    
+    // Euler integrate acceleration into velocity and velocity into position
+    Vec3 velocity = forward( index ) * speed( index ) + acceleration * elapsedTime;
+    velocity = velocity.truncateLength( p.maxSpeed );
+    float const newSpeed = velocity.length();
+    Vec3 position = this->position( index ) + velocity * elapsedTime;
+    
+    // wrap around to stay within the world sphere
+    position = position.sphericalWrapAround( Vec3::zero, p.worldRadius );
+    
+    field( positionX )[ index ] = position.x;
+    field( positionY )[ index ] = position.y;
+    field( positionZ )[ index ] = position.z;
+    if ( newSpeed > 0.0f ) {
+        field( forwardX )[ index ] = velocity.x / newSpeed;
+        field( forwardY )[ index ] = velocity.y / newSpeed;
+        field( forwardZ )[ index ] = velocity.z / newSpeed;
+    }
+    field( speedField )[ index ] = newSpeed;
+    field( accelerationX )[ index ] = acceleration.x;
+    field( accelerationY )[ index ] = acceleration.y;
+    field( accelerationZ )[ index ] = acceleration.z;
+}
@@ -0,0 +1,703 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Counters, gauges and histograms updated with atomic operations and their
+ * registry.
+ */
+#include "OpenSteer/Metrics.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::memcpy
+#include <cstring>
+
+// Include std::ostream
+#include <ostream>
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::lower_bound
+#include <algorithm>
+
+// Include std::numeric_limits
+#include <limits>
+
+#if defined( _WIN32 )
+    // Include InterlockedCompareExchange64, InterlockedExchangeAdd, 
+    // InterlockedExchange, Sleep
+    #include <windows.h>
+#else
+    // Include sched_yield
+    #include <sched.h>
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    // Atomic compare and swap of 64 bits, returns the previous value.
+    uint64_t 
+    compareAndSwap( uint64_t volatile& bits, uint64_t expected, uint64_t desired )
+    {
+#if defined( __GNUC__ )
+        return __sync_val_compare_and_swap( &bits, expected, desired );
+#elif defined( _WIN32 )
+        return static_cast< uint64_t >( InterlockedCompareExchange64( reinterpret_cast< LONGLONG volatile* >( &bits ), 
+                                                                      static_cast< LONGLONG >( desired ), 
+                                                                      static_cast< LONGLONG >( expected ) ) );
+#else
+        uint64_t const previous = bits;
+        if ( previous == expected ) {
+            bits = desired;
+        }
+        return previous;
+#endif
+    }
+    
+    
+    void 
+    atomicAdd( size_t& counter, size_t value )
+    {
+        size_t volatile& c = counter;
+#if defined( __GNUC__ )
+        __sync_fetch_and_add( &c, value );
+#elif defined( _WIN32 ) && defined( _WIN64 )
+        InterlockedExchangeAdd64( reinterpret_cast< LONGLONG volatile* >( &c ), static_cast< LONGLONG >( value ) );
+#elif defined( _WIN32 )
+        InterlockedExchangeAdd( reinterpret_cast< LONG volatile* >( &c ), static_cast< LONG >( value ) );
+#else
+        c += value;
+#endif
+    }
+    
+    
+    size_t 
+    atomicLoad( size_t const& counter )
+    {
+        size_t const volatile& c = counter;
+        return c;
+    }
+    
+    
+    uint64_t 
+    bitsOf( double value )
+    {
+        uint64_t bits = 0;
+        std::memcpy( &bits, &value, sizeof( bits ) );
+        return bits;
+    }
+    
+    
+    double 
+    valueOf( uint64_t bits )
+    {
+        double value = 0.0;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        return value;
+    }
+    
+    
+    // Sample values as Prometheus expects them: NaN, +Inf, -Inf or a 
+    // floating point number.
+    void 
+    writeValue( std::ostream& out, double value )
+    {
+        if ( value != value ) {
+            out << "NaN";
+        } else if ( value > std::numeric_limits< double >::max() ) {
+            out << "+Inf";
+        } else if ( value < -std::numeric_limits< double >::max() ) {
+            out << "-Inf";
+        } else {
+            std::ostringstream number;
+            number.precision( 15 );
+            number << value;
+            out << number.str();
+        }
+    }
+    
+    
+    // HELP text with backslashes and line feeds escaped.
+    void 
+    writeHelp( std::ostream& out, std::string const& help )
+    {
+        for ( std::string::const_iterator c = help.begin(); c != help.end(); ++c ) {
+            if ( '\\' == *c ) {
+                out << "\\\\";
+            } else if ( '\n' == *c ) {
+                out << "\\n";
+            } else {
+                out << *c;
+            }
+        }
+    }
+    
+    
+    char const* 
+    typeName( Metric::Type type )
+    {
+        switch ( type ) {
+            case Metric::counterType: return "counter";
+            case Metric::gaugeType: return "gauge";
+            case Metric::histogramType: return "histogram";
+        }
+        return "untyped";
+    }
+    
+    
+    bool 
+    isLetter( char c )
+    {
+        return ( 'a' <= c && c <= 'z' ) || ( 'A' <= c && c <= 'Z' ) || '_' == c || ':' == c;
+    }
+    
+    
+    bool 
+    isDigit( char c )
+    {
+        return '0' <= c && c <= '9';
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::AtomicDouble::AtomicDouble( double value )
+    : bits_( bitsOf( value ) )
+{
+    // Nothing to do.
+}
+
+
+
+double 
+OpenSteer::AtomicDouble::load() const
+{
+    // A compare and swap which never changes the value reads all 64 bits
+    // at once, also on 32 bit processors.
+    return valueOf( compareAndSwap( bits_, 0, 0 ) );
+}
+
+
+
+void 
+OpenSteer::AtomicDouble::store( double value )
+{
+    uint64_t const desired = bitsOf( value );
+    uint64_t expected = compareAndSwap( bits_, 0, 0 );
+    uint64_t previous = 0;
+    while ( ( previous = compareAndSwap( bits_, expected, desired ) ) != expected ) {
+        expected = previous;
+    }
+}
+
+
+
+void 
+OpenSteer::AtomicDouble::add( double amount )
+{
+    uint64_t expected = compareAndSwap( bits_, 0, 0 );
+    uint64_t previous = 0;
+    while ( ( previous = compareAndSwap( bits_, expected, bitsOf( valueOf( expected ) + amount ) ) ) != expected ) {
+        expected = previous;
+    }
+}
+
+
+
+
+OpenSteer::Metric::Metric( std::string const& name, std::string const& help, Type type )
+    : name_( name ), help_( help ), type_( type )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Metric::~Metric()
+{
+    // Nothing to do.
+}
+
+
+
+std::string const& 
+OpenSteer::Metric::name() const
+{
+    return name_;
+}
+
+
+
+std::string const& 
+OpenSteer::Metric::help() const
+{
+    return help_;
+}
+
+
+
+OpenSteer::Metric::Type 
+OpenSteer::Metric::type() const
+{
+    return type_;
+}
+
+
+
+bool 
+OpenSteer::Metric::validName( std::string const& name )
+{
+    if ( name.empty() || ! isLetter( name[ 0 ] ) ) {
+        return false;
+    }
+    
+    for ( std::string::size_type i = 1; i < name.size(); ++i ) {
+        if ( ! isLetter( name[ i ] ) && ! isDigit( name[ i ] ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+void 
+OpenSteer::Metric::writeHeader( std::ostream& out ) const
+{
+    out << "# HELP " << name_ << ' ';
+    writeHelp( out, help_ );
+    out << '\n' << "# TYPE " << name_ << ' ' << typeName( type_ ) << '\n';
+}
+
+
+
+
+OpenSteer::Counter::Counter( std::string const& name, std::string const& help )
+    : Metric( name, help, counterType ), value_( 0.0 )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Counter::increment( double amount )
+{
+    assert( amount >= 0.0 && "Counters only grow." );
+    value_.add( amount );
+}
+
+
+
+double 
+OpenSteer::Counter::value() const
+{
+    return value_.load();
+}
+
+
+
+void 
+OpenSteer::Counter::write( std::ostream& out ) const
+{
+    writeHeader( out );
+    out << name() << ' ';
+    writeValue( out, value() );
+    out << '\n';
+}
+
+
+
+
+OpenSteer::Gauge::Gauge( std::string const& name, std::string const& help )
+    : Metric( name, help, gaugeType ), value_( 0.0 )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Gauge::set( double value )
+{
+    value_.store( value );
+}
+
+
+
+void 
+OpenSteer::Gauge::add( double amount )
+{
+    value_.add( amount );
+}
+
+
+
+double 
+OpenSteer::Gauge::value() const
+{
+    return value_.load();
+}
+
+
+
+void 
+OpenSteer::Gauge::write( std::ostream& out ) const
+{
+    writeHeader( out );
+    out << name() << ' ';
+    writeValue( out, value() );
+    out << '\n';
+}
+
+
+
+
+OpenSteer::Histogram::Histogram( std::string const& name, 
+                                 std::string const& help, 
+                                 std::vector< double > const& upperBounds )
+    : Metric( name, help, histogramType ), 
+      upperBounds_( upperBounds ), 
+      counts_( upperBounds.size() + 1, 0 ), 
+      sum_( 0.0 )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Histogram::observe( double value )
+{
+    atomicAdd( counts_[ bucketOf( value ) ], 1 );
+    sum_.add( value );
+}
+
+
+
+OpenSteer::Histogram::size_type 
+OpenSteer::Histogram::count() const
+{
+    size_type total = 0;
+    for ( size_type i = 0; i < counts_.size(); ++i ) {
+        total += atomicLoad( counts_[ i ] );
+    }
+    return total;
+}
+
+
+
+double 
+OpenSteer::Histogram::sum() const
+{
+    return sum_.load();
+}
+
+
+
+std::vector< double > const& 
+OpenSteer::Histogram::upperBounds() const
+{
+    return upperBounds_;
+}
+
+
+
+OpenSteer::Histogram::size_type 
+OpenSteer::Histogram::bucketCount( size_type index ) const
+{
+    return atomicLoad( counts_[ index ] );
+}
+
+
+
+void 
+OpenSteer::Histogram::write( std::ostream& out ) const
+{
+    writeHeader( out );
+    
+    // buckets are exported cumulative, _count is the +Inf bucket
+    size_type cumulative = 0;
+    for ( size_type i = 0; i < counts_.size(); ++i ) {
+        cumulative += atomicLoad( counts_[ i ] );
+        out << name() << "_bucket{le=\"";
+        if ( i < upperBounds_.size() ) {
+            writeValue( out, upperBounds_[ i ] );
+        } else {
+            out << "+Inf";
+        }
+        out << "\"} " << cumulative << '\n';
+    }
+    out << name() << "_sum ";
+    writeValue( out, sum() );
+    out << '\n' << name() << "_count " << cumulative << '\n';
+}
+
+
+
+OpenSteer::Histogram::size_type 
+OpenSteer::Histogram::bucketOf( double value ) const
+{
+    // first bound not less than value
+    return static_cast< size_type >( std::lower_bound( upperBounds_.begin(), upperBounds_.end(), value ) - upperBounds_.begin() );
+}
+
+
+
+
+OpenSteer::Histogram::Batch::Batch( Histogram& histogram )
+    : histogram_( histogram ), 
+      counts_( histogram.counts_.size(), 0 ), 
+      sum_( 0.0 ), 
+      empty_( true )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Histogram::Batch::~Batch()
+{
+    flush();
+}
+
+
+
+void 
+OpenSteer::Histogram::Batch::observe( double value )
+{
+    ++counts_[ histogram_.bucketOf( value ) ];
+    sum_ += value;
+    empty_ = false;
+}
+
+
+
+void 
+OpenSteer::Histogram::Batch::flush()
+{
+    if ( empty_ ) {
+        return;
+    }
+    
+    for ( size_type i = 0; i < counts_.size(); ++i ) {
+        if ( 0 != counts_[ i ] ) {
+            atomicAdd( histogram_.counts_[ i ], counts_[ i ] );
+            counts_[ i ] = 0;
+        }
+    }
+    histogram_.sum_.add( sum_ );
+    sum_ = 0.0;
+    empty_ = true;
+}
+
+
+
+
+/**
+ * Spin lock around registration and writing out, both rare and short.
+ */
+class OpenSteer::MetricsRegistry::Lock {
+public:
+    explicit Lock( int volatile& lock ) 
+        : lock_( lock ) 
+    {
+#if defined( __GNUC__ )
+        while ( __sync_lock_test_and_set( &lock_, 1 ) ) {
+            sched_yield();
+        }
+#elif defined( _WIN32 )
+        while ( InterlockedExchange( reinterpret_cast< LONG volatile* >( &lock_ ), 1 ) ) {
+            Sleep( 0 );
+        }
+#else
+        lock_ = 1;
+#endif
+    }
+    
+    ~Lock() 
+    {
+#if defined( __GNUC__ )
+        __sync_lock_release( &lock_ );
+#elif defined( _WIN32 )
+        InterlockedExchange( reinterpret_cast< LONG volatile* >( &lock_ ), 0 );
+#else
+        lock_ = 0;
+#endif
+    }
+    
+private:
+    Lock( Lock const& );
+    Lock& operator=( Lock const& );
+    
+    int volatile& lock_;
+}; // class Lock
+
+
+
+OpenSteer::MetricsRegistry::MetricsRegistry()
+    : metrics_(), unexported_(), lock_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MetricsRegistry::~MetricsRegistry()
+{
+    for ( size_type i = 0; i < metrics_.size(); ++i ) {
+        delete metrics_[ i ];
+    }
+    for ( size_type i = 0; i < unexported_.size(); ++i ) {
+        delete unexported_[ i ];
+    }
+}
+
+
+
+OpenSteer::MetricsRegistry& 
+OpenSteer::MetricsRegistry::global()
+{
+    // created on first use so that metrics can be registered from static
+    // constructors, never destroyed so that they can be updated from 
+    // static destructors
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+
+
+OpenSteer::Counter& 
+OpenSteer::MetricsRegistry::counter( std::string const& name, std::string const& help )
+{
+    Lock lock( lock_ );
+    Metric* metric = find( name );
+    if ( 0 != metric && Metric::counterType == metric->type() ) {
+        return static_cast< Counter& >( *metric );
+    }
+    
+    Counter* counter = new Counter( name, help );
+    add( counter );
+    return *counter;
+}
+
+
+
+OpenSteer::Gauge& 
+OpenSteer::MetricsRegistry::gauge( std::string const& name, std::string const& help )
+{
+    Lock lock( lock_ );
+    Metric* metric = find( name );
+    if ( 0 != metric && Metric::gaugeType == metric->type() ) {
+        return static_cast< Gauge& >( *metric );
+    }
+    
+    Gauge* gauge = new Gauge( name, help );
+    add( gauge );
+    return *gauge;
+}
+
+
+
+OpenSteer::Histogram& 
+OpenSteer::MetricsRegistry::histogram( std::string const& name, 
+                                       std::string const& help, 
+                                       std::vector< double > const& upperBounds )
+{
+    Lock lock( lock_ );
+    Metric* metric = find( name );
+    if ( 0 != metric && Metric::histogramType == metric->type() ) {
+        return static_cast< Histogram& >( *metric );
+    }
+    
+    Histogram* histogram = new Histogram( name, help, upperBounds );
+    add( histogram );
+    return *histogram;
+}
+
+
+
+OpenSteer::MetricsRegistry::size_type 
+OpenSteer::MetricsRegistry::size() const
+{
+    Lock lock( lock_ );
+    return metrics_.size();
+}
+
+
+
+void 
+OpenSteer::MetricsRegistry::write( std::ostream& out ) const
+{
+    Lock lock( lock_ );
+    for ( size_type i = 0; i < metrics_.size(); ++i ) {
+        metrics_[ i ]->write( out );
+    }
+}
+
+
+
+std::string 
+OpenSteer::MetricsRegistry::text() const
+{
+    std::ostringstream out;
+    write( out );
+    return out.str();
+}
+
+
+
+OpenSteer::Metric* 
+OpenSteer::MetricsRegistry::find( std::string const& name ) const
+{
+    for ( size_type i = 0; i < metrics_.size(); ++i ) {
+        if ( metrics_[ i ]->name() == name ) {
+            return metrics_[ i ];
+        }
+    }
+    return 0;
+}
+
+
+
+void 
+OpenSteer::MetricsRegistry::add( Metric* metric )
+{
+    bool const exported = Metric::validName( metric->name() ) && 0 == find( metric->name() );
+    assert( exported && "Metric name invalid or registered with another type." );
+    
+    if ( exported ) {
+        metrics_.push_back( metric );
+    } else {
+        unexported_.push_back( metric );
+    }
+}
@@ -0,0 +1,442 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Background thread serving metrics over HTTP and writing them to a file.
+ */
+#include "OpenSteer/MetricsExporter.h"
+
+// Include std::rename, std::remove, std::fopen, std::fwrite, std::fclose
+#include <cstdio>
+
+// Include std::strerror
+#include <cstring>
+
+// Include errno
+#include <cerrno>
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include OpenSteer::Stopwatch
+#include "OpenSteer/Stopwatch.h"
+
+// Include OpenSteer::AllocationCounter
+#include "OpenSteer/AllocationCounter.h"
+
+#if ! defined( _WIN32 )
+    // Include pthread_create, pthread_join
+    #include <pthread.h>
+
+    // Include socket, bind, listen, accept, recv, send, setsockopt
+    #include <sys/socket.h>
+
+    // Include sockaddr_in, htons, ntohs
+    #include <netinet/in.h>
+
+    // Include inet_pton
+    #include <arpa/inet.h>
+
+    // Include poll
+    #include <poll.h>
+
+    // Include timeval
+    #include <sys/time.h>
+
+    // Include close
+    #include <unistd.h>
+#endif
+
+
+
+namespace {
+    
+    // How often the background thread looks for a stop request while it 
+    // waits for connections.
+    int const pollMilliseconds = 100;
+    
+    // Longest request read, the rest is ignored.
+    std::string::size_type const maxRequestSize = 4096;
+    
+#if ! defined( _WIN32 )
+    
+    // Sends all of text, returns false if the peer went away.
+    bool 
+    sendAll( int connection, std::string const& text )
+    {
+#if defined( MSG_NOSIGNAL )
+        int const flags = MSG_NOSIGNAL;
+#else
+        int const flags = 0;
+#endif
+        std::string::size_type sent = 0;
+        while ( sent < text.size() ) {
+            ssize_t const n = send( connection, text.data() + sent, text.size() - sent, flags );
+            if ( n <= 0 ) {
+                return false;
+            }
+            sent += static_cast< std::string::size_type >( n );
+        }
+        return true;
+    }
+    
+    
+    std::string 
+    response( char const* status, std::string const& body )
+    {
+        std::ostringstream out;
+        out << "HTTP/1.0 " << status << "\r\n"
+            << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n"
+            << "\r\n"
+            << body;
+        return out.str();
+    }
+    
+#endif
+    
+} // anonymous namespace
+
+
+
+#if ! defined( _WIN32 )
+struct OpenSteer::MetricsExporter::Thread {
+    pthread_t thread;
+};
+#else
+struct OpenSteer::MetricsExporter::Thread {
+};
+#endif
+
+
+
+OpenSteer::MetricsExporter::MetricsExporter( MetricsRegistry& registry )
+    : registry_( registry ), 
+      socket_( -1 ), 
+      port_( -1 ), 
+      fileName_(), 
+      interval_( 0.0 ), 
+      stopping_( false ), 
+      thread_( 0 ), 
+      errorMessage_()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MetricsExporter::~MetricsExporter()
+{
+    stop();
+    closeSocket();
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::listen( int port, std::string const& address )
+{
+#if ! defined( _WIN32 )
+    if ( running() ) {
+        return fail( "can't listen while running" );
+    }
+    closeSocket();
+    
+    sockaddr_in socketAddress;
+    std::memset( &socketAddress, 0, sizeof( socketAddress ) );
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_port = htons( static_cast< unsigned short >( port ) );
+    if ( inet_pton( AF_INET, address.c_str(), &socketAddress.sin_addr ) != 1 ) {
+        return fail( "not an IPv4 address: " + address );
+    }
+    
+    socket_ = socket( AF_INET, SOCK_STREAM, 0 );
+    if ( socket_ < 0 ) {
+        return fail( std::string( "can't open socket: " ) + std::strerror( errno ) );
+    }
+    
+    int const reuse = 1;
+    setsockopt( socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+    
+    socklen_t length = sizeof( socketAddress );
+    if ( bind( socket_, reinterpret_cast< sockaddr* >( &socketAddress ), sizeof( socketAddress ) ) != 0 ||
+         ::listen( socket_, 8 ) != 0 ||
+         getsockname( socket_, reinterpret_cast< sockaddr* >( &socketAddress ), &length ) != 0 ) {
+        std::ostringstream message;
+        message << "can't listen on " << address << " port " << port << ": " << std::strerror( errno );
+        closeSocket();
+        return fail( message.str() );
+    }
+    
+    port_ = ntohs( socketAddress.sin_port );
+    return true;
+#else
+    (void) port;
+    (void) address;
+    return fail( "serving metrics isn't supported on this platform" );
+#endif
+}
+
+
+
+int 
+OpenSteer::MetricsExporter::port() const
+{
+    return port_;
+}
+
+
+
+void 
+OpenSteer::MetricsExporter::dumpTo( std::string const& fileName, double intervalSeconds )
+{
+    fileName_ = fileName;
+    interval_ = intervalSeconds;
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::dump()
+{
+    if ( running() ) {
+        return fail( "the metrics thread writes the file while it runs" );
+    }
+    
+    std::string message;
+    return writeFile( message ) || fail( message );
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::start()
+{
+    if ( running() ) {
+        return true;
+    }
+    if ( socket_ < 0 && fileName_.empty() ) {
+        return fail( "nothing to export to: no port and no file" );
+    }
+    
+#if ! defined( _WIN32 )
+    stopping_ = false;
+    thread_ = new Thread;
+    if ( pthread_create( &thread_->thread, 0, run, this ) != 0 ) {
+        delete thread_;
+        thread_ = 0;
+        return fail( "can't start the metrics thread" );
+    }
+    return true;
+#else
+    return fail( "background threads aren't supported on this platform" );
+#endif
+}
+
+
+
+void 
+OpenSteer::MetricsExporter::stop()
+{
+#if ! defined( _WIN32 )
+    if ( ! running() ) {
+        return;
+    }
+    
+    stopping_ = true;
+    pthread_join( thread_->thread, 0 );
+    delete thread_;
+    thread_ = 0;
+#endif
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::running() const
+{
+    return 0 != thread_;
+}
+
+
+
+std::string const& 
+OpenSteer::MetricsExporter::errorMessage() const
+{
+    return errorMessage_;
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::fail( std::string const& message )
+{
+    errorMessage_ = message;
+    return false;
+}
+
+
+
+bool 
+OpenSteer::MetricsExporter::writeFile( std::string& errorMessage ) const
+{
+    if ( fileName_.empty() ) {
+        errorMessage = "no file to write metrics to";
+        return false;
+    }
+    
+    std::string const text = registry_.text();
+    std::string const temporary = fileName_ + ".tmp";
+    std::FILE* file = std::fopen( temporary.c_str(), "wb" );
+    if ( 0 == file ) {
+        errorMessage = "can't write " + temporary + ": " + std::strerror( errno );
+        return false;
+    }
+    bool const written = std::fwrite( text.data(), 1, text.size(), file ) == text.size();
+    if ( std::fclose( file ) != 0 || ! written ) {
+        errorMessage = "can't write " + temporary;
+        std::remove( temporary.c_str() );
+        return false;
+    }
+    
+#if defined( _WIN32 )
+    // rename doesn't replace files on Windows
+    std::remove( fileName_.c_str() );
+#endif
+    if ( std::rename( temporary.c_str(), fileName_.c_str() ) != 0 ) {
+        errorMessage = "can't rename " + temporary + " to " + fileName_ + ": " + std::strerror( errno );
+        std::remove( temporary.c_str() );
+        return false;
+    }
+    return true;
+}
+
+
+
+void 
+OpenSteer::MetricsExporter::closeSocket()
+{
+#if ! defined( _WIN32 )
+    if ( socket_ >= 0 ) {
+        close( socket_ );
+    }
+#endif
+    socket_ = -1;
+    port_ = -1;
+}
+
+
+
+void* 
+OpenSteer::MetricsExporter::run( void* exporter )
+{
+    // Keep the exporter's allocations out of the counts of the simulation
+    // it runs next to.
+    AllocationCounter::UncountedScope uncounted;
+    static_cast< MetricsExporter* >( exporter )->serve();
+    return 0;
+}
+
+
+
+void 
+OpenSteer::MetricsExporter::serve()
+{
+#if ! defined( _WIN32 )
+    std::string ignored;
+    double nextDump = Stopwatch::now() + interval_;
+    
+    while ( ! stopping_ ) {
+        pollfd listening;
+        listening.fd = socket_;
+        listening.events = POLLIN;
+        listening.revents = 0;
+        
+        // without a socket this only waits
+        int const ready = poll( &listening, socket_ >= 0 ? 1 : 0, pollMilliseconds );
+        if ( ready > 0 && ( listening.revents & POLLIN ) ) {
+            int const connection = accept( socket_, 0, 0 );
+            if ( connection >= 0 ) {
+                answer( connection );
+                close( connection );
+            }
+        }
+        
+        if ( ! fileName_.empty() && Stopwatch::now() >= nextDump ) {
+            // a failed dump is tried again at the next interval
+            writeFile( ignored );
+            nextDump = Stopwatch::now() + interval_;
+        }
+    }
+    
+    if ( ! fileName_.empty() ) {
+        writeFile( ignored );
+    }
+#endif
+}
+
+
+
+void 
+OpenSteer::MetricsExporter::answer( int connection ) const
+{
+#if ! defined( _WIN32 )
+    // a slow client mustn't stall the thread for long
+    timeval timeout;
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt( connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+    setsockopt( connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ) );
+    
+    // read up to the end of the request header
+    std::string request;
+    char buffer[ 512 ];
+    while ( request.find( "\r\n\r\n" ) == std::string::npos && request.size() < maxRequestSize ) {
+        ssize_t const n = recv( connection, buffer, sizeof( buffer ), 0 );
+        if ( n <= 0 ) {
+            break;
+        }
+        request.append( buffer, static_cast< std::string::size_type >( n ) );
+    }
+    
+    std::string const line = request.substr( 0, request.find( "\r\n" ) );
+    std::istringstream words( line );
+    std::string method;
+    std::string path;
+    words >> method >> path;
+    
+    if ( method != "GET" ) {
+        sendAll( connection, response( "405 Method Not Allowed", "only GET is supported\n" ) );
+    } else if ( path != "/metrics" && path != "/" ) {
+        sendAll( connection, response( "404 Not Found", "metrics are at /metrics\n" ) );
+    } else {
+        sendAll( connection, response( "200 OK", registry_.text() ) );
+    }
+#else
+    (void) connection;
+#endif
+}
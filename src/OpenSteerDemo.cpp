@@ -45,8 +45,19 @@
 #include "OpenSteer/Annotation.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/Stopwatch.h"
+#include "OpenSteer/AllocationCounter.h"
+#include "OpenSteer/PerformanceBaseline.h"
+#include "OpenSteer/GoldenTrajectory.h"
+#include "OpenSteer/SimulationHash.h"
+#include "OpenSteer/ZoneProfiler.h"
+#include "OpenSteer/Metrics.h"
+#include "OpenSteer/FlightRecorder.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <set>
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -76,6 +87,13 @@ OpenSteer::Clock OpenSteer::OpenSteerDemo::clock;
 OpenSteer::Camera OpenSteer::OpenSteerDemo::camera;
 
 
+// ----------------------------------------------------------------------------
+// frame budget lowers simulation fidelity while frames take too long
+
+
+OpenSteer::FrameBudget OpenSteer::OpenSteerDemo::frameBudget;
+
+
 // ----------------------------------------------------------------------------
 // currently selected plug-in (user can choose or cycle through them)
 
@@ -106,6 +124,29 @@ int OpenSteer::OpenSteerDemo::phase = OpenSteer::OpenSteerDemo::overheadPhase;
 bool OpenSteer::enableAnnotation = true;
 
 
+namespace {
+
+    // turns annotation off for the lifetime of the object if the frame
+    // budget skips annotation in this frame, the user's switch is left as
+    // it was afterwards
+    class AnnotationDecimation
+    {
+    public:
+        AnnotationDecimation (const bool annotate)
+            : userSetting (OpenSteer::enableAnnotation)
+        {
+            if (! annotate) OpenSteer::enableAnnotation = false;
+        }
+
+        ~AnnotationDecimation () {OpenSteer::enableAnnotation = userSetting;}
+
+    private:
+        const bool userSetting;
+    };
+
+} // anonymous namespace
+
+
 // ----------------------------------------------------------------------------
 // XXX apparently MS VC6 cannot handle initialized static const members,
 // XXX so they have to be initialized not-inline.
@@ -123,6 +164,211 @@ namespace {
 
     void printPlugIn (OpenSteer::PlugIn& pi) {std::cout << " " << pi << std::endl;} // XXX
 
+
+    // metrics of the selected PlugIn's updates and of the clock, exported
+    // by the global MetricsRegistry (registered when a PlugIn is opened,
+    // updated with atomic operations only)
+    struct DemoMetrics
+    {
+        DemoMetrics (OpenSteer::MetricsRegistry& registry)
+            : frames (registry.counter ("opensteer_frames_total",
+                                        "Simulation updates of the selected PlugIn.")),
+              frameSeconds (registry.histogram ("opensteer_frame_seconds",
+                                                "Wall time of simulation updates.",
+                                                frameTimeBounds ())),
+              agents (registry.gauge ("opensteer_agents",
+                                      "Vehicles of the selected PlugIn.")),
+              smoothedFPS (registry.gauge ("opensteer_smoothed_fps",
+                                           "Running average of the frame rate.")),
+              smoothedUsage (registry.gauge ("opensteer_smoothed_usage_percent",
+                                             "Running average of the non-wait share of fixed rate frames."))
+        {}
+
+        // from 1 ms to a second, the 60 and 30 Hz budgets are bounds
+        static std::vector<double> frameTimeBounds (void)
+        {
+            const double bounds[] = {0.001, 0.002, 0.004, 0.008, 1.0 / 60,
+                                     1.0 / 30, 0.066, 0.125, 0.25, 0.5, 1};
+            return std::vector<double> (bounds,
+                                        bounds + sizeof (bounds) / sizeof (bounds[0]));
+        }
+
+        OpenSteer::Counter& frames;
+        OpenSteer::Histogram& frameSeconds;
+        OpenSteer::Gauge& agents;
+        OpenSteer::Gauge& smoothedFPS;
+        OpenSteer::Gauge& smoothedUsage;
+    };
+
+
+    DemoMetrics& demoMetrics (void)
+    {
+        static DemoMetrics metrics (OpenSteer::MetricsRegistry::global ());
+        return metrics;
+    }
+
+    // split a "name=value" option at the first '=' (value may be empty)
+    void splitOption (const std::string& option,
+                      std::string& name,
+                      std::string& value)
+    {
+        const std::string::size_type equals = option.find ('=');
+        name = option.substr (0, equals);
+        value = ((equals == std::string::npos) ?
+                 std::string () :
+                 option.substr (equals + 1));
+    }
+
+
+    // the names of "name=value" options
+    std::set<std::string> optionNames (const std::vector<std::string>& options)
+    {
+        std::set<std::string> names;
+        for (size_t i = 0; i < options.size(); i++)
+        {
+            std::string name, value;
+            splitOption (options[i], name, value);
+            names.insert (name);
+        }
+        return names;
+    }
+
+
+    // pass "name=value" options on to a PlugIn before it is opened,
+    // returns false after reporting the first one it does not know
+    bool applyOptions (OpenSteer::PlugIn& pi,
+                       const std::vector<std::string>& options)
+    {
+        for (size_t i = 0; i < options.size(); i++)
+        {
+            std::string name, value;
+            splitOption (options[i], name, value);
+            if (!pi.setOption (name.c_str (), value.c_str ()))
+            {
+                std::cerr << pi << " does not know option \"" << options[i]
+                          << "\"" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    // timing and heap allocations of the updates of a headless run
+    struct RunMeasurement
+    {
+        double seconds;              // wall time of all updates
+        double slowestFrame;         // frame times in seconds
+        double p50;
+        double p95;
+        double p99;
+        double allocationsPerFrame;
+        double bytesPerFrame;
+        size_t steadyStateAllocations;  // from steadyStateFrame on
+        int firstAllocatingFrame;       // in steady state, -1 if none
+    };
+
+
+    // value below which fraction p of the ascending times lie (nearest rank)
+    double percentile (const std::vector<double>& sorted, const double p)
+    {
+        if (sorted.empty ()) return 0;
+        const size_t rank = (size_t) std::ceil (p * sorted.size ());
+        return sorted[std::min (std::max (rank, (size_t) 1), sorted.size ()) - 1];
+    }
+
+
+    // open the selected PlugIn and step it with a fixed frame time, timing
+    // each update and counting the allocations of all updates and of the
+    // updates from steadyStateFrame on (the frame times are stored in a
+    // vector reserved beforehand so that collecting them doesn't show up
+    // in the count)
+    RunMeasurement measureRun (const int frameCount,
+                               const float elapsedTime,
+                               const int steadyStateFrame)
+    {
+        using namespace OpenSteer;
+
+        std::vector<double> frameTimes;
+        frameTimes.reserve (std::max (frameCount, 1));
+
+        OpenSteerDemo::openSelectedPlugIn ();
+
+        const AllocationCounter::size_type allocations =
+            AllocationCounter::allocationCount ();
+        const AllocationCounter::size_type bytes =
+            AllocationCounter::allocatedBytes ();
+
+        RunMeasurement m;
+        m.steadyStateAllocations = 0;
+        m.firstAllocatingFrame = -1;
+
+        float currentTime = 0;
+        const Stopwatch run;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            const AllocationCounter::size_type frameAllocations =
+                AllocationCounter::allocationCount ();
+            const double frameStart = Stopwatch::now ();
+            OpenSteerDemo::updateSelectedPlugIn (currentTime, elapsedTime);
+            frameTimes.push_back (Stopwatch::now () - frameStart);
+            currentTime += elapsedTime;
+
+            const AllocationCounter::size_type allocated =
+                AllocationCounter::allocationCount () - frameAllocations;
+            if ((frame >= steadyStateFrame) && (allocated > 0))
+            {
+                if (m.firstAllocatingFrame < 0) m.firstAllocatingFrame = frame;
+                m.steadyStateAllocations += allocated;
+            }
+        }
+
+        m.seconds = run.elapsedSeconds ();
+
+        const double frames = std::max (frameCount, 1);
+        m.allocationsPerFrame =
+            (AllocationCounter::allocationCount () - allocations) / frames;
+        m.bytesPerFrame =
+            (AllocationCounter::allocatedBytes () - bytes) / frames;
+
+        std::sort (frameTimes.begin (), frameTimes.end ());
+        m.slowestFrame = frameTimes.empty () ? 0 : frameTimes.back ();
+        m.p50 = percentile (frameTimes, 0.50);
+        m.p95 = percentile (frameTimes, 0.95);
+        m.p99 = percentile (frameTimes, 0.99);
+        return m;
+    }
+
+
+    // open the selected PlugIn with the random generator seeded, step it
+    // with a fixed frame time and close it, recording the states of all
+    // vehicles and their digest after each frame
+    void recordRun (const int frameCount,
+                    const float elapsedTime,
+                    const unsigned int seed,
+                    OpenSteer::GoldenTrajectory& trajectory,
+                    std::vector<OpenSteer::SimulationHash::digest_type>& digests)
+    {
+        using namespace OpenSteer;
+
+        std::srand (seed);
+        OpenSteerDemo::openSelectedPlugIn ();
+
+        float currentTime = 0;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            OpenSteerDemo::updateSelectedPlugIn (currentTime, elapsedTime);
+            currentTime += elapsedTime;
+
+            const AVGroup& vehicles = OpenSteerDemo::allVehiclesOfSelectedPlugIn ();
+            digests.push_back (SimulationHash::digest (vehicles));
+            for (size_t i = 0; i < vehicles.size (); i++)
+                trajectory.record (frame, i, *vehicles[i]);
+        }
+
+        OpenSteerDemo::closeSelectedPlugIn ();
+    }
+
 } // anonymous namespace
 
 void 
@@ -170,6 +416,10 @@ OpenSteer::OpenSteerDemo::updateSimulationAndRedraw (void)
     updateSelectedPlugIn (clock.getTotalSimulationTime (),
                           clock.getElapsedSimulationTime ());
 
+    // export what the clock shows on screen
+    demoMetrics().smoothedFPS.set (clock.getSmoothedFPS ());
+    demoMetrics().smoothedUsage.set (clock.getSmoothedUsage ());
+
     // redraw selected PlugIn (based on real time)
     redrawSelectedPlugIn (clock.getTotalRealTime (),
                           clock.getElapsedRealTime ());
@@ -198,6 +448,462 @@ OpenSteer::OpenSteerDemo::exit (int exitCode)
 }
 
 
+// ----------------------------------------------------------------------------
+// run a PlugIn without graphics, for benchmarks and batch runs
+
+
+int 
+OpenSteer::OpenSteerDemo::runHeadless (const char* plugInName,
+                                       const int frameCount,
+                                       const float elapsedTime,
+                                       const std::vector<std::string>& options,
+                                       const int steadyStateFrame)
+{
+    // find the requested PlugIn
+    PlugIn* pi = PlugIn::findByName (plugInName);
+    if (pi == NULL)
+    {
+        std::cerr << "unknown PlugIn \"" << plugInName << "\", known plugins:"
+                  << std::endl;
+        PlugIn::applyToAll (printPlugIn);
+        return EXIT_FAILURE;
+    }
+
+    if (!applyOptions (*pi, options)) return EXIT_FAILURE;
+
+    // nothing is drawn, so don't collect annotation either
+    setAnnotationOff ();
+
+    selectedPlugIn = pi;
+    const RunMeasurement m = measureRun (frameCount, elapsedTime, steadyStateFrame);
+
+    // report
+    const size_t vehicleCount = allVehiclesOfSelectedPlugIn ().size ();
+    const double frames = std::max (frameCount, 1);
+    std::cout << "plugin:              " << pi->name () << std::endl
+              << "frames:              " << frameCount << std::endl
+              << "frame time (s):      " << elapsedTime << std::endl
+              << "vehicles:            " << vehicleCount << std::endl
+              << "wall time (s):       " << m.seconds << std::endl
+              << "mean frame (ms):     " << 1000 * m.seconds / frames << std::endl
+              << "p50 frame (ms):      " << 1000 * m.p50 << std::endl
+              << "p95 frame (ms):      " << 1000 * m.p95 << std::endl
+              << "p99 frame (ms):      " << 1000 * m.p99 << std::endl
+              << "slowest frame (ms):  " << 1000 * m.slowestFrame << std::endl
+              << "frames/s:            " << frames / m.seconds << std::endl
+              << "vehicle updates/s:   " << (vehicleCount * frames) / m.seconds
+              << std::endl
+              << "allocations/frame:   " << m.allocationsPerFrame << std::endl
+              << "bytes/frame:         " << m.bytesPerFrame << std::endl
+              << "state digest:        " << std::hex
+              << SimulationHash::digest (allVehiclesOfSelectedPlugIn ())
+              << std::dec << std::endl;
+    if (ZoneProfiler::active ())
+        ZoneProfiler::report (std::cout, frameCount, vehicleCount);
+    pi->printStatistics (std::cout);
+    const bool passed = pi->passedChecks (std::cout);
+    closeSelectedPlugIn ();
+    if (!passed)
+    {
+        std::cout << "FAILED: checks of PlugIn " << pi->name () << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // updates must not allocate once the simulation is in its steady state
+    if (steadyStateFrame < frameCount)
+    {
+        if (m.firstAllocatingFrame < 0)
+        {
+            std::cout << "no allocations from frame " << steadyStateFrame
+                      << " on" << std::endl;
+            return EXIT_SUCCESS;
+        }
+        std::cout << "FAILED: " << m.steadyStateAllocations
+                  << " allocations from frame " << steadyStateFrame
+                  << " on, the first in frame " << m.firstAllocatingFrame
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+
+// ----------------------------------------------------------------------------
+// run a PlugIn twice, with reference and with optimized options, and
+// compare the vehicle states frame by frame
+
+
+int 
+OpenSteer::OpenSteerDemo::runComparison (const char* plugInName,
+                                         const int frameCount,
+                                         const float elapsedTime,
+                                         const std::vector<std::string>& options,
+                                         const std::vector<std::string>& referenceOptions,
+                                         const std::vector<std::string>& optimizedOptions,
+                                         const float tolerance,
+                                         const unsigned int seed)
+{
+    // find the requested PlugIn
+    PlugIn* pi = PlugIn::findByName (plugInName);
+    if (pi == NULL)
+    {
+        std::cerr << "unknown PlugIn \"" << plugInName << "\", known plugins:"
+                  << std::endl;
+        PlugIn::applyToAll (printPlugIn);
+        return EXIT_FAILURE;
+    }
+    if (!applyOptions (*pi, options)) return EXIT_FAILURE;
+
+    // both runs use the one PlugIn instance, so an option only set for the
+    // reference run would stay set for the optimized one
+    if (optionNames (referenceOptions) != optionNames (optimizedOptions))
+    {
+        std::cerr << "--reference and --optimized must set the same options"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // nothing is drawn, so don't collect annotation either
+    setAnnotationOff ();
+    selectedPlugIn = pi;
+
+    // the reference run, then the optimized one seeded alike
+    GoldenTrajectory reference, optimized;
+    std::vector<SimulationHash::digest_type> referenceDigests, optimizedDigests;
+    if (!applyOptions (*pi, referenceOptions)) return EXIT_FAILURE;
+    recordRun (frameCount, elapsedTime, seed, reference, referenceDigests);
+    if (!applyOptions (*pi, optimizedOptions)) return EXIT_FAILURE;
+    recordRun (frameCount, elapsedTime, seed, optimized, optimizedDigests);
+
+    // the first frame whose states aren't bitwise identical
+    size_t firstDifferentFrame = 0;
+    while ((firstDifferentFrame < referenceDigests.size ()) &&
+           (referenceDigests[firstDifferentFrame] ==
+            optimizedDigests[firstDifferentFrame]))
+        firstDifferentFrame++;
+
+    const GoldenTrajectory::Comparison comparison =
+        optimized.compare (reference, tolerance);
+
+    std::cout << "plugin:              " << pi->name () << std::endl
+              << "frames:              " << frameCount << std::endl
+              << "vehicle states:      " << reference.size () << std::endl
+              << "tolerance:           " << tolerance << std::endl
+              << "identical states:    ";
+    if (firstDifferentFrame == referenceDigests.size ())
+        std::cout << "all frames" << std::endl;
+    else
+        std::cout << "until frame " << firstDifferentFrame << std::endl;
+
+    std::cout << "max deviation:       " << comparison.maxDeviation << std::endl;
+    if (comparison.match)
+    {
+        std::cout << "no divergence beyond the tolerance" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // report the first diverging frame and agent
+    if (comparison.firstMismatch < std::min (reference.size (), optimized.size ()))
+    {
+        const GoldenTrajectory::Sample& r = reference.sample (comparison.firstMismatch);
+        const GoldenTrajectory::Sample& o = optimized.sample (comparison.firstMismatch);
+        std::cout << "DIVERGED at frame " << r.step << ", vehicle " << r.vehicle
+                  << std::endl
+                  << "    reference position " << r.position
+                  << " speed " << r.speed << std::endl
+                  << "    optimized position " << o.position
+                  << " speed " << o.speed << std::endl;
+    }
+    std::cout << "DIVERGED: " << comparison.message << std::endl;
+    return EXIT_FAILURE;
+}
+
+
+
+// ----------------------------------------------------------------------------
+// run many independent worlds of a PlugIn side by side
+
+
+int 
+OpenSteer::OpenSteerDemo::runBatch (const char* plugInName,
+                                    const int frameCount,
+                                    const float elapsedTime,
+                                    const std::vector<std::string>& options,
+                                    const std::vector<std::string>& sweeps,
+                                    const int replicaCount)
+{
+    // find the requested PlugIn
+    PlugIn* pi = PlugIn::findByName (plugInName);
+    if (pi == NULL)
+    {
+        std::cerr << "unknown PlugIn \"" << plugInName << "\", known plugins:"
+                  << std::endl;
+        PlugIn::applyToAll (printPlugIn);
+        return EXIT_FAILURE;
+    }
+
+    // expand the sweeps into one list of options per world: each sweep
+    // "name=v1,v2" multiplies the lists made so far by its values
+    std::vector<std::vector<std::string> > worldOptions (1, options);
+    for (size_t i = 0; i < sweeps.size(); i++)
+    {
+        std::string name, values;
+        splitOption (sweeps[i], name, values);
+        std::vector<std::vector<std::string> > expanded;
+        std::string::size_type begin = 0;
+        while (begin <= values.size())
+        {
+            std::string::size_type end = values.find (',', begin);
+            if (end == std::string::npos) end = values.size();
+            const std::string option = name + "=" + values.substr (begin, end - begin);
+            for (size_t w = 0; w < worldOptions.size(); w++)
+            {
+                expanded.push_back (worldOptions[w]);
+                expanded.back().push_back (option);
+            }
+            begin = end + 1;
+        }
+        worldOptions.swap (expanded);
+    }
+
+    // nothing is drawn, so don't collect annotation either (annotation
+    // goes to buffers shared by all worlds)
+    setAnnotationOff ();
+
+    // make and open the worlds one at a time
+    std::vector<AbstractWorld*> worlds;
+    std::vector<std::string> descriptions;
+    size_t openedCount = 0;
+    int status = EXIT_SUCCESS;
+    for (size_t w = 0; (w < worldOptions.size()) && (status == EXIT_SUCCESS); w++)
+    {
+        for (int replica = 0; replica < replicaCount; replica++)
+        {
+            AbstractWorld* world = pi->makeWorld ();
+            if (world == NULL)
+            {
+                std::cerr << *pi << " does not support batch runs" << std::endl;
+                status = EXIT_FAILURE;
+                break;
+            }
+            worlds.push_back (world);
+
+            std::ostringstream description;
+            for (size_t i = 0; i < worldOptions[w].size(); i++)
+            {
+                std::string name, value;
+                splitOption (worldOptions[w][i], name, value);
+                if (!world->setOption (name.c_str (), value.c_str ()))
+                {
+                    std::cerr << *pi << " does not know option \""
+                              << worldOptions[w][i] << "\"" << std::endl;
+                    status = EXIT_FAILURE;
+                }
+                description << " " << worldOptions[w][i];
+            }
+            descriptions.push_back (description.str ());
+            if (status != EXIT_SUCCESS) break;
+
+            world->open ();
+            openedCount++;
+        }
+    }
+
+    // step every world for all of its frames, worlds are distributed over
+    // the available cores as they finish
+    const int worldCount = (status == EXIT_SUCCESS) ? (int) worlds.size() : 0;
+    std::vector<double> worldSeconds (worldCount, 0);
+    const Stopwatch run;
+    #pragma omp parallel for schedule(dynamic)
+    for (int w = 0; w < worldCount; w++)
+    {
+        const Stopwatch stopwatch;
+        float currentTime = 0;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            worlds[w]->update (currentTime, elapsedTime);
+            currentTime += elapsedTime;
+        }
+        worldSeconds[w] = stopwatch.elapsedSeconds ();
+    }
+    const double seconds = run.elapsedSeconds ();
+
+    // report totals, then timing and statistics of each world
+    if (status == EXIT_SUCCESS)
+    {
+        size_t vehicleCount = 0;
+        for (int w = 0; w < worldCount; w++)
+            vehicleCount += worlds[w]->allVehicles ().size ();
+        const double frames = std::max (frameCount, 1);
+        std::cout << "plugin:              " << pi->name () << std::endl
+                  << "worlds:              " << worldCount << std::endl
+                  << "frames:              " << frameCount << std::endl
+                  << "frame time (s):      " << elapsedTime << std::endl
+                  << "vehicles:            " << vehicleCount << std::endl
+                  << "wall time (s):       " << seconds << std::endl
+                  << "world frames/s:      " << (worldCount * frames) / seconds
+                  << std::endl
+                  << "vehicle updates/s:   " << (vehicleCount * frames) / seconds
+                  << std::endl;
+
+        for (int w = 0; w < worldCount; w++)
+        {
+            std::cout << "world " << w << ":" << descriptions[w] << std::endl
+                      << "    wall time (s):       " << worldSeconds[w]
+                      << std::endl;
+
+            // indent the PlugIn's statistics below the world
+            std::ostringstream statistics;
+            worlds[w]->printStatistics (statistics);
+            std::istringstream lines (statistics.str ());
+            std::string line;
+            while (std::getline (lines, line))
+                std::cout << "    " << line << std::endl;
+        }
+    }
+
+    // close and delete the worlds one at a time
+    for (size_t w = 0; w < worlds.size(); w++)
+    {
+        if (w < openedCount) worlds[w]->close ();
+        delete worlds[w];
+    }
+    return status;
+}
+
+
+// ----------------------------------------------------------------------------
+// run the scenarios of a performance baseline and compare against it, or
+// record them with their metrics as the baseline of this machine
+//
+// Each scenario is run once to warm up caches and the allocator, then
+// "repetitions" times with the random generator seeded alike.  Metrics are
+// the median over the repetitions, their spread the scaled median absolute
+// deviation (see PerformanceBaseline).
+
+
+int 
+OpenSteer::OpenSteerDemo::runRegression (const char* baselineFileName,
+                                         const int repetitions,
+                                         const char* recordFileName)
+{
+    const bool record = (recordFileName != NULL);
+    PerformanceBaseline baseline;
+    if (!baseline.load (baselineFileName))
+    {
+        std::cerr << baseline.errorMessage () << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (repetitions > 0) baseline.setRepetitions (repetitions);
+
+    // nothing is drawn, so don't collect annotation either
+    setAnnotationOff ();
+
+    const float elapsedTime = 1.0f / 60.0f;
+    int failures = 0;
+    const std::vector<PerformanceBaseline::Scenario>& scenarios =
+        baseline.scenarios ();
+    for (size_t i = 0; i < scenarios.size(); i++)
+    {
+        const PerformanceBaseline::Scenario& scenario = scenarios[i];
+        std::cout << "scenario " << scenario.name << " (" << scenario.frames
+                  << " frames of " << scenario.plugIn << ")" << std::endl;
+
+        PlugIn* pi = PlugIn::findByName (scenario.plugIn.c_str ());
+        if (pi == NULL)
+        {
+            std::cout << "    FAILED: unknown PlugIn" << std::endl;
+            failures++;
+            continue;
+        }
+        if (!applyOptions (*pi, scenario.options))
+        {
+            std::cout << "    FAILED: unknown option" << std::endl;
+            failures++;
+            continue;
+        }
+        if (!record && scenario.metrics.empty ())
+        {
+            std::cout << "    FAILED: no metrics recorded, record a baseline"
+                      << " of this machine with --record file" << std::endl;
+            failures++;
+            continue;
+        }
+        selectedPlugIn = pi;
+
+        std::vector<double> p50, p95, p99, allocations;
+        for (int r = -1; r < baseline.repetitions (); r++)
+        {
+            std::srand (scenario.seed);
+            const RunMeasurement m = measureRun (scenario.frames, elapsedTime,
+                                                 scenario.frames);
+            closeSelectedPlugIn ();
+            if (r < 0) continue;
+
+            p50.push_back (1000 * m.p50);
+            p95.push_back (1000 * m.p95);
+            p99.push_back (1000 * m.p99);
+            allocations.push_back (m.allocationsPerFrame);
+        }
+
+        std::vector<PerformanceBaseline::Metric> metrics;
+        metrics.push_back (PerformanceBaseline::summarize ("p50_ms", p50));
+        metrics.push_back (PerformanceBaseline::summarize ("p95_ms", p95));
+        metrics.push_back (PerformanceBaseline::summarize ("p99_ms", p99));
+        metrics.push_back (PerformanceBaseline::summarize ("allocations",
+                                                           allocations));
+
+        if (record)
+        {
+            baseline.setMetrics (i, metrics);
+            for (size_t j = 0; j < metrics.size(); j++)
+                std::cout << "    " << std::left << std::setw (12)
+                          << metrics[j].name << std::right
+                          << " " << std::setw (10) << metrics[j].value
+                          << " +- " << metrics[j].spread << std::endl;
+            continue;
+        }
+
+        const std::vector<PerformanceBaseline::Check> checks =
+            baseline.check (i, metrics);
+        for (size_t j = 0; j < checks.size(); j++)
+        {
+            const PerformanceBaseline::Check& c = checks[j];
+            std::cout << "    " << std::left << std::setw (12) << c.name
+                      << std::right
+                      << " baseline " << std::setw (10) << c.baseline
+                      << " measured " << std::setw (10) << c.measured
+                      << " limit " << std::setw (10) << c.limit << "  "
+                      << (c.regression ? "REGRESSION" :
+                          (c.improvement ? "improved" : "ok"))
+                      << std::endl;
+            if (c.regression) failures++;
+        }
+    }
+
+    if (record)
+    {
+        if (!baseline.save (recordFileName))
+        {
+            std::cerr << "can't write baseline " << recordFileName
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "recorded " << recordFileName << std::endl;
+        return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (failures == 0)
+    {
+        std::cout << "no regressions" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    std::cout << "FAILED: " << failures << " regressions or failed scenarios"
+              << std::endl;
+    return EXIT_FAILURE;
+}
+
+
 // ----------------------------------------------------------------------------
 // select the default PlugIn
 
@@ -253,7 +959,9 @@ void
 OpenSteer::OpenSteerDemo::openSelectedPlugIn (void)
 {
     camera.reset ();
+    frameBudget.reset ();
     selectedVehicle = NULL;
+    demoMetrics ();
     selectedPlugIn->open ();
 }
 
@@ -279,8 +987,31 @@ OpenSteer::OpenSteerDemo::updateSelectedPlugIn (const float currentTime,
         if (vehicles.size() > 0) selectedVehicle = vehicles.front();
     }
 
+    // decide on the fidelity of this frame from the cost of the last one
+    frameBudget.beginFrame ();
+    const AnnotationDecimation decimation (frameBudget.annotateFrame ());
+
     // invoke selected PlugIn's Update method
+    FlightRecorder::beginFrame ();
+    const double start = Stopwatch::now ();
     selectedPlugIn->update (currentTime, elapsedTime);
+    const double seconds = Stopwatch::now () - start;
+    frameBudget.addPhaseSeconds (FrameBudget::updatePhase, (float) seconds);
+
+    // dump what the agents did if the update was too slow
+    if (FlightRecorder::endFrame (seconds))
+    {
+        std::ostringstream message;
+        message << "slow update (" << seconds * 1000 << " ms), "
+                << "flight record written to "
+                << FlightRecorder::lastDumpFile () << std::ends;
+        printMessage (message);
+    }
+
+    DemoMetrics& metrics = demoMetrics ();
+    metrics.frameSeconds.observe (seconds);
+    metrics.frames.increment ();
+    metrics.agents.set ((double) allVehiclesOfSelectedPlugIn().size());
 
     // return to previous phase
     popPhase ();
@@ -297,6 +1028,8 @@ OpenSteer::OpenSteerDemo::redrawSelectedPlugIn (const float currentTime,
 {
     // switch to Draw phase
     pushPhase (drawPhase);
+    const double start = Stopwatch::now ();
+    const AnnotationDecimation decimation (frameBudget.annotateFrame ());
 
     // invoke selected PlugIn's Draw method
     selectedPlugIn->redraw (currentTime, elapsedTime);
@@ -305,6 +1038,9 @@ OpenSteer::OpenSteerDemo::redrawSelectedPlugIn (const float currentTime,
     drawAllDeferredLines ();
     drawAllDeferredCirclesOrDisks ();
 
+    const double seconds = Stopwatch::now () - start;
+    frameBudget.addPhaseSeconds (FrameBudget::drawPhase, (float) seconds);
+
     // return to previous phase
     popPhase ();
 }
@@ -736,6 +1472,7 @@ OpenSteer::OpenSteerDemo::keyboardMiniHelp (void)
     printMessage ("  f      select next preset frame rate");
     printMessage ("  Tab    select next PlugIn.");
     printMessage ("  a      toggle annotation on/off.");
+    printMessage ("  d      dump the flight record.");
     printMessage ("  Space  toggle between Run and Pause.");
     printMessage ("  ->     step forward one frame.");
     printMessage ("  Esc    exit.");
@@ -759,6 +1496,19 @@ bool updatePhaseActive = false;
 bool drawPhaseActive = false;
 }
 
+namespace {
+
+    // the profiler zone of the current phase, zoneCount for overhead
+    OpenSteer::ZoneProfiler::Zone zoneOfPhase (void)
+    {
+        using namespace OpenSteer;
+        if (OpenSteerDemo::phaseIsUpdate ()) return ZoneProfiler::update;
+        if (OpenSteerDemo::phaseIsDraw ()) return ZoneProfiler::draw;
+        return ZoneProfiler::zoneCount;
+    }
+
+} // anonymous namespace
+
 void 
 OpenSteer::OpenSteerDemo::pushPhase (const int newPhase)
 {
@@ -774,6 +1524,10 @@ OpenSteer::OpenSteerDemo::pushPhase (const int newPhase)
     // set new phase
     phase = newPhase;
 
+    // the profiler zones follow the phases
+    if (ZoneProfiler::active () && (zoneOfPhase () != ZoneProfiler::zoneCount))
+        ZoneProfiler::enter (zoneOfPhase ());
+
     // check for stack overflow
     if (phaseStackIndex >= phaseStackSize) errorExit ("phaseStack overflow");
 }
@@ -785,6 +1539,9 @@ OpenSteer::OpenSteerDemo::popPhase (void)
     // update timer for current (old) phase: add in time since last switch
     updatePhaseTimers ();
 
+    if (ZoneProfiler::active () && (zoneOfPhase () != ZoneProfiler::zoneCount))
+        ZoneProfiler::leave (zoneOfPhase ());
+
     // restore old phase
     phase = phaseStack[--phaseStackIndex];
     updatePhaseActive = phase == OpenSteer::OpenSteerDemo::updatePhase;
@@ -1308,6 +2065,20 @@ namespace {
                                                     "annotation ON" : "annotation OFF");
             break;
 
+        // write the recent work of all agents to a file
+        case 'd':
+            {
+                std::string errorMessage;
+                if (OpenSteer::FlightRecorder::dumpNow (errorMessage))
+                    message << "flight record written to "
+                            << OpenSteer::FlightRecorder::lastDumpFile ();
+                else
+                    message << errorMessage;
+                message << std::ends;
+                OpenSteer::OpenSteerDemo::printMessage (message);
+            }
+            break;
+
         // toggle run/pause state
         case space:
             OpenSteer::OpenSteerDemo::printMessage (OpenSteer::OpenSteerDemo::clock.togglePausedState () ?
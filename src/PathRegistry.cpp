@@ -0,0 +1,140 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the registry of shared pathways.
+ */
+#include "OpenSteer/PathRegistry.h"
+
+
+
+namespace {
+    
+    /**
+     * Returns @c true if @a path was made from @a numOfPoints @a points,
+     * radius @a r and @a closeCycle.
+     */
+    bool madeFrom( OpenSteer::IndexedPathway const& path,
+                   OpenSteer::IndexedPathway::size_type numOfPoints,
+                   OpenSteer::Vec3 const points[],
+                   float r,
+                   bool closeCycle )
+    {
+        // A cyclic path repeats its first point at the end.
+        OpenSteer::IndexedPathway::size_type const pointCount = numOfPoints + ( closeCycle ? 1 : 0 );
+        if ( ( path.isCyclic() != closeCycle ) || 
+             ( path.radius() != r ) || 
+             ( path.pointCount() != pointCount ) ) {
+            return false;
+        }
+        
+        for ( OpenSteer::IndexedPathway::size_type i = 0; i < numOfPoints; ++i ) {
+            if ( path.point( i ) != points[ i ] ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PathRegistry::PathRegistry()
+    : paths_()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathRegistry::~PathRegistry()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathRegistry::PathPointer 
+OpenSteer::PathRegistry::find( std::string const& name ) const
+{
+    PathMap::const_iterator const entry = paths_.find( name );
+    if ( entry == paths_.end() ) {
+        return PathPointer();
+    }
+    return entry->second;
+}
+
+
+
+OpenSteer::PathRegistry::PathPointer 
+OpenSteer::PathRegistry::acquire( std::string const& name,
+                                  IndexedPathway::size_type numOfPoints,
+                                  Vec3 const points[],
+                                  float r,
+                                  bool closeCycle )
+{
+    PathPointer& path = paths_[ name ];
+    if ( ( ! path ) || ( ! madeFrom( *path, numOfPoints, points, r, closeCycle ) ) ) {
+        path.reset( new IndexedPathway( numOfPoints, points, r, closeCycle ) );
+    }
+    return path;
+}
+
+
+
+OpenSteer::PathRegistry::size_type 
+OpenSteer::PathRegistry::removeUnused()
+{
+    size_type removed = 0;
+    PathMap::iterator entry = paths_.begin();
+    while ( entry != paths_.end() ) {
+        if ( entry->second.useCount() == 1 ) {
+            paths_.erase( entry++ );
+            ++removed;
+        } else {
+            ++entry;
+        }
+    }
+    return removed;
+}
+
+
+
+OpenSteer::PathRegistry::size_type 
+OpenSteer::PathRegistry::size() const
+{
+    return paths_.size();
+}
+
+
+
+OpenSteer::PathRegistry& 
+OpenSteer::PathRegistry::shared()
+{
+    static PathRegistry registry;
+    return registry;
+}
@@ -0,0 +1,402 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of checking, reading and writing performance baselines.
+ */
+#include "OpenSteer/PerformanceBaseline.h"
+
+// Include std::ifstream, std::ofstream
+#include <fstream>
+
+// Include std::istream, std::ostream
+#include <istream>
+#include <ostream>
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include std::nth_element
+#include <algorithm>
+
+// Include std::fabs
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Median of @a values, reorders them.
+     */
+    double 
+    median( std::vector< double >& values )
+    {
+        assert( ! values.empty() && "no values" );
+        
+        std::vector< double >::iterator const middle = values.begin() + values.size() / 2;
+        std::nth_element( values.begin(), middle, values.end() );
+        double const upper = *middle;
+        if ( values.size() % 2 ) {
+            return upper;
+        }
+        
+        double const lower = *std::max_element( values.begin(), middle );
+        return 0.5 * ( lower + upper );
+    }
+    
+    
+    /**
+     * Reads the rest of the line after the keyword, @c false if it is empty.
+     */
+    bool 
+    readRestOfLine( std::istream& in, std::string& value )
+    {
+        std::getline( in >> std::ws, value );
+        while ( ! value.empty() && ( ' ' == value[ value.size() - 1 ] || '\r' == value[ value.size() - 1 ] ) ) {
+            value.erase( value.size() - 1 );
+        }
+        return ! in.fail() && ! value.empty();
+    }
+    
+    
+    /**
+     * Scales the median absolute deviation to an estimate of the standard
+     * deviation of normally distributed values.
+     */
+    double const madToStandardDeviation = 1.4826;
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PerformanceBaseline::PerformanceBaseline()
+    : tolerance_( 0.15 ), spreadFactor_( 3.0 ), repetitions_( 5 ), 
+      scenarios_(), errorMessage_()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::clear()
+{
+    tolerance_ = 0.15;
+    spreadFactor_ = 3.0;
+    repetitions_ = 5;
+    scenarios_.clear();
+}
+
+
+
+double 
+OpenSteer::PerformanceBaseline::tolerance() const
+{
+    return tolerance_;
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::setTolerance( double tolerance )
+{
+    assert( tolerance >= 0.0 && "tolerance must not be negative" );
+    tolerance_ = tolerance;
+}
+
+
+
+double 
+OpenSteer::PerformanceBaseline::spreadFactor() const
+{
+    return spreadFactor_;
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::setSpreadFactor( double factor )
+{
+    assert( factor >= 0.0 && "spread factor must not be negative" );
+    spreadFactor_ = factor;
+}
+
+
+
+int 
+OpenSteer::PerformanceBaseline::repetitions() const
+{
+    return repetitions_;
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::setRepetitions( int repetitions )
+{
+    assert( repetitions > 0 && "at least one repetition needed" );
+    repetitions_ = repetitions;
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::addScenario( Scenario const& scenario )
+{
+    scenarios_.push_back( scenario );
+}
+
+
+
+std::vector< OpenSteer::PerformanceBaseline::Scenario > const& 
+OpenSteer::PerformanceBaseline::scenarios() const
+{
+    return scenarios_;
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::setMetrics( size_type index, 
+                                            std::vector< Metric > const& metrics )
+{
+    assert( index < scenarios_.size() && "index out of range" );
+    scenarios_[ index ].metrics = metrics;
+}
+
+
+
+std::vector< OpenSteer::PerformanceBaseline::Check > 
+OpenSteer::PerformanceBaseline::check( size_type index, 
+                                       std::vector< Metric > const& measured ) const
+{
+    assert( index < scenarios_.size() && "index out of range" );
+    std::vector< Metric > const& metrics = scenarios_[ index ].metrics;
+    
+    std::vector< Check > checks;
+    for ( size_type i = 0; i < measured.size(); ++i ) {
+        Check check = { measured[ i ].name, 0.0, measured[ i ].value, 
+                        std::numeric_limits< double >::max(), false, false };
+        
+        for ( size_type j = 0; j < metrics.size(); ++j ) {
+            if ( metrics[ j ].name == measured[ i ].name ) {
+                double const slack = spreadFactor_ * metrics[ j ].spread;
+                check.baseline = metrics[ j ].value;
+                check.limit = metrics[ j ].value * ( 1.0 + tolerance_ ) + slack;
+                check.regression = check.measured > check.limit;
+                check.improvement = check.measured < metrics[ j ].value * ( 1.0 - tolerance_ ) - slack;
+                break;
+            }
+        }
+        checks.push_back( check );
+    }
+    return checks;
+}
+
+
+
+bool 
+OpenSteer::PerformanceBaseline::load( std::string const& fileName )
+{
+    std::ifstream in( fileName.c_str() );
+    if ( ! in ) {
+        return fail( "can't open baseline file " + fileName );
+    }
+    
+    if ( ! read( in ) ) {
+        errorMessage_ = fileName + ": " + errorMessage_;
+        return false;
+    }
+    return true;
+}
+
+
+
+bool 
+OpenSteer::PerformanceBaseline::save( std::string const& fileName ) const
+{
+    std::ofstream out( fileName.c_str(), std::ios::out | std::ios::trunc );
+    write( out );
+    return out.good();
+}
+
+
+
+bool 
+OpenSteer::PerformanceBaseline::read( std::istream& in )
+{
+    clear();
+    errorMessage_.clear();
+    
+    Scenario scenario;
+    bool inScenario = false;
+    
+    std::string keyword;
+    while ( in >> keyword ) {
+        if ( '#' == keyword[ 0 ] ) {
+            in.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+        } else if ( "tolerance" == keyword ) {
+            in >> tolerance_;
+            if ( in.fail() || tolerance_ < 0.0 ) {
+                return fail( "malformed tolerance" );
+            }
+        } else if ( "spreadFactor" == keyword ) {
+            in >> spreadFactor_;
+            if ( in.fail() || spreadFactor_ < 0.0 ) {
+                return fail( "malformed spreadFactor" );
+            }
+        } else if ( "repetitions" == keyword ) {
+            in >> repetitions_;
+            if ( in.fail() || repetitions_ < 1 ) {
+                return fail( "malformed repetitions" );
+            }
+        } else if ( "scenario" == keyword ) {
+            if ( inScenario ) {
+                return fail( "scenario " + scenario.name + " lacks end" );
+            }
+            scenario = Scenario();
+            scenario.frames = 0;
+            scenario.seed = 1;
+            if ( ! readRestOfLine( in, scenario.name ) ) {
+                return fail( "malformed scenario" );
+            }
+            inScenario = true;
+        } else if ( ! inScenario ) {
+            return fail( keyword + " outside of a scenario" );
+        } else if ( "plugin" == keyword ) {
+            if ( ! readRestOfLine( in, scenario.plugIn ) ) {
+                return fail( "malformed plugin of scenario " + scenario.name );
+            }
+        } else if ( "frames" == keyword ) {
+            in >> scenario.frames;
+            if ( in.fail() || scenario.frames < 1 ) {
+                return fail( "malformed frames of scenario " + scenario.name );
+            }
+        } else if ( "seed" == keyword ) {
+            in >> scenario.seed;
+            if ( in.fail() ) {
+                return fail( "malformed seed of scenario " + scenario.name );
+            }
+        } else if ( "option" == keyword ) {
+            std::string option;
+            if ( ! readRestOfLine( in, option ) || std::string::npos == option.find( '=' ) ) {
+                return fail( "malformed option of scenario " + scenario.name );
+            }
+            scenario.options.push_back( option );
+        } else if ( "metric" == keyword ) {
+            Metric metric;
+            in >> metric.name >> metric.value >> metric.spread;
+            if ( in.fail() || metric.spread < 0.0 ) {
+                return fail( "malformed metric of scenario " + scenario.name );
+            }
+            scenario.metrics.push_back( metric );
+        } else if ( "end" == keyword ) {
+            if ( scenario.plugIn.empty() || scenario.frames < 1 ) {
+                return fail( "scenario " + scenario.name + " lacks plugin or frames" );
+            }
+            scenarios_.push_back( scenario );
+            inScenario = false;
+        } else {
+            return fail( "unknown record " + keyword );
+        }
+    }
+    
+    if ( inScenario ) {
+        return fail( "scenario " + scenario.name + " lacks end" );
+    }
+    return in.eof() ? true : fail( "unreadable input" );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaseline::write( std::ostream& out ) const
+{
+    std::streamsize const precision = out.precision( 6 );
+    
+    out << "tolerance " << tolerance_ << '\n'
+        << "spreadFactor " << spreadFactor_ << '\n'
+        << "repetitions " << repetitions_ << '\n';
+    
+    for ( size_type i = 0; i < scenarios_.size(); ++i ) {
+        Scenario const& s = scenarios_[ i ];
+        out << '\n'
+            << "scenario " << s.name << '\n'
+            << "plugin " << s.plugIn << '\n'
+            << "frames " << s.frames << '\n'
+            << "seed " << s.seed << '\n';
+        for ( size_type j = 0; j < s.options.size(); ++j ) {
+            out << "option " << s.options[ j ] << '\n';
+        }
+        for ( size_type j = 0; j < s.metrics.size(); ++j ) {
+            out << "metric " << s.metrics[ j ].name << ' ' 
+                << s.metrics[ j ].value << ' ' << s.metrics[ j ].spread << '\n';
+        }
+        out << "end" << '\n';
+    }
+    
+    out.precision( precision );
+}
+
+
+
+std::string const& 
+OpenSteer::PerformanceBaseline::errorMessage() const
+{
+    return errorMessage_;
+}
+
+
+
+OpenSteer::PerformanceBaseline::Metric 
+OpenSteer::PerformanceBaseline::summarize( std::string const& name, 
+                                           std::vector< double > values )
+{
+    Metric metric;
+    metric.name = name;
+    metric.value = median( values );
+    for ( size_type i = 0; i < values.size(); ++i ) {
+        values[ i ] = std::fabs( values[ i ] - metric.value );
+    }
+    metric.spread = madToStandardDeviation * median( values );
+    return metric;
+}
+
+
+
+bool 
+OpenSteer::PerformanceBaseline::fail( std::string const& message )
+{
+    clear();
+    errorMessage_ = message;
+    return false;
+}
@@ -0,0 +1,257 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of reading hardware performance counters.
+ */
+#include "OpenSteer/PerformanceCounters.h"
+
+// Include std::strerror, std::memset
+#include <cstring>
+
+// Include assert
+#include <cassert>
+
+#if defined( __linux__ )
+    // Include perf_event_attr, PERF_* constants
+    #include <linux/perf_event.h>
+
+    // Include syscall, __NR_perf_event_open
+    #include <sys/syscall.h>
+
+    // Include read, close
+    #include <unistd.h>
+
+    // Include ioctl
+    #include <sys/ioctl.h>
+
+    // Include errno
+    #include <cerrno>
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+#if defined( __linux__ )
+    
+    /**
+     * Type and configuration of each counter.
+     */
+    struct Event {
+        unsigned int type;
+        unsigned long config;
+    };
+    
+    Event const events[ PerformanceCounters::counterCount ] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | 
+                              ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | 
+                              ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES } };
+    
+    
+    /**
+     * Opens a counter of the calling thread on any processor as member of
+     * the group of @a leader (or as leader if @c -1), returns its file 
+     * descriptor or @c -1.
+     */
+    int 
+    openEvent( Event const& event, int leader )
+    {
+        perf_event_attr attributes;
+        std::memset( &attributes, 0, sizeof( attributes ) );
+        attributes.size = sizeof( attributes );
+        attributes.type = event.type;
+        attributes.config = event.config;
+        attributes.disabled = ( -1 == leader ) ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+        
+        return static_cast< int >( syscall( __NR_perf_event_open, &attributes, 0, -1, leader, 0 ) );
+    }
+    
+#endif
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PerformanceCounters::PerformanceCounters()
+    : leader_( -1 ), availableCount_( 0 ), errorMessage_()
+{
+    for ( int i = 0; i < counterCount; ++i ) {
+        descriptors_[ i ] = -1;
+        slots_[ i ] = -1;
+    }
+}
+
+
+
+OpenSteer::PerformanceCounters::~PerformanceCounters()
+{
+    close();
+}
+
+
+
+bool 
+OpenSteer::PerformanceCounters::open()
+{
+    close();
+    errorMessage_.clear();
+    
+#if defined( __linux__ )
+    int firstError = 0;
+    for ( int i = 0; i < counterCount; ++i ) {
+        int const descriptor = openEvent( events[ i ], leader_ );
+        if ( -1 == descriptor ) {
+            if ( 0 == firstError ) {
+                firstError = errno;
+            }
+            continue;
+        }
+        
+        if ( -1 == leader_ ) {
+            leader_ = descriptor;
+        }
+        descriptors_[ i ] = descriptor;
+        slots_[ i ] = static_cast< int >( availableCount_++ );
+    }
+    
+    if ( -1 == leader_ ) {
+        errorMessage_ = std::string( "perf_event_open failed: " ) + std::strerror( firstError );
+        return false;
+    }
+    
+    ioctl( leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+    ioctl( leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    return true;
+#else
+    errorMessage_ = "hardware counters are only supported on Linux";
+    return false;
+#endif
+}
+
+
+
+void 
+OpenSteer::PerformanceCounters::close()
+{
+#if defined( __linux__ )
+    // Close the members of the group before their leader.
+    for ( int i = counterCount - 1; i >= 0; --i ) {
+        if ( -1 != descriptors_[ i ] && leader_ != descriptors_[ i ] ) {
+            ::close( descriptors_[ i ] );
+        }
+    }
+    if ( -1 != leader_ ) {
+        ::close( leader_ );
+    }
+#endif
+    
+    leader_ = -1;
+    for ( int i = 0; i < counterCount; ++i ) {
+        descriptors_[ i ] = -1;
+        slots_[ i ] = -1;
+    }
+    availableCount_ = 0;
+}
+
+
+
+bool 
+OpenSteer::PerformanceCounters::available( Counter counter ) const
+{
+    assert( counter < counterCount && "no such counter" );
+    return -1 != slots_[ counter ];
+}
+
+
+
+OpenSteer::PerformanceCounters::size_type 
+OpenSteer::PerformanceCounters::availableCount() const
+{
+    return availableCount_;
+}
+
+
+
+void 
+OpenSteer::PerformanceCounters::read( Values& values ) const
+{
+    for ( int i = 0; i < counterCount; ++i ) {
+        values.counts[ i ] = 0.0;
+    }
+    
+#if defined( __linux__ )
+    if ( -1 == leader_ ) {
+        return;
+    }
+    
+    // Group read format: the number of counters followed by their values.
+    __u64 buffer[ 1 + counterCount ];
+    ssize_t const size = ::read( leader_, buffer, sizeof( buffer ) );
+    if ( size < static_cast< ssize_t >( sizeof( __u64 ) * ( 1 + availableCount_ ) ) ) {
+        return;
+    }
+    
+    for ( int i = 0; i < counterCount; ++i ) {
+        if ( -1 != slots_[ i ] ) {
+            values.counts[ i ] = static_cast< double >( buffer[ 1 + slots_[ i ] ] );
+        }
+    }
+#endif
+}
+
+
+
+std::string const& 
+OpenSteer::PerformanceCounters::errorMessage() const
+{
+    return errorMessage_;
+}
+
+
+
+char const* 
+OpenSteer::PerformanceCounters::name( Counter counter )
+{
+    static char const* const names[ counterCount ] = {
+        "cycles",
+        "instructions",
+        "L1D read misses",
+        "LLC misses",
+        "branch misses" };
+    
+    assert( counter < counterCount && "no such counter" );
+    return names[ counter ];
+}
@@ -39,16 +39,113 @@
 
 #include "OpenSteer/PlugIn.h"
 #include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
 
 // ----------------------------------------------------------------------------
 // PlugIn registry
 //
-// XXX replace with STL utilities
+// The registry grows with the number of PlugIns: built in ones register from
+// static constructors, others when their shared library is loaded.  Lookup
+// by name goes through a hash index which is built lazily on the first
+// search after the registry changed (names can't be asked for while a
+// PlugIn is still being constructed, and most runs only look up one).
+
+
+namespace {
+
+    typedef std::vector<OpenSteer::PlugIn*> PlugInVector;
+
 
+    // created on first use so that PlugIns registering from static
+    // constructors of other translation units find it initialized
+    PlugInVector& registry (void)
+    {
+        static PlugInVector plugIns;
+        return plugIns;
+    }
+
+
+    // FNV-1a hash of a zero terminated string
+    unsigned int hashName (const char* string)
+    {
+        unsigned int hash = 2166136261u;
+        for (const char* c = string; *c; c++)
+        {
+            hash ^= (unsigned char) *c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+
+    // hash index from name to PlugIn, its buckets keep registry order so
+    // that the first PlugIn registered under a name is the one found
+    class NameIndex
+    {
+    public:
+
+        NameIndex (void) : dirty (true) {}
+
+        void invalidate (void) {dirty = true;}
+
+        OpenSteer::PlugIn* find (const char* name)
+        {
+            if (dirty) rebuild ();
+            if (buckets.empty ()) return NULL;
+
+            const PlugInVector& bucket = buckets[bucketOf (name)];
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                if (std::strcmp (name, bucket[i]->name ()) == 0)
+                    return bucket[i];
+            }
+            return NULL;
+        }
+
+    private:
+
+        size_t bucketOf (const char* name) const
+        {
+            return hashName (name) & (buckets.size() - 1);
+        }
+
+        void rebuild (void)
+        {
+            const PlugInVector& plugIns = registry ();
+
+            // a power of two, at least twice the number of PlugIns
+            size_t bucketCount = 1;
+            while (bucketCount < 2 * plugIns.size()) bucketCount *= 2;
+
+            buckets.clear ();
+            buckets.resize (bucketCount);
+            for (size_t i = 0; i < plugIns.size(); i++)
+            {
+                const char* s = plugIns[i]->name ();
+                if (s) buckets[bucketOf (s)].push_back (plugIns[i]);
+            }
+            dirty = false;
+        }
+
+        std::vector<PlugInVector> buckets;
+        bool dirty;
+    };
+
+
+    NameIndex& nameIndex (void)
+    {
+        static NameIndex index;
+        return index;
+    }
 
-int OpenSteer::PlugIn::itemsInRegistry = 0;
-const int OpenSteer::PlugIn::totalSizeOfRegistry = 1000;
-OpenSteer::PlugIn* OpenSteer::PlugIn::registry [totalSizeOfRegistry];
+} // anonymous namespace
 
 
 // ----------------------------------------------------------------------------
@@ -66,22 +163,26 @@ OpenSteer::PlugIn::PlugIn (void)
 // destructor
 
 
-OpenSteer::PlugIn::~PlugIn() {}
+OpenSteer::PlugIn::~PlugIn()
+{
+    removeFromRegistry ();
+}
 
 
 // ----------------------------------------------------------------------------
 // returns pointer to the next PlugIn in "selection order"
 
 
-OpenSteer::PlugIn* 
+OpenSteer::PlugIn*
 OpenSteer::PlugIn::next (void)
 {
-    for (int i = 0; i < itemsInRegistry; i++)
+    const PlugInVector& plugIns = registry ();
+    for (size_t i = 0; i < plugIns.size(); i++)
     {
-        if (this == registry[i])
+        if (this == plugIns[i])
         {
-            const bool atEnd = (i == (itemsInRegistry - 1));
-            return registry [atEnd ? 0 : i + 1];
+            const bool atEnd = (i == (plugIns.size() - 1));
+            return plugIns [atEnd ? 0 : i + 1];
         }
     }
     return NULL;
@@ -93,18 +194,10 @@ OpenSteer::PlugIn::next (void)
 // returns NULL if none is found
 
 
-OpenSteer::PlugIn* 
+OpenSteer::PlugIn*
 OpenSteer::PlugIn::findByName (const char* string)
 {
-    if (string)
-    {
-        for (int i = 0; i < itemsInRegistry; i++)
-        {
-            PlugIn& pi = *registry[i];
-            const char* s = pi.name();
-            if (s && (std::strcmp (string, s) == 0)) return &pi;
-        }
-    }
+    if (string) return nameIndex().find (string);
     return NULL;
 }
 
@@ -113,45 +206,50 @@ OpenSteer::PlugIn::findByName (const char* string)
 // apply a given function to all PlugIns in the registry
 
 
-void 
+void
 OpenSteer::PlugIn::applyToAll (plugInCallBackFunction f)
 {
-    for (int i = 0; i < itemsInRegistry; i++)
+    const PlugInVector& plugIns = registry ();
+    for (size_t i = 0; i < plugIns.size(); i++)
     {
-        f (*registry[i]);
+        f (*plugIns[i]);
     }
 }
 
 
 // ----------------------------------------------------------------------------
 // sort PlugIn registry by "selection order"
-//
-// XXX replace with STL utilities
 
 
-void 
+void
 OpenSteer::PlugIn::sortBySelectionOrder (void)
 {
     // I know, I know, just what the world needs:
     // another inline shell sort implementation...
+    // (kept rather than std::sort for the order it leaves equal keys in)
+
+    PlugInVector& plugIns = registry ();
 
     // starting at each of the first n-1 elements of the array
-    for (int i = 0; i < itemsInRegistry-1; i++)
+    for (size_t i = 0; i + 1 < plugIns.size(); i++)
     {
         // scan over subsequent pairs, swapping if larger value is first
-        for (int j = i+1; j < itemsInRegistry; j++)
+        for (size_t j = i+1; j < plugIns.size(); j++)
         {
-            const float iKey = registry[i]->selectionOrderSortKey ();
-            const float jKey = registry[j]->selectionOrderSortKey ();
+            const float iKey = plugIns[i]->selectionOrderSortKey ();
+            const float jKey = plugIns[j]->selectionOrderSortKey ();
 
             if (iKey > jKey)
             {
-                PlugIn* temporary = registry[i];
-                registry[i] = registry[j];
-                registry[j] = temporary;
+                PlugIn* temporary = plugIns[i];
+                plugIns[i] = plugIns[j];
+                plugIns[j] = temporary;
             }
         }
     }
+
+    // the first PlugIn of a name may have changed
+    nameIndex().invalidate ();
 }
 
 
@@ -159,20 +257,63 @@ OpenSteer::PlugIn::sortBySelectionOrder (void)
 // returns pointer to default PlugIn (currently, first in registry)
 
 
-OpenSteer::PlugIn* 
+OpenSteer::PlugIn*
 OpenSteer::PlugIn::findDefault (void)
 {
+    const PlugInVector& plugIns = registry ();
+
     // return NULL if no PlugIns exist
-    if (itemsInRegistry == 0) return NULL;
+    if (plugIns.empty ()) return NULL;
 
     // otherwise, return the first PlugIn that requests initial selection
-    for (int i = 0; i < itemsInRegistry; i++)
+    for (size_t i = 0; i < plugIns.size(); i++)
     {
-        if (registry[i]->requestInitialSelection ()) return registry[i];
+        if (plugIns[i]->requestInitialSelection ()) return plugIns[i];
     }
 
     // otherwise, return the "first" PlugIn (in "selection order")
-    return registry[0];
+    return plugIns[0];
+}
+
+
+// ----------------------------------------------------------------------------
+// number of PlugIns in the registry
+
+
+int
+OpenSteer::PlugIn::count (void)
+{
+    return (int) registry().size();
+}
+
+
+// ----------------------------------------------------------------------------
+// load a shared library whose PlugIns register themselves on loading
+//
+// The library's PlugIns call back into the executable (SimpleVehicle,
+// drawing, OpenSteerDemo), so on Linux the executable is linked with
+// -rdynamic to export those symbols.
+
+
+bool
+OpenSteer::PlugIn::loadLibrary (const char* fileName,
+                                std::string& errorMessage)
+{
+#ifdef _WIN32
+    if (LoadLibraryA (fileName) == NULL)
+    {
+        errorMessage = std::string ("can't load ") + fileName;
+        return false;
+    }
+#else
+    if (dlopen (fileName, RTLD_NOW | RTLD_LOCAL) == NULL)
+    {
+        const char* error = dlerror ();
+        errorMessage = error ? error : (std::string ("can't load ") + fileName);
+        return false;
+    }
+#endif
+    return true;
 }
 
 
@@ -181,11 +322,32 @@ OpenSteer::PlugIn::findDefault (void)
 // (for use by contractors)
 
 
-void 
+void
 OpenSteer::PlugIn::addToRegistry (void)
 {
     // save this instance in the registry
-    registry[itemsInRegistry++] = this;
+    registry().push_back (this);
+    nameIndex().invalidate ();
+}
+
+
+// ----------------------------------------------------------------------------
+// remove this instance from the class's registry of instances
+
+
+void
+OpenSteer::PlugIn::removeFromRegistry (void)
+{
+    PlugInVector& plugIns = registry ();
+    for (PlugInVector::iterator i = plugIns.begin(); i != plugIns.end(); ++i)
+    {
+        if (*i == this)
+        {
+            plugIns.erase (i);
+            break;
+        }
+    }
+    nameIndex().invalidate ();
 }
 
 
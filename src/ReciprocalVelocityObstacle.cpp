@@ -0,0 +1,350 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the ORCA half-plane construction and the incremental
+ * linear programs solving for the new velocity. Follows the structure of 
+ * the RVO2 library by van den Berg et al.
+ */
+#include "OpenSteer/ReciprocalVelocityObstacle.h"
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::square, OpenSteer::sqrtXXX, OpenSteer::absXXX
+#include "OpenSteer/Utilities.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    float const orcaEpsilon = 0.00001f;
+    
+    
+    /**
+     * Dot product of the XZ components of @a lhs and @a rhs.
+     */
+    inline float dotXZ( Vec3 const& lhs, Vec3 const& rhs ) {
+        return lhs.x * rhs.x + lhs.z * rhs.z;
+    }
+    
+    /**
+     * Determinant of the 2x2 matrix with columns @a lhs and @a rhs (XZ 
+     * components only). Positive if @a rhs lies to the left of @a lhs.
+     */
+    inline float detXZ( Vec3 const& lhs, Vec3 const& rhs ) {
+        return lhs.x * rhs.z - lhs.z * rhs.x;
+    }
+    
+    inline float lengthSquaredXZ( Vec3 const& v ) {
+        return dotXZ( v, v );
+    }
+    
+    inline Vec3 xz( float x, float z ) {
+        return Vec3( x, 0.0f, z );
+    }
+    
+    
+    /**
+     * Solves the one dimensional linear program on line @a lineNo subject
+     * to the lines before it and the speed circle of @a radius.
+     * Returns @c false if the program is infeasible.
+     */
+    bool linearProgram1( OrcaLine const* lines,
+                         size_t lineNo,
+                         float radius,
+                         Vec3 const& optVelocity,
+                         bool directionOpt,
+                         Vec3& result )
+    {
+        OrcaLine const& line = lines[ lineNo ];
+        float const dotProduct = dotXZ( line.point, line.direction );
+        float const discriminant = square( dotProduct ) + square( radius ) - lengthSquaredXZ( line.point );
+        
+        if ( discriminant < 0.0f ) {
+            // Max speed circle fully invalidates line lineNo.
+            return false;
+        }
+        
+        float const sqrtDiscriminant = sqrtXXX( discriminant );
+        float tLeft = -dotProduct - sqrtDiscriminant;
+        float tRight = -dotProduct + sqrtDiscriminant;
+        
+        for ( size_t i = 0; i < lineNo; ++i ) {
+            float const denominator = detXZ( line.direction, lines[ i ].direction );
+            float const numerator = detXZ( lines[ i ].direction, line.point - lines[ i ].point );
+            
+            if ( absXXX( denominator ) <= orcaEpsilon ) {
+                // Lines lineNo and i are (almost) parallel.
+                if ( numerator < 0.0f ) {
+                    return false;
+                }
+                continue;
+            }
+            
+            float const t = numerator / denominator;
+            
+            if ( denominator >= 0.0f ) {
+                // Line i bounds line lineNo on the right.
+                tRight = minXXX( tRight, t );
+            } else {
+                // Line i bounds line lineNo on the left.
+                tLeft = maxXXX( tLeft, t );
+            }
+            
+            if ( tLeft > tRight ) {
+                return false;
+            }
+        }
+        
+        if ( directionOpt ) {
+            // Optimize direction.
+            if ( dotXZ( optVelocity, line.direction ) > 0.0f ) {
+                result = line.point + line.direction * tRight;
+            } else {
+                result = line.point + line.direction * tLeft;
+            }
+        } else {
+            // Optimize closest point.
+            float const t = dotXZ( line.direction, optVelocity - line.point );
+            result = line.point + line.direction * clamp( t, tLeft, tRight );
+        }
+        
+        return true;
+    }
+    
+    
+    /**
+     * Solves the two dimensional linear program. Returns the number of the
+     * line it fails on or @a lineCount if successful.
+     */
+    size_t linearProgram2( OrcaLine const* lines,
+                           size_t lineCount,
+                           float radius,
+                           Vec3 const& optVelocity,
+                           bool directionOpt,
+                           Vec3& result )
+    {
+        if ( directionOpt ) {
+            // Optimize direction. Note that the optimization velocity is of
+            // unit length in this case.
+            result = optVelocity * radius;
+        } else if ( lengthSquaredXZ( optVelocity ) > square( radius ) ) {
+            // Optimize closest point and outside circle.
+            result = optVelocity.normalize() * radius;
+        } else {
+            // Optimize closest point and inside circle.
+            result = optVelocity;
+        }
+        
+        for ( size_t i = 0; i < lineCount; ++i ) {
+            if ( detXZ( lines[ i ].direction, lines[ i ].point - result ) > 0.0f ) {
+                // Result does not satisfy constraint i. Compute new optimal 
+                // result.
+                Vec3 const tempResult( result );
+                if ( ! linearProgram1( lines, i, radius, optVelocity, directionOpt, result ) ) {
+                    result = tempResult;
+                    return i;
+                }
+            }
+        }
+        
+        return lineCount;
+    }
+    
+    
+    /**
+     * Minimizes the maximal penetration of the lines starting at 
+     * @a beginLine if the two dimensional program is infeasible.
+     */
+    void linearProgram3( OrcaLine const* lines,
+                         size_t lineCount,
+                         size_t beginLine,
+                         float radius,
+                         Vec3& result )
+    {
+        float distance = 0.0f;
+        
+        // Stack storage instead of a std::vector keeps the solver free of
+        // allocations.
+        OrcaLine projectedLines[ maxOrcaLineCount ];
+        
+        for ( size_t i = beginLine; i < lineCount; ++i ) {
+            if ( detXZ( lines[ i ].direction, lines[ i ].point - result ) > distance ) {
+                // Result does not satisfy constraint of line i.
+                size_t projectedLineCount = 0;
+                
+                for ( size_t j = 0; j < i; ++j ) {
+                    OrcaLine line;
+                    float const determinant = detXZ( lines[ i ].direction, lines[ j ].direction );
+                    
+                    if ( absXXX( determinant ) <= orcaEpsilon ) {
+                        // Lines i and j are parallel.
+                        if ( dotXZ( lines[ i ].direction, lines[ j ].direction ) > 0.0f ) {
+                            // Lines i and j point in the same direction.
+                            continue;
+                        }
+                        // Lines i and j point in opposite direction.
+                        line.point = ( lines[ i ].point + lines[ j ].point ) * 0.5f;
+                    } else {
+                        float const t = detXZ( lines[ j ].direction, lines[ i ].point - lines[ j ].point ) / determinant;
+                        line.point = lines[ i ].point + lines[ i ].direction * t;
+                    }
+                    
+                    line.direction = ( lines[ j ].direction - lines[ i ].direction ).normalize();
+                    projectedLines[ projectedLineCount ] = line;
+                    ++projectedLineCount;
+                }
+                
+                Vec3 const tempResult( result );
+                if ( linearProgram2( projectedLines, 
+                                     projectedLineCount, 
+                                     radius, 
+                                     xz( -lines[ i ].direction.z, lines[ i ].direction.x ), 
+                                     true, 
+                                     result ) < projectedLineCount ) {
+                    // This should in principle not happen. The result is by
+                    // definition already in the feasible region of this 
+                    // linear program. If it fails, it is due to small 
+                    // floating point error, and the current result is kept.
+                    result = tempResult;
+                }
+                
+                distance = detXZ( lines[ i ].direction, lines[ i ].point - result );
+            }
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+OpenSteer::OrcaLine
+OpenSteer::computeOrcaLine( Vec3 const& velocity,
+                            Vec3 const& relativePosition,
+                            Vec3 const& relativeVelocity,
+                            float combinedRadius,
+                            float timeHorizon,
+                            float timeStep )
+{
+    assert( 0.0f < timeHorizon && "timeHorizon must be greater than 0." );
+    
+    // Without a time step (a paused simulation) overlaps are resolved 
+    // within the time horizon.
+    float const resolveTime = 0.0f < timeStep ? timeStep : timeHorizon;
+    
+    float const distanceSquared = lengthSquaredXZ( relativePosition );
+    float const combinedRadiusSquared = square( combinedRadius );
+    
+    OrcaLine line;
+    Vec3 u;
+    
+    if ( distanceSquared > combinedRadiusSquared ) {
+        // No collision.
+        float const invTimeHorizon = 1.0f / timeHorizon;
+        
+        // Vector from cutoff center to relative velocity.
+        Vec3 const w( xz( relativeVelocity.x - relativePosition.x * invTimeHorizon,
+                          relativeVelocity.z - relativePosition.z * invTimeHorizon ) );
+        float const wLengthSquared = lengthSquaredXZ( w );
+        float const dotProduct1 = dotXZ( w, relativePosition );
+        
+        if ( ( dotProduct1 < 0.0f ) && ( square( dotProduct1 ) > combinedRadiusSquared * wLengthSquared ) ) {
+            // Project on cut-off circle.
+            float const wLength = sqrtXXX( wLengthSquared );
+            Vec3 const unitW( w / wLength );
+            
+            line.direction = xz( unitW.z, -unitW.x );
+            u = unitW * ( combinedRadius * invTimeHorizon - wLength );
+        } else {
+            // Project on legs.
+            float const leg = sqrtXXX( distanceSquared - combinedRadiusSquared );
+            
+            if ( detXZ( relativePosition, w ) > 0.0f ) {
+                // Project on left leg.
+                line.direction = xz( relativePosition.x * leg - relativePosition.z * combinedRadius,
+                                     relativePosition.x * combinedRadius + relativePosition.z * leg ) / distanceSquared;
+            } else {
+                // Project on right leg.
+                line.direction = -xz( relativePosition.x * leg + relativePosition.z * combinedRadius,
+                                      -relativePosition.x * combinedRadius + relativePosition.z * leg ) / distanceSquared;
+            }
+            
+            float const dotProduct2 = dotXZ( relativeVelocity, line.direction );
+            u = line.direction * dotProduct2 - xz( relativeVelocity.x, relativeVelocity.z );
+        }
+    } else {
+        // Collision. Project on cut-off circle of time resolveTime.
+        float const invTimeStep = 1.0f / resolveTime;
+        
+        // Vector from cutoff center to relative velocity.
+        Vec3 w( xz( relativeVelocity.x - relativePosition.x * invTimeStep,
+                    relativeVelocity.z - relativePosition.z * invTimeStep ) );
+        float wLength = sqrtXXX( lengthSquaredXZ( w ) );
+        
+        if ( wLength <= orcaEpsilon ) {
+            // Coincident agents with equal velocities, any direction works.
+            w = xz( 1.0f, 0.0f );
+            wLength = 1.0f;
+        }
+        
+        Vec3 const unitW( w / wLength );
+        
+        line.direction = xz( unitW.z, -unitW.x );
+        u = unitW * ( combinedRadius * invTimeStep - wLength );
+    }
+    
+    // Both agents take half of the responsibility to avoid each other.
+    line.point = xz( velocity.x, velocity.z ) + u * 0.5f;
+    
+    return line;
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::solveOrcaLinearProgram( OrcaLine const* lines,
+                                   size_t lineCount,
+                                   float maxSpeed,
+                                   Vec3 const& preferredVelocity )
+{
+    assert( lineCount <= maxOrcaLineCount && "Too many lines for the ORCA solver." );
+    
+    Vec3 const optVelocity( xz( preferredVelocity.x, preferredVelocity.z ) );
+    Vec3 result;
+    
+    size_t const lineFail = linearProgram2( lines, lineCount, maxSpeed, optVelocity, false, result );
+    
+    if ( lineFail < lineCount ) {
+        linearProgram3( lines, lineCount, lineFail, maxSpeed, result );
+    }
+    
+    return result;
+}
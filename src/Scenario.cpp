@@ -0,0 +1,851 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of reading, writing and building scenarios.
+ */
+#include "OpenSteer/Scenario.h"
+
+// Include std::ifstream, std::ofstream
+#include <fstream>
+
+// Include std::setprecision
+#include <iomanip>
+
+// Include std::istream, std::ostream
+#include <istream>
+#include <ostream>
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include std::istringstream
+#include <sstream>
+
+// Include std::memcmp
+#include <cstring>
+
+// Include std::bad_alloc
+#include <new>
+
+// Include assert
+#include <cassert>
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * First bytes of a binary scenario.
+     */
+    char const binaryMagic[ 4 ] = { 'O', 'S', 'S', 'B' };
+    
+    /**
+     * Version of the binary format, read back with another byte order it
+     * doesn't match.
+     */
+    unsigned int const binaryVersion = 1;
+    
+    /**
+     * Number of floats of the records stored as float arrays.
+     */
+    Scenario::size_type const sphereFloats = 4;
+    Scenario::size_type const boxFloats = 15;
+    Scenario::size_type const pointFloats = 3;
+    Scenario::size_type const agentFloats = 7;
+    
+    /**
+     * Counts larger than this are taken as a sign of a corrupt file.
+     */
+    unsigned int const maxCount = 1u << 28;
+    
+    
+    // Binary output, counts are written as 32 bit unsigned integers.
+    
+    void 
+    writeCount( std::ostream& out, Scenario::size_type count )
+    {
+        unsigned int const value = static_cast< unsigned int >( count );
+        out.write( reinterpret_cast< char const* >( &value ), sizeof( value ) );
+    }
+    
+    void 
+    writeString( std::ostream& out, std::string const& text )
+    {
+        writeCount( out, text.size() );
+        out.write( text.data(), text.size() );
+    }
+    
+    void 
+    writeFloats( std::ostream& out, std::vector< float > const& floats )
+    {
+        if ( ! floats.empty() ) {
+            out.write( reinterpret_cast< char const* >( &floats[ 0 ] ), 
+                       floats.size() * sizeof( float ) );
+        }
+    }
+    
+    
+    // Binary input, return false if the input ends early.
+    
+    /**
+     * Returns @c true if @a in has at least @a count records of 
+     * @a recordBytes bytes left, so a corrupt count is rejected before 
+     * storage for it is allocated. Streams that can't seek are trusted.
+     */
+    bool 
+    holds( std::istream& in, Scenario::size_type count, Scenario::size_type recordBytes )
+    {
+        std::istream::pos_type const position = in.tellg();
+        if ( std::istream::pos_type( -1 ) == position ) {
+            in.clear( in.rdstate() & ~std::ios::failbit );
+            return true;
+        }
+        in.seekg( 0, std::ios::end );
+        std::istream::pos_type const end = in.tellg();
+        in.seekg( position );
+        if ( std::istream::pos_type( -1 ) == end || ! in.good() ) {
+            in.clear( in.rdstate() & ~std::ios::failbit );
+            in.seekg( position );
+            return true;
+        }
+        Scenario::size_type const left = static_cast< Scenario::size_type >( end - position );
+        return count <= left / recordBytes;
+    }
+    
+    bool 
+    readCount( std::istream& in, Scenario::size_type& count )
+    {
+        unsigned int value = 0;
+        in.read( reinterpret_cast< char* >( &value ), sizeof( value ) );
+        count = value;
+        return in.good() && value <= maxCount;
+    }
+    
+    bool 
+    readString( std::istream& in, std::string& text )
+    {
+        Scenario::size_type length = 0;
+        if ( ! ( readCount( in, length ) && holds( in, length, 1 ) ) ) {
+            return false;
+        }
+        text.resize( length );
+        if ( length > 0 ) {
+            in.read( &text[ 0 ], length );
+        }
+        return in.good();
+    }
+    
+    bool 
+    readFloats( std::istream& in, std::vector< float >& floats, Scenario::size_type count )
+    {
+        if ( ! holds( in, count, sizeof( float ) ) ) {
+            return false;
+        }
+        floats.resize( count );
+        if ( count > 0 ) {
+            in.read( reinterpret_cast< char* >( &floats[ 0 ] ), count * sizeof( float ) );
+        }
+        return in.good();
+    }
+    
+    
+    // Float array packing of the records.
+    
+    void 
+    put( std::vector< float >::iterator& f, Vec3 const& v )
+    {
+        *f++ = v.x;
+        *f++ = v.y;
+        *f++ = v.z;
+    }
+    
+    Vec3 
+    take( std::vector< float >::const_iterator& f )
+    {
+        Vec3 const v( f[ 0 ], f[ 1 ], f[ 2 ] );
+        f += 3;
+        return v;
+    }
+    
+    
+    /**
+     * Reads @a count floats from text into @a floats. 
+     */
+    bool 
+    readTextFloats( std::istream& in, float* floats, Scenario::size_type count )
+    {
+        for ( Scenario::size_type i = 0; i < count; ++i ) {
+            in >> floats[ i ];
+        }
+        return ! in.fail();
+    }
+    
+    
+    void 
+    writeVec3Text( std::ostream& out, Vec3 const& v )
+    {
+        out << ' ' << v.x << ' ' << v.y << ' ' << v.z;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::Scenario::size_type const OpenSteer::Scenario::npos = static_cast< size_type >( -1 );
+
+
+
+OpenSteer::Scenario::Scenario()
+    : name_(), 
+      parameters_(), 
+      spheres_(), 
+      boxes_(), 
+      paths_(), 
+      pathPoints_(), 
+      populations_(), 
+      agents_(),
+      errorMessage_()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Scenario::clear()
+{
+    name_.clear();
+    parameters_.clear();
+    spheres_.clear();
+    boxes_.clear();
+    paths_.clear();
+    pathPoints_.clear();
+    populations_.clear();
+    agents_.clear();
+}
+
+
+
+std::string const& 
+OpenSteer::Scenario::name() const
+{
+    return name_;
+}
+
+
+
+void 
+OpenSteer::Scenario::setName( std::string const& name )
+{
+    name_ = name;
+}
+
+
+
+void 
+OpenSteer::Scenario::addParameter( std::string const& name, std::string const& value )
+{
+    parameters_.push_back( Parameter( name, value ) );
+}
+
+
+
+void 
+OpenSteer::Scenario::addSphere( Vec3 const& center, float radius )
+{
+    Sphere const sphere = { center, radius };
+    spheres_.push_back( sphere );
+}
+
+
+
+void 
+OpenSteer::Scenario::addBox( Box const& box )
+{
+    boxes_.push_back( box );
+}
+
+
+
+OpenSteer::Scenario::size_type 
+OpenSteer::Scenario::addPath( std::string const& name,
+                              float radius,
+                              bool cyclic,
+                              size_type pointCount, 
+                              Vec3 const points[] )
+{
+    Path const path = { name, radius, cyclic, pathPoints_.size(), pointCount };
+    paths_.push_back( path );
+    pathPoints_.insert( pathPoints_.end(), points, points + pointCount );
+    return paths_.size() - 1;
+}
+
+
+
+OpenSteer::Scenario::size_type 
+OpenSteer::Scenario::addPopulation( std::string const& name,
+                                    size_type agentCount,
+                                    Agent const agents[] )
+{
+    Population const population = { name, agents_.size(), agentCount };
+    populations_.push_back( population );
+    agents_.insert( agents_.end(), agents, agents + agentCount );
+    return populations_.size() - 1;
+}
+
+
+
+std::vector< OpenSteer::Scenario::Parameter > const& 
+OpenSteer::Scenario::parameters() const
+{
+    return parameters_;
+}
+
+
+
+std::vector< OpenSteer::Scenario::Sphere > const& 
+OpenSteer::Scenario::spheres() const
+{
+    return spheres_;
+}
+
+
+
+std::vector< OpenSteer::Scenario::Box > const& 
+OpenSteer::Scenario::boxes() const
+{
+    return boxes_;
+}
+
+
+
+std::vector< OpenSteer::Scenario::Path > const& 
+OpenSteer::Scenario::paths() const
+{
+    return paths_;
+}
+
+
+
+std::vector< OpenSteer::Scenario::Population > const& 
+OpenSteer::Scenario::populations() const
+{
+    return populations_;
+}
+
+
+
+OpenSteer::Vec3 const* 
+OpenSteer::Scenario::pathPoints( Path const& path ) const
+{
+    return pathPoints_.empty() ? 0 : &pathPoints_[ path.firstPoint ];
+}
+
+
+
+OpenSteer::Scenario::Agent const* 
+OpenSteer::Scenario::populationAgents( Population const& population ) const
+{
+    return agents_.empty() ? 0 : &agents_[ population.firstAgent ];
+}
+
+
+
+OpenSteer::Scenario::size_type 
+OpenSteer::Scenario::findPath( std::string const& name ) const
+{
+    for ( size_type i = 0; i < paths_.size(); ++i ) {
+        if ( paths_[ i ].name == name ) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+
+
+OpenSteer::Scenario::size_type 
+OpenSteer::Scenario::findPopulation( std::string const& name ) const
+{
+    for ( size_type i = 0; i < populations_.size(); ++i ) {
+        if ( populations_[ i ].name == name ) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+
+
+bool 
+OpenSteer::Scenario::load( std::string const& fileName )
+{
+    std::ifstream in( fileName.c_str(), std::ios::in | std::ios::binary );
+    if ( ! in ) {
+        return fail( "can't open scenario file " + fileName );
+    }
+    
+    char magic[ sizeof( binaryMagic ) ] = { 0, 0, 0, 0 };
+    in.read( magic, sizeof( magic ) );
+    Format const format = ( in.good() && std::memcmp( magic, binaryMagic, sizeof( magic ) ) == 0 ) ? binary : text;
+    in.clear();
+    in.seekg( 0 );
+    
+    if ( ! read( in, format ) ) {
+        errorMessage_ = fileName + ": " + errorMessage_;
+        return false;
+    }
+    name_ = fileName;
+    return true;
+}
+
+
+
+bool 
+OpenSteer::Scenario::save( std::string const& fileName, Format format ) const
+{
+    std::ofstream out( fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    write( out, format );
+    return out.good();
+}
+
+
+
+bool 
+OpenSteer::Scenario::read( std::istream& in, Format format )
+{
+    clear();
+    errorMessage_.clear();
+    try {
+        return ( binary == format ) ? readBinary( in ) : readText( in );
+    } catch ( std::bad_alloc const& ) {
+        return fail( "out of memory reading scenario" );
+    }
+}
+
+
+
+void 
+OpenSteer::Scenario::write( std::ostream& out, Format format ) const
+{
+    if ( binary == format ) {
+        writeBinary( out );
+    } else {
+        writeText( out );
+    }
+}
+
+
+
+std::string const& 
+OpenSteer::Scenario::errorMessage() const
+{
+    return errorMessage_;
+}
+
+
+
+void 
+OpenSteer::Scenario::buildObstacles( std::vector< SphereObstacle >& sphereObstacles,
+                                     std::vector< BoxObstacle >& boxObstacles,
+                                     ObstacleGroup& obstacles ) const
+{
+    sphereObstacles.clear();
+    sphereObstacles.reserve( spheres_.size() );
+    for ( size_type i = 0; i < spheres_.size(); ++i ) {
+        sphereObstacles.push_back( SphereObstacle( spheres_[ i ].radius, spheres_[ i ].center ) );
+    }
+    
+    boxObstacles.clear();
+    boxObstacles.reserve( boxes_.size() );
+    for ( size_type i = 0; i < boxes_.size(); ++i ) {
+        Box const& box = boxes_[ i ];
+        boxObstacles.push_back( BoxObstacle( box.width, box.height, box.depth ) );
+        boxObstacles.back().setPosition( box.position );
+        boxObstacles.back().setForward( box.forward );
+        boxObstacles.back().setSide( box.side );
+        boxObstacles.back().setUp( box.up );
+    }
+    
+    obstacles.reserve( obstacles.size() + sphereObstacles.size() + boxObstacles.size() );
+    for ( size_type i = 0; i < sphereObstacles.size(); ++i ) {
+        obstacles.push_back( &sphereObstacles[ i ] );
+    }
+    for ( size_type i = 0; i < boxObstacles.size(); ++i ) {
+        obstacles.push_back( &boxObstacles[ i ] );
+    }
+}
+
+
+
+OpenSteer::PathRegistry::PathPointer 
+OpenSteer::Scenario::acquirePath( size_type pathIndex, 
+                                  PathRegistry& registry ) const
+{
+    assert( pathIndex < paths_.size() && "pathIndex out of range." );
+    
+    Path const& path = paths_[ pathIndex ];
+    return registry.acquire( "scenario " + name_ + " path " + path.name,
+                             path.pointCount,
+                             pathPoints( path ),
+                             path.radius,
+                             path.cyclic );
+}
+
+
+
+bool 
+OpenSteer::Scenario::readText( std::istream& in )
+{
+    std::string keyword;
+    while ( in >> keyword ) {
+        if ( '#' == keyword[ 0 ] ) {
+            in.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+        } else if ( "parameter" == keyword ) {
+            std::string name;
+            std::string value;
+            in >> name >> std::ws;
+            std::getline( in, value );
+            if ( in.fail() || name.empty() ) {
+                return fail( "malformed parameter" );
+            }
+            addParameter( name, value );
+        } else if ( "sphere" == keyword ) {
+            float f[ sphereFloats ];
+            if ( ! readTextFloats( in, f, sphereFloats ) ) {
+                return fail( "malformed sphere" );
+            }
+            addSphere( Vec3( f[ 0 ], f[ 1 ], f[ 2 ] ), f[ 3 ] );
+        } else if ( "box" == keyword ) {
+            float f[ boxFloats ];
+            if ( ! readTextFloats( in, f, boxFloats ) ) {
+                return fail( "malformed box" );
+            }
+            Box const box = { Vec3( f[ 0 ], f[ 1 ], f[ 2 ] ),
+                              Vec3( f[ 3 ], f[ 4 ], f[ 5 ] ),
+                              Vec3( f[ 6 ], f[ 7 ], f[ 8 ] ),
+                              Vec3( f[ 9 ], f[ 10 ], f[ 11 ] ),
+                              f[ 12 ], f[ 13 ], f[ 14 ] };
+            addBox( box );
+        } else if ( "path" == keyword ) {
+            std::string name;
+            float radius = 0.0f;
+            std::string closing;
+            size_type pointCount = 0;
+            in >> name >> radius >> closing >> pointCount;
+            if ( in.fail() || ( "open" != closing && "cyclic" != closing ) || pointCount < 2 || pointCount > maxCount ) {
+                return fail( "malformed path " + name );
+            }
+            Path const path = { name, radius, "cyclic" == closing, pathPoints_.size(), pointCount };
+            pathPoints_.resize( pathPoints_.size() + pointCount );
+            for ( size_type i = path.firstPoint; i < pathPoints_.size(); ++i ) {
+                in >> pathPoints_[ i ].x >> pathPoints_[ i ].y >> pathPoints_[ i ].z;
+            }
+            if ( in.fail() ) {
+                return fail( "malformed points of path " + name );
+            }
+            paths_.push_back( path );
+        } else if ( "population" == keyword ) {
+            std::string name;
+            size_type agentCount = 0;
+            in >> name >> agentCount;
+            if ( in.fail() || agentCount > maxCount ) {
+                return fail( "malformed population " + name );
+            }
+            Population const population = { name, agents_.size(), agentCount };
+            agents_.resize( agents_.size() + agentCount );
+            for ( size_type i = population.firstAgent; i < agents_.size(); ++i ) {
+                Agent& agent = agents_[ i ];
+                in >> agent.position.x >> agent.position.y >> agent.position.z
+                   >> agent.forward.x >> agent.forward.y >> agent.forward.z
+                   >> agent.speed;
+            }
+            if ( in.fail() ) {
+                return fail( "malformed agents of population " + name );
+            }
+            populations_.push_back( population );
+        } else {
+            return fail( "unknown record " + keyword );
+        }
+    }
+    
+    return in.eof() ? true : fail( "unreadable input" );
+}
+
+
+
+bool 
+OpenSteer::Scenario::readBinary( std::istream& in )
+{
+    char magic[ sizeof( binaryMagic ) ];
+    unsigned int version = 0;
+    in.read( magic, sizeof( magic ) );
+    in.read( reinterpret_cast< char* >( &version ), sizeof( version ) );
+    if ( ! in.good() || std::memcmp( magic, binaryMagic, sizeof( magic ) ) != 0 ) {
+        return fail( "not a binary scenario" );
+    }
+    if ( binaryVersion != version ) {
+        return fail( "unsupported version or byte order of binary scenario" );
+    }
+    
+    size_type parameterCount = 0;
+    size_type sphereCount = 0;
+    size_type boxCount = 0;
+    size_type pathCount = 0;
+    size_type pointCount = 0;
+    size_type populationCount = 0;
+    size_type agentCount = 0;
+    if ( ! ( readCount( in, parameterCount ) && readCount( in, sphereCount ) && 
+             readCount( in, boxCount ) && readCount( in, pathCount ) && 
+             readCount( in, pointCount ) && readCount( in, populationCount ) && 
+             readCount( in, agentCount ) ) ) {
+        return fail( "corrupt record counts" );
+    }
+    
+    // Every parameter, path and population record starts with at least two
+    // counts, which bounds their number by the bytes left.
+    size_type const recordBytes = 2 * sizeof( unsigned int );
+    if ( ! holds( in, parameterCount, recordBytes ) ) {
+        return fail( "corrupt parameters" );
+    }
+    parameters_.resize( parameterCount );
+    for ( size_type i = 0; i < parameterCount; ++i ) {
+        if ( ! ( readString( in, parameters_[ i ].first ) && readString( in, parameters_[ i ].second ) ) ) {
+            return fail( "corrupt parameters" );
+        }
+    }
+    
+    std::vector< float > floats;
+    if ( ! readFloats( in, floats, sphereCount * sphereFloats ) ) {
+        return fail( "corrupt spheres" );
+    }
+    spheres_.resize( sphereCount );
+    std::vector< float >::const_iterator f = floats.begin();
+    for ( size_type i = 0; i < sphereCount; ++i ) {
+        spheres_[ i ].center = take( f );
+        spheres_[ i ].radius = *f++;
+    }
+    
+    if ( ! readFloats( in, floats, boxCount * boxFloats ) ) {
+        return fail( "corrupt boxes" );
+    }
+    boxes_.resize( boxCount );
+    f = floats.begin();
+    for ( size_type i = 0; i < boxCount; ++i ) {
+        Box& box = boxes_[ i ];
+        box.position = take( f );
+        box.forward = take( f );
+        box.side = take( f );
+        box.up = take( f );
+        box.width = *f++;
+        box.height = *f++;
+        box.depth = *f++;
+    }
+    
+    if ( ! holds( in, pathCount, recordBytes ) ) {
+        return fail( "corrupt paths" );
+    }
+    paths_.resize( pathCount );
+    size_type firstPoint = 0;
+    for ( size_type i = 0; i < pathCount; ++i ) {
+        Path& path = paths_[ i ];
+        size_type cyclic = 0;
+        if ( ! ( readString( in, path.name ) && readFloats( in, floats, 1 ) && 
+                 readCount( in, cyclic ) && readCount( in, path.pointCount ) ) || 
+             path.pointCount < 2 ) {
+            return fail( "corrupt paths" );
+        }
+        path.radius = floats[ 0 ];
+        path.cyclic = ( cyclic != 0 );
+        path.firstPoint = firstPoint;
+        firstPoint += path.pointCount;
+    }
+    if ( firstPoint != pointCount || ! readFloats( in, floats, pointCount * pointFloats ) ) {
+        return fail( "corrupt path points" );
+    }
+    pathPoints_.resize( pointCount );
+    f = floats.begin();
+    for ( size_type i = 0; i < pointCount; ++i ) {
+        pathPoints_[ i ] = take( f );
+    }
+    
+    if ( ! holds( in, populationCount, recordBytes ) ) {
+        return fail( "corrupt populations" );
+    }
+    populations_.resize( populationCount );
+    size_type firstAgent = 0;
+    for ( size_type i = 0; i < populationCount; ++i ) {
+        Population& population = populations_[ i ];
+        if ( ! ( readString( in, population.name ) && readCount( in, population.agentCount ) ) ) {
+            return fail( "corrupt populations" );
+        }
+        population.firstAgent = firstAgent;
+        firstAgent += population.agentCount;
+    }
+    if ( firstAgent != agentCount || ! readFloats( in, floats, agentCount * agentFloats ) ) {
+        return fail( "corrupt agents" );
+    }
+    agents_.resize( agentCount );
+    f = floats.begin();
+    for ( size_type i = 0; i < agentCount; ++i ) {
+        agents_[ i ].position = take( f );
+        agents_[ i ].forward = take( f );
+        agents_[ i ].speed = *f++;
+    }
+    
+    return true;
+}
+
+
+
+void 
+OpenSteer::Scenario::writeText( std::ostream& out ) const
+{
+    std::streamsize const oldPrecision = out.precision( std::numeric_limits< float >::digits10 + 3 );
+    
+    out << "# OpenSteer scenario" << '\n';
+    for ( size_type i = 0; i < parameters_.size(); ++i ) {
+        out << "parameter " << parameters_[ i ].first << ' ' << parameters_[ i ].second << '\n';
+    }
+    for ( size_type i = 0; i < spheres_.size(); ++i ) {
+        out << "sphere";
+        writeVec3Text( out, spheres_[ i ].center );
+        out << ' ' << spheres_[ i ].radius << '\n';
+    }
+    for ( size_type i = 0; i < boxes_.size(); ++i ) {
+        Box const& box = boxes_[ i ];
+        out << "box";
+        writeVec3Text( out, box.position );
+        writeVec3Text( out, box.forward );
+        writeVec3Text( out, box.side );
+        writeVec3Text( out, box.up );
+        out << ' ' << box.width << ' ' << box.height << ' ' << box.depth << '\n';
+    }
+    for ( size_type i = 0; i < paths_.size(); ++i ) {
+        Path const& path = paths_[ i ];
+        out << "path " << path.name << ' ' << path.radius << ' ' 
+            << ( path.cyclic ? "cyclic" : "open" ) << ' ' << path.pointCount << '\n';
+        Vec3 const* points = pathPoints( path );
+        for ( size_type p = 0; p < path.pointCount; ++p ) {
+            writeVec3Text( out, points[ p ] );
+            out << '\n';
+        }
+    }
+    for ( size_type i = 0; i < populations_.size(); ++i ) {
+        Population const& population = populations_[ i ];
+        out << "population " << population.name << ' ' << population.agentCount << '\n';
+        Agent const* agents = populationAgents( population );
+        for ( size_type a = 0; a < population.agentCount; ++a ) {
+            writeVec3Text( out, agents[ a ].position );
+            writeVec3Text( out, agents[ a ].forward );
+            out << ' ' << agents[ a ].speed << '\n';
+        }
+    }
+    
+    out.precision( oldPrecision );
+}
+
+
+
+void 
+OpenSteer::Scenario::writeBinary( std::ostream& out ) const
+{
+    out.write( binaryMagic, sizeof( binaryMagic ) );
+    out.write( reinterpret_cast< char const* >( &binaryVersion ), sizeof( binaryVersion ) );
+    writeCount( out, parameters_.size() );
+    writeCount( out, spheres_.size() );
+    writeCount( out, boxes_.size() );
+    writeCount( out, paths_.size() );
+    writeCount( out, pathPoints_.size() );
+    writeCount( out, populations_.size() );
+    writeCount( out, agents_.size() );
+    
+    for ( size_type i = 0; i < parameters_.size(); ++i ) {
+        writeString( out, parameters_[ i ].first );
+        writeString( out, parameters_[ i ].second );
+    }
+    
+    std::vector< float > floats( spheres_.size() * sphereFloats );
+    std::vector< float >::iterator f = floats.begin();
+    for ( size_type i = 0; i < spheres_.size(); ++i ) {
+        put( f, spheres_[ i ].center );
+        *f++ = spheres_[ i ].radius;
+    }
+    writeFloats( out, floats );
+    
+    floats.resize( boxes_.size() * boxFloats );
+    f = floats.begin();
+    for ( size_type i = 0; i < boxes_.size(); ++i ) {
+        Box const& box = boxes_[ i ];
+        put( f, box.position );
+        put( f, box.forward );
+        put( f, box.side );
+        put( f, box.up );
+        *f++ = box.width;
+        *f++ = box.height;
+        *f++ = box.depth;
+    }
+    writeFloats( out, floats );
+    
+    for ( size_type i = 0; i < paths_.size(); ++i ) {
+        writeString( out, paths_[ i ].name );
+        writeFloats( out, std::vector< float >( 1, paths_[ i ].radius ) );
+        writeCount( out, paths_[ i ].cyclic ? 1 : 0 );
+        writeCount( out, paths_[ i ].pointCount );
+    }
+    floats.resize( pathPoints_.size() * pointFloats );
+    f = floats.begin();
+    for ( size_type i = 0; i < pathPoints_.size(); ++i ) {
+        put( f, pathPoints_[ i ] );
+    }
+    writeFloats( out, floats );
+    
+    for ( size_type i = 0; i < populations_.size(); ++i ) {
+        writeString( out, populations_[ i ].name );
+        writeCount( out, populations_[ i ].agentCount );
+    }
+    floats.resize( agents_.size() * agentFloats );
+    f = floats.begin();
+    for ( size_type i = 0; i < agents_.size(); ++i ) {
+        put( f, agents_[ i ].position );
+        put( f, agents_[ i ].forward );
+        *f++ = agents_[ i ].speed;
+    }
+    writeFloats( out, floats );
+}
+
+
+
+bool 
+OpenSteer::Scenario::fail( std::string const& message )
+{
+    clear();
+    errorMessage_ = message;
+    return false;
+}
@@ -0,0 +1,117 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the digest of vehicle states.
+ */
+#include "OpenSteer/SimulationHash.h"
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    SimulationHash::digest_type const fnvOffsetBasis = 2166136261u;
+    SimulationHash::digest_type const fnvPrime = 16777619u;
+    
+} // anonymous namespace
+
+
+
+OpenSteer::SimulationHash::SimulationHash()
+    : hash_( fnvOffsetBasis )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::SimulationHash::add( float value )
+{
+    // Negative zero compares equal to zero and has to hash alike.
+    if ( 0.0f == value ) {
+        value = 0.0f;
+    }
+    
+    unsigned char const* bytes = reinterpret_cast< unsigned char const* >( &value );
+    for ( size_t i = 0; i < sizeof( value ); ++i ) {
+        hash_ ^= bytes[ i ];
+        hash_ *= fnvPrime;
+    }
+}
+
+
+
+void 
+OpenSteer::SimulationHash::add( Vec3 const& value )
+{
+    add( value.x );
+    add( value.y );
+    add( value.z );
+}
+
+
+
+void 
+OpenSteer::SimulationHash::add( AbstractVehicle const& vehicle )
+{
+    add( vehicle.position() );
+    add( vehicle.forward() );
+    add( vehicle.side() );
+    add( vehicle.up() );
+    add( vehicle.speed() );
+    add( vehicle.radius() );
+}
+
+
+
+void 
+OpenSteer::SimulationHash::add( AVGroup const& vehicles )
+{
+    for ( AVGroup::const_iterator i = vehicles.begin(); i != vehicles.end(); ++i ) {
+        add( **i );
+    }
+}
+
+
+
+OpenSteer::SimulationHash::digest_type 
+OpenSteer::SimulationHash::value() const
+{
+    return hash_;
+}
+
+
+
+OpenSteer::SimulationHash::digest_type 
+OpenSteer::SimulationHash::digest( AVGroup const& vehicles )
+{
+    SimulationHash hash;
+    hash.add( vehicles );
+    return hash.value();
+}
@@ -0,0 +1,339 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the sleep scheduler.
+ */
+#include "OpenSteer/SleepScheduler.h"
+
+// Include assert
+#include <cassert>
+
+
+
+OpenSteer::SleepScheduler::SleepScheduler( Vec3 const& center, 
+                                           Vec3 const& dimensions, 
+                                           Vec3 const& divisions )
+    : speedThreshold_( 0.05f ), 
+      accelerationThreshold_( 0.1f ), 
+      framesUntilSleep_( 30 ), 
+      wakeRadius_( 2.0f ), 
+      sleepers_( center, dimensions, divisions ), 
+      queryToken_( 0 ), 
+      sleeperIndices_(), 
+      neighbors_(), 
+      states_(), 
+      fellAsleepVehicleCount_( 0 ), 
+      wokenVehicleCount_( 0 )
+{
+    // The query token is never positioned so it isn't found by queries.
+    queryToken_ = sleepers_.allocateToken( 0 );
+}
+
+
+
+OpenSteer::SleepScheduler::~SleepScheduler()
+{
+    reset();
+    delete queryToken_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::setSpeedThreshold( float speed )
+{
+    speedThreshold_ = speed;
+}
+
+
+
+float 
+OpenSteer::SleepScheduler::speedThreshold() const
+{
+    return speedThreshold_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::setAccelerationThreshold( float acceleration )
+{
+    accelerationThreshold_ = acceleration;
+}
+
+
+
+float 
+OpenSteer::SleepScheduler::accelerationThreshold() const
+{
+    return accelerationThreshold_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::setFramesUntilSleep( size_type frames )
+{
+    framesUntilSleep_ = frames;
+}
+
+
+
+OpenSteer::SleepScheduler::size_type 
+OpenSteer::SleepScheduler::framesUntilSleep() const
+{
+    return framesUntilSleep_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::setWakeRadius( float radius )
+{
+    wakeRadius_ = radius;
+}
+
+
+
+float 
+OpenSteer::SleepScheduler::wakeRadius() const
+{
+    return wakeRadius_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::update( AVGroup const& vehicles, 
+                                   float currentTime, 
+                                   float elapsedTime )
+{
+    resize( vehicles );
+    
+    fellAsleepVehicleCount_ = 0;
+    wokenVehicleCount_ = 0;
+    
+    for ( size_type i = 0; i < vehicles.size(); ++i ) {
+        if ( 0 != states_[ i ].sleeperToken ) {
+            continue;
+        }
+        
+        AbstractVehicle& vehicle = *vehicles[ i ];
+        Vec3 const previousVelocity = vehicle.velocity();
+        vehicle.update( currentTime, elapsedTime );
+        
+        // Compare squared values to spare the square roots.
+        Vec3 const velocityChange = vehicle.velocity() - previousVelocity;
+        float const maxVelocityChange = accelerationThreshold_ * elapsedTime;
+        bool const resting = ( vehicle.velocity().lengthSquared() < speedThreshold_ * speedThreshold_ ) &&
+                             ( velocityChange.lengthSquared() <= maxVelocityChange * maxVelocityChange );
+        
+        if ( ! resting ) {
+            states_[ i ].restingFrames = 0;
+            
+            // Only moving vehicles wake others, otherwise two resting 
+            // neighbors would keep each other awake forever.
+            if ( ! sleeperIndices_.empty() ) {
+                wakeNeighborsOf( vehicle.position(), wakeRadius_ );
+            }
+        } else if ( ++states_[ i ].restingFrames >= framesUntilSleep_ ) {
+            sleep( i, vehicle );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::wake( size_type index )
+{
+    if ( ( index >= states_.size() ) || ( 0 == states_[ index ].sleeperToken ) ) {
+        return;
+    }
+    
+    VehicleState& state = states_[ index ];
+    
+    // Deleting the token removes it from its bin.
+    delete state.sleeperToken;
+    state.sleeperToken = 0;
+    sleeperIndices_.erase( state.vehicle );
+    state.vehicle = 0;
+    state.restingFrames = 0;
+    ++wokenVehicleCount_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::wakeWithin( Vec3 const& center, float radius )
+{
+    wakeNeighborsOf( center, radius );
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::remove( size_type index )
+{
+    if ( index >= states_.size() ) {
+        return;
+    }
+    
+    forget( index );
+    states_.erase( states_.begin() + index );
+    
+    typedef std::map< AbstractVehicle const*, size_type >::iterator iterator;
+    for ( iterator i = sleeperIndices_.begin(); i != sleeperIndices_.end(); ++i ) {
+        if ( i->second > index ) {
+            --( i->second );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::reset()
+{
+    for ( size_type i = 0; i < states_.size(); ++i ) {
+        delete states_[ i ].sleeperToken;
+    }
+    
+    states_.clear();
+    sleeperIndices_.clear();
+    fellAsleepVehicleCount_ = 0;
+    wokenVehicleCount_ = 0;
+}
+
+
+
+bool 
+OpenSteer::SleepScheduler::isAsleep( size_type index ) const
+{
+    return ( index < states_.size() ) && ( 0 != states_[ index ].sleeperToken );
+}
+
+
+
+OpenSteer::SleepScheduler::size_type 
+OpenSteer::SleepScheduler::sleepingVehicleCount() const
+{
+    return sleeperIndices_.size();
+}
+
+
+
+OpenSteer::SleepScheduler::size_type 
+OpenSteer::SleepScheduler::awakeVehicleCount() const
+{
+    return states_.size() - sleeperIndices_.size();
+}
+
+
+
+OpenSteer::SleepScheduler::size_type 
+OpenSteer::SleepScheduler::fellAsleepVehicleCount() const
+{
+    return fellAsleepVehicleCount_;
+}
+
+
+
+OpenSteer::SleepScheduler::size_type 
+OpenSteer::SleepScheduler::wokenVehicleCount() const
+{
+    return wokenVehicleCount_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::resize( AVGroup const& vehicles )
+{
+    // Forget vehicles removed from the end of the group without a call of
+    // remove. Their pointers might already be dangling, they are only used
+    // as keys.
+    for ( size_type i = vehicles.size(); i < states_.size(); ++i ) {
+        forget( i );
+    }
+    
+    states_.resize( vehicles.size() );
+    
+    // A sleeper replaced by another vehicle at its index mustn't pass its
+    // sleep on.
+    for ( size_type i = 0; i < states_.size(); ++i ) {
+        if ( ( 0 != states_[ i ].sleeperToken ) && ( states_[ i ].vehicle != vehicles[ i ] ) ) {
+            forget( i );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::sleep( size_type index, AbstractVehicle& vehicle )
+{
+    assert( 0 == states_[ index ].sleeperToken && "Vehicle is already asleep." );
+    
+    vehicle.setSpeed( 0.0f );
+    
+    SleeperToken* token = sleepers_.allocateToken( &vehicle );
+    token->updateForNewPosition( vehicle.position() );
+    states_[ index ].sleeperToken = token;
+    states_[ index ].vehicle = &vehicle;
+    sleeperIndices_[ &vehicle ] = index;
+    ++fellAsleepVehicleCount_;
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::forget( size_type index )
+{
+    VehicleState& state = states_[ index ];
+    if ( 0 != state.sleeperToken ) {
+        delete state.sleeperToken;
+        sleeperIndices_.erase( state.vehicle );
+    }
+    state = VehicleState();
+}
+
+
+
+void 
+OpenSteer::SleepScheduler::wakeNeighborsOf( Vec3 const& position, float radius )
+{
+    neighbors_.clear();
+    queryToken_->findNeighbors( position, radius, neighbors_ );
+    
+    for ( size_type i = 0; i < neighbors_.size(); ++i ) {
+        std::map< AbstractVehicle const*, size_type >::iterator const found = sleeperIndices_.find( neighbors_[ i ] );
+        assert( found != sleeperIndices_.end() && "Sleeper database and index map disagree." );
+        
+        wake( found->second );
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the stopwatch.
+ */
+#include "OpenSteer/Stopwatch.h"
+
+#if defined (_XBOX)
+    #include <xtl.h>
+#elif defined (_WIN32)
+    #include <windows.h>
+#elif defined (__APPLE__)
+    #include <sys/time.h> 
+#else
+    #include <time.h>
+#endif
+
+
+
+OpenSteer::Stopwatch::Stopwatch()
+    : start_( now() )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::Stopwatch::restart()
+{
+    start_ = now();
+}
+
+
+
+double 
+OpenSteer::Stopwatch::elapsedSeconds() const
+{
+    return now() - start_;
+}
+
+
+
+double 
+OpenSteer::Stopwatch::now()
+#if defined (_WIN32)
+{
+    LONGLONG counter = 0;
+    LONGLONG frequency = 1;
+    QueryPerformanceCounter( reinterpret_cast< LARGE_INTEGER* >( &counter ) );
+    QueryPerformanceFrequency( reinterpret_cast< LARGE_INTEGER* >( &frequency ) );
+    return static_cast< double >( counter ) / static_cast< double >( frequency );
+}
+#elif defined (__APPLE__)
+{
+    timeval t;
+    gettimeofday( &t, 0 );
+    return t.tv_sec + t.tv_usec / 1000000.0;
+}
+#else
+{
+    timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec / 1000000000.0;
+}
+#endif
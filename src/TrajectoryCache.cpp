@@ -0,0 +1,135 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the sampled trajectory of a vehicle.
+ */
+#include "OpenSteer/TrajectoryCache.h"
+
+// Include std::ceil
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::AbstractVehicle
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::interpolate
+#include "OpenSteer/Utilities.h"
+
+
+
+OpenSteer::TrajectoryCache::TrajectoryCache()
+    : positions_(), horizon_( 0.0f ), step_( 1.0f ), inverseStep_( 1.0f )
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::TrajectoryCache::sample( AbstractVehicle const& vehicle, 
+                                    float horizon, 
+                                    float step )
+{
+    assert( horizon >= 0.0f && "horizon must not be negative." );
+    assert( step > 0.0f && "step must be greater than 0." );
+    
+    // the last sample lies at or just beyond the horizon
+    size_type const intervals = static_cast< size_type >( std::ceil( horizon / step ) );
+    
+    horizon_ = intervals * step;
+    step_ = step;
+    inverseStep_ = 1.0f / step;
+    
+    positions_.resize( intervals + 1 );
+    for ( size_type i = 0; i <= intervals; ++i ) {
+        positions_[ i ] = vehicle.predictFuturePosition( i * step );
+    }
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::TrajectoryCache::predictFuturePosition( float predictionTime ) const
+{
+    if ( positions_.empty() ) {
+        return Vec3::zero;
+    }
+    
+    if ( predictionTime <= 0.0f ) {
+        return positions_.front();
+    }
+    
+    if ( predictionTime >= horizon_ ) {
+        return positions_.back();
+    }
+    
+    float const sampleTime = predictionTime * inverseStep_;
+    size_type const i = static_cast< size_type >( sampleTime );
+    
+    // rounding may put sampleTime onto the last sample
+    if ( i + 1 >= positions_.size() ) {
+        return positions_.back();
+    }
+    
+    return interpolate( sampleTime - i, positions_[ i ], positions_[ i + 1 ] );
+}
+
+
+
+bool 
+OpenSteer::TrajectoryCache::covers( float predictionTime ) const
+{
+    return ! positions_.empty() && 
+           predictionTime >= 0.0f && 
+           predictionTime <= horizon_;
+}
+
+
+
+float 
+OpenSteer::TrajectoryCache::horizon() const
+{
+    return horizon_;
+}
+
+
+
+float 
+OpenSteer::TrajectoryCache::step() const
+{
+    return step_;
+}
+
+
+
+OpenSteer::TrajectoryCache::size_type 
+OpenSteer::TrajectoryCache::sampleCount() const
+{
+    return positions_.size();
+}
@@ -0,0 +1,262 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Implementation of the zone profiler.
+ */
+#include "OpenSteer/ZoneProfiler.h"
+
+// Include std::ostream, std::endl
+#include <ostream>
+
+// Include std::setw
+#include <iomanip>
+
+// Include std::max
+#include <algorithm>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::Stopwatch
+#include "OpenSteer/Stopwatch.h"
+
+// Include OpenSteer::AllocationCounter
+#include "OpenSteer/AllocationCounter.h"
+
+#ifdef _OPENMP
+    // Include omp_in_parallel
+    #include <omp.h>
+#endif
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Totals and the state of the open zones.
+     */
+    struct ZoneState {
+        ZoneProfiler::Totals totals;
+        int depth;
+        double startSeconds;
+        AllocationCounter::size_type startAllocations;
+        AllocationCounter::size_type startBytes;
+        PerformanceCounters::Values startCounters;
+    };
+    
+    
+    ZoneState zones[ ZoneProfiler::zoneCount ];
+    
+    
+    /**
+     * Created on first use, it is opened and closed by @c start and 
+     * @c stop.
+     */
+    PerformanceCounters& 
+    performanceCounters()
+    {
+        static PerformanceCounters counters;
+        return counters;
+    }
+    
+    
+    /**
+     * @c true if called from inside an OpenMP parallel region.
+     */
+    bool 
+    inParallel()
+    {
+#ifdef _OPENMP
+        return 0 != omp_in_parallel();
+#else
+        return false;
+#endif
+    }
+    
+} // anonymous namespace
+
+
+
+bool OpenSteer::ZoneProfiler::active_ = false;
+
+
+
+void 
+OpenSteer::ZoneProfiler::start( bool withCounters )
+{
+    for ( int z = 0; z < zoneCount; ++z ) {
+        ZoneState& zone = zones[ z ];
+        zone.totals.calls = 0;
+        zone.totals.seconds = 0.0;
+        zone.totals.allocations = 0;
+        zone.totals.allocatedBytes = 0;
+        for ( int c = 0; c < PerformanceCounters::counterCount; ++c ) {
+            zone.totals.counters.counts[ c ] = 0.0;
+        }
+        zone.depth = 0;
+    }
+    
+    if ( withCounters ) {
+        performanceCounters().open();
+    } else {
+        performanceCounters().close();
+    }
+    active_ = true;
+}
+
+
+
+void 
+OpenSteer::ZoneProfiler::stop()
+{
+    active_ = false;
+    performanceCounters().close();
+}
+
+
+
+void 
+OpenSteer::ZoneProfiler::enter( Zone zone )
+{
+    assert( zone < zoneCount && "no such zone" );
+    if ( ! active_ || inParallel() ) {
+        return;
+    }
+    
+    ZoneState& state = zones[ zone ];
+    if ( 0 == state.depth++ ) {
+        state.startAllocations = AllocationCounter::allocationCount();
+        state.startBytes = AllocationCounter::allocatedBytes();
+        performanceCounters().read( state.startCounters );
+        state.startSeconds = Stopwatch::now();
+    }
+}
+
+
+
+void 
+OpenSteer::ZoneProfiler::leave( Zone zone )
+{
+    assert( zone < zoneCount && "no such zone" );
+    if ( ! active_ || inParallel() ) {
+        return;
+    }
+    
+    ZoneState& state = zones[ zone ];
+    if ( 0 == state.depth || 0 != --state.depth ) {
+        return;
+    }
+    
+    // Read the clock first to keep reading the counters out of the time.
+    double const seconds = Stopwatch::now() - state.startSeconds;
+    PerformanceCounters::Values counters;
+    performanceCounters().read( counters );
+    
+    ++state.totals.calls;
+    state.totals.seconds += seconds;
+    state.totals.allocations += AllocationCounter::allocationCount() - state.startAllocations;
+    state.totals.allocatedBytes += AllocationCounter::allocatedBytes() - state.startBytes;
+    for ( int c = 0; c < PerformanceCounters::counterCount; ++c ) {
+        state.totals.counters.counts[ c ] += counters.counts[ c ] - state.startCounters.counts[ c ];
+    }
+}
+
+
+
+OpenSteer::ZoneProfiler::Totals const& 
+OpenSteer::ZoneProfiler::totals( Zone zone )
+{
+    assert( zone < zoneCount && "no such zone" );
+    return zones[ zone ].totals;
+}
+
+
+
+OpenSteer::PerformanceCounters const& 
+OpenSteer::ZoneProfiler::counters()
+{
+    return performanceCounters();
+}
+
+
+
+char const* 
+OpenSteer::ZoneProfiler::name( Zone zone )
+{
+    static char const* const names[ zoneCount ] = {
+        "update",
+        "proximity",
+        "draw" };
+    
+    assert( zone < zoneCount && "no such zone" );
+    return names[ zone ];
+}
+
+
+
+void 
+OpenSteer::ZoneProfiler::report( std::ostream& out, 
+                                 size_type frameCount, 
+                                 size_type agentCount )
+{
+    PerformanceCounters const& hardware = performanceCounters();
+    if ( 0 == hardware.availableCount() ) {
+        out << "hardware counters:   unavailable";
+        if ( ! hardware.errorMessage().empty() ) {
+            out << " (" << hardware.errorMessage() << ")";
+        }
+        out << std::endl;
+    }
+    
+    double const frames = static_cast< double >( std::max( frameCount, size_type( 1 ) ) );
+    double const agentFrames = frames * static_cast< double >( std::max( agentCount, size_type( 1 ) ) );
+    
+    for ( int z = 0; z < zoneCount; ++z ) {
+        Totals const& zone = zones[ z ].totals;
+        if ( 0 == zone.calls ) {
+            continue;
+        }
+        
+        out << "zone " << std::left << std::setw( 16 ) << name( Zone( z ) ) << std::right
+            << zone.calls / frames << " calls/frame, " 
+            << 1000.0 * zone.seconds / frames << " ms/frame, "
+            << zone.allocations / frames << " allocations/frame, "
+            << zone.allocatedBytes / frames << " bytes/frame" << std::endl;
+        
+        for ( int c = 0; c < PerformanceCounters::counterCount; ++c ) {
+            PerformanceCounters::Counter const counter = PerformanceCounters::Counter( c );
+            if ( ! hardware.available( counter ) ) {
+                continue;
+            }
+            out << "    " << std::left << std::setw( 16 ) << PerformanceCounters::name( counter ) << std::right
+                << std::setw( 14 ) << zone.counters.counts[ c ] / frames << " /frame"
+                << std::setw( 14 ) << zone.counters.counts[ c ] / agentFrames << " /agent" << std::endl;
+        }
+    }
+}
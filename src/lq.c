@@ -59,6 +59,10 @@
 /*           definitions: lqFindNearestHelper lqFindNearestState      */
 /*           Add lqMapOverAllObjects and lqRemoveAllObjects (plus:    */
 /*           lqMapOverAllObjectsInBin and lqRemoveAllObjectsInBin)    */
+/* 10-18-26: Add lqResizeDatabase: objects move to the new bins over  */
+/*           the following updates.  Count the candidates of locality */
+/*           queries (lqMapOverAllObjectsInLocalityCounted), add      */
+/*           lqGetBinPopulationHistogram.                             */
 /*                                                                    */
 /* ------------------------------------------------------------------ */
 
@@ -104,9 +108,24 @@ typedef struct lqInternalDB
     /* extra bin for "everything else" (points outside super-brick) */
     lqClientProxy* other;
 
+    /* while a resize is in progress (see lqResizeDatabase): the bin
+       array of the previous subdivision, its divisions and the index
+       of the next old bin to be emptied, oldBins is NULL otherwise */
+    lqClientProxy** oldBins;
+    int oldDivx, oldDivy, oldDivz;
+    int migrationCursor;
+
 } lqInternalDB;
 
 
+/* ------------------------------------------------------------------ */
+/* Number of old bins emptied by each lqUpdateForNewLocation during a
+   resize, in addition to the moving object itself. */
+
+
+#define LQ_BINS_MIGRATED_PER_UPDATE 8
+
+
 /* ------------------------------------------------------------------ */
 /* Allocate and initialize an LQ database, return a pointer to it.
    The application needs to call this before using the LQ facility.
@@ -139,11 +158,27 @@ lqInternalDB* lqCreateDatabase (float originx, float originy, float originz,
 
 void lqDeleteDatabase(lqDB* lq)
 {
+    free (lq->oldBins);
     free (lq->bins);
     free (lq);
 }
 
 
+/* ------------------------------------------------------------------ */
+/* Allocate a bin array with all bins empty */
+
+lqClientProxy** lqAllocateBins (int bincount);
+
+lqClientProxy** lqAllocateBins (int bincount)
+{
+    int i;
+    int arraysize = sizeof (lqClientProxy*) * bincount;
+    lqClientProxy** bins = (lqClientProxy**) malloc (arraysize);
+    for (i=0; i<bincount; i++) bins[i] = NULL;
+    return bins;
+}
+
+
 /* ------------------------------------------------------------------ */
 /* Given an LQ database object and the nine basic parameters: fill in
    the object's slots, allocate the bin array, and initialize its
@@ -164,14 +199,11 @@ void lqInitDatabase (lqInternalDB* lq,
     lq->divx = divx;
     lq->divy = divy;
     lq->divz = divz;
-    {
-	int i;
-	int bincount = divx * divy * divz;
-	int arraysize = sizeof (lqClientProxy*) * bincount;
-	lq->bins = (lqClientProxy**) malloc (arraysize);
-	for (i=0; i<bincount; i++) lq->bins[i] = NULL;
-    }
+    lq->bins = lqAllocateBins (divx * divy * divz);
     lq->other = NULL;
+    lq->oldBins = NULL;
+    lq->oldDivx = lq->oldDivy = lq->oldDivz = 0;
+    lq->migrationCursor = 0;
 }
 
 
@@ -287,6 +319,86 @@ void lqRemoveFromBin (lqClientProxy* object)
 }
 
 
+/* ------------------------------------------------------------------ */
+/* Moves the objects of the next binCount old bins of a resize in
+   progress into the new bins, and frees the old bin array once all of
+   them are empty.  (Objects never move into old bins, so bins before
+   the cursor stay empty.) */
+
+void lqMigrateOldBins (lqInternalDB* lq, int binCount);
+
+void lqMigrateOldBins (lqInternalDB* lq, int binCount)
+{
+    int oldBinCount = lq->oldDivx * lq->oldDivy * lq->oldDivz;
+    int end = lq->migrationCursor + binCount;
+    if (end > oldBinCount) end = oldBinCount;
+
+    while (lq->migrationCursor < end)
+    {
+	lqClientProxy** bin = &lq->oldBins[lq->migrationCursor++];
+	while (*bin != NULL)
+	{
+	    lqClientProxy* object = *bin;
+	    lqRemoveFromBin (object);
+	    lqAddToBin (object,
+			lqBinForLocation (lq, object->x, object->y, object->z));
+	}
+    }
+
+    if (lq->migrationCursor >= oldBinCount)
+    {
+	free (lq->oldBins);
+	lq->oldBins = NULL;
+    }
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Change the number of subdivisions, see lq.h */
+
+
+void lqResizeDatabase (lqInternalDB* lq, int divx, int divy, int divz)
+{
+    /* complete a previous resize, only one old bin array is kept */
+    lqFinishResize (lq);
+
+    lq->oldBins = lq->bins;
+    lq->oldDivx = lq->divx;
+    lq->oldDivy = lq->divy;
+    lq->oldDivz = lq->divz;
+    lq->migrationCursor = 0;
+
+    lq->divx = divx;
+    lq->divy = divy;
+    lq->divz = divz;
+    lq->bins = lqAllocateBins (divx * divy * divz);
+}
+
+
+int lqResizeInProgress (lqInternalDB* lq)
+{
+    return lq->oldBins != NULL;
+}
+
+
+void lqFinishResize (lqInternalDB* lq)
+{
+    if (lq->oldBins != NULL)
+    {
+	int oldBinCount = lq->oldDivx * lq->oldDivy * lq->oldDivz;
+	lqMigrateOldBins (lq, oldBinCount - lq->migrationCursor);
+    }
+}
+
+
+void lqGetDivisions (lqInternalDB* lq, int* divx, int* divy, int* divz)
+{
+    *divx = lq->divx;
+    *divy = lq->divy;
+    *divz = lq->divz;
+}
+
+
 /* ------------------------------------------------------------------ */
 /* Call for each client object every time its location changes.  For
    example, in an animation application, this would be called each
@@ -305,24 +417,31 @@ void lqUpdateForNewLocation  (lqInternalDB* lq,
     object->y = y;
     object->z = z;
 
-    /* has object moved into a new bin? */
+    /* has object moved into a new bin?  (always true for an object
+       still in the old bins of a resize in progress) */
     if (newBin != object->bin)
     {
 	lqRemoveFromBin (object);
  	lqAddToBin (object, newBin);
     }
+
+    /* continue emptying the old bins of a resize in progress */
+    if (lq->oldBins != NULL)
+	lqMigrateOldBins (lq, LQ_BINS_MIGRATED_PER_UPDATE);
 }
 
 
 /* ------------------------------------------------------------------ */
 /* Given a bin's list of client proxies, traverse the list and invoke
    the given lqCallBackFunction on each object that falls within the
-   search radius.  */
+   search radius.  Adds the number of objects tested to count.  */
 
 
-#define lqTraverseBinClientObjectList(co, radiusSquared, func, state) \
+#define lqTraverseBinClientObjectList(co, radiusSquared, func, state, count) \
     while (co != NULL)                                                \
     {                                                                 \
+	(count)++;                                                    \
+                                                                      \
 	/* compute distance (squared) from this client   */           \
 	/* object to given locality sphere's centerpoint */           \
 	float dx = x - co->x;                                         \
@@ -342,9 +461,13 @@ void lqUpdateForNewLocation  (lqInternalDB* lq,
 /* ------------------------------------------------------------------ */
 /* This subroutine of lqMapOverAllObjectsInLocality efficiently
    traverses of subset of bins specified by max and min bin
-   coordinates. */
+   coordinates.  The bins are those of the current subdivision or,
+   during a resize, of the previous one.  Returns the number of
+   objects tested. */
 
-void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
+int lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq USUSED_PARAM,
+                                           lqClientProxy** bins,
+                                           int divy, int divz,
                                            float x, float y, float z,
                                            float radius,
                                            lqCallBackFunction func,
@@ -356,7 +479,9 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
                                            int maxBinY,
                                            int maxBinZ);
 
-void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
+int lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq USUSED_PARAM,
+					   lqClientProxy** bins,
+					   int divy, int divz,
 					   float x, float y, float z,
 					   float radius,
 					   lqCallBackFunction func,
@@ -370,8 +495,9 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
 {
     int i, j, k;
     int iindex, jindex, kindex;
-    int slab = lq->divy * lq->divz;
-    int row = lq->divz;
+    int count = 0;
+    int slab = divy * divz;
+    int row = divz;
     int istart = minBinX * slab;
     int jstart = minBinY * row;
     int kstart = minBinZ;
@@ -396,7 +522,7 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
 	    for (k = minBinZ; k <= maxBinZ; k++)
 	    {
 		/* get current bin's client object list */
-		bin = &lq->bins[iindex + jindex + kindex];
+		bin = &bins[iindex + jindex + kindex];
 		co = *bin;
 
 #ifdef BOIDS_LQ_DEBUG
@@ -406,13 +532,15 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
 		lqTraverseBinClientObjectList (co,
 					       radiusSquared,
 					       func,
-					       clientQueryState);
+					       clientQueryState,
+					       count);
 		kindex += 1;
 	    }
 	    jindex += row;
 	}
 	iindex += slab;
     }
+    return count;
 }
 
 
@@ -421,18 +549,19 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
    we need to check for objects in the catch-all "other" bin which
    holds any object which are not inside the regular sub-bricks  */
 
-void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
-                                 float x, float y, float z,
-                                 float radius,
-                                 lqCallBackFunction func,
-                                 void* clientQueryState);
-
-void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
-				 float x, float y, float z,
-				 float radius,
-				 lqCallBackFunction func,
-				 void* clientQueryState)
+int lqMapOverAllOutsideObjects (lqInternalDB* lq, 
+                                float x, float y, float z,
+                                float radius,
+                                lqCallBackFunction func,
+                                void* clientQueryState);
+
+int lqMapOverAllOutsideObjects (lqInternalDB* lq, 
+				float x, float y, float z,
+				float radius,
+				lqCallBackFunction func,
+				void* clientQueryState)
 {
+    int count = 0;
     lqClientProxy* co = lq->other;
     float radiusSquared = radius * radius;
 
@@ -440,7 +569,50 @@ void lqMapOverAllOutsideObjects (lqInternalDB* lq,
     lqTraverseBinClientObjectList (co,
 				   radiusSquared,
 				   func,
-				   clientQueryState);
+				   clientQueryState,
+				   count);
+    return count;
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Compute the range of bins of a subdivision (divx, divy, divz) of the
+   super-brick overlapped by the query sphere, clipped to the
+   super-brick.  Returns non-zero if clipping was needed.  */
+
+int lqClipLocalityToBins (lqInternalDB* lq,
+                          int divx, int divy, int divz,
+                          float x, float y, float z,
+                          float radius,
+                          int* minBinX, int* minBinY, int* minBinZ,
+                          int* maxBinX, int* maxBinY, int* maxBinZ);
+
+int lqClipLocalityToBins (lqInternalDB* lq,
+			  int divx, int divy, int divz,
+			  float x, float y, float z,
+			  float radius,
+			  int* minBinX, int* minBinY, int* minBinZ,
+			  int* maxBinX, int* maxBinY, int* maxBinZ)
+{
+    int partlyOut = 0;
+
+    /* compute min and max bin coordinates for each dimension */
+    *minBinX = (int) ((((x - radius) - lq->originx) / lq->sizex) * divx);
+    *minBinY = (int) ((((y - radius) - lq->originy) / lq->sizey) * divy);
+    *minBinZ = (int) ((((z - radius) - lq->originz) / lq->sizez) * divz);
+    *maxBinX = (int) ((((x + radius) - lq->originx) / lq->sizex) * divx);
+    *maxBinY = (int) ((((y + radius) - lq->originy) / lq->sizey) * divy);
+    *maxBinZ = (int) ((((z + radius) - lq->originz) / lq->sizez) * divz);
+
+    /* clip bin coordinates */
+    if (*minBinX < 0)     {partlyOut = 1; *minBinX = 0;}
+    if (*minBinY < 0)     {partlyOut = 1; *minBinY = 0;}
+    if (*minBinZ < 0)     {partlyOut = 1; *minBinZ = 0;}
+    if (*maxBinX >= divx) {partlyOut = 1; *maxBinX = divx - 1;}
+    if (*maxBinY >= divy) {partlyOut = 1; *maxBinY = divy - 1;}
+    if (*maxBinZ >= divz) {partlyOut = 1; *maxBinZ = divz - 1;}
+
+    return partlyOut;
 }
 
 
@@ -470,7 +642,24 @@ void lqMapOverAllObjectsInLocality (lqInternalDB* lq,
 				    lqCallBackFunction func,
 				    void* clientQueryState)
 {
-    int partlyOut = 0;
+    lqMapOverAllObjectsInLocalityCounted (lq, x, y, z, radius, func,
+					  clientQueryState);
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Like lqMapOverAllObjectsInLocality, returns the number of objects
+   tested (see lq.h) */
+
+
+int lqMapOverAllObjectsInLocalityCounted (lqInternalDB* lq, 
+					  float x, float y, float z,
+					  float radius,
+					  lqCallBackFunction func,
+					  void* clientQueryState)
+{
+    int count = 0;
+    int partlyOut;
     int completelyOutside = 
 	(((x + radius) < lq->originx) ||
 	 ((y + radius) < lq->originy) ||
@@ -483,40 +672,52 @@ void lqMapOverAllObjectsInLocality (lqInternalDB* lq,
     /* is the sphere completely outside the "super brick"? */
     if (completelyOutside)
     {
-	lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
-				    clientQueryState);
-	return;
+	return lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
+					   clientQueryState);
     }
 
     /* compute min and max bin coordinates for each dimension */
-    minBinX = (int) ((((x - radius) - lq->originx) / lq->sizex) * lq->divx);
-    minBinY = (int) ((((y - radius) - lq->originy) / lq->sizey) * lq->divy);
-    minBinZ = (int) ((((z - radius) - lq->originz) / lq->sizez) * lq->divz);
-    maxBinX = (int) ((((x + radius) - lq->originx) / lq->sizex) * lq->divx);
-    maxBinY = (int) ((((y + radius) - lq->originy) / lq->sizey) * lq->divy);
-    maxBinZ = (int) ((((z + radius) - lq->originz) / lq->sizez) * lq->divz);
-
-    /* clip bin coordinates */
-    if (minBinX < 0)         {partlyOut = 1; minBinX = 0;}
-    if (minBinY < 0)         {partlyOut = 1; minBinY = 0;}
-    if (minBinZ < 0)         {partlyOut = 1; minBinZ = 0;}
-    if (maxBinX >= lq->divx) {partlyOut = 1; maxBinX = lq->divx - 1;}
-    if (maxBinY >= lq->divy) {partlyOut = 1; maxBinY = lq->divy - 1;}
-    if (maxBinZ >= lq->divz) {partlyOut = 1; maxBinZ = lq->divz - 1;}
+    partlyOut = lqClipLocalityToBins (lq, lq->divx, lq->divy, lq->divz,
+				      x, y, z, radius,
+				      &minBinX, &minBinY, &minBinZ,
+				      &maxBinX, &maxBinY, &maxBinZ);
 
     /* map function over outside objects if necessary (if clipped) */
     if (partlyOut) 
-	lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
-				    clientQueryState);
+	count += lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
+					     clientQueryState);
     
     /* map function over objects in bins */
-    lqMapOverAllObjectsInLocalityClipped (lq,
-					  x, y, z,
-					  radius,
-					  func,
-					  clientQueryState,
-					  minBinX, minBinY, minBinZ,
-					  maxBinX, maxBinY, maxBinZ);
+    count += lqMapOverAllObjectsInLocalityClipped (lq,
+						   lq->bins,
+						   lq->divy, lq->divz,
+						   x, y, z,
+						   radius,
+						   func,
+						   clientQueryState,
+						   minBinX, minBinY, minBinZ,
+						   maxBinX, maxBinY, maxBinZ);
+
+    /* during a resize, also map over the objects left in old bins */
+    if (lq->oldBins != NULL)
+    {
+	lqClipLocalityToBins (lq, lq->oldDivx, lq->oldDivy, lq->oldDivz,
+			      x, y, z, radius,
+			      &minBinX, &minBinY, &minBinZ,
+			      &maxBinX, &maxBinY, &maxBinZ);
+	count += lqMapOverAllObjectsInLocalityClipped (lq,
+						       lq->oldBins,
+						       lq->oldDivy,
+						       lq->oldDivz,
+						       x, y, z,
+						       radius,
+						       func,
+						       clientQueryState,
+						       minBinX, minBinY,
+						       minBinZ, maxBinX,
+						       maxBinY, maxBinZ);
+    }
+    return count;
 }
 
 
@@ -625,6 +826,17 @@ void lqMapOverAllObjects (lqInternalDB* lq,
     {
 	lqMapOverAllObjectsInBin (lq->bins[i], func, clientQueryState);
     }
+
+    /* objects left in old bins of a resize in progress */
+    if (lq->oldBins != NULL)
+    {
+	bincount = lq->oldDivx * lq->oldDivy * lq->oldDivz;
+	for (i=lq->migrationCursor; i<bincount; i++)
+	{
+	    lqMapOverAllObjectsInBin (lq->oldBins[i], func, clientQueryState);
+	}
+    }
+
     lqMapOverAllObjectsInBin (lq->other, func, clientQueryState);
 }
 
@@ -655,9 +867,13 @@ void lqGetBinPopulationStats (lqInternalDB* lq,
     int maxPop = 0;
     int totalCount = 0;
     int nonEmptyBinCount = 0;
-    int bincount = lq->divx * lq->divy * lq->divz;
+    int bincount;
     int i;
 
+    /* the statistics are those of the current subdivision */
+    lqFinishResize (lq);
+    bincount = lq->divx * lq->divy * lq->divz;
+
     for (i=0; i<bincount; i++)
     {
         /* clear the counter */
@@ -682,6 +898,35 @@ void lqGetBinPopulationStats (lqInternalDB* lq,
     *average = ((float) totalCount) / ((float) nonEmptyBinCount);
 }
 
+
+/* ------------------------------------------------------------------ */
+/* Histogram of bin populations (except "other"): histogram[i] is the
+   number of bins holding i objects, histogram[size-1] the number of
+   bins holding size-1 or more */
+
+void lqGetBinPopulationHistogram (lqInternalDB* lq,
+                                  int* histogram,
+                                  int size)
+{
+    int bincount;
+    int i;
+
+    for (i=0; i<size; i++) histogram[i] = 0;
+    if (size <= 0) return;
+
+    /* the statistics are those of the current subdivision */
+    lqFinishResize (lq);
+    bincount = lq->divx * lq->divy * lq->divz;
+
+    for (i=0; i<bincount; i++)
+    {
+        int objectCount = 0;
+	lqMapOverAllObjectsInBin (lq->bins[i], lqgbpsCounter, &objectCount);
+        if (objectCount >= size) objectCount = size - 1;
+        histogram[objectCount]++;
+    }
+}
+
 #endif /* NO_LQ_BIN_STATS */
 
 
@@ -700,7 +945,11 @@ void lqGetBinPopulationStats (lqInternalDB* lq,
 void lqRemoveAllObjects (lqInternalDB* lq)
 {
     int i;
-    int bincount = lq->divx * lq->divy * lq->divz;
+    int bincount;
+
+    /* first move objects left in old bins of a resize in progress */
+    lqFinishResize (lq);
+    bincount = lq->divx * lq->divy * lq->divz;
     for (i=0; i<bincount; i++)
     {
 	lqRemoveAllObjectsInBin (lq->bins[i]);
@@ -30,6 +30,76 @@
 //
 // Main: top level routine for OpenSteerDemo application
 //
+// Without arguments the interactive demo is started.  To run a PlugIn
+// without graphics (for benchmarks and batch runs):
+//
+//     OpenSteerDemo --headless "PlugIn name" [--frames 1000] [--dt 0.0166]
+//                   [--option name=value] ... [--seed n] [--profile]
+//                   [--allocations] [--zero-allocations n]
+//
+// --profile adds the time, the heap allocations and the hardware counters
+// (cycles, instructions, cache and branch misses, where the system
+// provides them) of the update, proximity query and draw zones per frame
+// and per vehicle, --allocations the same without hardware counters.
+// --zero-allocations n fails the run if an update allocates from frame n
+// on, when the simulation should have reached its steady state.
+//
+// Adding --sweep or --worlds runs many independent worlds of the PlugIn
+// concurrently instead (for parameter sweeps), one for each combination of
+// the swept values, each combination repeated n times:
+//
+//     OpenSteerDemo --headless Boids --sweep separationWeight=8,12,16
+//                   --sweep cohesionWeight=4,8 [--worlds n] ...
+//
+// PlugIns built as shared libraries are loaded with --plugin, which may be
+// given several times, both for the interactive demo and before --headless:
+//
+//     OpenSteerDemo --plugin ./libMyPlugIn.so [--headless "My PlugIn" ...]
+//
+// The reference and an optimized code path of a PlugIn, selected by its
+// options, are checked to behave alike by running it with each and
+// comparing the states of all vehicles after every frame (both must set
+// the same options):
+//
+//     OpenSteerDemo --headless Boids --reference proximity=bruteforce
+//                   --optimized proximity=lq [--tolerance 0.0001] ...
+//
+// The performance regression check runs the scenarios of a baseline file
+// and fails if one got slower or allocates more than recorded.  Timings
+// are only comparable on one machine, so test/performance/scenarios.txt
+// has no recorded metrics: --record measures its scenarios and writes
+// them with the metrics to a baseline of this machine to check against:
+//
+//     OpenSteerDemo --regression test/performance/scenarios.txt
+//                   --record baseline.txt [--repetitions n]
+//     OpenSteerDemo --regression baseline.txt [--repetitions n]
+//
+// Metrics (frame times, agent and neighbor counts, bin statistics) are
+// served for Prometheus to scrape at http://host:port/metrics from a
+// background thread and/or written to a file every few seconds, in any
+// mode.  The file is the fallback when the port can't be opened.  Only
+// local connections are accepted unless --metrics-address names another
+// interface (0.0.0.0 for all):
+//
+//     OpenSteerDemo [--metrics-port 9464] [--metrics-address 127.0.0.1]
+//                   [--metrics-file f.prom] [--metrics-interval seconds] ...
+//
+// The flight recorder keeps the recent work of each agent (neighbors seen,
+// obstacles tested, the branch taken to avoid neighbors).  It is written
+// to prefix<frame>.flight when an update takes longer than the threshold
+// (and with the d key in the interactive demo), --print-flight prints
+// such a file:
+//
+//     OpenSteerDemo [--flight-threshold ms] [--flight-prefix prefix] ...
+//     OpenSteerDemo --print-flight flight-1234.flight
+//
+// With a frame budget the simulation's fidelity is lowered step by step
+// (fewer neighbors, less annotation, distant agents updated less often)
+// while update and draw take longer than the budget, and restored when
+// there is headroom again.  Each decision is printed:
+//
+//     OpenSteerDemo [--frame-budget ms] ...
+//
 //  5-29-02 cwr: created
 //
 //
@@ -38,13 +108,360 @@
 
 #include "OpenSteer/OpenSteerDemo.h"        // OpenSteerDemo application
 #include "OpenSteer/Draw.h"                 // OpenSteerDemo graphics
+#include "OpenSteer/ZoneProfiler.h"         // --profile
+#include "OpenSteer/MetricsExporter.h"      // --metrics-port, --metrics-file
+#include "OpenSteer/FlightRecorder.h"       // --flight-threshold
+#include "OpenSteer/FrameBudget.h"          // --frame-budget
 
 // To include EXIT_SUCCESS
 #include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    // load the shared libraries named by --plugin and remove those
+    // arguments, returns false if a library can't be loaded
+    bool loadPlugIns (int& argc, char **argv)
+    {
+        int kept = 1;
+        for (int i = 1; i < argc; i++)
+        {
+            if (((i + 1) < argc) && (std::strcmp (argv[i], "--plugin") == 0))
+            {
+                const char* fileName = argv[++i];
+                std::string errorMessage;
+                if (! OpenSteer::PlugIn::loadLibrary (fileName, errorMessage))
+                {
+                    std::cerr << "can't load PlugIn library " << fileName
+                              << ": " << errorMessage << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                argv[kept++] = argv[i];
+            }
+        }
+        argc = kept;
+        argv[argc] = NULL;
+        return true;
+    }
+
+
+    // exports the metrics until the program exits (also through exit())
+    OpenSteer::MetricsExporter& metricsExporter (void)
+    {
+        static OpenSteer::MetricsExporter exporter;
+        return exporter;
+    }
+
+
+    // start exporting metrics as asked by --metrics-port,
+    // --metrics-address, --metrics-file and --metrics-interval and remove
+    // those arguments, returns false if neither the port nor the file can
+    // be used
+    bool startMetrics (int& argc, char **argv)
+    {
+        int port = -1;
+        const char* address = "127.0.0.1";
+        const char* fileName = NULL;
+        double interval = 5;
+
+        int kept = 1;
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = (i + 1) < argc;
+            if (hasValue && (std::strcmp (argv[i], "--metrics-port") == 0))
+                port = std::atoi (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--metrics-address") == 0))
+                address = argv[++i];
+            else if (hasValue && (std::strcmp (argv[i], "--metrics-file") == 0))
+                fileName = argv[++i];
+            else if (hasValue && (std::strcmp (argv[i], "--metrics-interval") == 0))
+                interval = std::atof (argv[++i]);
+            else
+                argv[kept++] = argv[i];
+        }
+        argc = kept;
+        argv[argc] = NULL;
+
+        if ((port < 0) && (fileName == NULL)) return true;
+
+        OpenSteer::MetricsExporter& exporter = metricsExporter ();
+        if ((port >= 0) && ! exporter.listen (port, address))
+        {
+            std::cerr << "can't serve metrics: " << exporter.errorMessage ()
+                      << std::endl;
+            if (fileName == NULL) return false;
+            std::cerr << "writing them to " << fileName << " instead"
+                      << std::endl;
+        }
+        if (fileName != NULL) exporter.dumpTo (fileName, interval);
+
+        if (! exporter.start ())
+        {
+            std::cerr << "can't export metrics: " << exporter.errorMessage ()
+                      << std::endl;
+            return false;
+        }
+        if (exporter.port () >= 0)
+            std::cerr << "serving metrics on " << address << " port "
+                      << exporter.port () << std::endl;
+        return true;
+    }
+
+
+    // dump the flight recorder on slow updates as asked by
+    // --flight-threshold and --flight-prefix and remove those arguments
+    void setUpFlightRecorder (int& argc, char **argv)
+    {
+        double threshold = 0;
+        std::string prefix = "flight-";
+
+        int kept = 1;
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = (i + 1) < argc;
+            if (hasValue && (std::strcmp (argv[i], "--flight-threshold") == 0))
+                threshold = std::atof (argv[++i]) / 1000;
+            else if (hasValue && (std::strcmp (argv[i], "--flight-prefix") == 0))
+                prefix = argv[++i];
+            else
+                argv[kept++] = argv[i];
+        }
+        argc = kept;
+        argv[argc] = NULL;
+
+        OpenSteer::FlightRecorder::setSpikeDump (prefix, threshold);
+    }
+
+
+    // keep frames within the time asked for by --frame-budget and remove
+    // that argument
+    void setUpFrameBudget (int& argc, char **argv)
+    {
+        int kept = 1;
+        for (int i = 1; i < argc; i++)
+        {
+            if (((i + 1) < argc) && (std::strcmp (argv[i], "--frame-budget") == 0))
+            {
+                const float seconds = (float) std::atof (argv[++i]) / 1000;
+                OpenSteer::OpenSteerDemo::frameBudget.setBudget (seconds);
+                OpenSteer::OpenSteerDemo::frameBudget.setLog (&std::cerr);
+            }
+            else
+            {
+                argv[kept++] = argv[i];
+            }
+        }
+        argc = kept;
+        argv[argc] = NULL;
+    }
+
+
+    // print the flight recorder dump named by --print-flight
+    int printFlightRecord (int argc, char **argv)
+    {
+        if (argc != 3)
+        {
+            std::cerr << "usage: " << argv[0] << " --print-flight file"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<OpenSteer::FlightRecorder::Record> records;
+        std::string errorMessage;
+        if (! OpenSteer::FlightRecorder::readDump (argv[2], records, errorMessage))
+        {
+            std::cerr << errorMessage << std::endl;
+            return EXIT_FAILURE;
+        }
+        OpenSteer::FlightRecorder::print (std::cout, records);
+        return EXIT_SUCCESS;
+    }
+
+
+    // parse the headless command line and run the PlugIn it names
+    int runHeadless (int argc, char **argv)
+    {
+        const char* plugInName = NULL;
+        int frameCount = 1000;
+        int steadyStateFrame = -1;
+        float elapsedTime = 1.0f / 60.0f;
+        std::vector<std::string> options;
+        std::vector<std::string> sweeps;
+        int replicaCount = 1;
+        bool batch = false;
+        bool seeded = false;
+        unsigned int seed = 1;
+        std::vector<std::string> referenceOptions;
+        std::vector<std::string> optimizedOptions;
+        float tolerance = 0;
+        bool compare = false;
+
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = (i + 1) < argc;
+            if (hasValue && (std::strcmp (argv[i], "--headless") == 0))
+                plugInName = argv[++i];
+            else if (hasValue && (std::strcmp (argv[i], "--frames") == 0))
+                frameCount = std::atoi (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--dt") == 0))
+                elapsedTime = (float) std::atof (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--option") == 0))
+                options.push_back (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--sweep") == 0))
+            {
+                sweeps.push_back (argv[++i]);
+                batch = true;
+            }
+            else if (hasValue && (std::strcmp (argv[i], "--worlds") == 0))
+            {
+                replicaCount = std::atoi (argv[++i]);
+                batch = true;
+            }
+            else if (std::strcmp (argv[i], "--profile") == 0)
+                OpenSteer::ZoneProfiler::start (true);
+            else if (std::strcmp (argv[i], "--allocations") == 0)
+            {
+                if (! OpenSteer::ZoneProfiler::active ())
+                    OpenSteer::ZoneProfiler::start (false);
+            }
+            else if (hasValue && (std::strcmp (argv[i], "--zero-allocations") == 0))
+                steadyStateFrame = std::atoi (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--reference") == 0))
+            {
+                referenceOptions.push_back (argv[++i]);
+                compare = true;
+            }
+            else if (hasValue && (std::strcmp (argv[i], "--optimized") == 0))
+            {
+                optimizedOptions.push_back (argv[++i]);
+                compare = true;
+            }
+            else if (hasValue && (std::strcmp (argv[i], "--tolerance") == 0))
+            {
+                tolerance = (float) std::atof (argv[++i]);
+                compare = true;
+            }
+            else if (hasValue && (std::strcmp (argv[i], "--seed") == 0))
+            {
+                seed = (unsigned int) std::strtoul (argv[++i], NULL, 10);
+                seeded = true;
+            }
+            else
+            {
+                std::cerr << "unknown or incomplete argument: " << argv[i]
+                          << std::endl
+                          << "usage: " << argv[0] << " [--plugin library] ..."
+                          << " --headless \"PlugIn name\""
+                          << " [--frames n] [--dt seconds]"
+                          << " [--option name=value] ..."
+                          << " [--sweep name=v1,v2,...] ... [--worlds n]"
+                          << " [--seed n] [--profile] [--allocations]"
+                          << " [--zero-allocations n]"
+                          << " [--reference name=value] ..."
+                          << " [--optimized name=value] ... [--tolerance t]"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // random placement in the PlugIns uses rand
+        if (seeded) std::srand (seed);
+
+        if (compare)
+            return OpenSteer::OpenSteerDemo::runComparison (plugInName,
+                                                            frameCount,
+                                                            elapsedTime,
+                                                            options,
+                                                            referenceOptions,
+                                                            optimizedOptions,
+                                                            tolerance,
+                                                            seed);
+
+        if (batch)
+            return OpenSteer::OpenSteerDemo::runBatch (plugInName,
+                                                       frameCount,
+                                                       elapsedTime,
+                                                       options,
+                                                       sweeps,
+                                                       replicaCount);
+
+        // without --zero-allocations no frame is in the steady state
+        if (steadyStateFrame < 0) steadyStateFrame = frameCount;
+
+        return OpenSteer::OpenSteerDemo::runHeadless (plugInName,
+                                                      frameCount,
+                                                      elapsedTime,
+                                                      options,
+                                                      steadyStateFrame);
+    }
+
+
+
+    // parse the regression command line and run the baseline's scenarios
+    int runRegression (int argc, char **argv)
+    {
+        const char* baselineFileName = NULL;
+        const char* recordFileName = NULL;
+        int repetitions = 0;
+
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = (i + 1) < argc;
+            if (hasValue && (std::strcmp (argv[i], "--regression") == 0))
+                baselineFileName = argv[++i];
+            else if (hasValue && (std::strcmp (argv[i], "--repetitions") == 0))
+                repetitions = std::atoi (argv[++i]);
+            else if (hasValue && (std::strcmp (argv[i], "--record") == 0))
+                recordFileName = argv[++i];
+            else
+            {
+                std::cerr << "unknown or incomplete argument: " << argv[i]
+                          << std::endl
+                          << "usage: " << argv[0] << " [--plugin library] ..."
+                          << " --regression baseline"
+                          << " [--repetitions n] [--record file]"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        return OpenSteer::OpenSteerDemo::runRegression (baselineFileName,
+                                                        repetitions,
+                                                        recordFileName);
+    }
+
+} // anonymous namespace
 
 
 int main (int argc, char **argv) 
 {
+    // load PlugIns from shared libraries before any is looked up
+    if (! loadPlugIns (argc, argv)) return EXIT_FAILURE;
+
+    // export metrics from a background thread if asked to
+    if (! startMetrics (argc, argv)) return EXIT_FAILURE;
+
+    // dump what the agents did when an update is too slow
+    setUpFlightRecorder (argc, argv);
+
+    // lower fidelity when frames take longer than a budget
+    setUpFrameBudget (argc, argv);
+
+    // run without graphics if asked to
+    if ((argc > 1) && (std::strcmp (argv[1], "--headless") == 0))
+        return runHeadless (argc, argv);
+    if ((argc > 1) && (std::strcmp (argv[1], "--regression") == 0))
+        return runRegression (argc, argv);
+    if ((argc > 1) && (std::strcmp (argv[1], "--print-flight") == 0))
+        return printFlightRecord (argc, argv);
+
     // initialize OpenSteerDemo application
     OpenSteer::OpenSteerDemo::initialize ();
 
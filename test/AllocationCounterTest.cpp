@@ -0,0 +1,222 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AllocationCounter.
+ */
+#include "AllocationCounterTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::nothrow
+#include <new>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::AllocationCounterTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    AllocationCounter::size_type forbiddenCount = 0;
+    AllocationCounter::size_type forbiddenBytes = 0;
+    
+    
+    void 
+    countForbidden( AllocationCounter::size_type bytes )
+    {
+        ++forbiddenCount;
+        forbiddenBytes += bytes;
+    }
+    
+    
+#if defined( __cpp_aligned_new )
+    struct alignas( 64 ) CacheLine {
+        float values[ 16 ];
+    };
+#endif
+    
+} // anonymous namespace
+
+
+
+OpenSteer::AllocationCounterTest::AllocationCounterTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::AllocationCounterTest::~AllocationCounterTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::AllocationCounterTest::setUp()
+{
+    TestFixture::setUp();
+    forbiddenCount = 0;
+    forbiddenBytes = 0;
+    AllocationCounter::setForbiddenAllocationHandler( countForbidden );
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::tearDown()
+{
+    AllocationCounter::forbidAllocations( false );
+    AllocationCounter::setForbiddenAllocationHandler( 0 );
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testCountsAllocations()
+{
+    AllocationCounter::size_type const count = AllocationCounter::allocationCount();
+    AllocationCounter::size_type const bytes = AllocationCounter::allocatedBytes();
+    
+    // Volatile pointers keep the compiler from eliding the allocations.
+    int* volatile const single = new int( 1 );
+    char* volatile const array = new char[ 100 ];
+    
+    CPPUNIT_ASSERT_EQUAL( count + 2, AllocationCounter::allocationCount() );
+    CPPUNIT_ASSERT( AllocationCounter::allocatedBytes() >= bytes + sizeof( int ) + 100 );
+    
+    delete single;
+    delete [] array;
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testCountsNothrowAndAlignedAllocations()
+{
+    AllocationCounter::size_type const count = AllocationCounter::allocationCount();
+    
+    int* volatile const single = new ( std::nothrow ) int( 1 );
+    char* volatile const array = new ( std::nothrow ) char[ 100 ];
+    CPPUNIT_ASSERT( 0 != single );
+    CPPUNIT_ASSERT( 0 != array );
+    CPPUNIT_ASSERT_EQUAL( count + 2, AllocationCounter::allocationCount() );
+    delete single;
+    delete [] array;
+    
+#if defined( __cpp_aligned_new )
+    CacheLine* volatile const line = new CacheLine;
+    CacheLine* volatile const lines = new CacheLine[ 3 ];
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), reinterpret_cast< std::size_t >( line ) % 64 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), reinterpret_cast< std::size_t >( lines ) % 64 );
+    CPPUNIT_ASSERT_EQUAL( count + 4, AllocationCounter::allocationCount() );
+    delete line;
+    delete [] lines;
+#endif
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testForbiddenAllocationCallsHandler()
+{
+    int* volatile allocated = 0;
+    {
+        AllocationCounter::ForbiddenScope noAllocations;
+        allocated = new int( 2 );
+    }
+    delete allocated;
+    
+    CPPUNIT_ASSERT_EQUAL( AllocationCounter::size_type( 1 ), forbiddenCount );
+    CPPUNIT_ASSERT_EQUAL( AllocationCounter::size_type( sizeof( int ) ), forbiddenBytes );
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testForbiddenScopeRestores()
+{
+    CPPUNIT_ASSERT( ! AllocationCounter::allocationsForbidden() );
+    {
+        AllocationCounter::ForbiddenScope outer;
+        {
+            AllocationCounter::ForbiddenScope inner;
+            CPPUNIT_ASSERT( AllocationCounter::allocationsForbidden() );
+        }
+        CPPUNIT_ASSERT( AllocationCounter::allocationsForbidden() );
+    }
+    CPPUNIT_ASSERT( ! AllocationCounter::allocationsForbidden() );
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testAllocationFreeCodePasses()
+{
+    std::vector< int > neighbors;
+    neighbors.reserve( 64 );
+    {
+        AllocationCounter::ForbiddenScope noAllocations;
+        for ( int frame = 0; frame < 10; ++frame ) {
+            neighbors.clear();
+            for ( int i = 0; i < 64; ++i ) {
+                neighbors.push_back( i );
+            }
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL( AllocationCounter::size_type( 0 ), forbiddenCount );
+}
+
+
+
+void 
+OpenSteer::AllocationCounterTest::testUncountedScope()
+{
+    AllocationCounter::ForbiddenScope noAllocations;
+    AllocationCounter::size_type const count = AllocationCounter::allocationCount();
+    
+    CPPUNIT_ASSERT( AllocationCounter::threadCounted() );
+    {
+        AllocationCounter::UncountedScope uncounted;
+        CPPUNIT_ASSERT( ! AllocationCounter::threadCounted() );
+        
+        int* volatile const allocated = new int( 3 );
+        delete allocated;
+    }
+    CPPUNIT_ASSERT( AllocationCounter::threadCounted() );
+    
+    CPPUNIT_ASSERT_EQUAL( count, AllocationCounter::allocationCount() );
+    CPPUNIT_ASSERT_EQUAL( AllocationCounter::size_type( 0 ), forbiddenCount );
+}
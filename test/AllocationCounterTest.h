@@ -0,0 +1,114 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AllocationCounter.
+ */
+#ifndef OPENSTEER_ALLOCATIONCOUNTERTEST_H
+#define OPENSTEER_ALLOCATIONCOUNTERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::AllocationCounter
+#include "OpenSteer/AllocationCounter.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class AllocationCounterTest : public CppUnit::TestFixture {
+    public:
+        AllocationCounterTest();
+        virtual ~AllocationCounterTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(AllocationCounterTest);
+        CPPUNIT_TEST(testCountsAllocations);
+        CPPUNIT_TEST(testCountsNothrowAndAlignedAllocations);
+        CPPUNIT_TEST(testForbiddenAllocationCallsHandler);
+        CPPUNIT_TEST(testForbiddenScopeRestores);
+        CPPUNIT_TEST(testAllocationFreeCodePasses);
+        CPPUNIT_TEST(testUncountedScope);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AllocationCounterTest( AllocationCounterTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AllocationCounterTest& operator=( AllocationCounterTest const& );
+        
+    private:
+        /**
+         * Tests that new and new[] are counted with their sizes.
+         */
+        void testCountsAllocations();
+        
+        /**
+         * Tests that the nothrow and aligned forms of new are counted too.
+         */
+        void testCountsNothrowAndAlignedAllocations();
+        
+        /**
+         * Tests that allocating while forbidden calls the handler.
+         */
+        void testForbiddenAllocationCallsHandler();
+        
+        /**
+         * Tests that nested scopes restore the previous state.
+         */
+        void testForbiddenScopeRestores();
+        
+        /**
+         * Tests that reusing reserved memory doesn't allocate.
+         */
+        void testAllocationFreeCodePasses();
+        
+        /**
+         * Tests that allocations in an uncounted scope are neither counted
+         * nor forbidden.
+         */
+        void testUncountedScope();
+        
+    }; // AllocationCounterTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ALLOCATIONCOUNTERTEST_H
@@ -0,0 +1,257 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContinuumCrowdGrid and 
+ * @c OpenSteer::ContinuumCrowdPotential.
+ */
+#include "ContinuumCrowdTest.h"
+
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include OpenSteer::equalsRelative for Vec3s
+#include "OpenSteer/Vec3Utilities.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ContinuumCrowdTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef ContinuumCrowdGrid::size_type size_type;
+    
+    float const unreachable = std::numeric_limits< float >::max();
+    
+    
+    // A grid of 10 by 10 cells of size 1 with its corner at the origin.
+    ContinuumCrowdGrid 
+    makeGrid()
+    {
+        return ContinuumCrowdGrid( Vec3( 5.0f, 0.0f, 5.0f ), 10.0f, 10.0f, 1.0f );
+    }
+    
+    
+    float 
+    totalDensity( ContinuumCrowdGrid const& grid )
+    {
+        float total = 0.0f;
+        for ( size_type row = 0; row < grid.rowCount(); ++row ) {
+            for ( size_type column = 0; column < grid.columnCount(); ++column ) {
+                total += grid.sampleDensity( grid.cellCenter( column, row ) );
+            }
+        }
+        return total;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::ContinuumCrowdTest::ContinuumCrowdTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ContinuumCrowdTest::~ContinuumCrowdTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::testSplatDensity()
+{
+    ContinuumCrowdGrid grid( makeGrid() );
+    
+    // At a cell center all density goes into that cell.
+    grid.splat( grid.cellCenter( 2, 3 ), Vec3::zero );
+    CPPUNIT_ASSERT( equalsRelative( 1.0f, grid.sampleDensity( grid.cellCenter( 2, 3 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 0.0f, grid.sampleDensity( grid.cellCenter( 3, 3 ) ) ) );
+    
+    // Halfway between four cell centers each gets a quarter.
+    grid.clear();
+    Vec3 const between( ( grid.cellCenter( 5, 5 ) + grid.cellCenter( 6, 6 ) ) * 0.5f );
+    grid.splat( between, Vec3::zero );
+    CPPUNIT_ASSERT( equalsRelative( 0.25f, grid.sampleDensity( grid.cellCenter( 5, 5 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 0.25f, grid.sampleDensity( grid.cellCenter( 6, 5 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 0.25f, grid.sampleDensity( grid.cellCenter( 5, 6 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 0.25f, grid.sampleDensity( grid.cellCenter( 6, 6 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 0.25f, grid.sampleDensity( between ) ) );
+    CPPUNIT_ASSERT( equalsRelative( 1.0f, totalDensity( grid ) ) );
+    
+    // Agents outside of the grid are ignored.
+    grid.splat( Vec3( -5.0f, 0.0f, 5.0f ), Vec3::zero );
+    grid.splat( Vec3( 5.0f, 0.0f, 20.0f ), Vec3::zero );
+    CPPUNIT_ASSERT( equalsRelative( 1.0f, totalDensity( grid ) ) );
+    
+    grid.clear();
+    CPPUNIT_ASSERT( equalsRelative( 0.0f, totalDensity( grid ) ) );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::testAverageVelocity()
+{
+    ContinuumCrowdGrid grid( makeGrid() );
+    Vec3 const center( grid.cellCenter( 4, 4 ) );
+    
+    grid.splat( center, Vec3( 1.0f, 0.0f, 0.0f ) );
+    grid.splat( center, Vec3( 0.0f, 0.0f, 2.0f ) );
+    grid.computeCosts();
+    
+    Vec3 const average( 0.5f, 0.0f, 1.0f );
+    CPPUNIT_ASSERT( equalsRelative( average, grid.sampleAverageVelocity( center ) ) );
+    
+    // Computing again doesn't divide the average by the density again.
+    grid.computeCosts();
+    CPPUNIT_ASSERT( equalsRelative( average, grid.sampleAverageVelocity( center ) ) );
+    
+    // Empty cells and positions outside of the grid have no velocity.
+    CPPUNIT_ASSERT( equalsRelative( Vec3::zero, grid.sampleAverageVelocity( grid.cellCenter( 0, 0 ) ) ) );
+    CPPUNIT_ASSERT( equalsRelative( Vec3::zero, grid.sampleAverageVelocity( Vec3( -1.0f, 0.0f, -1.0f ) ) ) );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::testCosts()
+{
+    ContinuumCrowdGrid grid( makeGrid() );
+    grid.setPassable( 0, 0, false );
+    
+    // A dense standing crowd in cell ( 5, 5 ).
+    for ( int i = 0; i < 4; ++i ) {
+        grid.splat( grid.cellCenter( 5, 5 ), Vec3::zero );
+    }
+    grid.computeCosts();
+    
+    float const sparse = grid.cost( grid.cellIndex( 2, 2 ) );
+    float const dense = grid.cost( grid.cellIndex( 5, 5 ) );
+    CPPUNIT_ASSERT( 0.0f < sparse );
+    CPPUNIT_ASSERT( sparse < dense );
+    CPPUNIT_ASSERT_EQUAL( unreachable, grid.cost( grid.cellIndex( 0, 0 ) ) );
+    
+    // Computing again gives the same costs.
+    grid.computeCosts();
+    CPPUNIT_ASSERT_EQUAL( dense, grid.cost( grid.cellIndex( 5, 5 ) ) );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::testPotentialFallsTowardGoal()
+{
+    ContinuumCrowdGrid grid( makeGrid() );
+    grid.computeCosts();
+    
+    ContinuumCrowdPotential potential;
+    potential.addGoal( grid, grid.cellCenter( 0, 0 ), 0.0f );
+    potential.compute( grid );
+    
+    CPPUNIT_ASSERT_EQUAL( 0.0f, potential.samplePotential( grid, grid.cellCenter( 0, 0 ) ) );
+    
+    // Along rows, columns and the diagonal the potential rises with the
+    // distance from the goal.
+    for ( size_type i = 1; i < grid.columnCount(); ++i ) {
+        CPPUNIT_ASSERT( potential.samplePotential( grid, grid.cellCenter( i - 1, 0 ) ) <
+                        potential.samplePotential( grid, grid.cellCenter( i, 0 ) ) );
+        CPPUNIT_ASSERT( potential.samplePotential( grid, grid.cellCenter( 0, i - 1 ) ) <
+                        potential.samplePotential( grid, grid.cellCenter( 0, i ) ) );
+        CPPUNIT_ASSERT( potential.samplePotential( grid, grid.cellCenter( i - 1, i - 1 ) ) <
+                        potential.samplePotential( grid, grid.cellCenter( i, i ) ) );
+    }
+    
+    // The direction points toward the goal.
+    Vec3 const position( grid.cellCenter( 7, 7 ) );
+    Vec3 const direction( potential.sampleDirection( grid, position ) );
+    Vec3 const towardGoal( ( grid.cellCenter( 0, 0 ) - position ).normalize() );
+    CPPUNIT_ASSERT( equalsRelative( 1.0f, direction.length(), 0.001f ) );
+    CPPUNIT_ASSERT( 0.9f < direction.dot( towardGoal ) );
+    
+    // Unchanged by computing the costs again.
+    float const before = potential.samplePotential( grid, position );
+    grid.computeCosts();
+    potential.compute( grid );
+    CPPUNIT_ASSERT_EQUAL( before, potential.samplePotential( grid, position ) );
+}
+
+
+
+void 
+OpenSteer::ContinuumCrowdTest::testUnreachableCells()
+{
+    // A wall along column 5 cuts the grid in two.
+    ContinuumCrowdGrid grid( makeGrid() );
+    for ( size_type row = 0; row < grid.rowCount(); ++row ) {
+        grid.setPassable( 5, row, false );
+    }
+    grid.computeCosts();
+    
+    ContinuumCrowdPotential potential;
+    potential.addGoal( grid, grid.cellCenter( 0, 5 ), 0.0f );
+    potential.compute( grid );
+    
+    CPPUNIT_ASSERT( unreachable > potential.samplePotential( grid, grid.cellCenter( 4, 9 ) ) );
+    CPPUNIT_ASSERT_EQUAL( unreachable, potential.samplePotential( grid, grid.cellCenter( 5, 5 ) ) );
+    CPPUNIT_ASSERT_EQUAL( unreachable, potential.samplePotential( grid, grid.cellCenter( 6, 5 ) ) );
+    CPPUNIT_ASSERT_EQUAL( unreachable, potential.samplePotential( grid, grid.cellCenter( 9, 0 ) ) );
+    CPPUNIT_ASSERT( equalsRelative( Vec3::zero, potential.sampleDirection( grid, grid.cellCenter( 8, 5 ) ) ) );
+    
+    // Outside of the grid is unreachable too.
+    CPPUNIT_ASSERT_EQUAL( unreachable, potential.samplePotential( grid, Vec3( -1.0f, 0.0f, 5.0f ) ) );
+    
+    // A goal on the wall is no goal.
+    ContinuumCrowdPotential blocked;
+    blocked.addGoal( grid, grid.cellCenter( 5, 5 ), 0.0f );
+    blocked.compute( grid );
+    CPPUNIT_ASSERT_EQUAL( unreachable, blocked.samplePotential( grid, grid.cellCenter( 4, 5 ) ) );
+}
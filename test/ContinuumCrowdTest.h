@@ -0,0 +1,112 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContinuumCrowdGrid and 
+ * @c OpenSteer::ContinuumCrowdPotential.
+ */
+#ifndef OPENSTEER_CONTINUUMCROWDTEST_H
+#define OPENSTEER_CONTINUUMCROWDTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::ContinuumCrowdGrid, OpenSteer::ContinuumCrowdPotential
+#include "OpenSteer/ContinuumCrowd.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class ContinuumCrowdTest : public CppUnit::TestFixture {
+    public:
+        ContinuumCrowdTest();
+        virtual ~ContinuumCrowdTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ContinuumCrowdTest);
+        CPPUNIT_TEST(testSplatDensity);
+        CPPUNIT_TEST(testAverageVelocity);
+        CPPUNIT_TEST(testCosts);
+        CPPUNIT_TEST(testPotentialFallsTowardGoal);
+        CPPUNIT_TEST(testUnreachableCells);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContinuumCrowdTest( ContinuumCrowdTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContinuumCrowdTest& operator=( ContinuumCrowdTest const& );
+        
+    private:
+        /**
+         * Tests that an agent's density is distributed bilinearly over the
+         * four nearest cells and agents outside of the grid are ignored.
+         */
+        void testSplatDensity();
+        
+        /**
+         * Tests that the average velocity of a cell is weighted by density
+         * and stays the same if the costs are computed again.
+         */
+        void testAverageVelocity();
+        
+        /**
+         * Tests that dense cells cost more than sparse ones and impassable
+         * cells can't be entered.
+         */
+        void testCosts();
+        
+        /**
+         * Tests that the potential falls monotonically toward the goal and
+         * the sampled direction points toward it.
+         */
+        void testPotentialFallsTowardGoal();
+        
+        /**
+         * Tests that cells walled off from the goal are unreachable and have
+         * no direction.
+         */
+        void testUnreachableCells();
+        
+    }; // ContinuumCrowdTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CONTINUUMCROWDTEST_H
@@ -0,0 +1,311 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlightRecorder.
+ */
+#include "FlightRecorderTest.h"
+
+
+// Include std::remove
+#include <cstdio>
+
+// Include std::ifstream
+#include <fstream>
+
+// Include std::set
+#include <set>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+#if ! defined( _WIN32 )
+    // Include pthread_create, pthread_join
+    #include <pthread.h>
+#endif
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FlightRecorderTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef FlightRecorder::Record Record;
+    
+    
+    // The records of the current frame, the recorder keeps the records 
+    // of earlier tests.
+    std::vector< Record > 
+    recordsOfThisFrame()
+    {
+        std::vector< Record > const all = FlightRecorder::records();
+        std::vector< Record > result;
+        for ( size_t i = 0; i < all.size(); ++i ) {
+            if ( all[ i ].frame == FlightRecorder::frame() ) {
+                result.push_back( all[ i ] );
+            }
+        }
+        return result;
+    }
+    
+    
+    void 
+    recordAgents( size_t first, size_t count )
+    {
+        for ( size_t agent = first; agent < first + count; ++agent ) {
+            FlightRecorder::AgentScope scope( agent );
+            FlightRecorder::addNeighbors( agent % 7 );
+        }
+    }
+    
+    
+    size_t const agentsPerThread = 1000;
+    
+    void* 
+    recordThreadAgents( void* first )
+    {
+        recordAgents( *static_cast< size_t* >( first ), agentsPerThread );
+        return 0;
+    }
+    
+    
+    bool 
+    fileExists( std::string const& fileName )
+    {
+        std::ifstream file( fileName.c_str() );
+        return file.good();
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::FlightRecorderTest::FlightRecorderTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FlightRecorderTest::~FlightRecorderTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::FlightRecorderTest::setUp()
+{
+    TestFixture::setUp();
+    FlightRecorder::setEnabled( true );
+    FlightRecorder::beginFrame();
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::tearDown()
+{
+    FlightRecorder::setSpikeDump( "flight-", 0.0 );
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testRecordsAgentScopes()
+{
+    {
+        FlightRecorder::AgentScope scope( 7 );
+        FlightRecorder::addNeighbors( 3 );
+        FlightRecorder::addNeighbors( 2 );
+        FlightRecorder::addObstacles( 4 );
+        FlightRecorder::setAvoidance( FlightRecorder::headOn );
+    }
+    {
+        FlightRecorder::AgentScope scope( 8 );
+        FlightRecorder::addNeighbors( 100000 );
+    }
+    
+    std::vector< Record > const records = recordsOfThisFrame();
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), records.size() );
+    
+    CPPUNIT_ASSERT_EQUAL( uint32_t( 7 ), records[ 0 ].agent );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( 5 ), records[ 0 ].neighbors );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( 4 ), records[ 0 ].obstacles );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( FlightRecorder::headOn ), records[ 0 ].avoidance );
+    
+    // counts saturate
+    CPPUNIT_ASSERT_EQUAL( uint32_t( 8 ), records[ 1 ].agent );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( 0xffff ), records[ 1 ].neighbors );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( FlightRecorder::notEvaluated ), records[ 1 ].avoidance );
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testIgnoresNotesOutsideOfScopes()
+{
+    { 
+        FlightRecorder::AgentScope scope( 1 );
+    }
+    FlightRecorder::addNeighbors( 3 );
+    FlightRecorder::setAvoidance( FlightRecorder::parallel );
+    FlightRecorder::endAgent();
+    
+    std::vector< Record > const records = recordsOfThisFrame();
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), records.size() );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( 0 ), records[ 0 ].neighbors );
+    CPPUNIT_ASSERT_EQUAL( uint16_t( FlightRecorder::notEvaluated ), records[ 0 ].avoidance );
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testDisabled()
+{
+    FlightRecorder::setEnabled( false );
+    recordAgents( 0, 10 );
+    FlightRecorder::setEnabled( true );
+    
+    CPPUNIT_ASSERT( recordsOfThisFrame().empty() );
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testRingKeepsNewestRecords()
+{
+#if ! defined( _WIN32 )
+    // Rings get their capacity when a thread records for the first time.
+    FlightRecorder::size_type const capacity = FlightRecorder::capacity();
+    FlightRecorder::setCapacity( 100 );
+    CPPUNIT_ASSERT_EQUAL( FlightRecorder::size_type( 128 ), FlightRecorder::capacity() );
+    
+    pthread_t thread;
+    size_t first = 0;
+    CPPUNIT_ASSERT_EQUAL( 0, pthread_create( &thread, 0, recordThreadAgents, &first ) );
+    pthread_join( thread, 0 );
+    FlightRecorder::setCapacity( capacity );
+    
+    std::vector< Record > const records = recordsOfThisFrame();
+    CPPUNIT_ASSERT_EQUAL( size_t( 127 ), records.size() );
+    for ( size_t i = 0; i < records.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( uint32_t( agentsPerThread - 127 + i ), records[ i ].agent );
+    }
+#endif
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testThreadsRecordSeparately()
+{
+#if ! defined( _WIN32 )
+    size_t const threadCount = 4;
+    size_t firsts[ threadCount ];
+    pthread_t threads[ threadCount ];
+    for ( size_t i = 0; i < threadCount; ++i ) {
+        firsts[ i ] = i * agentsPerThread;
+        CPPUNIT_ASSERT_EQUAL( 0, pthread_create( &threads[ i ], 0, recordThreadAgents, &firsts[ i ] ) );
+    }
+    for ( size_t i = 0; i < threadCount; ++i ) {
+        pthread_join( threads[ i ], 0 );
+    }
+    
+    std::vector< Record > const records = recordsOfThisFrame();
+    CPPUNIT_ASSERT_EQUAL( threadCount * agentsPerThread, records.size() );
+    
+    std::set< uint32_t > agents;
+    std::set< uint16_t > threadIds;
+    for ( size_t i = 0; i < records.size(); ++i ) {
+        agents.insert( records[ i ].agent );
+        threadIds.insert( records[ i ].thread );
+        CPPUNIT_ASSERT_EQUAL( uint16_t( records[ i ].agent % 7 ), records[ i ].neighbors );
+        CPPUNIT_ASSERT_EQUAL( records[ i ].thread, records[ i / agentsPerThread * agentsPerThread ].thread );
+    }
+    CPPUNIT_ASSERT_EQUAL( threadCount * agentsPerThread, agents.size() );
+    CPPUNIT_ASSERT_EQUAL( threadCount, threadIds.size() );
+#endif
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testDumpRoundTrip()
+{
+    recordAgents( 0, 50 );
+    std::vector< Record > const recorded = FlightRecorder::records();
+    
+    std::string const fileName = "FlightRecorderTest.flight";
+    std::string errorMessage;
+    CPPUNIT_ASSERT( FlightRecorder::dump( fileName, errorMessage ) );
+    CPPUNIT_ASSERT_EQUAL( fileName, FlightRecorder::lastDumpFile() );
+    
+    std::vector< Record > read;
+    bool const readable = FlightRecorder::readDump( fileName, read, errorMessage );
+    std::remove( fileName.c_str() );
+    
+    CPPUNIT_ASSERT( readable );
+    CPPUNIT_ASSERT_EQUAL( recorded.size(), read.size() );
+    for ( size_t i = 0; i < read.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( recorded[ i ].frame, read[ i ].frame );
+        CPPUNIT_ASSERT_EQUAL( recorded[ i ].agent, read[ i ].agent );
+        CPPUNIT_ASSERT_EQUAL( recorded[ i ].neighbors, read[ i ].neighbors );
+    }
+    
+    CPPUNIT_ASSERT( ! FlightRecorder::readDump( "FlightRecorderTest.missing", read, errorMessage ) );
+}
+
+
+
+void 
+OpenSteer::FlightRecorderTest::testSpikeDump()
+{
+    FlightRecorder::setSpikeDump( "FlightRecorderTest-", 0.010, 1 );
+    
+    recordAgents( 0, 10 );
+    CPPUNIT_ASSERT( ! FlightRecorder::endFrame( 0.005 ) );
+    
+    FlightRecorder::beginFrame();
+    recordAgents( 0, 10 );
+    CPPUNIT_ASSERT( FlightRecorder::endFrame( 0.020 ) );
+    std::string const fileName = FlightRecorder::lastDumpFile();
+    CPPUNIT_ASSERT( fileExists( fileName ) );
+    std::remove( fileName.c_str() );
+    
+    // no more than the maximum number of dumps
+    FlightRecorder::beginFrame();
+    CPPUNIT_ASSERT( ! FlightRecorder::endFrame( 0.020 ) );
+}
@@ -0,0 +1,118 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlightRecorder.
+ */
+#ifndef OPENSTEER_FLIGHTRECORDERTEST_H
+#define OPENSTEER_FLIGHTRECORDERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::FlightRecorder
+#include "OpenSteer/FlightRecorder.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class FlightRecorderTest : public CppUnit::TestFixture {
+    public:
+        FlightRecorderTest();
+        virtual ~FlightRecorderTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(FlightRecorderTest);
+        CPPUNIT_TEST(testRecordsAgentScopes);
+        CPPUNIT_TEST(testIgnoresNotesOutsideOfScopes);
+        CPPUNIT_TEST(testDisabled);
+        CPPUNIT_TEST(testRingKeepsNewestRecords);
+        CPPUNIT_TEST(testThreadsRecordSeparately);
+        CPPUNIT_TEST(testDumpRoundTrip);
+        CPPUNIT_TEST(testSpikeDump);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlightRecorderTest( FlightRecorderTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlightRecorderTest& operator=( FlightRecorderTest const& );
+        
+    private:
+        /**
+         * Tests that the notes made in an agent scope end up in its record.
+         */
+        void testRecordsAgentScopes();
+        
+        /**
+         * Tests that notes made outside of agent scopes are dropped.
+         */
+        void testIgnoresNotesOutsideOfScopes();
+        
+        /**
+         * Tests that nothing is recorded while the recorder is disabled.
+         */
+        void testDisabled();
+        
+        /**
+         * Tests that a full ring overwrites its oldest records.
+         */
+        void testRingKeepsNewestRecords();
+        
+        /**
+         * Tests that each thread records into its own ring.
+         */
+        void testThreadsRecordSeparately();
+        
+        /**
+         * Tests that a dump reads back as the records dumped.
+         */
+        void testDumpRoundTrip();
+        
+        /**
+         * Tests that only frames over the threshold are dumped.
+         */
+        void testSpikeDump();
+        
+    }; // FlightRecorderTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FLIGHTRECORDERTEST_H
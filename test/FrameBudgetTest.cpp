@@ -0,0 +1,304 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FrameBudget.
+ */
+#include "FrameBudgetTest.h"
+
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::string
+#include <string>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FrameBudgetTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef FrameBudget::size_type size_type;
+    
+    float const budgetSeconds = 0.010f;
+    
+    
+    // Runs @a count frames costing @a updateSeconds and @a drawSeconds,
+    // the budget decides on each at the start of the next.
+    void 
+    runFrames( FrameBudget& budget, size_type count, float updateSeconds, float drawSeconds )
+    {
+        for ( size_type i = 0; i < count; ++i ) {
+            budget.addPhaseSeconds( FrameBudget::updatePhase, updateSeconds );
+            budget.addPhaseSeconds( FrameBudget::drawPhase, drawSeconds );
+            budget.beginFrame();
+        }
+    }
+    
+    
+    // A budget with all knobs supported at the start of its first frame.
+    void 
+    start( FrameBudget& budget )
+    {
+        budget.setBudget( budgetSeconds );
+        budget.setSupported( FrameBudget::distantUpdatesKnob, true );
+        budget.setSupported( FrameBudget::neighborCapKnob, true );
+        budget.beginFrame();
+    }
+    
+    
+    size_type 
+    lineCount( std::string const& text )
+    {
+        size_type count = 0;
+        for ( std::string::size_type i = 0; i < text.size(); ++i ) {
+            if ( text[ i ] == '\n' ) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    
+    
+} // anonymous namespace
+
+
+
+OpenSteer::FrameBudgetTest::FrameBudgetTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FrameBudgetTest::~FrameBudgetTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::FrameBudgetTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testDisabled()
+{
+    FrameBudget budget;
+    budget.setSupported( FrameBudget::neighborCapKnob, true );
+    budget.beginFrame();
+    runFrames( budget, 100, 1.0f, 1.0f );
+    
+    CPPUNIT_ASSERT( ! budget.enabled() );
+    CPPUNIT_ASSERT_EQUAL( size_type( 0 ), budget.decisionCount() );
+    CPPUNIT_ASSERT_EQUAL( size_type( 0 ), budget.neighborCap() );
+    CPPUNIT_ASSERT_EQUAL( size_type( 1 ), budget.annotationInterval() );
+    CPPUNIT_ASSERT( budget.annotateFrame() );
+    CPPUNIT_ASSERT( ! budget.reduceDistantUpdates() );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testDegradesAfterFramesOverBudget()
+{
+    FrameBudget budget;
+    start( budget );
+    
+    runFrames( budget, FrameBudget::degradeAfterFrames - 1, 2.0f * budgetSeconds, 0.0f );
+    runFrames( budget, 1, 0.5f * budgetSeconds, 0.0f );
+    runFrames( budget, FrameBudget::degradeAfterFrames - 1, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 0 ), budget.decisionCount() );
+    
+    runFrames( budget, 1, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 1 ), budget.decisionCount() );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::distantUpdatesKnob ) );
+    CPPUNIT_ASSERT( budget.reduceDistantUpdates() );
+    
+    // The least turned knob of the update phase is next.
+    runFrames( budget, FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 2 ), budget.decisionCount() );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::neighborCapKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::annotationKnob ) );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testDegradesCostlyPhaseFirst()
+{
+    FrameBudget budget;
+    start( budget );
+    
+    runFrames( budget, FrameBudget::degradeAfterFrames, 0.5f * budgetSeconds, budgetSeconds );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::annotationKnob ) );
+    
+    // With annotation off the update phase's knobs follow.
+    runFrames( budget, 3 * FrameBudget::degradeAfterFrames, 0.5f * budgetSeconds, budgetSeconds );
+    CPPUNIT_ASSERT_EQUAL( FrameBudget::maxStep, budget.step( FrameBudget::annotationKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::neighborCapKnob ) );
+    
+    runFrames( budget, FrameBudget::degradeAfterFrames, 0.5f * budgetSeconds, budgetSeconds );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::distantUpdatesKnob ) );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testRestoresWithHeadroom()
+{
+    FrameBudget budget;
+    start( budget );
+    
+    runFrames( budget, 3 * FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( 2, budget.step( FrameBudget::distantUpdatesKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::neighborCapKnob ) );
+    
+    // Frames within budget but without headroom keep the fidelity.
+    runFrames( budget, 2 * FrameBudget::restoreAfterFrames, 0.9f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 3 ), budget.decisionCount() );
+    
+    // The last knob turned down is turned up first.
+    runFrames( budget, FrameBudget::restoreAfterFrames, 0.1f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::distantUpdatesKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.step( FrameBudget::neighborCapKnob ) );
+    
+    runFrames( budget, 2 * FrameBudget::restoreAfterFrames, 0.1f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::distantUpdatesKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::neighborCapKnob ) );
+    CPPUNIT_ASSERT_EQUAL( size_type( 6 ), budget.decisionCount() );
+    
+    // Nothing left to restore.
+    runFrames( budget, FrameBudget::restoreAfterFrames, 0.1f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 6 ), budget.decisionCount() );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testTurnsSupportedKnobsOnly()
+{
+    FrameBudget budget;
+    budget.setBudget( budgetSeconds );
+    budget.beginFrame();
+    
+    runFrames( budget, 10 * FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( FrameBudget::maxStep ), budget.decisionCount() );
+    CPPUNIT_ASSERT_EQUAL( FrameBudget::maxStep, budget.step( FrameBudget::annotationKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::neighborCapKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::distantUpdatesKnob ) );
+    
+    // Reset forgets the knobs a plugin supported.
+    start( budget );
+    budget.reset();
+    CPPUNIT_ASSERT( budget.supported( FrameBudget::annotationKnob ) );
+    CPPUNIT_ASSERT( ! budget.supported( FrameBudget::neighborCapKnob ) );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.step( FrameBudget::annotationKnob ) );
+    CPPUNIT_ASSERT( budget.enabled() );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testKnobSettings()
+{
+    FrameBudget budget;
+    start( budget );
+    budget.setSupported( FrameBudget::annotationKnob, false );
+    budget.setSupported( FrameBudget::distantUpdatesKnob, false );
+    
+    size_type const caps[] = { 0, 32, 16, 8 };
+    for ( int step = 0; step <= FrameBudget::maxStep; ++step ) {
+        CPPUNIT_ASSERT_EQUAL( step, budget.step( FrameBudget::neighborCapKnob ) );
+        CPPUNIT_ASSERT_EQUAL( caps[ step ], budget.neighborCap() );
+        runFrames( budget, FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    }
+    
+    budget.setSupported( FrameBudget::annotationKnob, true );
+    size_type const intervals[] = { 1, 2, 4, 0 };
+    for ( int step = 0; step <= FrameBudget::maxStep; ++step ) {
+        CPPUNIT_ASSERT_EQUAL( intervals[ step ], budget.annotationInterval() );
+        runFrames( budget, FrameBudget::degradeAfterFrames, 0.0f, 2.0f * budgetSeconds );
+    }
+    CPPUNIT_ASSERT( ! budget.annotateFrame() );
+    
+    budget.setSupported( FrameBudget::distantUpdatesKnob, true );
+    float const scales[] = { 1.0f, 1.0f, 0.5f, 0.25f };
+    for ( int step = 0; step <= FrameBudget::maxStep; ++step ) {
+        CPPUNIT_ASSERT_EQUAL( step > 0, budget.reduceDistantUpdates() );
+        CPPUNIT_ASSERT_EQUAL( scales[ step ], budget.fullDetailScale() );
+        runFrames( budget, FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    }
+    
+    // Disabling the budget restores full fidelity.
+    budget.setBudget( 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 0 ), budget.neighborCap() );
+    CPPUNIT_ASSERT_EQUAL( size_type( 1 ), budget.annotationInterval() );
+    CPPUNIT_ASSERT( ! budget.reduceDistantUpdates() );
+}
+
+
+
+void 
+OpenSteer::FrameBudgetTest::testLogsDecisions()
+{
+    std::ostringstream log;
+    FrameBudget budget;
+    budget.setLog( &log );
+    start( budget );
+    
+    runFrames( budget, FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 1 ), lineCount( log.str() ) );
+    CPPUNIT_ASSERT( budget.lastDecision().find( "over budget" ) != std::string::npos );
+    CPPUNIT_ASSERT( budget.lastDecision().find( FrameBudget::name( FrameBudget::distantUpdatesKnob ) ) != std::string::npos );
+    
+    runFrames( budget, FrameBudget::restoreAfterFrames, 0.0f, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( size_type( 2 ), lineCount( log.str() ) );
+    CPPUNIT_ASSERT( budget.lastDecision().find( "under budget" ) != std::string::npos );
+    
+    // Running out of knobs is logged once.
+    runFrames( budget, 20 * FrameBudget::degradeAfterFrames, 2.0f * budgetSeconds, 2.0f * budgetSeconds );
+    CPPUNIT_ASSERT_EQUAL( size_type( 3 * FrameBudget::maxStep + 3 ), lineCount( log.str() ) );
+    CPPUNIT_ASSERT( budget.lastDecision().find( "nothing left" ) != std::string::npos );
+}
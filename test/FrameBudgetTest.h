@@ -0,0 +1,120 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FrameBudget.
+ */
+#ifndef OPENSTEER_FRAMEBUDGETTEST_H
+#define OPENSTEER_FRAMEBUDGETTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::FrameBudget
+#include "OpenSteer/FrameBudget.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class FrameBudgetTest : public CppUnit::TestFixture {
+    public:
+        FrameBudgetTest();
+        virtual ~FrameBudgetTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(FrameBudgetTest);
+        CPPUNIT_TEST(testDisabled);
+        CPPUNIT_TEST(testDegradesAfterFramesOverBudget);
+        CPPUNIT_TEST(testDegradesCostlyPhaseFirst);
+        CPPUNIT_TEST(testRestoresWithHeadroom);
+        CPPUNIT_TEST(testTurnsSupportedKnobsOnly);
+        CPPUNIT_TEST(testKnobSettings);
+        CPPUNIT_TEST(testLogsDecisions);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FrameBudgetTest( FrameBudgetTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FrameBudgetTest& operator=( FrameBudgetTest const& );
+        
+    private:
+        /**
+         * Tests that fidelity isn't lowered without a budget.
+         */
+        void testDisabled();
+        
+        /**
+         * Tests that a knob is turned down only after enough frames over
+         * budget in a row.
+         */
+        void testDegradesAfterFramesOverBudget();
+        
+        /**
+         * Tests that knobs of the most expensive phase are turned first.
+         */
+        void testDegradesCostlyPhaseFirst();
+        
+        /**
+         * Tests that knobs are turned back up in reverse order once frames
+         * have headroom.
+         */
+        void testRestoresWithHeadroom();
+        
+        /**
+         * Tests that unsupported knobs stay at full fidelity.
+         */
+        void testTurnsSupportedKnobsOnly();
+        
+        /**
+         * Tests the settings derived from the knob steps.
+         */
+        void testKnobSettings();
+        
+        /**
+         * Tests that each decision is logged as one line.
+         */
+        void testLogsDecisions();
+        
+    }; // FrameBudgetTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FRAMEBUDGETTEST_H
@@ -0,0 +1,221 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::GoldenTrajectory.
+ */
+#include "GoldenTrajectoryTest.h"
+
+
+// Include std::stringstream
+#include <sstream>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::GoldenTrajectoryTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    GoldenTrajectory::Sample 
+    makeSample( GoldenTrajectory::size_type step, float x )
+    {
+        GoldenTrajectory::Sample const sample = { step, 
+                                                  0, 
+                                                  Vec3( x, 0.0f, 1.0f / 3.0f ), 
+                                                  Vec3( 0.6f, 0.0f, 0.8f ), 
+                                                  Vec3( 0.0f, 1.0f, 0.0f ), 
+                                                  0.1f * x };
+        return sample;
+    }
+    
+    
+    GoldenTrajectory 
+    makeTrajectory( GoldenTrajectory::size_type count )
+    {
+        GoldenTrajectory trajectory;
+        for ( GoldenTrajectory::size_type i = 0; i < count; ++i ) {
+            trajectory.add( makeSample( 10 * ( i + 1 ), 1.0f + 0.123456789f * i ) );
+        }
+        return trajectory;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::GoldenTrajectoryTest::GoldenTrajectoryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::GoldenTrajectoryTest::~GoldenTrajectoryTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testCompareEqual()
+{
+    GoldenTrajectory const trajectory = makeTrajectory( 5 );
+    GoldenTrajectory const golden = makeTrajectory( 5 );
+    
+    GoldenTrajectory::Comparison const result = trajectory.compare( golden, 0.0f );
+    CPPUNIT_ASSERT( result.match );
+    CPPUNIT_ASSERT_EQUAL( GoldenTrajectory::npos, result.firstMismatch );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, result.maxDeviation );
+    CPPUNIT_ASSERT( result.message.empty() );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testCompareTolerance()
+{
+    GoldenTrajectory const golden = makeTrajectory( 3 );
+    GoldenTrajectory trajectory;
+    trajectory.add( golden.sample( 0 ) );
+    GoldenTrajectory::Sample deviating = golden.sample( 1 );
+    deviating.up.y += 1e-4f;
+    trajectory.add( deviating );
+    trajectory.add( golden.sample( 2 ) );
+    
+    CPPUNIT_ASSERT( trajectory.compare( golden, 1e-3f ).match );
+    
+    GoldenTrajectory::Comparison const result = trajectory.compare( golden, 1e-5f );
+    CPPUNIT_ASSERT( ! result.match );
+    CPPUNIT_ASSERT_EQUAL( GoldenTrajectory::size_type( 1 ), result.firstMismatch );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1e-4, result.maxDeviation, 1e-6 );
+    CPPUNIT_ASSERT( ! result.message.empty() );
+    
+    CPPUNIT_ASSERT( ! trajectory.compare( golden, 0.0f ).match );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testCompareDifferentSteps()
+{
+    GoldenTrajectory const golden = makeTrajectory( 2 );
+    GoldenTrajectory trajectory;
+    trajectory.add( golden.sample( 0 ) );
+    GoldenTrajectory::Sample other = golden.sample( 1 );
+    other.step += 1;
+    trajectory.add( other );
+    
+    GoldenTrajectory::Comparison const result = trajectory.compare( golden, 1.0f );
+    CPPUNIT_ASSERT( ! result.match );
+    CPPUNIT_ASSERT_EQUAL( GoldenTrajectory::size_type( 1 ), result.firstMismatch );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testCompareDifferentLength()
+{
+    GoldenTrajectory const trajectory = makeTrajectory( 3 );
+    GoldenTrajectory const golden = makeTrajectory( 4 );
+    
+    GoldenTrajectory::Comparison const result = trajectory.compare( golden, 0.0f );
+    CPPUNIT_ASSERT( ! result.match );
+    CPPUNIT_ASSERT_EQUAL( GoldenTrajectory::size_type( 3 ), result.firstMismatch );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, result.maxDeviation );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testTextRoundTripIsExact()
+{
+    GoldenTrajectory const trajectory = makeTrajectory( 20 );
+    std::stringstream text;
+    trajectory.write( text );
+    
+    GoldenTrajectory readBack;
+    CPPUNIT_ASSERT( readBack.read( text ) );
+    CPPUNIT_ASSERT_EQUAL( trajectory.size(), readBack.size() );
+    CPPUNIT_ASSERT( readBack.compare( trajectory, 0.0f ).match );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testReadMalformed()
+{
+    std::stringstream text( "# comment\n60 0 1 2 3 0 0 1 0 1 0 1.5\n120 0 1 2\n" );
+    
+    GoldenTrajectory trajectory;
+    CPPUNIT_ASSERT( ! trajectory.read( text ) );
+    CPPUNIT_ASSERT_EQUAL( GoldenTrajectory::size_type( 0 ), trajectory.size() );
+    CPPUNIT_ASSERT( ! trajectory.errorMessage().empty() );
+}
+
+
+
+void 
+OpenSteer::GoldenTrajectoryTest::testCheckOptions()
+{
+    GoldenTrajectoryCheck check;
+    std::ostringstream report;
+    
+    CPPUNIT_ASSERT( check.check( report ) );
+    CPPUNIT_ASSERT( report.str().empty() );
+    
+    CPPUNIT_ASSERT( GoldenTrajectoryCheck::isOption( "goldenInterval" ) );
+    CPPUNIT_ASSERT( ! GoldenTrajectoryCheck::isOption( "stepsPerFrame" ) );
+    CPPUNIT_ASSERT( ! check.setOption( "stepsPerFrame", "1" ) );
+    CPPUNIT_ASSERT( ! check.setOption( "goldenInterval", "0" ) );
+    CPPUNIT_ASSERT( ! check.setOption( "goldenTolerance", "-1" ) );
+    CPPUNIT_ASSERT( check.setOption( "goldenTolerance", "0" ) );
+    CPPUNIT_ASSERT( check.setOption( "golden", "does/not/exist.txt" ) );
+    
+    CPPUNIT_ASSERT( ! check.check( report ) );
+    CPPUNIT_ASSERT( ! report.str().empty() );
+}
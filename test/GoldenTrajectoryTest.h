@@ -0,0 +1,120 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::GoldenTrajectory.
+ */
+#ifndef OPENSTEER_GOLDENTRAJECTORYTEST_H
+#define OPENSTEER_GOLDENTRAJECTORYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::GoldenTrajectory
+#include "OpenSteer/GoldenTrajectory.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class GoldenTrajectoryTest : public CppUnit::TestFixture {
+    public:
+        GoldenTrajectoryTest();
+        virtual ~GoldenTrajectoryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(GoldenTrajectoryTest);
+        CPPUNIT_TEST(testCompareEqual);
+        CPPUNIT_TEST(testCompareTolerance);
+        CPPUNIT_TEST(testCompareDifferentSteps);
+        CPPUNIT_TEST(testCompareDifferentLength);
+        CPPUNIT_TEST(testTextRoundTripIsExact);
+        CPPUNIT_TEST(testReadMalformed);
+        CPPUNIT_TEST(testCheckOptions);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        GoldenTrajectoryTest( GoldenTrajectoryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        GoldenTrajectoryTest& operator=( GoldenTrajectoryTest const& );
+        
+    private:
+        /**
+         * Tests that a trajectory matches a copy of itself bitwise.
+         */
+        void testCompareEqual();
+        
+        /**
+         * Tests that deviations match within the tolerance only.
+         */
+        void testCompareTolerance();
+        
+        /**
+         * Tests that samples of other steps never match.
+         */
+        void testCompareDifferentSteps();
+        
+        /**
+         * Tests that a shorter trajectory doesn't match.
+         */
+        void testCompareDifferentLength();
+        
+        /**
+         * Tests that writing and reading text keeps all floats.
+         */
+        void testTextRoundTripIsExact();
+        
+        /**
+         * Tests that malformed text is reported and leaves it empty.
+         */
+        void testReadMalformed();
+        
+        /**
+         * Tests that the check accepts its options, rejects invalid values 
+         * and fails if the golden trajectory can't be loaded.
+         */
+        void testCheckOptions();
+        
+    }; // GoldenTrajectoryTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_GOLDENTRAJECTORYTEST_H
@@ -0,0 +1,210 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::IndexedPathway.
+ */
+#include "IndexedPathwayTest.h"
+
+
+// Include std::cos, std::sin
+#include <cmath>
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::IndexedPathwayTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef IndexedPathway::size_type size_type;
+    
+    size_type const spiralPointCount = 40;
+    
+    /**
+     * Fills @a points with a flat spiral that winds around the origin two
+     * and a half times, so that segments of different windings lie side
+     * by side.
+     */
+    void 
+    makeSpiral( Vec3 points[ spiralPointCount ] )
+    {
+        for ( size_type i = 0; i < spiralPointCount; ++i ) {
+            float const angle = i * 0.4f;
+            float const distance = 5.0f + 1.5f * angle;
+            points[ i ] = Vec3( distance * std::cos( angle ), 0.0f, distance * std::sin( angle ) );
+        }
+    }
+    
+    /**
+     * Compares all point queries of @a indexed and @a polyline at points 
+     * of a grid reaching well beyond the path.
+     */
+    void 
+    checkPointQueries( IndexedPathway const& indexed, 
+                       PolylineSegmentedPathwaySingleRadius const& polyline )
+    {
+        for ( float x = -60.0f; x <= 60.0f; x += 1.7f ) {
+            for ( float z = -60.0f; z <= 60.0f; z += 1.3f ) {
+                Vec3 const point( x, 0.5f * x - z, z );
+                
+                Vec3 expectedTangent;
+                float expectedOutside = 0.0f;
+                Vec3 const expected = polyline.mapPointToPath( point, expectedTangent, expectedOutside );
+                
+                Vec3 tangent;
+                float outside = 0.0f;
+                Vec3 const mapped = indexed.mapPointToPath( point, tangent, outside );
+                
+                CPPUNIT_ASSERT( expected == mapped );
+                CPPUNIT_ASSERT( expectedTangent == tangent );
+                CPPUNIT_ASSERT_EQUAL( expectedOutside, outside );
+                CPPUNIT_ASSERT_EQUAL( polyline.mapPointToPathDistance( point ), 
+                                      indexed.mapPointToPathDistance( point ) );
+            }
+        }
+    }
+    
+    /**
+     * Compares distance queries of @a indexed and @a polyline from before 
+     * the start to beyond the end of the path.
+     */
+    void 
+    checkDistanceQueries( IndexedPathway const& indexed, 
+                          PolylineSegmentedPathwaySingleRadius const& polyline )
+    {
+        float const length = polyline.length();
+        for ( float distance = -10.0f; distance < length + 10.0f; distance += 0.37f ) {
+            Vec3 const expected = polyline.mapPathDistanceToPoint( distance );
+            Vec3 const mapped = indexed.mapPathDistanceToPoint( distance );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, Vec3::distance( expected, mapped ), 0.001f );
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::IndexedPathwayTest::IndexedPathwayTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::IndexedPathwayTest::~IndexedPathwayTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::testPointsMapLikePolyline()
+{
+    Vec3 points[ spiralPointCount ];
+    makeSpiral( points );
+    
+    IndexedPathway const indexed( spiralPointCount, points, 2.0f, false );
+    PolylineSegmentedPathwaySingleRadius const polyline( spiralPointCount, points, 2.0f, false );
+    
+    checkPointQueries( indexed, polyline );
+}
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::testDistancesMapLikePolyline()
+{
+    Vec3 points[ spiralPointCount ];
+    makeSpiral( points );
+    
+    IndexedPathway const indexed( spiralPointCount, points, 2.0f, false );
+    PolylineSegmentedPathwaySingleRadius const polyline( spiralPointCount, points, 2.0f, false );
+    
+    CPPUNIT_ASSERT_EQUAL( polyline.length(), indexed.length() );
+    checkDistanceQueries( indexed, polyline );
+}
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::testCyclicPath()
+{
+    Vec3 const points[] = { Vec3( 0.0f, 0.0f, 0.0f ),
+                            Vec3( 20.0f, 0.0f, 0.0f ),
+                            Vec3( 20.0f, 0.0f, 10.0f ),
+                            Vec3( 2.0f, 0.0f, 12.0f ) };
+    
+    IndexedPathway const indexed( 4, points, 1.0f, true );
+    PolylineSegmentedPathwaySingleRadius const polyline( 4, points, 1.0f, true );
+    
+    CPPUNIT_ASSERT( indexed.isCyclic() );
+    CPPUNIT_ASSERT_EQUAL( polyline.length(), indexed.length() );
+    checkPointQueries( indexed, polyline );
+    checkDistanceQueries( indexed, polyline );
+}
+
+
+
+void 
+OpenSteer::IndexedPathwayTest::testCellsListFewSegments()
+{
+    Vec3 points[ spiralPointCount ];
+    makeSpiral( points );
+    
+    IndexedPathway const indexed( spiralPointCount, points, 2.0f, false );
+    
+    CPPUNIT_ASSERT( indexed.cellCount() > 0 );
+    CPPUNIT_ASSERT( indexed.meanSegmentsPerCell() >= 1.0f );
+    CPPUNIT_ASSERT( indexed.meanSegmentsPerCell() < 0.25f * indexed.polyline().segmentCount() );
+}
@@ -0,0 +1,103 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::IndexedPathway.
+ */
+#ifndef OPENSTEER_INDEXEDPATHWAYTEST_H
+#define OPENSTEER_INDEXEDPATHWAYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::IndexedPathway
+#include "OpenSteer/IndexedPathway.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class IndexedPathwayTest : public CppUnit::TestFixture {
+    public:
+        IndexedPathwayTest();
+        virtual ~IndexedPathwayTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(IndexedPathwayTest);
+        CPPUNIT_TEST(testPointsMapLikePolyline);
+        CPPUNIT_TEST(testDistancesMapLikePolyline);
+        CPPUNIT_TEST(testCyclicPath);
+        CPPUNIT_TEST(testCellsListFewSegments);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        IndexedPathwayTest( IndexedPathwayTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        IndexedPathwayTest& operator=( IndexedPathwayTest const& );
+        
+    private:
+        /**
+         * Tests that points inside and outside of the grid map to the same
+         * point, tangent and distances as on the polyline pathway.
+         */
+        void testPointsMapLikePolyline();
+        
+        /**
+         * Tests that distances along the path map to the same points as on
+         * the polyline pathway.
+         */
+        void testDistancesMapLikePolyline();
+        
+        /**
+         * Tests queries on a closed path.
+         */
+        void testCyclicPath();
+        
+        /**
+         * Tests that cells list fewer segments than the path has.
+         */
+        void testCellsListFewSegments();
+        
+    }; // IndexedPathwayTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_INDEXEDPATHWAYTEST_H
@@ -0,0 +1,350 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::LQProximityDatabase and resizing the LQ bin
+ * lattice it wraps.
+ */
+#include "LQProximityDatabaseTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::LQProximityDatabaseTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    // Objects on a lattice of latticeSide^3 points, one unit apart, inside 
+    // a super-brick from the origin to latticeSide along each axis.
+    int const latticeSide = 10;
+    int const latticeCount = latticeSide * latticeSide * latticeSide;
+    
+    Vec3 
+    latticePoint( int index )
+    {
+        return Vec3( 0.5f + index % latticeSide, 
+                     0.5f + ( index / latticeSide ) % latticeSide,
+                     0.5f + index / ( latticeSide * latticeSide ) );
+    }
+    
+    
+    void 
+    countObject( void* /* clientObject */, float /* distanceSquared */, void* clientQueryState )
+    {
+        ++*static_cast< int* >( clientQueryState );
+    }
+    
+    
+    int 
+    countInLocality( lqDB* lq, Vec3 const& center, float radius )
+    {
+        int count = 0;
+        lqMapOverAllObjectsInLocality( lq, center.x, center.y, center.z, radius, countObject, &count );
+        return count;
+    }
+    
+    
+    // Numbers of objects found around a few points, inside and at the 
+    // border of the super-brick.
+    std::vector< int > 
+    sampleQueries( lqDB* lq )
+    {
+        std::vector< int > counts;
+        for ( int i = 0; i < latticeCount; i += 97 ) {
+            counts.push_back( countInLocality( lq, latticePoint( i ), 1.5f ) );
+            counts.push_back( countInLocality( lq, latticePoint( i ), 3.0f ) );
+        }
+        return counts;
+    }
+    
+    
+    class Lattice {
+    public:
+        explicit Lattice( int divisions ) 
+            : lq_( lqCreateDatabase( 0.0f, 0.0f, 0.0f, 
+                                     latticeSide, latticeSide, latticeSide, 
+                                     divisions, divisions, divisions ) ), 
+              proxies_( latticeCount ) 
+        {
+            for ( int i = 0; i < latticeCount; ++i ) {
+                lqInitClientProxy( &proxies_[ i ], &proxies_[ i ] );
+                update( i );
+            }
+        }
+        
+        ~Lattice() 
+        {
+            lqDeleteDatabase( lq_ );
+        }
+        
+        void update( int index ) 
+        {
+            Vec3 const p = latticePoint( index );
+            lqUpdateForNewLocation( lq_, &proxies_[ index ], p.x, p.y, p.z );
+        }
+        
+        lqDB* lq() const 
+        {
+            return lq_;
+        }
+        
+    private:
+        Lattice( Lattice const& );
+        Lattice& operator=( Lattice const& );
+        
+        lqDB* lq_;
+        std::vector< lqClientProxy > proxies_;
+    };
+    
+    
+    typedef LQProximityDatabase< int* > Database;
+    
+    // Runs frames in which each token queries its neighborhood, then 
+    // updates its (unchanged) position.
+    void 
+    runFrames( std::vector< Database::tokenType* > const& tokens, int frames )
+    {
+        std::vector< int* > neighbors;
+        for ( int frame = 0; frame < frames; ++frame ) {
+            for ( size_t i = 0; i < tokens.size(); ++i ) {
+                neighbors.clear();
+                tokens[ i ]->findNeighbors( latticePoint( static_cast< int >( i ) ), 1.5f, neighbors );
+            }
+            for ( size_t i = 0; i < tokens.size(); ++i ) {
+                tokens[ i ]->updateForNewPosition( latticePoint( static_cast< int >( i ) ) );
+            }
+        }
+    }
+    
+    
+    std::vector< Database::tokenType* > 
+    makeTokens( Database& database, std::vector< int >& ids )
+    {
+        ids.resize( latticeCount );
+        std::vector< Database::tokenType* > tokens;
+        for ( int i = 0; i < latticeCount; ++i ) {
+            ids[ i ] = i;
+            tokens.push_back( database.allocateToken( &ids[ i ] ) );
+            tokens.back()->updateForNewPosition( latticePoint( i ) );
+        }
+        return tokens;
+    }
+    
+    
+    void 
+    deleteTokens( std::vector< Database::tokenType* >& tokens )
+    {
+        for ( size_t i = 0; i < tokens.size(); ++i ) {
+            delete tokens[ i ];
+        }
+        tokens.clear();
+    }
+    
+    
+    Vec3 const center( 5.0f, 5.0f, 5.0f );
+    Vec3 const dimensions( 10.0f, 10.0f, 10.0f );
+    
+} // anonymous namespace
+
+
+
+OpenSteer::LQProximityDatabaseTest::LQProximityDatabaseTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::LQProximityDatabaseTest::~LQProximityDatabaseTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testCountedQueryCountsCandidates()
+{
+    Lattice lattice( 1 );
+    Vec3 const p = latticePoint( 555 );
+    
+    int found = 0;
+    int const candidates = lqMapOverAllObjectsInLocalityCounted( lattice.lq(), p.x, p.y, p.z, 1.5f, countObject, &found );
+    
+    CPPUNIT_ASSERT_EQUAL( latticeCount, candidates );
+    CPPUNIT_ASSERT_EQUAL( 19, found );
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testResizeKeepsQueryResults()
+{
+    Lattice lattice( 2 );
+    std::vector< int > const expected = sampleQueries( lattice.lq() );
+    
+    lqResizeDatabase( lattice.lq(), 7, 7, 7 );
+    CPPUNIT_ASSERT( lqResizeInProgress( lattice.lq() ) );
+    CPPUNIT_ASSERT( expected == sampleQueries( lattice.lq() ) );
+    
+    // some objects moved by their updates, some by emptying old bins
+    for ( int i = 0; i < latticeCount; i += 3 ) {
+        lattice.update( i );
+    }
+    CPPUNIT_ASSERT( expected == sampleQueries( lattice.lq() ) );
+    
+    lqFinishResize( lattice.lq() );
+    CPPUNIT_ASSERT( ! lqResizeInProgress( lattice.lq() ) );
+    CPPUNIT_ASSERT( expected == sampleQueries( lattice.lq() ) );
+    
+    int x = 0;
+    int y = 0;
+    int z = 0;
+    lqGetDivisions( lattice.lq(), &x, &y, &z );
+    CPPUNIT_ASSERT_EQUAL( 7, x );
+    CPPUNIT_ASSERT_EQUAL( 7, y );
+    CPPUNIT_ASSERT_EQUAL( 7, z );
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testResizeIsIncremental()
+{
+    // 1000 old bins, emptied a few per update
+    Lattice lattice( 10 );
+    lqResizeDatabase( lattice.lq(), 5, 5, 5 );
+    
+    lattice.update( 0 );
+    CPPUNIT_ASSERT( lqResizeInProgress( lattice.lq() ) );
+    
+    int updates = 1;
+    while ( lqResizeInProgress( lattice.lq() ) && updates < latticeCount ) {
+        lattice.update( updates++ );
+    }
+    
+    CPPUNIT_ASSERT( ! lqResizeInProgress( lattice.lq() ) );
+    CPPUNIT_ASSERT( updates > 10 );
+    CPPUNIT_ASSERT( updates < latticeCount );
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testAdaptiveResolutionApproachesTarget()
+{
+    float const target = 150.0f;
+    float const hysteresis = 0.3f;
+    
+    Database database( center, dimensions, Vec3( 1.0f, 1.0f, 1.0f ) );
+    database.setAdaptiveResolution( target, hysteresis );
+    std::vector< int > ids;
+    std::vector< Database::tokenType* > tokens = makeTokens( database, ids );
+    
+    runFrames( tokens, 60 );
+    
+    CPPUNIT_ASSERT( database.getResolutionChanges() > 0 );
+    CPPUNIT_ASSERT( database.getDivisions().x > 1.0f );
+    CPPUNIT_ASSERT( database.getAverageCandidates() <= target * ( 1.0f + hysteresis ) );
+    CPPUNIT_ASSERT( database.getAverageCandidates() * ( 1.0f + hysteresis ) >= target );
+    
+    deleteTokens( tokens );
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testAdaptiveResolutionKeepsGridWithinHysteresis()
+{
+    // measure candidates per query of a fixed lattice first
+    Database fixed( center, dimensions, Vec3( 5.0f, 5.0f, 5.0f ) );
+    fixed.setAdaptiveResolution( 1.0f, 1.0e6f );
+    std::vector< int > ids;
+    std::vector< Database::tokenType* > tokens = makeTokens( fixed, ids );
+    runFrames( tokens, 5 );
+    deleteTokens( tokens );
+    float const measured = fixed.getAverageCandidates();
+    CPPUNIT_ASSERT( measured > 0.0f );
+    
+    Database database( center, dimensions, Vec3( 5.0f, 5.0f, 5.0f ) );
+    database.setAdaptiveResolution( measured * 1.2f, 0.3f );
+    tokens = makeTokens( database, ids );
+    runFrames( tokens, 30 );
+    
+    CPPUNIT_ASSERT_EQUAL( 0, database.getResolutionChanges() );
+    CPPUNIT_ASSERT( Vec3( 5.0f, 5.0f, 5.0f ) == database.getDivisions() );
+    
+    deleteTokens( tokens );
+}
+
+
+
+void 
+OpenSteer::LQProximityDatabaseTest::testAdaptiveResolutionIgnoresQueryOnlyTokens()
+{
+    Database database( center, dimensions, Vec3( 1.0f, 1.0f, 1.0f ) );
+    database.setAdaptiveResolution( 150.0f, 0.3f );
+    std::vector< int > ids;
+    std::vector< Database::tokenType* > tokens = makeTokens( database, ids );
+    
+    // as many tokens again that only query and never update
+    std::vector< int* > neighbors;
+    std::vector< Database::tokenType* > queryOnly;
+    for ( size_t i = 0; i < tokens.size(); ++i ) {
+        queryOnly.push_back( database.allocateToken( &ids[ i ] ) );
+        queryOnly.back()->findNeighbors( latticePoint( static_cast< int >( i ) ), 1.5f, neighbors );
+    }
+    
+    // the measurement ends after four frames of the placed tokens
+    runFrames( tokens, 4 );
+    CPPUNIT_ASSERT_EQUAL( 1, database.getResolutionChanges() );
+    
+    deleteTokens( queryOnly );
+    deleteTokens( tokens );
+}
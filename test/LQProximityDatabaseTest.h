@@ -0,0 +1,118 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::LQProximityDatabase and resizing the LQ bin
+ * lattice it wraps.
+ */
+#ifndef OPENSTEER_LQPROXIMITYDATABASETEST_H
+#define OPENSTEER_LQPROXIMITYDATABASETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class LQProximityDatabaseTest : public CppUnit::TestFixture {
+    public:
+        LQProximityDatabaseTest();
+        virtual ~LQProximityDatabaseTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(LQProximityDatabaseTest);
+        CPPUNIT_TEST(testCountedQueryCountsCandidates);
+        CPPUNIT_TEST(testResizeKeepsQueryResults);
+        CPPUNIT_TEST(testResizeIsIncremental);
+        CPPUNIT_TEST(testAdaptiveResolutionApproachesTarget);
+        CPPUNIT_TEST(testAdaptiveResolutionKeepsGridWithinHysteresis);
+        CPPUNIT_TEST(testAdaptiveResolutionIgnoresQueryOnlyTokens);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LQProximityDatabaseTest( LQProximityDatabaseTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LQProximityDatabaseTest& operator=( LQProximityDatabaseTest const& );
+        
+    private:
+        /**
+         * Tests that a counted query returns the number of objects tested,
+         * all objects for a lattice of one bin.
+         */
+        void testCountedQueryCountsCandidates();
+        
+        /**
+         * Tests that queries find the same objects before, during and after
+         * objects move to the bins of a new subdivision.
+         */
+        void testResizeKeepsQueryResults();
+        
+        /**
+         * Tests that a resize completes over several updates, not in one.
+         */
+        void testResizeIsIncremental();
+        
+        /**
+         * Tests that adaptive resolution subdivides a coarse lattice until
+         * the candidates per query are near the target.
+         */
+        void testAdaptiveResolutionApproachesTarget();
+        
+        /**
+         * Tests that adaptive resolution leaves a lattice alone whose
+         * candidates per query are within the hysteresis of the target.
+         */
+        void testAdaptiveResolutionKeepsGridWithinHysteresis();
+        
+        /**
+         * Tests that tokens which are never placed in a bin do not hold
+         * back the measurement of the tokens that are.
+         */
+        void testAdaptiveResolutionIgnoresQueryOnlyTokens();
+        
+    }; // LQProximityDatabaseTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_LQPROXIMITYDATABASETEST_H
@@ -0,0 +1,219 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::LevelOfDetailScheduler.
+ */
+#include "LevelOfDetailSchedulerTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::LevelOfDetailSchedulerTest );
+
+
+
+OpenSteer::LevelOfDetailSchedulerTest::LevelOfDetailSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::LevelOfDetailSchedulerTest::~LevelOfDetailSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::LevelOfDetailSchedulerTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailSchedulerTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Records its updates instead of moving.
+     */
+    class CountingVehicle : public LocalSpaceMixin< AbstractVehicle > {
+    public:
+        CountingVehicle() : updateCount( 0 ), elapsedTimeSum( 0.0f ) {}
+        
+        virtual float mass() const { return 1.0f; }
+        virtual float setMass( float m ) { return m; }
+        virtual float radius() const { return 0.5f; }
+        virtual float setRadius( float r ) { return r; }
+        virtual Vec3 velocity() const { return Vec3::zero; }
+        virtual float speed() const { return 0.0f; }
+        virtual float setSpeed( float s ) { return s; }
+        virtual Vec3 predictFuturePosition( float const ) const { return position(); }
+        virtual float maxForce() const { return 1.0f; }
+        virtual float setMaxForce( float f ) { return f; }
+        virtual float maxSpeed() const { return 1.0f; }
+        virtual float setMaxSpeed( float s ) { return s; }
+        
+        virtual void update( float const, float const elapsedTime ) {
+            ++updateCount;
+            elapsedTimeSum += elapsedTime;
+        }
+        
+        int updateCount;
+        float elapsedTimeSum;
+    }; // class CountingVehicle
+    
+    
+    /**
+     * Uses the x coordinate of the vehicle position as its importance.
+     */
+    class PositionImportanceMetric : public AbstractImportanceMetric {
+    public:
+        virtual float importance( AbstractVehicle const& vehicle ) const {
+            return vehicle.position().x;
+        }
+    }; // class PositionImportanceMetric
+    
+    
+    /**
+     * Fills @a group with pointers to the vehicles of @a vehicles.
+     */
+    void fillGroup( std::vector< CountingVehicle >& vehicles, AVGroup& group ) {
+        group.clear();
+        for ( std::vector< CountingVehicle >::size_type i = 0; i < vehicles.size(); ++i ) {
+            group.push_back( &vehicles[ i ] );
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::LevelOfDetailSchedulerTest::testWithoutMetric()
+{
+    std::vector< CountingVehicle > vehicles( 5 );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    LevelOfDetailScheduler scheduler;
+    
+    for ( int frame = 0; frame < 4; ++frame ) {
+        scheduler.update( group, 0.0f, 0.5f );
+        CPPUNIT_ASSERT_EQUAL( LevelOfDetailScheduler::size_type( 5 ), scheduler.updatedVehicleCount() );
+    }
+    
+    for ( std::vector< CountingVehicle >::size_type i = 0; i < vehicles.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 4, vehicles[ i ].updateCount );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0f, vehicles[ i ].elapsedTimeSum, 0.0001f );
+    }
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailSchedulerTest::testLevelThresholds()
+{
+    // Default thresholds are 0.5, 0.25, 0.125 and 0.
+    float const importances[] = { 1.0f, 0.5f, 0.3f, 0.2f, 0.125f, 0.01f };
+    LevelOfDetailScheduler::size_type const expectedPopulation[] = { 2, 1, 2, 1 };
+    
+    std::vector< CountingVehicle > vehicles( 6 );
+    for ( std::vector< CountingVehicle >::size_type i = 0; i < vehicles.size(); ++i ) {
+        vehicles[ i ].setPosition( importances[ i ], 0.0f, 0.0f );
+    }
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    PositionImportanceMetric metric;
+    LevelOfDetailScheduler scheduler;
+    scheduler.setImportanceMetric( &metric );
+    
+    // The first frame updates every vehicle and assigns the levels.
+    scheduler.update( group, 0.0f, 0.1f );
+    CPPUNIT_ASSERT_EQUAL( LevelOfDetailScheduler::size_type( 6 ), scheduler.updatedVehicleCount() );
+    
+    for ( LevelOfDetailScheduler::size_type level = 0; level < scheduler.levelCount(); ++level ) {
+        CPPUNIT_ASSERT_EQUAL( expectedPopulation[ level ], scheduler.vehicleCountOnLevel( level ) );
+    }
+}
+
+
+
+void 
+OpenSteer::LevelOfDetailSchedulerTest::testAccumulatedTime()
+{
+    // All vehicles end up on the coarsest level and are updated every 8th 
+    // frame after their first update.
+    std::vector< CountingVehicle > vehicles( 8 );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    PositionImportanceMetric metric;
+    LevelOfDetailScheduler scheduler;
+    scheduler.setImportanceMetric( &metric );
+    
+    float const elapsedTime = 0.25f;
+    scheduler.update( group, 0.0f, elapsedTime );
+    
+    for ( int frame = 1; frame < 17; ++frame ) {
+        scheduler.update( group, frame * elapsedTime, elapsedTime );
+        
+        // Staggering spreads the eight vehicles evenly over the frames.
+        CPPUNIT_ASSERT_EQUAL( LevelOfDetailScheduler::size_type( 1 ), scheduler.updatedVehicleCount() );
+    }
+    
+    for ( std::vector< CountingVehicle >::size_type i = 0; i < vehicles.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 3, vehicles[ i ].updateCount );
+        
+        // No time is lost by skipping frames.
+        CPPUNIT_ASSERT( vehicles[ i ].elapsedTimeSum <= 17 * elapsedTime + 0.0001f );
+        CPPUNIT_ASSERT( vehicles[ i ].elapsedTimeSum > 9 * elapsedTime );
+    }
+}
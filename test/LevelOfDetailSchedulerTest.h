@@ -0,0 +1,99 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::LevelOfDetailScheduler.
+ */
+#ifndef OPENSTEER_LEVELOFDETAILSCHEDULERTEST_H
+#define OPENSTEER_LEVELOFDETAILSCHEDULERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::LevelOfDetailScheduler
+#include "OpenSteer/LevelOfDetailScheduler.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class LevelOfDetailSchedulerTest : public CppUnit::TestFixture {
+    public:
+        LevelOfDetailSchedulerTest();
+        virtual ~LevelOfDetailSchedulerTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(LevelOfDetailSchedulerTest);
+        CPPUNIT_TEST(testWithoutMetric);
+        CPPUNIT_TEST(testLevelThresholds);
+        CPPUNIT_TEST(testAccumulatedTime);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LevelOfDetailSchedulerTest( LevelOfDetailSchedulerTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LevelOfDetailSchedulerTest& operator=( LevelOfDetailSchedulerTest const& );
+        
+    private:
+        /**
+         * Tests that all vehicles are updated every frame if no importance
+         * metric is set.
+         */
+        void testWithoutMetric();
+        
+        /**
+         * Tests that vehicles are placed on the level matching their 
+         * importance.
+         */
+        void testLevelThresholds();
+        
+        /**
+         * Tests that vehicles on a coarse level are updated with the time
+         * elapsed since their last update and that the updates are 
+         * staggered.
+         */
+        void testAccumulatedTime();
+        
+    }; // LevelOfDetailSchedulerTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_LEVELOFDETAILSCHEDULERTEST_H
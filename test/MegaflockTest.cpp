@@ -0,0 +1,175 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Megaflock.
+ */
+#include "MegaflockTest.h"
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::MegaflockTest );
+
+
+
+OpenSteer::MegaflockTest::MegaflockTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MegaflockTest::~MegaflockTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::MegaflockTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::testSpawn()
+{
+    Megaflock flock;
+    Megaflock::size_type const first = flock.add( Vec3( 1.0f, 2.0f, 3.0f ), 
+                                                  Vec3::forward, 
+                                                  4.0f );
+    flock.spawn( 1000, 20.0f );
+    
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 1001 ), flock.size() );
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 0 ), first );
+    CPPUNIT_ASSERT( flock.position( 0 ) == Vec3( 1.0f, 2.0f, 3.0f ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 4.0f, flock.speed( 0 ), 0.0f );
+    
+    for ( Megaflock::size_type i = 1; i < flock.size(); ++i ) {
+        CPPUNIT_ASSERT( flock.position( i ).length() <= 20.0f );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, flock.forward( i ).length(), 0.0001f );
+    }
+    
+    flock.clear();
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 0 ), flock.size() );
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::testEmptyFlock()
+{
+    Megaflock flock;
+    flock.update( 0.1f );
+    
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 0 ), flock.size() );
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 0 ), flock.neighborCount() );
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::testLonelyBoidFliesStraight()
+{
+    Megaflock flock;
+    flock.add( Vec3( -20.0f, 0.0f, 0.0f ), Vec3::forward, 5.0f );
+    flock.add( Vec3( 20.0f, 0.0f, 0.0f ), Vec3( 1.0f, 0.0f, 0.0f ), 5.0f );
+    
+    for ( int frame = 0; frame < 10; ++frame ) {
+        flock.update( 0.1f );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 0 ), flock.neighborCount() );
+    CPPUNIT_ASSERT( flock.forward( 0 ) == Vec3::forward );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0f, flock.speed( 0 ), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0f, flock.position( 0 ).z, 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0f, flock.position( 1 ).x - 20.0f, 0.0001f );
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::testSeparation()
+{
+    // only separation, the boids fly along z one meter apart on x
+    Megaflock::Parameters parameters;
+    parameters.alignmentWeight = 0.0f;
+    parameters.cohesionWeight = 0.0f;
+    Megaflock flock( parameters );
+    flock.add( Vec3( -0.5f, 0.0f, 0.0f ), Vec3::forward, 5.0f );
+    flock.add( Vec3( 0.5f, 0.0f, 0.0f ), Vec3::forward, 5.0f );
+    
+    flock.update( 0.1f );
+    CPPUNIT_ASSERT_EQUAL( Megaflock::size_type( 2 ), flock.neighborCount() );
+    for ( int frame = 0; frame < 9; ++frame ) {
+        flock.update( 0.1f );
+    }
+    
+    CPPUNIT_ASSERT( flock.position( 0 ).x < -0.5f );
+    CPPUNIT_ASSERT( flock.position( 1 ).x > 0.5f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -flock.position( 0 ).x, flock.position( 1 ).x, 0.0001f );
+}
+
+
+
+void 
+OpenSteer::MegaflockTest::testGridFindsAllNeighbors()
+{
+    Megaflock flock;
+    flock.spawn( 2000, 50.0f );
+    
+    // neighbor count of the state before the update
+    Megaflock::size_type expected = 0;
+    float const maxRadius = flock.parameters().cohesionRadius;
+    for ( Megaflock::size_type i = 0; i < flock.size(); ++i ) {
+        for ( Megaflock::size_type j = 0; j < flock.size(); ++j ) {
+            if ( i != j && 
+                 Vec3::distance( flock.position( i ), flock.position( j ) ) <= maxRadius ) {
+                ++expected;
+            }
+        }
+    }
+    
+    flock.update( 0.1f );
+    CPPUNIT_ASSERT( flock.cellCount() > 27 );
+    CPPUNIT_ASSERT_EQUAL( expected, flock.neighborCount() );
+}
@@ -0,0 +1,109 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Megaflock.
+ */
+#ifndef OPENSTEER_MEGAFLOCKTEST_H
+#define OPENSTEER_MEGAFLOCKTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::Megaflock
+#include "OpenSteer/Megaflock.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class MegaflockTest : public CppUnit::TestFixture {
+    public:
+        MegaflockTest();
+        virtual ~MegaflockTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(MegaflockTest);
+        CPPUNIT_TEST(testSpawn);
+        CPPUNIT_TEST(testEmptyFlock);
+        CPPUNIT_TEST(testLonelyBoidFliesStraight);
+        CPPUNIT_TEST(testSeparation);
+        CPPUNIT_TEST(testGridFindsAllNeighbors);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MegaflockTest( MegaflockTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MegaflockTest& operator=( MegaflockTest const& );
+        
+    private:
+        /**
+         * Tests that spawned boids start inside the spawn sphere with unit
+         * headings and keep their indices when more are added.
+         */
+        void testSpawn();
+        
+        /**
+         * Tests that a flock without any boids can be updated.
+         */
+        void testEmptyFlock();
+        
+        /**
+         * Tests that a boid without neighbors keeps its heading and speed.
+         */
+        void testLonelyBoidFliesStraight();
+        
+        /**
+         * Tests that two boids flying side by side too close move apart.
+         */
+        void testSeparation();
+        
+        /**
+         * Tests that the grid finds the same number of neighbors as a brute
+         * force search, including across the cell borders.
+         */
+        void testGridFindsAllNeighbors();
+        
+    }; // MegaflockTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_MEGAFLOCKTEST_H
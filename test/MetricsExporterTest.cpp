@@ -0,0 +1,220 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for serving and dumping metrics with 
+ * @c OpenSteer::MetricsExporter.
+ */
+#include "MetricsExporterTest.h"
+
+
+// Include std::remove
+#include <cstdio>
+
+// Include std::ifstream
+#include <fstream>
+
+// Include std::string
+#include <string>
+
+// Include std::ostringstream
+#include <sstream>
+
+#if ! defined( _WIN32 )
+    // Include socket, connect, send, recv
+    #include <sys/socket.h>
+
+    // Include sockaddr_in, htons, htonl
+    #include <netinet/in.h>
+
+    // Include close
+    #include <unistd.h>
+#endif
+
+// Include OpenSteer::MetricsRegistry
+#include "OpenSteer/Metrics.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::MetricsExporterTest );
+
+
+
+namespace {
+    
+#if ! defined( _WIN32 )
+    
+    /**
+     * Sends a GET request for @a path to the local @a port and returns
+     * everything received until the server closes the connection.
+     */
+    std::string 
+    get( int port, std::string const& path )
+    {
+        int const connection = socket( AF_INET, SOCK_STREAM, 0 );
+        if ( connection < 0 ) {
+            return std::string();
+        }
+        
+        sockaddr_in address = sockaddr_in();
+        address.sin_family = AF_INET;
+        address.sin_port = htons( static_cast< unsigned short >( port ) );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        
+        std::string response;
+        if ( 0 == connect( connection, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) ) {
+            std::string const request = "GET " + path + " HTTP/1.0\r\n\r\n";
+            send( connection, request.data(), request.size(), 0 );
+            
+            char buffer[ 1024 ];
+            ssize_t received = 0;
+            while ( 0 < ( received = recv( connection, buffer, sizeof( buffer ), 0 ) ) ) {
+                response.append( buffer, static_cast< std::string::size_type >( received ) );
+            }
+        }
+        close( connection );
+        return response;
+    }
+    
+#endif
+    
+} // anonymous namespace
+
+
+
+OpenSteer::MetricsExporterTest::MetricsExporterTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MetricsExporterTest::~MetricsExporterTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::MetricsExporterTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::MetricsExporterTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::MetricsExporterTest::testServesMetrics()
+{
+#if ! defined( _WIN32 )
+    MetricsRegistry registry;
+    registry.counter( "frames_total", "Frames." ).increment( 2.0 );
+    
+    MetricsExporter exporter( registry );
+    CPPUNIT_ASSERT( exporter.listen( 0 ) );
+    CPPUNIT_ASSERT( 0 < exporter.port() );
+    CPPUNIT_ASSERT( exporter.start() );
+    
+    std::string const response = get( exporter.port(), "/metrics" );
+    exporter.stop();
+    
+    CPPUNIT_ASSERT_EQUAL( std::string( "HTTP/1.0 200" ), response.substr( 0, 12 ) );
+    std::string::size_type const body = response.find( "\r\n\r\n" );
+    CPPUNIT_ASSERT( std::string::npos != body );
+    CPPUNIT_ASSERT_EQUAL( registry.text(), response.substr( body + 4 ) );
+    CPPUNIT_ASSERT( ! exporter.running() );
+#endif
+}
+
+
+
+void 
+OpenSteer::MetricsExporterTest::testUnknownPath()
+{
+#if ! defined( _WIN32 )
+    MetricsRegistry registry;
+    MetricsExporter exporter( registry );
+    CPPUNIT_ASSERT( exporter.listen( 0 ) );
+    CPPUNIT_ASSERT( exporter.start() );
+    
+    std::string const response = get( exporter.port(), "/nothing" );
+    exporter.stop();
+    
+    CPPUNIT_ASSERT_EQUAL( std::string( "HTTP/1.0 404" ), response.substr( 0, 12 ) );
+#endif
+}
+
+
+
+void 
+OpenSteer::MetricsExporterTest::testListenAddress()
+{
+#if ! defined( _WIN32 )
+    MetricsRegistry registry;
+    MetricsExporter exporter( registry );
+    CPPUNIT_ASSERT( ! exporter.listen( 0, "localhost" ) );
+    CPPUNIT_ASSERT( ! exporter.errorMessage().empty() );
+    CPPUNIT_ASSERT_EQUAL( -1, exporter.port() );
+    
+    CPPUNIT_ASSERT( exporter.listen( 0, "127.0.0.1" ) );
+    CPPUNIT_ASSERT( exporter.start() );
+    std::string const response = get( exporter.port(), "/metrics" );
+    exporter.stop();
+    
+    CPPUNIT_ASSERT_EQUAL( std::string( "HTTP/1.0 200" ), response.substr( 0, 12 ) );
+#endif
+}
+
+
+
+void 
+OpenSteer::MetricsExporterTest::testDump()
+{
+    MetricsRegistry registry;
+    registry.gauge( "agents", "Agents." ).set( 42.0 );
+    
+    std::string const fileName = "MetricsExporterTest.prom";
+    MetricsExporter exporter( registry );
+    exporter.dumpTo( fileName, 1.0 );
+    CPPUNIT_ASSERT( exporter.dump() );
+    
+    std::ifstream file( fileName.c_str() );
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    file.close();
+    std::remove( fileName.c_str() );
+    
+    CPPUNIT_ASSERT_EQUAL( registry.text(), contents.str() );
+}
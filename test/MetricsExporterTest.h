@@ -0,0 +1,102 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for serving and dumping metrics with 
+ * @c OpenSteer::MetricsExporter.
+ */
+#ifndef OPENSTEER_METRICSEXPORTERTEST_H
+#define OPENSTEER_METRICSEXPORTERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::MetricsExporter
+#include "OpenSteer/MetricsExporter.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class MetricsExporterTest : public CppUnit::TestFixture {
+    public:
+        MetricsExporterTest();
+        virtual ~MetricsExporterTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(MetricsExporterTest);
+        CPPUNIT_TEST(testServesMetrics);
+        CPPUNIT_TEST(testUnknownPath);
+        CPPUNIT_TEST(testListenAddress);
+        CPPUNIT_TEST(testDump);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MetricsExporterTest( MetricsExporterTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MetricsExporterTest& operator=( MetricsExporterTest const& );
+        
+    private:
+        /**
+         * Tests that a GET of /metrics answers with the registry's text.
+         */
+        void testServesMetrics();
+        
+        /**
+         * Tests that other paths aren't found.
+         */
+        void testUnknownPath();
+        
+        /**
+         * Tests that listen binds the given address and rejects 
+         * malformed ones.
+         */
+        void testListenAddress();
+        
+        /**
+         * Tests that a dump writes the registry's text to the file.
+         */
+        void testDump();
+        
+    }; // MetricsExporterTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_METRICSEXPORTERTEST_H
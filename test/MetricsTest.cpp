@@ -0,0 +1,275 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for the counters, gauges and histograms of 
+ * @c OpenSteer::MetricsRegistry.
+ */
+#include "MetricsTest.h"
+
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+#if ! defined( _WIN32 )
+    // Include pthread_create, pthread_join
+    #include <pthread.h>
+#endif
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::MetricsTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    std::vector< double > 
+    bounds( double first, double second, double third )
+    {
+        std::vector< double > result;
+        result.push_back( first );
+        result.push_back( second );
+        result.push_back( third );
+        return result;
+    }
+    
+    
+    struct Shared {
+        Counter* counter;
+        Histogram* histogram;
+    };
+    
+    int const updatesPerThread = 100000;
+    
+    
+    void* 
+    update( void* state )
+    {
+        Shared& shared = *static_cast< Shared* >( state );
+        Histogram::Batch batch( *shared.histogram );
+        for ( int i = 0; i < updatesPerThread; ++i ) {
+            shared.counter->increment();
+            shared.histogram->observe( 1.0 );
+            batch.observe( 3.0 );
+        }
+        return 0;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::MetricsTest::MetricsTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MetricsTest::~MetricsTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::MetricsTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::MetricsTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testCounterAndGauge()
+{
+    MetricsRegistry registry;
+    Counter& counter = registry.counter( "frames_total", "Frames." );
+    Gauge& gauge = registry.gauge( "agents", "Agents." );
+    
+    counter.increment();
+    counter.increment( 2.5 );
+    gauge.set( 10.0 );
+    gauge.add( -3.0 );
+    
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.5, counter.value(), 0.0 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 7.0, gauge.value(), 0.0 );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testHistogramBuckets()
+{
+    MetricsRegistry registry;
+    Histogram& histogram = registry.histogram( "seconds", "Seconds.", bounds( 1.0, 2.0, 4.0 ) );
+    
+    histogram.observe( 0.5 );
+    histogram.observe( 1.0 );
+    histogram.observe( 1.5 );
+    histogram.observe( 4.0 );
+    histogram.observe( 5.0 );
+    
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 2 ), histogram.bucketCount( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 3 ) );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 5 ), histogram.count() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 12.0, histogram.sum(), 0.0 );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testBatchAddsAtOnce()
+{
+    MetricsRegistry registry;
+    Histogram& histogram = registry.histogram( "neighbors", "Neighbors.", bounds( 1.0, 2.0, 4.0 ) );
+    
+    {
+        Histogram::Batch batch( histogram );
+        batch.observe( 1.0 );
+        batch.observe( 3.0 );
+        CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 0 ), histogram.count() );
+        
+        batch.flush();
+        CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 2 ), histogram.count() );
+        CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 0 ) );
+        CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 2 ) );
+        
+        batch.observe( 8.0 );
+    }
+    
+    // flushed when destroyed
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 3 ), histogram.count() );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( 1 ), histogram.bucketCount( 3 ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 12.0, histogram.sum(), 0.0 );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testRegisteringTwiceReturnsSameMetric()
+{
+    MetricsRegistry registry;
+    Counter& first = registry.counter( "frames_total", "Frames." );
+    Counter& second = registry.counter( "frames_total", "Other help." );
+    Histogram& histogram = registry.histogram( "seconds", "Seconds.", bounds( 1.0, 2.0, 4.0 ) );
+    Histogram& again = registry.histogram( "seconds", "Seconds.", bounds( 8.0, 16.0, 32.0 ) );
+    
+    CPPUNIT_ASSERT( &first == &second );
+    CPPUNIT_ASSERT( &histogram == &again );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, again.upperBounds()[ 0 ], 0.0 );
+    CPPUNIT_ASSERT_EQUAL( MetricsRegistry::size_type( 2 ), registry.size() );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testValidNames()
+{
+    CPPUNIT_ASSERT( Metric::validName( "opensteer_frames_total" ) );
+    CPPUNIT_ASSERT( Metric::validName( "_private:rate5m" ) );
+    CPPUNIT_ASSERT( ! Metric::validName( "" ) );
+    CPPUNIT_ASSERT( ! Metric::validName( "5m_rate" ) );
+    CPPUNIT_ASSERT( ! Metric::validName( "frame-seconds" ) );
+    CPPUNIT_ASSERT( ! Metric::validName( "frame seconds" ) );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testPrometheusText()
+{
+    MetricsRegistry registry;
+    registry.counter( "frames_total", "Simulation updates." ).increment( 3.0 );
+    registry.gauge( "agents", "Vehicles,\nwith a line feed." ).set( 0.25 );
+    Histogram& histogram = registry.histogram( "seconds", "Frame \\ time.", bounds( 0.5, 1.0, 2.0 ) );
+    histogram.observe( 0.25 );
+    histogram.observe( 1.5 );
+    histogram.observe( 3.0 );
+    
+    std::string const expected = 
+        "# HELP frames_total Simulation updates.\n"
+        "# TYPE frames_total counter\n"
+        "frames_total 3\n"
+        "# HELP agents Vehicles,\\nwith a line feed.\n"
+        "# TYPE agents gauge\n"
+        "agents 0.25\n"
+        "# HELP seconds Frame \\\\ time.\n"
+        "# TYPE seconds histogram\n"
+        "seconds_bucket{le=\"0.5\"} 1\n"
+        "seconds_bucket{le=\"1\"} 1\n"
+        "seconds_bucket{le=\"2\"} 2\n"
+        "seconds_bucket{le=\"+Inf\"} 3\n"
+        "seconds_sum 4.75\n"
+        "seconds_count 3\n";
+    
+    CPPUNIT_ASSERT_EQUAL( expected, registry.text() );
+}
+
+
+
+void 
+OpenSteer::MetricsTest::testConcurrentUpdates()
+{
+#if ! defined( _WIN32 )
+    MetricsRegistry registry;
+    Shared shared;
+    shared.counter = &registry.counter( "updates_total", "Updates." );
+    shared.histogram = &registry.histogram( "values", "Values.", bounds( 1.0, 2.0, 4.0 ) );
+    
+    int const threadCount = 4;
+    pthread_t threads[ threadCount ];
+    for ( int i = 0; i < threadCount; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 0, pthread_create( &threads[ i ], 0, update, &shared ) );
+    }
+    for ( int i = 0; i < threadCount; ++i ) {
+        pthread_join( threads[ i ], 0 );
+    }
+    
+    double const updates = static_cast< double >( threadCount ) * updatesPerThread;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( updates, shared.counter->value(), 0.0 );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( updates ), shared.histogram->bucketCount( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( Histogram::size_type( updates ), shared.histogram->bucketCount( 2 ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 4.0 * updates, shared.histogram->sum(), 0.0 );
+#endif
+}
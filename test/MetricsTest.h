@@ -0,0 +1,122 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * @file
+ *
+ * Unit test for the counters, gauges and histograms of 
+ * @c OpenSteer::MetricsRegistry.
+ */
+#ifndef OPENSTEER_METRICSTEST_H
+#define OPENSTEER_METRICSTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::MetricsRegistry
+#include "OpenSteer/Metrics.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class MetricsTest : public CppUnit::TestFixture {
+    public:
+        MetricsTest();
+        virtual ~MetricsTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(MetricsTest);
+        CPPUNIT_TEST(testCounterAndGauge);
+        CPPUNIT_TEST(testHistogramBuckets);
+        CPPUNIT_TEST(testBatchAddsAtOnce);
+        CPPUNIT_TEST(testRegisteringTwiceReturnsSameMetric);
+        CPPUNIT_TEST(testValidNames);
+        CPPUNIT_TEST(testPrometheusText);
+        CPPUNIT_TEST(testConcurrentUpdates);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MetricsTest( MetricsTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MetricsTest& operator=( MetricsTest const& );
+        
+    private:
+        /**
+         * Tests that counters sum increments and gauges keep what was set.
+         */
+        void testCounterAndGauge();
+        
+        /**
+         * Tests that observations fall into the first bucket whose upper
+         * bound they don't exceed, or into the +Inf bucket.
+         */
+        void testHistogramBuckets();
+        
+        /**
+         * Tests that a batch changes its histogram only when flushed.
+         */
+        void testBatchAddsAtOnce();
+        
+        /**
+         * Tests that registering a name again returns the metric 
+         * registered first.
+         */
+        void testRegisteringTwiceReturnsSameMetric();
+        
+        /**
+         * Tests which metric names Prometheus accepts.
+         */
+        void testValidNames();
+        
+        /**
+         * Tests the exposition of each type of metric in the Prometheus
+         * text format.
+         */
+        void testPrometheusText();
+        
+        /**
+         * Tests that no updates from several threads get lost.
+         */
+        void testConcurrentUpdates();
+        
+    }; // MetricsTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_METRICSTEST_H
@@ -0,0 +1,154 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PathRegistry.
+ */
+#include "PathRegistryTest.h"
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PathRegistryTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    OpenSteer::Vec3 const points[] = { Vec3( 0.0f, 0.0f, 0.0f ),
+                                       Vec3( 10.0f, 0.0f, 0.0f ),
+                                       Vec3( 10.0f, 0.0f, 10.0f ) };
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PathRegistryTest::PathRegistryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathRegistryTest::~PathRegistryTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::PathRegistryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::PathRegistryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::PathRegistryTest::testFindUnknownPath()
+{
+    PathRegistry registry;
+    
+    CPPUNIT_ASSERT( ! registry.find( "unknown" ) );
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 0 ), registry.size() );
+}
+
+
+
+void 
+OpenSteer::PathRegistryTest::testAcquireSharesPath()
+{
+    PathRegistry registry;
+    
+    PathRegistry::PathPointer const first = registry.acquire( "corner", 3, points, 1.0f, false );
+    PathRegistry::PathPointer const second = registry.acquire( "corner", 3, points, 1.0f, false );
+    PathRegistry::PathPointer const other = registry.acquire( "corner wide", 3, points, 2.0f, false );
+    
+    CPPUNIT_ASSERT( first );
+    CPPUNIT_ASSERT( first.get() == second.get() );
+    CPPUNIT_ASSERT( first.get() == registry.find( "corner" ).get() );
+    CPPUNIT_ASSERT( first.get() != other.get() );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, other->radius() );
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 2 ), registry.size() );
+}
+
+
+
+void 
+OpenSteer::PathRegistryTest::testAcquireReplacesChangedPath()
+{
+    PathRegistry registry;
+    
+    Vec3 moved[] = { points[ 0 ], points[ 1 ], points[ 2 ] };
+    moved[ 2 ].z += 0.001f;
+    
+    PathRegistry::PathPointer const first = registry.acquire( "corner", 3, points, 1.0f, false );
+    PathRegistry::PathPointer const changed = registry.acquire( "corner", 3, moved, 1.0f, false );
+    PathRegistry::PathPointer const cyclic = registry.acquire( "corner", 3, moved, 1.0f, true );
+    PathRegistry::PathPointer const again = registry.acquire( "corner", 3, moved, 1.0f, true );
+    
+    CPPUNIT_ASSERT( first.get() != changed.get() );
+    CPPUNIT_ASSERT( first->point( 2 ) == points[ 2 ] );
+    CPPUNIT_ASSERT( changed->point( 2 ) == moved[ 2 ] );
+    CPPUNIT_ASSERT( changed.get() != cyclic.get() );
+    CPPUNIT_ASSERT( cyclic.get() == again.get() );
+    CPPUNIT_ASSERT( cyclic.get() == registry.find( "corner" ).get() );
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 1 ), registry.size() );
+}
+
+
+
+void 
+OpenSteer::PathRegistryTest::testRemoveUnused()
+{
+    PathRegistry registry;
+    
+    PathRegistry::PathPointer used = registry.acquire( "used", 3, points, 1.0f, false );
+    registry.acquire( "unused", 3, points, 1.0f, false );
+    
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 1 ), registry.removeUnused() );
+    CPPUNIT_ASSERT( registry.find( "used" ) );
+    CPPUNIT_ASSERT( ! registry.find( "unused" ) );
+    
+    used.reset();
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 1 ), registry.removeUnused() );
+    CPPUNIT_ASSERT_EQUAL( PathRegistry::size_type( 0 ), registry.size() );
+}
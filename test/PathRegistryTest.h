@@ -0,0 +1,102 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PathRegistry.
+ */
+#ifndef OPENSTEER_PATHREGISTRYTEST_H
+#define OPENSTEER_PATHREGISTRYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::PathRegistry
+#include "OpenSteer/PathRegistry.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class PathRegistryTest : public CppUnit::TestFixture {
+    public:
+        PathRegistryTest();
+        virtual ~PathRegistryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(PathRegistryTest);
+        CPPUNIT_TEST(testFindUnknownPath);
+        CPPUNIT_TEST(testAcquireSharesPath);
+        CPPUNIT_TEST(testAcquireReplacesChangedPath);
+        CPPUNIT_TEST(testRemoveUnused);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathRegistryTest( PathRegistryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathRegistryTest& operator=( PathRegistryTest const& );
+        
+    private:
+        /**
+         * Tests that unknown names find an empty pointer.
+         */
+        void testFindUnknownPath();
+        
+        /**
+         * Tests that acquiring a name twice returns the same path.
+         */
+        void testAcquireSharesPath();
+        
+        /**
+         * Tests that acquiring a name with other path data replaces the 
+         * registered path and leaves the old one to its users.
+         */
+        void testAcquireReplacesChangedPath();
+        
+        /**
+         * Tests that only paths without users are removed.
+         */
+        void testRemoveUnused();
+        
+    }; // PathRegistryTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PATHREGISTRYTEST_H
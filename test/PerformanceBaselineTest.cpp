@@ -0,0 +1,230 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PerformanceBaseline.
+ */
+#include "PerformanceBaselineTest.h"
+
+
+// Include std::stringstream
+#include <sstream>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PerformanceBaselineTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    PerformanceBaseline::Metric 
+    makeMetric( std::string const& name, double value, double spread )
+    {
+        PerformanceBaseline::Metric const metric = { name, value, spread };
+        return metric;
+    }
+    
+    
+    PerformanceBaseline::Scenario 
+    makeScenario( std::string const& name )
+    {
+        PerformanceBaseline::Scenario scenario;
+        scenario.name = name;
+        scenario.plugIn = "Capture the Flag";
+        scenario.frames = 600;
+        scenario.seed = 7;
+        scenario.options.push_back( "seekers=4" );
+        scenario.options.push_back( "enemies=2" );
+        scenario.metrics.push_back( makeMetric( "p50_ms", 10.0, 1.0 ) );
+        scenario.metrics.push_back( makeMetric( "allocations", 0.0, 0.0 ) );
+        return scenario;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PerformanceBaselineTest::PerformanceBaselineTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PerformanceBaselineTest::~PerformanceBaselineTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testSummarizeOddCount()
+{
+    double const values[] = { 4.0, 100.0, 1.0, 3.0, 2.0 };
+    PerformanceBaseline::Metric const metric = 
+        PerformanceBaseline::summarize( "p50_ms", std::vector< double >( values, values + 5 ) );
+    
+    CPPUNIT_ASSERT_EQUAL( std::string( "p50_ms" ), metric.name );
+    CPPUNIT_ASSERT_EQUAL( 3.0, metric.value );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.4826, metric.spread, 1e-12 );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testSummarizeEvenCount()
+{
+    double const values[] = { 4.0, 1.0, 3.0, 2.0 };
+    PerformanceBaseline::Metric const metric = 
+        PerformanceBaseline::summarize( "p95_ms", std::vector< double >( values, values + 4 ) );
+    
+    CPPUNIT_ASSERT_EQUAL( 2.5, metric.value );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.4826, metric.spread, 1e-12 );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testCheckLimits()
+{
+    PerformanceBaseline baseline;
+    baseline.setTolerance( 0.1 );
+    baseline.setSpreadFactor( 3.0 );
+    baseline.addScenario( makeScenario( "ctf" ) );
+    
+    std::vector< PerformanceBaseline::Metric > measured;
+    measured.push_back( makeMetric( "p50_ms", 13.9, 0.0 ) );
+    measured.push_back( makeMetric( "allocations", 0.5, 0.0 ) );
+    
+    std::vector< PerformanceBaseline::Check > checks = baseline.check( 0, measured );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), checks.size() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 14.0, checks[ 0 ].limit, 1e-12 );
+    CPPUNIT_ASSERT( ! checks[ 0 ].regression );
+    CPPUNIT_ASSERT( ! checks[ 0 ].improvement );
+    // Any allocation regresses a baseline of none.
+    CPPUNIT_ASSERT( checks[ 1 ].regression );
+    
+    measured[ 0 ].value = 14.1;
+    checks = baseline.check( 0, measured );
+    CPPUNIT_ASSERT( checks[ 0 ].regression );
+    
+    measured[ 0 ].value = 5.9;
+    checks = baseline.check( 0, measured );
+    CPPUNIT_ASSERT( ! checks[ 0 ].regression );
+    CPPUNIT_ASSERT( checks[ 0 ].improvement );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testCheckWithoutBaseline()
+{
+    PerformanceBaseline baseline;
+    baseline.addScenario( makeScenario( "ctf" ) );
+    
+    std::vector< PerformanceBaseline::Metric > measured;
+    measured.push_back( makeMetric( "p99_ms", 1e9, 0.0 ) );
+    
+    std::vector< PerformanceBaseline::Check > const checks = baseline.check( 0, measured );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), checks.size() );
+    CPPUNIT_ASSERT( ! checks[ 0 ].regression );
+    CPPUNIT_ASSERT( ! checks[ 0 ].improvement );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testTextRoundTrip()
+{
+    PerformanceBaseline baseline;
+    baseline.setTolerance( 0.2 );
+    baseline.setSpreadFactor( 2.0 );
+    baseline.setRepetitions( 9 );
+    baseline.addScenario( makeScenario( "Capture the Flag 4 seekers" ) );
+    baseline.addScenario( makeScenario( "second" ) );
+    
+    std::stringstream text;
+    baseline.write( text );
+    
+    PerformanceBaseline readBack;
+    CPPUNIT_ASSERT( readBack.read( text ) );
+    CPPUNIT_ASSERT_EQUAL( 0.2, readBack.tolerance() );
+    CPPUNIT_ASSERT_EQUAL( 2.0, readBack.spreadFactor() );
+    CPPUNIT_ASSERT_EQUAL( 9, readBack.repetitions() );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), readBack.scenarios().size() );
+    
+    PerformanceBaseline::Scenario const& scenario = readBack.scenarios()[ 0 ];
+    CPPUNIT_ASSERT_EQUAL( std::string( "Capture the Flag 4 seekers" ), scenario.name );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Capture the Flag" ), scenario.plugIn );
+    CPPUNIT_ASSERT_EQUAL( 600, scenario.frames );
+    CPPUNIT_ASSERT_EQUAL( 7u, scenario.seed );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), scenario.options.size() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "enemies=2" ), scenario.options[ 1 ] );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), scenario.metrics.size() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "p50_ms" ), scenario.metrics[ 0 ].name );
+    CPPUNIT_ASSERT_EQUAL( 10.0, scenario.metrics[ 0 ].value );
+    CPPUNIT_ASSERT_EQUAL( 1.0, scenario.metrics[ 0 ].spread );
+}
+
+
+
+void 
+OpenSteer::PerformanceBaselineTest::testReadMalformed()
+{
+    std::stringstream outside( "tolerance 0.1\nmetric p50_ms 1 0\n" );
+    PerformanceBaseline baseline;
+    CPPUNIT_ASSERT( ! baseline.read( outside ) );
+    CPPUNIT_ASSERT( ! baseline.errorMessage().empty() );
+    
+    std::stringstream unterminated( "scenario a\nplugin Boids\nframes 10\n" );
+    CPPUNIT_ASSERT( ! baseline.read( unterminated ) );
+    CPPUNIT_ASSERT( baseline.scenarios().empty() );
+    
+    std::stringstream noFrames( "scenario a\nplugin Boids\nend\n" );
+    CPPUNIT_ASSERT( ! baseline.read( noFrames ) );
+    CPPUNIT_ASSERT( baseline.scenarios().empty() );
+}
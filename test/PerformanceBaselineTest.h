@@ -0,0 +1,116 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PerformanceBaseline.
+ */
+#ifndef OPENSTEER_PERFORMANCEBASELINETEST_H
+#define OPENSTEER_PERFORMANCEBASELINETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::PerformanceBaseline
+#include "OpenSteer/PerformanceBaseline.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class PerformanceBaselineTest : public CppUnit::TestFixture {
+    public:
+        PerformanceBaselineTest();
+        virtual ~PerformanceBaselineTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(PerformanceBaselineTest);
+        CPPUNIT_TEST(testSummarizeOddCount);
+        CPPUNIT_TEST(testSummarizeEvenCount);
+        CPPUNIT_TEST(testCheckLimits);
+        CPPUNIT_TEST(testCheckWithoutBaseline);
+        CPPUNIT_TEST(testTextRoundTrip);
+        CPPUNIT_TEST(testReadMalformed);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PerformanceBaselineTest( PerformanceBaselineTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PerformanceBaselineTest& operator=( PerformanceBaselineTest const& );
+        
+    private:
+        /**
+         * Tests median and spread of an odd number of values with an 
+         * outlier.
+         */
+        void testSummarizeOddCount();
+        
+        /**
+         * Tests that the median of an even number of values is the mean of
+         * the middle ones.
+         */
+        void testSummarizeEvenCount();
+        
+        /**
+         * Tests the regression and improvement limits.
+         */
+        void testCheckLimits();
+        
+        /**
+         * Tests that metrics missing in the baseline never regress.
+         */
+        void testCheckWithoutBaseline();
+        
+        /**
+         * Tests that writing and reading text keeps thresholds and 
+         * scenarios.
+         */
+        void testTextRoundTrip();
+        
+        /**
+         * Tests that malformed text is reported and leaves it empty.
+         */
+        void testReadMalformed();
+        
+    }; // PerformanceBaselineTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PERFORMANCEBASELINETEST_H
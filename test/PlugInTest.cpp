@@ -0,0 +1,149 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PlugIn.
+ */
+#include "PlugInTest.h"
+
+
+// Include std::string
+#include <string>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PlugInTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    // Does nothing but register itself under the given name.
+    class NamedPlugIn : public PlugIn {
+    public:
+        explicit NamedPlugIn( char const* name ) : name_( name ) {}
+        
+        char const* name() { return name_; }
+        void open() {}
+        void update( float const, float const ) {}
+        void redraw( float const, float const ) {}
+        void close() {}
+        AVGroup const& allVehicles() { return vehicles_; }
+        
+    private:
+        char const* name_;
+        AVGroup vehicles_;
+    };
+    
+} // anonymous namespace
+
+
+
+OpenSteer::PlugInTest::PlugInTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PlugInTest::~PlugInTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::PlugInTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::PlugInTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::PlugInTest::testFindByName()
+{
+    int const count = PlugIn::count();
+    NamedPlugIn first( "PlugInTest first" );
+    NamedPlugIn second( "PlugInTest second" );
+    
+    CPPUNIT_ASSERT_EQUAL( count + 2, PlugIn::count() );
+    CPPUNIT_ASSERT( &first == PlugIn::findByName( "PlugInTest first" ) );
+    CPPUNIT_ASSERT( &second == PlugIn::findByName( "PlugInTest second" ) );
+    CPPUNIT_ASSERT( 0 == PlugIn::findByName( "PlugInTest unknown" ) );
+    CPPUNIT_ASSERT( 0 == PlugIn::findByName( 0 ) );
+}
+
+
+
+void 
+OpenSteer::PlugInTest::testFirstRegisteredNameWins()
+{
+    NamedPlugIn first( "PlugInTest twin" );
+    NamedPlugIn second( "PlugInTest twin" );
+    
+    CPPUNIT_ASSERT( &first == PlugIn::findByName( "PlugInTest twin" ) );
+}
+
+
+
+void 
+OpenSteer::PlugInTest::testDestructorUnregisters()
+{
+    int const count = PlugIn::count();
+    {
+        NamedPlugIn temporary( "PlugInTest temporary" );
+        CPPUNIT_ASSERT( &temporary == PlugIn::findByName( "PlugInTest temporary" ) );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( count, PlugIn::count() );
+    CPPUNIT_ASSERT( 0 == PlugIn::findByName( "PlugInTest temporary" ) );
+}
+
+
+
+void 
+OpenSteer::PlugInTest::testLoadMissingLibrary()
+{
+    int const count = PlugIn::count();
+    std::string errorMessage;
+    
+    CPPUNIT_ASSERT( ! PlugIn::loadLibrary( "PlugInTest-missing-library", errorMessage ) );
+    CPPUNIT_ASSERT( ! errorMessage.empty() );
+    CPPUNIT_ASSERT_EQUAL( count, PlugIn::count() );
+}
@@ -0,0 +1,217 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the ORCA solver in 
+ * @c OpenSteer/ReciprocalVelocityObstacle.h.
+ */
+#include "ReciprocalVelocityObstacleTest.h"
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::equalsRelative
+#include "OpenSteer/Vec3Utilities.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ReciprocalVelocityObstacleTest );
+
+
+
+OpenSteer::ReciprocalVelocityObstacleTest::ReciprocalVelocityObstacleTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ReciprocalVelocityObstacleTest::~ReciprocalVelocityObstacleTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    /**
+     * Returns @c true if @a velocity lies in the half-plane permitted by
+     * @a line (with a small tolerance).
+     */
+    bool permits( OpenSteer::OrcaLine const& line, OpenSteer::Vec3 const& velocity ) {
+        OpenSteer::Vec3 const offset( velocity - line.point );
+        return ( line.direction.x * offset.z - line.direction.z * offset.x ) >= -0.0001f;
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::testUnconstrained()
+{
+    Vec3 const preferred( 1.0f, 0.0f, 0.5f );
+    
+    Vec3 const result( solveOrcaLinearProgram( 0, 0, 2.0f, preferred ) );
+    CPPUNIT_ASSERT( equalsRelative( preferred, result ) );
+    
+    Vec3 const tooFast( 10.0f, 0.0f, 0.0f );
+    Vec3 const clamped( solveOrcaLinearProgram( 0, 0, 2.0f, tooFast ) );
+    CPPUNIT_ASSERT( equalsRelative( Vec3( 2.0f, 0.0f, 0.0f ), clamped ) );
+    
+    // A distant neighbor moving away doesn't constrain the velocity.
+    OrcaLine const line( computeOrcaLine( preferred,
+                                          Vec3( 0.0f, 0.0f, -20.0f ),
+                                          preferred - Vec3( 0.0f, 0.0f, -1.0f ),
+                                          1.0f,
+                                          3.0f,
+                                          0.1f ) );
+    Vec3 const stillPreferred( solveOrcaLinearProgram( &line, 1, 2.0f, preferred ) );
+    CPPUNIT_ASSERT( equalsRelative( preferred, stillPreferred ) );
+}
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::testHeadOn()
+{
+    Vec3 const positionA( -2.0f, 0.0f, 0.0f );
+    Vec3 const positionB( 2.0f, 0.0f, 0.0f );
+    Vec3 const velocityA( 1.0f, 0.0f, 0.0f );
+    Vec3 const velocityB( -1.0f, 0.0f, 0.0f );
+    float const combinedRadius = 1.0f;
+    float const timeHorizon = 4.0f;
+    
+    OrcaLine const lineA( computeOrcaLine( velocityA, 
+                                           positionB - positionA, 
+                                           velocityA - velocityB, 
+                                           combinedRadius, 
+                                           timeHorizon, 
+                                           0.1f ) );
+    OrcaLine const lineB( computeOrcaLine( velocityB, 
+                                           positionA - positionB, 
+                                           velocityB - velocityA, 
+                                           combinedRadius, 
+                                           timeHorizon, 
+                                           0.1f ) );
+    
+    // The current velocities lead to a collision.
+    CPPUNIT_ASSERT( ! permits( lineA, velocityA ) );
+    CPPUNIT_ASSERT( ! permits( lineB, velocityB ) );
+    
+    Vec3 const newVelocityA( solveOrcaLinearProgram( &lineA, 1, 2.0f, velocityA ) );
+    Vec3 const newVelocityB( solveOrcaLinearProgram( &lineB, 1, 2.0f, velocityB ) );
+    
+    CPPUNIT_ASSERT( permits( lineA, newVelocityA ) );
+    CPPUNIT_ASSERT( permits( lineB, newVelocityB ) );
+    CPPUNIT_ASSERT( newVelocityA.length() <= 2.0001f );
+    
+    // Both agents take half of the responsibility and swerve to opposite
+    // sides (in world space).
+    CPPUNIT_ASSERT( 0.0f != newVelocityA.z );
+    CPPUNIT_ASSERT( equalsRelative( newVelocityA.z, -newVelocityB.z, 0.001f ) );
+    
+    // The relative velocity doesn't lead into the collision disk within
+    // the time horizon.
+    Vec3 const relativeVelocity( newVelocityA - newVelocityB );
+    Vec3 const relativePosition( positionB - positionA );
+    float const closestApproachTime = relativePosition.dot( relativeVelocity ) / relativeVelocity.lengthSquared();
+    Vec3 const closest( relativePosition - relativeVelocity * closestApproachTime );
+    CPPUNIT_ASSERT( closest.length() >= combinedRadius - 0.001f );
+}
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::testSurrounded()
+{
+    // Four neighbors nearly touching us and closing in from all sides leave
+    // no feasible velocity.
+    Vec3 const velocity( 0.0f, 0.0f, 0.0f );
+    Vec3 const offsets[] = { Vec3( 1.05f, 0.0f, 0.0f ), 
+                             Vec3( -1.05f, 0.0f, 0.0f ), 
+                             Vec3( 0.0f, 0.0f, 1.05f ), 
+                             Vec3( 0.0f, 0.0f, -1.05f ) };
+    
+    OrcaLine lines[ 4 ];
+    for ( size_t i = 0; i < 4; ++i ) {
+        lines[ i ] = computeOrcaLine( velocity, 
+                                      offsets[ i ], 
+                                      velocity - ( -offsets[ i ] ), 
+                                      1.0f, 
+                                      2.0f, 
+                                      0.1f );
+    }
+    
+    Vec3 const result( solveOrcaLinearProgram( lines, 4, 2.0f, Vec3( 1.0f, 0.0f, 0.0f ) ) );
+    
+    // The least penetrating velocity is the symmetric one.
+    CPPUNIT_ASSERT( result.length() <= 2.0001f );
+    CPPUNIT_ASSERT( equalsRelative( result.x, 0.0f, 0.001f ) );
+    CPPUNIT_ASSERT( equalsRelative( result.z, 0.0f, 0.001f ) );
+}
+
+
+
+void 
+OpenSteer::ReciprocalVelocityObstacleTest::testOverlapWithoutTimeStep()
+{
+    // Standing still, overlapping a standing neighbor.
+    Vec3 const velocity( 0.0f, 0.0f, 0.0f );
+    Vec3 const offset( 0.5f, 0.0f, 0.0f );
+    float const timeHorizon = 2.0f;
+    
+    OrcaLine const paused( computeOrcaLine( velocity, offset, velocity, 1.0f, timeHorizon, 0.0f ) );
+    OrcaLine const overHorizon( computeOrcaLine( velocity, offset, velocity, 1.0f, timeHorizon, timeHorizon ) );
+    
+    CPPUNIT_ASSERT( equalsRelative( overHorizon.point, paused.point ) );
+    CPPUNIT_ASSERT( equalsRelative( overHorizon.direction, paused.direction ) );
+    
+    // Moving away from the neighbor is permitted, staying or moving into
+    // it isn't.
+    CPPUNIT_ASSERT( permits( paused, Vec3( -1.0f, 0.0f, 0.0f ) ) );
+    CPPUNIT_ASSERT( ! permits( paused, velocity ) );
+    CPPUNIT_ASSERT( ! permits( paused, Vec3( 0.5f, 0.0f, 0.0f ) ) );
+}
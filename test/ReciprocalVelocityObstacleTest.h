@@ -0,0 +1,106 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the ORCA solver in 
+ * @c OpenSteer/ReciprocalVelocityObstacle.h.
+ */
+#ifndef OPENSTEER_RECIPROCALVELOCITYOBSTACLETEST_H
+#define OPENSTEER_RECIPROCALVELOCITYOBSTACLETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::computeOrcaLine, OpenSteer::solveOrcaLinearProgram
+#include "OpenSteer/ReciprocalVelocityObstacle.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class ReciprocalVelocityObstacleTest : public CppUnit::TestFixture {
+    public:
+        ReciprocalVelocityObstacleTest();
+        virtual ~ReciprocalVelocityObstacleTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ReciprocalVelocityObstacleTest);
+        CPPUNIT_TEST(testUnconstrained);
+        CPPUNIT_TEST(testHeadOn);
+        CPPUNIT_TEST(testSurrounded);
+        CPPUNIT_TEST(testOverlapWithoutTimeStep);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ReciprocalVelocityObstacleTest( ReciprocalVelocityObstacleTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ReciprocalVelocityObstacleTest& operator=( ReciprocalVelocityObstacleTest const& );
+        
+    private:
+        /**
+         * Tests that the preferred velocity is kept if no line constrains 
+         * it and is clamped to the max speed.
+         */
+        void testUnconstrained();
+        
+        /**
+         * Tests that two agents on a head-on course get velocities outside
+         * of each others velocity obstacle.
+         */
+        void testHeadOn();
+        
+        /**
+         * Tests the infeasible case of an agent squeezed by neighbors from
+         * all sides.
+         */
+        void testSurrounded();
+        
+        /**
+         * Tests that overlapping agents are pushed apart within the time 
+         * horizon if no time elapses.
+         */
+        void testOverlapWithoutTimeStep();
+        
+    }; // ReciprocalVelocityObstacleTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_RECIPROCALVELOCITYOBSTACLETEST_H
@@ -0,0 +1,342 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Scenario.
+ */
+#include "ScenarioTest.h"
+
+
+// Include std::stringstream
+#include <sstream>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ScenarioTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Fills @a scenario with one or more records of each kind.
+     */
+    void 
+    makeScenario( Scenario& scenario )
+    {
+        scenario.addParameter( "pedestrians", "3" );
+        scenario.addParameter( "note", "value with spaces" );
+        scenario.addSphere( Vec3( 1.0f, 2.0f, 3.0f ), 4.0f );
+        scenario.addSphere( Vec3( -1.0f, 0.1f, 1.0f / 3.0f ), 0.5f );
+        
+        Scenario::Box const box = { Vec3( 5.0f, 0.0f, 5.0f ), Vec3::forward, Vec3::side, Vec3::up, 1.0f, 2.0f, 3.0f };
+        scenario.addBox( box );
+        
+        Vec3 const points[] = { Vec3( 0.0f, 0.0f, 0.0f ), Vec3( 10.0f, 0.0f, 0.0f ), Vec3( 10.0f, 0.0f, 7.5f ) };
+        scenario.addPath( "first", 2.0f, false, 3, points );
+        scenario.addPath( "second", 1.5f, true, 2, points + 1 );
+        
+        Scenario::Agent const agents[] = { { Vec3( 1.0f, 0.0f, 1.0f ), Vec3::forward, 0.0f },
+                                           { Vec3( 2.0f, 0.0f, 1.0f ), Vec3::side, 1.25f },
+                                           { Vec3( 3.0f, 0.0f, 1.0f ), Vec3( 0.6f, 0.0f, 0.8f ), 2.0f / 3.0f } };
+        scenario.addPopulation( "pedestrians", 3, agents );
+        scenario.addPopulation( "nobody", 0, agents );
+    }
+    
+    
+    /**
+     * Asserts that @a scenario holds exactly what @c makeScenario adds.
+     */
+    void 
+    checkScenario( Scenario const& scenario )
+    {
+        Scenario expected;
+        makeScenario( expected );
+        
+        CPPUNIT_ASSERT( expected.parameters() == scenario.parameters() );
+        
+        CPPUNIT_ASSERT_EQUAL( expected.spheres().size(), scenario.spheres().size() );
+        for ( Scenario::size_type i = 0; i < expected.spheres().size(); ++i ) {
+            CPPUNIT_ASSERT( expected.spheres()[ i ].center == scenario.spheres()[ i ].center );
+            CPPUNIT_ASSERT_EQUAL( expected.spheres()[ i ].radius, scenario.spheres()[ i ].radius );
+        }
+        
+        CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 1 ), scenario.boxes().size() );
+        Scenario::Box const& box = scenario.boxes()[ 0 ];
+        CPPUNIT_ASSERT( expected.boxes()[ 0 ].position == box.position );
+        CPPUNIT_ASSERT( expected.boxes()[ 0 ].side == box.side );
+        CPPUNIT_ASSERT_EQUAL( 3.0f, box.depth );
+        
+        CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 2 ), scenario.paths().size() );
+        for ( Scenario::size_type i = 0; i < expected.paths().size(); ++i ) {
+            Scenario::Path const& e = expected.paths()[ i ];
+            Scenario::Path const& p = scenario.paths()[ i ];
+            CPPUNIT_ASSERT_EQUAL( e.name, p.name );
+            CPPUNIT_ASSERT_EQUAL( e.radius, p.radius );
+            CPPUNIT_ASSERT_EQUAL( e.cyclic, p.cyclic );
+            CPPUNIT_ASSERT_EQUAL( e.pointCount, p.pointCount );
+            for ( Scenario::size_type k = 0; k < e.pointCount; ++k ) {
+                CPPUNIT_ASSERT( expected.pathPoints( e )[ k ] == scenario.pathPoints( p )[ k ] );
+            }
+        }
+        
+        CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 2 ), scenario.populations().size() );
+        Scenario::size_type const walkers = scenario.findPopulation( "pedestrians" );
+        CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 0 ), walkers );
+        CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 0 ), scenario.populations()[ 1 ].agentCount );
+        Scenario::Population const& population = scenario.populations()[ walkers ];
+        for ( Scenario::size_type k = 0; k < population.agentCount; ++k ) {
+            Scenario::Agent const& e = expected.populationAgents( expected.populations()[ 0 ] )[ k ];
+            Scenario::Agent const& a = scenario.populationAgents( population )[ k ];
+            CPPUNIT_ASSERT( e.position == a.position );
+            CPPUNIT_ASSERT( e.forward == a.forward );
+            CPPUNIT_ASSERT_EQUAL( e.speed, a.speed );
+        }
+    }
+    
+    
+    void 
+    appendCount( std::string& bytes, unsigned int count )
+    {
+        bytes.append( reinterpret_cast< char const* >( &count ), sizeof( count ) );
+    }
+    
+    void 
+    appendFloat( std::string& bytes, float value )
+    {
+        bytes.append( reinterpret_cast< char const* >( &value ), sizeof( value ) );
+    }
+    
+    /**
+     * Returns a binary header with the given record counts.
+     */
+    std::string 
+    binaryHeader( unsigned int parameters, unsigned int spheres, unsigned int paths, unsigned int points )
+    {
+        std::string bytes( "OSSB" );
+        appendCount( bytes, 1 );
+        appendCount( bytes, parameters );
+        appendCount( bytes, spheres );
+        appendCount( bytes, 0 );
+        appendCount( bytes, paths );
+        appendCount( bytes, points );
+        appendCount( bytes, 0 );
+        appendCount( bytes, 0 );
+        return bytes;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::ScenarioTest::ScenarioTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ScenarioTest::~ScenarioTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ScenarioTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testTextRoundTrip()
+{
+    Scenario written;
+    makeScenario( written );
+    std::stringstream stream;
+    written.write( stream, Scenario::text );
+    
+    Scenario scenario;
+    CPPUNIT_ASSERT( scenario.read( stream, Scenario::text ) );
+    checkScenario( scenario );
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testBinaryRoundTrip()
+{
+    Scenario written;
+    makeScenario( written );
+    std::stringstream stream;
+    written.write( stream, Scenario::binary );
+    
+    Scenario scenario;
+    CPPUNIT_ASSERT( scenario.read( stream, Scenario::binary ) );
+    checkScenario( scenario );
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testMalformedInput()
+{
+    Scenario scenario;
+    
+    std::istringstream unknown( "sphere 0 0 0 1\nteapot 1 2 3\n" );
+    CPPUNIT_ASSERT( ! scenario.read( unknown, Scenario::text ) );
+    CPPUNIT_ASSERT( ! scenario.errorMessage().empty() );
+    CPPUNIT_ASSERT( scenario.spheres().empty() );
+    
+    std::istringstream shortPath( "path p 1 open 3 0 0 0 1 1 1\n" );
+    CPPUNIT_ASSERT( ! scenario.read( shortPath, Scenario::text ) );
+    CPPUNIT_ASSERT( scenario.paths().empty() );
+    
+    std::istringstream badClosing( "path p 1 closed 2 0 0 0 1 1 1\n" );
+    CPPUNIT_ASSERT( ! scenario.read( badClosing, Scenario::text ) );
+    
+    std::istringstream commented( "# sphere 1\nsphere 0 0 0 1 # unit sphere\n" );
+    CPPUNIT_ASSERT( scenario.read( commented, Scenario::text ) );
+    CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 1 ), scenario.spheres().size() );
+    
+    // binary input cut short
+    Scenario written;
+    makeScenario( written );
+    std::stringstream stream;
+    written.write( stream, Scenario::binary );
+    std::string const bytes = stream.str();
+    std::istringstream truncated( bytes.substr( 0, bytes.size() - 5 ) );
+    CPPUNIT_ASSERT( ! scenario.read( truncated, Scenario::binary ) );
+    CPPUNIT_ASSERT( scenario.populations().empty() );
+    
+    std::istringstream text( "sphere 0 0 0 1\n" );
+    CPPUNIT_ASSERT( ! scenario.read( text, Scenario::binary ) );
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testCorruptBinaryCounts()
+{
+    Scenario scenario;
+    
+    // a path of a single point, rejected as by the text reader
+    std::string onePoint = binaryHeader( 0, 0, 1, 1 );
+    appendCount( onePoint, 1 );
+    onePoint += 'p';
+    appendFloat( onePoint, 1.0f );
+    appendCount( onePoint, 0 );
+    appendCount( onePoint, 1 );
+    for ( int i = 0; i < 3; ++i ) {
+        appendFloat( onePoint, 0.0f );
+    }
+    std::istringstream onePointStream( onePoint );
+    CPPUNIT_ASSERT( ! scenario.read( onePointStream, Scenario::binary ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "corrupt paths" ), scenario.errorMessage() );
+    CPPUNIT_ASSERT( scenario.paths().empty() );
+    
+    // counts far beyond the bytes that follow the header
+    std::istringstream parameters( binaryHeader( 1u << 28, 0, 0, 0 ) );
+    CPPUNIT_ASSERT( ! scenario.read( parameters, Scenario::binary ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "corrupt parameters" ), scenario.errorMessage() );
+    
+    std::istringstream spheres( binaryHeader( 0, 1u << 28, 0, 0 ) );
+    CPPUNIT_ASSERT( ! scenario.read( spheres, Scenario::binary ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "corrupt spheres" ), scenario.errorMessage() );
+    
+    std::istringstream paths( binaryHeader( 0, 0, 1u << 28, 0 ) );
+    CPPUNIT_ASSERT( ! scenario.read( paths, Scenario::binary ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "corrupt paths" ), scenario.errorMessage() );
+    
+    std::string longName = binaryHeader( 1, 0, 0, 0 );
+    appendCount( longName, 1u << 28 );
+    std::istringstream longNameStream( longName );
+    CPPUNIT_ASSERT( ! scenario.read( longNameStream, Scenario::binary ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "corrupt parameters" ), scenario.errorMessage() );
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testBuildObstacles()
+{
+    Scenario scenario;
+    makeScenario( scenario );
+    
+    std::vector< SphereObstacle > spheres;
+    std::vector< BoxObstacle > boxes;
+    ObstacleGroup obstacles;
+    scenario.buildObstacles( spheres, boxes, obstacles );
+    
+    CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 2 ), spheres.size() );
+    CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 1 ), boxes.size() );
+    CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 3 ), obstacles.size() );
+    CPPUNIT_ASSERT( obstacles[ 0 ] == &spheres[ 0 ] );
+    CPPUNIT_ASSERT( obstacles[ 2 ] == &boxes[ 0 ] );
+    CPPUNIT_ASSERT_EQUAL( 4.0f, spheres[ 0 ].radius );
+    CPPUNIT_ASSERT( Vec3( 5.0f, 0.0f, 5.0f ) == boxes[ 0 ].position() );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, boxes[ 0 ].height );
+}
+
+
+
+void 
+OpenSteer::ScenarioTest::testAcquirePath()
+{
+    Scenario scenario;
+    makeScenario( scenario );
+    scenario.setName( "test scenario" );
+    Scenario other;
+    makeScenario( other );
+    other.setName( "test scenario" );
+    
+    PathRegistry registry;
+    PathRegistry::PathPointer const first = scenario.acquirePath( 0, registry );
+    PathRegistry::PathPointer const second = scenario.acquirePath( 1, registry );
+    
+    CPPUNIT_ASSERT( first.get() == other.acquirePath( 0, registry ).get() );
+    CPPUNIT_ASSERT( first.get() != second.get() );
+    CPPUNIT_ASSERT_EQUAL( Scenario::size_type( 3 ), first->pointCount() );
+    CPPUNIT_ASSERT( second->isCyclic() );
+    CPPUNIT_ASSERT_EQUAL( 1.5f, second->radius() );
+}
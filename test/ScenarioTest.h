@@ -0,0 +1,115 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Scenario.
+ */
+#ifndef OPENSTEER_SCENARIOTEST_H
+#define OPENSTEER_SCENARIOTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::Scenario
+#include "OpenSteer/Scenario.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class ScenarioTest : public CppUnit::TestFixture {
+    public:
+        ScenarioTest();
+        virtual ~ScenarioTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ScenarioTest);
+        CPPUNIT_TEST(testTextRoundTrip);
+        CPPUNIT_TEST(testBinaryRoundTrip);
+        CPPUNIT_TEST(testMalformedInput);
+        CPPUNIT_TEST(testCorruptBinaryCounts);
+        CPPUNIT_TEST(testBuildObstacles);
+        CPPUNIT_TEST(testAcquirePath);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ScenarioTest( ScenarioTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ScenarioTest& operator=( ScenarioTest const& );
+        
+    private:
+        /**
+         * Tests that a scenario written as text reads back unchanged.
+         */
+        void testTextRoundTrip();
+        
+        /**
+         * Tests that a scenario written as binary reads back unchanged.
+         */
+        void testBinaryRoundTrip();
+        
+        /**
+         * Tests that malformed input is rejected with a message and leaves
+         * the scenario empty.
+         */
+        void testMalformedInput();
+        
+        /**
+         * Tests that binary counts are checked against the input before
+         * anything is allocated for them.
+         */
+        void testCorruptBinaryCounts();
+        
+        /**
+         * Tests that obstacles are built in place with their shapes.
+         */
+        void testBuildObstacles();
+        
+        /**
+         * Tests that scenarios of the same name share their paths.
+         */
+        void testAcquirePath();
+        
+    }; // ScenarioTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SCENARIOTEST_H
@@ -27,11 +27,21 @@
  *
  * @author Bjoern Knafla <bknafla@uni-kassel.de>
  *
- * Unit test for @c OpenSteer::SharedPointer.
+ * Unit test for @c OpenSteer::SharedPointer and 
+ * @c OpenSteer::IntrusivePointer.
  */
 #include "SharedPointerTest.h"
 
 
+// Include std::vector
+#include <vector>
+
+#if ! defined( _WIN32 )
+    // Include pthread_create, pthread_join
+    #include <pthread.h>
+#endif
+
+
 
 
 
@@ -433,3 +443,218 @@ OpenSteer::SharedPointerTest::testSwap()
 
 
 
+
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    template< typename ReferenceCount >
+    struct Counted : public ReferenceCounted< ReferenceCount > {
+        Counted() {
+            ++instanceCount_;
+        }
+        
+        Counted( Counted const& other ) : ReferenceCounted< ReferenceCount >( other ) {
+            ++instanceCount_;
+        }
+        
+        virtual ~Counted() {
+            --instanceCount_;
+        }
+        
+        static int instanceCount_;
+    };
+    
+    template< typename ReferenceCount > int Counted< ReferenceCount >::instanceCount_ = 0;
+    
+    
+    struct CountedSub : public Counted< AtomicReferenceCount > {
+        CountedSub() : value_( 42 ) {
+            // Nothing to do.
+        }
+        
+        int value_;
+    };
+    
+    
+    typedef Counted< AtomicReferenceCount > AtomicCounted;
+    typedef Counted< PlainReferenceCount > PlainCounted;
+    typedef IntrusivePointer< AtomicCounted > AtomicPointer;
+    
+    
+    int const copiesPerThread = 100000;
+    int const threadCount = 4;
+    
+    
+    void* 
+    copyRepeatedly( void* shared )
+    {
+        AtomicPointer const& pointer = *static_cast< AtomicPointer const* >( shared );
+        std::vector< AtomicPointer > copies( 16 );
+        for ( int i = 0; i < copiesPerThread; ++i ) {
+            copies[ i % copies.size() ] = pointer;
+            if ( 15 == i % 16 ) {
+                std::vector< AtomicPointer >( copies.size() ).swap( copies );
+            }
+        }
+        return 0;
+    }
+    
+    
+    void* 
+    releaseOwnCopy( void* ownCopy )
+    {
+        AtomicPointer* pointer = static_cast< AtomicPointer* >( ownCopy );
+        for ( int i = 0; i < copiesPerThread; ++i ) {
+            AtomicPointer copy( *pointer );
+        }
+        pointer->reset();
+        return 0;
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SharedPointerTest::testIntrusiveConstruction()
+{
+    CPPUNIT_ASSERT_EQUAL( 0, AtomicCounted::instanceCount_ );
+    
+    {
+        AtomicPointer empty;
+        CPPUNIT_ASSERT( ! empty );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), empty.useCount() );
+    }
+    
+    AtomicCounted* rawPointer = new AtomicCounted();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), rawPointer->useCount() );
+    
+    {
+        AtomicPointer ip0( rawPointer );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), ip0.useCount() );
+        {
+            AtomicPointer ip1( ip0 );
+            AtomicPointer ip2( rawPointer );
+            CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), ip0.useCount() );
+            CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), rawPointer->useCount() );
+            CPPUNIT_ASSERT( ip1 == ip2 );
+            CPPUNIT_ASSERT_EQUAL( rawPointer, ip2.get() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 1, AtomicCounted::instanceCount_ );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), ip0.useCount() );
+        
+        ip0.reset( new AtomicCounted() );
+        CPPUNIT_ASSERT_EQUAL( 1, AtomicCounted::instanceCount_ );
+        CPPUNIT_ASSERT( rawPointer != ip0.get() );
+        
+        // A copied object isn't shared with the original.
+        AtomicPointer ip3( new AtomicCounted( *ip0 ) );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), ip3.useCount() );
+        CPPUNIT_ASSERT_EQUAL( 2, AtomicCounted::instanceCount_ );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( 0, AtomicCounted::instanceCount_ );
+}
+
+
+
+void 
+OpenSteer::SharedPointerTest::testIntrusiveInheritance()
+{
+    {
+        IntrusivePointer< CountedSub > sub( new CountedSub() );
+        AtomicPointer super( sub );
+        IntrusivePointer< AtomicCounted const > constSuper;
+        constSuper = super;
+        
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), sub.useCount() );
+        CPPUNIT_ASSERT( sub == super );
+        CPPUNIT_ASSERT( constSuper == sub );
+        CPPUNIT_ASSERT_EQUAL( 42, sub->value_ );
+        
+        sub.reset();
+        super.reset();
+        CPPUNIT_ASSERT_EQUAL( 1, AtomicCounted::instanceCount_ );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), constSuper.useCount() );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( 0, AtomicCounted::instanceCount_ );
+}
+
+
+
+void 
+OpenSteer::SharedPointerTest::testIntrusivePlainCount()
+{
+    {
+        IntrusivePointer< PlainCounted > ip0( new PlainCounted() );
+        IntrusivePointer< PlainCounted > ip1;
+        
+        CPPUNIT_ASSERT( ! ip1 );
+        ip1 = ip0;
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), ip0.useCount() );
+        
+        swap( ip0, ip1 );
+        ip0.reset();
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), ip1.useCount() );
+        CPPUNIT_ASSERT_EQUAL( 1, PlainCounted::instanceCount_ );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( 0, PlainCounted::instanceCount_ );
+}
+
+
+
+void 
+OpenSteer::SharedPointerTest::testConcurrentCopies()
+{
+#if ! defined( _WIN32 )
+    AtomicPointer shared( new AtomicCounted() );
+    
+    pthread_t threads[ threadCount ];
+    for ( int i = 0; i < threadCount; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 0, pthread_create( &threads[ i ], 0, copyRepeatedly, &shared ) );
+    }
+    for ( int i = 0; i < threadCount; ++i ) {
+        pthread_join( threads[ i ], 0 );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), shared.useCount() );
+    CPPUNIT_ASSERT_EQUAL( 1, AtomicCounted::instanceCount_ );
+    
+    shared.reset();
+    CPPUNIT_ASSERT_EQUAL( 0, AtomicCounted::instanceCount_ );
+#endif
+}
+
+
+
+void 
+OpenSteer::SharedPointerTest::testConcurrentRelease()
+{
+#if ! defined( _WIN32 )
+    for ( int round = 0; round < 100; ++round ) {
+        AtomicPointer copies[ threadCount ];
+        {
+            AtomicPointer shared( new AtomicCounted() );
+            for ( int i = 0; i < threadCount; ++i ) {
+                copies[ i ] = shared;
+            }
+        }
+        
+        pthread_t threads[ threadCount ];
+        for ( int i = 0; i < threadCount; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( 0, pthread_create( &threads[ i ], 0, releaseOwnCopy, &copies[ i ] ) );
+        }
+        for ( int i = 0; i < threadCount; ++i ) {
+            pthread_join( threads[ i ], 0 );
+        }
+        
+        CPPUNIT_ASSERT_EQUAL( 0, AtomicCounted::instanceCount_ );
+    }
+#endif
+}
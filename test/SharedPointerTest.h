@@ -27,7 +27,8 @@
  *
  * @author Bjoern Knafla <bknafla@uni-kassel.de>
  *
- * Unit test for @c OpenSteer::SharedPointer.
+ * Unit test for @c OpenSteer::SharedPointer and 
+ * @c OpenSteer::IntrusivePointer.
  */
 #ifndef OPENSTEER_SHAREDPOINTERTEST_H
 #define OPENSTEER_SHAREDPOINTERTEST_H
@@ -42,6 +43,9 @@
 // Include OpenSteer::SharedPointer
 #include "OpenSteer/SharedPointer.h"
 
+// Include OpenSteer::IntrusivePointer
+#include "OpenSteer/IntrusivePointer.h"
+
 
 
 namespace OpenSteer {
@@ -63,6 +67,11 @@ namespace OpenSteer {
         CPPUNIT_TEST(testComparisons);
         CPPUNIT_TEST(testImplicitBoolCast);
         CPPUNIT_TEST(testSwap);
+        CPPUNIT_TEST(testIntrusiveConstruction);
+        CPPUNIT_TEST(testIntrusiveInheritance);
+        CPPUNIT_TEST(testIntrusivePlainCount);
+        CPPUNIT_TEST(testConcurrentCopies);
+        CPPUNIT_TEST(testConcurrentRelease);
         CPPUNIT_TEST_SUITE_END();
         
     private:
@@ -114,6 +123,35 @@ namespace OpenSteer {
          */
         void testSwap();
         
+        /**
+         * Tests that intrusive pointers share the count inside the object,
+         * also when made from the raw pointer again.
+         */
+        void testIntrusiveConstruction();
+        
+        /**
+         * Tests intrusive pointers to a super class managing instances of
+         * a sub class.
+         */
+        void testIntrusiveInheritance();
+        
+        /**
+         * Tests intrusive pointers to objects with a non-atomic count.
+         */
+        void testIntrusivePlainCount();
+        
+        /**
+         * Tests that copies made and destroyed by several threads at once
+         * leave the count where it was.
+         */
+        void testConcurrentCopies();
+        
+        /**
+         * Tests that an object shared by several threads is deleted exactly
+         * once by whichever thread releases it last.
+         */
+        void testConcurrentRelease();
+        
         
 
         
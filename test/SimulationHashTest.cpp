@@ -0,0 +1,142 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SimulationHash.
+ */
+#include "SimulationHashTest.h"
+
+
+// Include std::numeric_limits
+#include <limits>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SimulationHashTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    SimulationHash::digest_type 
+    digestOf( Vec3 const& first, Vec3 const& second )
+    {
+        SimulationHash hash;
+        hash.add( first );
+        hash.add( second );
+        return hash.value();
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::SimulationHashTest::SimulationHashTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SimulationHashTest::~SimulationHashTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::SimulationHashTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::testEqualStatesDigestAlike()
+{
+    Vec3 const a( 1.0f, 2.0f, 3.0f );
+    Vec3 const b( 0.6f, 0.0f, 0.8f );
+    
+    CPPUNIT_ASSERT_EQUAL( digestOf( a, b ), digestOf( Vec3( 1.0f, 2.0f, 3.0f ), b ) );
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::testSmallestChangeChangesDigest()
+{
+    Vec3 const a( 1.0f, 2.0f, 3.0f );
+    Vec3 const b( 0.6f, 0.0f, 0.8f );
+    Vec3 const changed( 1.0f, 2.0f, 3.0f + 3.0f * std::numeric_limits< float >::epsilon() );
+    
+    CPPUNIT_ASSERT( 3.0f != changed.z );
+    CPPUNIT_ASSERT( digestOf( a, b ) != digestOf( changed, b ) );
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::testOrderChangesDigest()
+{
+    Vec3 const a( 1.0f, 2.0f, 3.0f );
+    Vec3 const b( 0.6f, 0.0f, 0.8f );
+    
+    CPPUNIT_ASSERT( digestOf( a, b ) != digestOf( b, a ) );
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::testNegativeZero()
+{
+    SimulationHash zero;
+    zero.add( 0.0f );
+    SimulationHash negativeZero;
+    negativeZero.add( -0.0f );
+    
+    CPPUNIT_ASSERT_EQUAL( zero.value(), negativeZero.value() );
+}
+
+
+
+void 
+OpenSteer::SimulationHashTest::testEmptyGroup()
+{
+    CPPUNIT_ASSERT_EQUAL( SimulationHash().value(), SimulationHash::digest( AVGroup() ) );
+}
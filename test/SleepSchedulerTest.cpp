@@ -0,0 +1,298 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SleepScheduler.
+ */
+#include "SleepSchedulerTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SleepSchedulerTest );
+
+
+
+OpenSteer::SleepSchedulerTest::SleepSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SleepSchedulerTest::~SleepSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Moves with a constant velocity and counts its updates.
+     */
+    class ConstantVelocityVehicle : public LocalSpaceMixin< AbstractVehicle > {
+    public:
+        ConstantVelocityVehicle() : velocity_( Vec3::zero ), updateCount( 0 ) {}
+        
+        virtual float mass() const { return 1.0f; }
+        virtual float setMass( float m ) { return m; }
+        virtual float radius() const { return 0.5f; }
+        virtual float setRadius( float r ) { return r; }
+        virtual Vec3 velocity() const { return velocity_; }
+        virtual float speed() const { return velocity_.length(); }
+        virtual float setSpeed( float s ) { velocity_ = velocity_.normalize() * s; return s; }
+        virtual Vec3 predictFuturePosition( float const t ) const { return position() + velocity_ * t; }
+        virtual float maxForce() const { return 1.0f; }
+        virtual float setMaxForce( float f ) { return f; }
+        virtual float maxSpeed() const { return 1.0f; }
+        virtual float setMaxSpeed( float s ) { return s; }
+        
+        virtual void update( float const, float const elapsedTime ) {
+            ++updateCount;
+            setPosition( position() + velocity_ * elapsedTime );
+        }
+        
+        Vec3 velocity_;
+        int updateCount;
+    }; // class ConstantVelocityVehicle
+    
+    
+    typedef std::vector< ConstantVelocityVehicle > VehicleVector;
+    
+    /**
+     * Fills @a group with pointers to the vehicles of @a vehicles.
+     */
+    void fillGroup( VehicleVector& vehicles, AVGroup& group ) {
+        group.clear();
+        for ( VehicleVector::size_type i = 0; i < vehicles.size(); ++i ) {
+            group.push_back( &vehicles[ i ] );
+        }
+    }
+    
+    
+    /**
+     * Sleep scheduler covering a 100x100 area around the origin.
+     */
+    class TestSleepScheduler : public SleepScheduler {
+    public:
+        TestSleepScheduler() 
+            : SleepScheduler( Vec3::zero, Vec3( 100.0f, 100.0f, 100.0f ), Vec3( 10.0f, 1.0f, 10.0f ) ) {
+            setFramesUntilSleep( 3 );
+            setWakeRadius( 2.0f );
+        }
+    }; // class TestSleepScheduler
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::testRestingVehiclesFallAsleep()
+{
+    VehicleVector vehicles( 3 );
+    vehicles[ 0 ].setPosition( -10.0f, 0.0f, 0.0f );
+    vehicles[ 1 ].setPosition( 10.0f, 0.0f, 0.0f );
+    vehicles[ 2 ].setPosition( 0.0f, 0.0f, -30.0f );
+    vehicles[ 2 ].velocity_ = Vec3( 0.0f, 0.0f, 1.0f );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    TestSleepScheduler scheduler;
+    
+    for ( int frame = 0; frame < 2; ++frame ) {
+        scheduler.update( group, 0.0f, 0.1f );
+    }
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 0 ), scheduler.sleepingVehicleCount() );
+    
+    scheduler.update( group, 0.0f, 0.1f );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 2 ), scheduler.sleepingVehicleCount() );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 1 ), scheduler.awakeVehicleCount() );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 2 ), scheduler.fellAsleepVehicleCount() );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 0 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 1 ) );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 2 ) );
+    
+    for ( int frame = 0; frame < 5; ++frame ) {
+        scheduler.update( group, 0.0f, 0.1f );
+    }
+    CPPUNIT_ASSERT_EQUAL( 3, vehicles[ 0 ].updateCount );
+    CPPUNIT_ASSERT_EQUAL( 3, vehicles[ 1 ].updateCount );
+    CPPUNIT_ASSERT_EQUAL( 8, vehicles[ 2 ].updateCount );
+}
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::testMovingVehicleWakesSleepers()
+{
+    VehicleVector vehicles( 3 );
+    vehicles[ 0 ].setPosition( 0.0f, 0.0f, 0.0f );
+    vehicles[ 1 ].setPosition( 0.0f, 0.0f, 20.0f );
+    
+    // Starts moving towards the first vehicle once both others sleep.
+    vehicles[ 2 ].setPosition( -5.0f, 0.0f, 0.0f );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    TestSleepScheduler scheduler;
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.update( group, 0.0f, 0.5f );
+    }
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 3 ), scheduler.sleepingVehicleCount() );
+    
+    scheduler.wake( 2 );
+    vehicles[ 2 ].velocity_ = Vec3( 1.0f, 0.0f, 0.0f );
+    
+    // Six frames move the vehicle from -5 to -2, just outside wake range.
+    for ( int frame = 0; frame < 6; ++frame ) {
+        scheduler.update( group, 0.0f, 0.5f );
+    }
+    CPPUNIT_ASSERT( scheduler.isAsleep( 0 ) );
+    
+    // The next frame moves it to -1.5, within wake range.
+    scheduler.update( group, 0.0f, 0.5f );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 0 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 1 ), scheduler.wokenVehicleCount() );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 2 ), scheduler.awakeVehicleCount() );
+}
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::testExternalWake()
+{
+    VehicleVector vehicles( 4 );
+    vehicles[ 0 ].setPosition( 0.0f, 0.0f, 0.0f );
+    vehicles[ 1 ].setPosition( 1.0f, 0.0f, 0.0f );
+    vehicles[ 2 ].setPosition( 20.0f, 0.0f, 0.0f );
+    vehicles[ 3 ].setPosition( -20.0f, 0.0f, 0.0f );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    TestSleepScheduler scheduler;
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.update( group, 0.0f, 0.1f );
+    }
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 4 ), scheduler.sleepingVehicleCount() );
+    
+    scheduler.wake( 3 );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 3 ) );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 3 ), scheduler.sleepingVehicleCount() );
+    
+    scheduler.wakeWithin( Vec3( 0.5f, 0.0f, 0.0f ), 1.0f );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 0 ) );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 1 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 3 ), scheduler.awakeVehicleCount() );
+    
+    // Woken vehicles are updated again.
+    scheduler.update( group, 0.0f, 0.1f );
+    CPPUNIT_ASSERT_EQUAL( 4, vehicles[ 0 ].updateCount );
+    CPPUNIT_ASSERT_EQUAL( 3, vehicles[ 2 ].updateCount );
+    
+    // Removing the sleeping vehicle at the end of the group is fine.
+    vehicles[ 3 ].setPosition( 30.0f, 0.0f, 0.0f );
+    group.pop_back();
+    scheduler.update( group, 0.0f, 0.1f );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 3 ), scheduler.sleepingVehicleCount() + scheduler.awakeVehicleCount() );
+}
+
+
+
+void 
+OpenSteer::SleepSchedulerTest::testRemovedVehiclesAreForgotten()
+{
+    VehicleVector vehicles( 4 );
+    vehicles[ 0 ].setPosition( 0.0f, 0.0f, 0.0f );
+    vehicles[ 1 ].setPosition( 10.0f, 0.0f, 0.0f );
+    vehicles[ 2 ].setPosition( 20.0f, 0.0f, 0.0f );
+    vehicles[ 3 ].setPosition( -20.0f, 0.0f, 0.0f );
+    vehicles[ 3 ].velocity_ = Vec3( 0.0f, 0.0f, 1.0f );
+    AVGroup group;
+    fillGroup( vehicles, group );
+    
+    TestSleepScheduler scheduler;
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.update( group, 0.0f, 0.1f );
+    }
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 3 ), scheduler.sleepingVehicleCount() );
+    
+    // Removing a sleeper from the middle moves the ones behind it down.
+    scheduler.remove( 1 );
+    group.erase( group.begin() + 1 );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 2 ), scheduler.sleepingVehicleCount() );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 0 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 1 ) );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 2 ) );
+    
+    // Waking by index and by area still finds the right vehicles.
+    scheduler.wakeWithin( Vec3( 20.0f, 0.0f, 0.0f ), 1.0f );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 1 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 0 ) );
+    
+    // A sleeper replaced by another vehicle at its index doesn't pass its
+    // sleep on, the new vehicle is updated.
+    ConstantVelocityVehicle replacement;
+    replacement.setPosition( 40.0f, 0.0f, 0.0f );
+    group[ 0 ] = &replacement;
+    scheduler.update( group, 0.0f, 0.1f );
+    CPPUNIT_ASSERT_EQUAL( 1, replacement.updateCount );
+    CPPUNIT_ASSERT_EQUAL( SleepScheduler::size_type( 0 ), scheduler.sleepingVehicleCount() );
+}
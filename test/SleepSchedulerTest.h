@@ -0,0 +1,105 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SleepScheduler.
+ */
+#ifndef OPENSTEER_SLEEPSCHEDULERTEST_H
+#define OPENSTEER_SLEEPSCHEDULERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::SleepScheduler
+#include "OpenSteer/SleepScheduler.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class SleepSchedulerTest : public CppUnit::TestFixture {
+    public:
+        SleepSchedulerTest();
+        virtual ~SleepSchedulerTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SleepSchedulerTest);
+        CPPUNIT_TEST(testRestingVehiclesFallAsleep);
+        CPPUNIT_TEST(testMovingVehicleWakesSleepers);
+        CPPUNIT_TEST(testExternalWake);
+        CPPUNIT_TEST(testRemovedVehiclesAreForgotten);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SleepSchedulerTest( SleepSchedulerTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SleepSchedulerTest& operator=( SleepSchedulerTest const& );
+        
+    private:
+        /**
+         * Tests that vehicles at rest fall asleep after the configured 
+         * number of frames and aren't updated anymore while moving ones 
+         * stay awake.
+         */
+        void testRestingVehiclesFallAsleep();
+        
+        /**
+         * Tests that a moving vehicle wakes sleepers within the wake radius
+         * but not the ones further away.
+         */
+        void testMovingVehicleWakesSleepers();
+        
+        /**
+         * Tests waking vehicles by index and by area.
+         */
+        void testExternalWake();
+        
+        /**
+         * Tests that removed vehicles don't pass their sleep on to the 
+         * vehicles taking their index.
+         */
+        void testRemovedVehiclesAreForgotten();
+        
+    }; // SleepSchedulerTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SLEEPSCHEDULERTEST_H
@@ -0,0 +1,198 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TrajectoryCache.
+ */
+#include "TrajectoryCacheTest.h"
+
+
+// Include std::cos, std::sin
+#include <cmath>
+
+// Include OpenSteer::AbstractVehicle
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::TrajectoryCacheTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Vehicle circling the origin on the xz plane at one radian per second
+     * which counts how often it is asked for its future position.
+     */
+    class CirclingVehicle : public LocalSpaceMixin< AbstractVehicle > {
+    public:
+        CirclingVehicle() : predictions( 0 ) {}
+        
+        float mass() const { return 1.0f; }
+        float setMass( float m ) { return m; }
+        float radius() const { return 0.5f; }
+        float setRadius( float r ) { return r; }
+        Vec3 velocity() const { return forward() * speed(); }
+        float speed() const { return circleRadius; }
+        float setSpeed( float s ) { return s; }
+        float maxForce() const { return 1.0f; }
+        float setMaxForce( float f ) { return f; }
+        float maxSpeed() const { return circleRadius; }
+        float setMaxSpeed( float s ) { return s; }
+        void update( float, float ) {}
+        
+        Vec3 predictFuturePosition( float predictionTime ) const
+        {
+            ++predictions;
+            return Vec3( std::cos( predictionTime ), 0.0f, std::sin( predictionTime ) ) * circleRadius;
+        }
+        
+        static float const circleRadius;
+        mutable int predictions;
+    }; // class CirclingVehicle
+    
+    float const CirclingVehicle::circleRadius = 10.0f;
+    
+} // anonymous namespace
+
+
+
+OpenSteer::TrajectoryCacheTest::TrajectoryCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::TrajectoryCacheTest::~TrajectoryCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::testEmptyCache()
+{
+    TrajectoryCache const cache;
+    
+    CPPUNIT_ASSERT_EQUAL( TrajectoryCache::size_type( 0 ), cache.sampleCount() );
+    CPPUNIT_ASSERT( ! cache.covers( 0.0f ) );
+    CPPUNIT_ASSERT( Vec3::zero == cache.predictFuturePosition( 1.0f ) );
+}
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::testSamplesArePredictions()
+{
+    CirclingVehicle const vehicle;
+    TrajectoryCache cache;
+    cache.sample( vehicle, 20.0f, 0.25f );
+    
+    CPPUNIT_ASSERT_EQUAL( TrajectoryCache::size_type( 81 ), cache.sampleCount() );
+    CPPUNIT_ASSERT_EQUAL( 81, vehicle.predictions );
+    
+    for ( int i = 0; i <= 80; ++i ) {
+        float const time = i * 0.25f;
+        Vec3 const expected = vehicle.predictFuturePosition( time );
+        Vec3 const cached = cache.predictFuturePosition( time );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, Vec3::distance( expected, cached ), 0.0001f );
+    }
+}
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::testInterpolation()
+{
+    CirclingVehicle const vehicle;
+    TrajectoryCache cache;
+    cache.sample( vehicle, 4.0f, 0.5f );
+    
+    // halfway between the samples at 1 and 1.5 seconds
+    Vec3 const chordMiddle = ( vehicle.predictFuturePosition( 1.0f ) + 
+                               vehicle.predictFuturePosition( 1.5f ) ) / 2.0f;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, 
+                                  Vec3::distance( chordMiddle, cache.predictFuturePosition( 1.25f ) ), 
+                                  0.0001f );
+    
+    // linear interpolation is off by at most step^2/8 times the largest
+    // acceleration, which is the circle radius at one radian per second
+    float const maxError = 0.5f * 0.5f / 8.0f * CirclingVehicle::circleRadius;
+    for ( float time = 0.0f; time < 4.0f; time += 0.1f ) {
+        float const error = Vec3::distance( vehicle.predictFuturePosition( time ), 
+                                            cache.predictFuturePosition( time ) );
+        CPPUNIT_ASSERT( error <= maxError );
+    }
+}
+
+
+
+void 
+OpenSteer::TrajectoryCacheTest::testOutsideHorizon()
+{
+    CirclingVehicle const vehicle;
+    TrajectoryCache cache;
+    cache.sample( vehicle, 1.0f, 0.3f );
+    
+    CPPUNIT_ASSERT_EQUAL( TrajectoryCache::size_type( 5 ), cache.sampleCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.2f, cache.horizon(), 0.0001f );
+    CPPUNIT_ASSERT( cache.covers( 1.1f ) );
+    CPPUNIT_ASSERT( ! cache.covers( 1.3f ) );
+    CPPUNIT_ASSERT( ! cache.covers( -0.1f ) );
+    
+    Vec3 const first = vehicle.predictFuturePosition( 0.0f );
+    Vec3 const last = vehicle.predictFuturePosition( 1.2f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, Vec3::distance( first, cache.predictFuturePosition( -5.0f ) ), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, Vec3::distance( last, cache.predictFuturePosition( 5.0f ) ), 0.0001f );
+}
@@ -0,0 +1,104 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TrajectoryCache.
+ */
+#ifndef OPENSTEER_TRAJECTORYCACHETEST_H
+#define OPENSTEER_TRAJECTORYCACHETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::TrajectoryCache
+#include "OpenSteer/TrajectoryCache.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class TrajectoryCacheTest : public CppUnit::TestFixture {
+    public:
+        TrajectoryCacheTest();
+        virtual ~TrajectoryCacheTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(TrajectoryCacheTest);
+        CPPUNIT_TEST(testEmptyCache);
+        CPPUNIT_TEST(testSamplesArePredictions);
+        CPPUNIT_TEST(testInterpolation);
+        CPPUNIT_TEST(testOutsideHorizon);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TrajectoryCacheTest( TrajectoryCacheTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TrajectoryCacheTest& operator=( TrajectoryCacheTest const& );
+        
+    private:
+        /**
+         * Tests that a cache that was never sampled covers no time.
+         */
+        void testEmptyCache();
+        
+        /**
+         * Tests that the vehicle is asked once per sample and that the
+         * cache returns its predictions at the sample times.
+         */
+        void testSamplesArePredictions();
+        
+        /**
+         * Tests that positions between samples lie on the chord between
+         * them.
+         */
+        void testInterpolation();
+        
+        /**
+         * Tests that the horizon is rounded up to whole steps and that 
+         * times outside of it are clamped to the first and last sample.
+         */
+        void testOutsideHorizon();
+        
+    }; // TrajectoryCacheTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_TRAJECTORYCACHETEST_H
@@ -0,0 +1,183 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ZoneProfiler.
+ */
+#include "ZoneProfilerTest.h"
+
+
+// Include std::ostringstream
+#include <sstream>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ZoneProfilerTest );
+
+
+
+OpenSteer::ZoneProfilerTest::ZoneProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ZoneProfilerTest::~ZoneProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::tearDown()
+{
+    ZoneProfiler::stop();
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testInactiveIgnoresZones()
+{
+    ZoneProfiler::start( false );
+    ZoneProfiler::stop();
+    CPPUNIT_ASSERT( ! ZoneProfiler::active() );
+    
+    {
+        ZoneProfiler::Scope zone( ZoneProfiler::update );
+    }
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 0 ), ZoneProfiler::totals( ZoneProfiler::update ).calls );
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testNestedZones()
+{
+    ZoneProfiler::start( false );
+    {
+        ZoneProfiler::Scope update( ZoneProfiler::update );
+        for ( int i = 0; i < 3; ++i ) {
+            ZoneProfiler::Scope proximity( ZoneProfiler::proximity );
+        }
+    }
+    
+    ZoneProfiler::Totals const& update = ZoneProfiler::totals( ZoneProfiler::update );
+    ZoneProfiler::Totals const& proximity = ZoneProfiler::totals( ZoneProfiler::proximity );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 1 ), update.calls );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 3 ), proximity.calls );
+    CPPUNIT_ASSERT( update.seconds >= proximity.seconds );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 0 ), ZoneProfiler::totals( ZoneProfiler::draw ).calls );
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testReenteredZoneCountsOnce()
+{
+    ZoneProfiler::start( false );
+    {
+        ZoneProfiler::Scope outer( ZoneProfiler::proximity );
+        ZoneProfiler::Scope inner( ZoneProfiler::proximity );
+    }
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 1 ), ZoneProfiler::totals( ZoneProfiler::proximity ).calls );
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testStartClearsTotals()
+{
+    ZoneProfiler::start( false );
+    {
+        ZoneProfiler::Scope zone( ZoneProfiler::draw );
+    }
+    ZoneProfiler::start( false );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 0 ), ZoneProfiler::totals( ZoneProfiler::draw ).calls );
+    CPPUNIT_ASSERT_EQUAL( 0.0, ZoneProfiler::totals( ZoneProfiler::draw ).seconds );
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testCountersDegrade()
+{
+    ZoneProfiler::start( true );
+    {
+        ZoneProfiler::Scope zone( ZoneProfiler::update );
+    }
+    
+    PerformanceCounters const& counters = ZoneProfiler::counters();
+    CPPUNIT_ASSERT( counters.availableCount() > 0 || ! counters.errorMessage().empty() );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 1 ), ZoneProfiler::totals( ZoneProfiler::update ).calls );
+    for ( int c = 0; c < PerformanceCounters::counterCount; ++c ) {
+        if ( ! counters.available( PerformanceCounters::Counter( c ) ) ) {
+            CPPUNIT_ASSERT_EQUAL( 0.0, ZoneProfiler::totals( ZoneProfiler::update ).counters.counts[ c ] );
+        }
+    }
+    
+    std::ostringstream report;
+    ZoneProfiler::report( report, 1, 1 );
+    CPPUNIT_ASSERT( std::string::npos != report.str().find( "zone update" ) );
+}
+
+
+
+void 
+OpenSteer::ZoneProfilerTest::testAllocationsAttributedToZones()
+{
+    ZoneProfiler::start( false );
+    {
+        ZoneProfiler::Scope update( ZoneProfiler::update );
+        // Volatile pointers keep the compiler from eliding the allocations.
+        int* volatile single = new int( 1 );
+        delete single;
+        {
+            ZoneProfiler::Scope proximity( ZoneProfiler::proximity );
+            char* volatile array = new char[ 40 ];
+            delete [] array;
+        }
+    }
+    
+    ZoneProfiler::Totals const& update = ZoneProfiler::totals( ZoneProfiler::update );
+    ZoneProfiler::Totals const& proximity = ZoneProfiler::totals( ZoneProfiler::proximity );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 2 ), update.allocations );
+    CPPUNIT_ASSERT_EQUAL( ZoneProfiler::size_type( 1 ), proximity.allocations );
+    CPPUNIT_ASSERT( proximity.allocatedBytes >= 40 );
+    CPPUNIT_ASSERT( update.allocatedBytes >= proximity.allocatedBytes + sizeof( int ) );
+}
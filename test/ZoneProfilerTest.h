@@ -0,0 +1,115 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ZoneProfiler.
+ */
+#ifndef OPENSTEER_ZONEPROFILERTEST_H
+#define OPENSTEER_ZONEPROFILERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::ZoneProfiler
+#include "OpenSteer/ZoneProfiler.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class ZoneProfilerTest : public CppUnit::TestFixture {
+    public:
+        ZoneProfilerTest();
+        virtual ~ZoneProfilerTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ZoneProfilerTest);
+        CPPUNIT_TEST(testInactiveIgnoresZones);
+        CPPUNIT_TEST(testNestedZones);
+        CPPUNIT_TEST(testReenteredZoneCountsOnce);
+        CPPUNIT_TEST(testStartClearsTotals);
+        CPPUNIT_TEST(testCountersDegrade);
+        CPPUNIT_TEST(testAllocationsAttributedToZones);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ZoneProfilerTest( ZoneProfilerTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ZoneProfilerTest& operator=( ZoneProfilerTest const& );
+        
+    private:
+        /**
+         * Tests that zones aren't counted before @c start.
+         */
+        void testInactiveIgnoresZones();
+        
+        /**
+         * Tests that nested zones are counted each.
+         */
+        void testNestedZones();
+        
+        /**
+         * Tests that entering an open zone again isn't counted.
+         */
+        void testReenteredZoneCountsOnce();
+        
+        /**
+         * Tests that @c start clears the totals.
+         */
+        void testStartClearsTotals();
+        
+        /**
+         * Tests that counters are either available or say why not, and
+         * that profiling works either way.
+         */
+        void testCountersDegrade();
+        
+        /**
+         * Tests that allocations count in the zones open while they are
+         * made.
+         */
+        void testAllocationsAttributedToZones();
+        
+    }; // ZoneProfilerTest
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ZONEPROFILERTEST_H